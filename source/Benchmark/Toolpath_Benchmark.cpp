@@ -0,0 +1,239 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#include "Toolpath_Benchmark.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <algorithm>
+#include <chrono>
+#include <atomic>
+#include <stdexcept>
+
+namespace Toolpath {
+
+	static std::atomic<uint64_t> s_nBenchmarkSink(0);
+
+	static double getElapsedSeconds(std::chrono::steady_clock::time_point startTime)
+	{
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+	}
+
+	CToolpathBenchmarkRunner::CToolpathBenchmarkRunner()
+		: m_nSampleCount(10), m_dMinSampleTimeInSeconds(0.05), m_dWarmupTimeInSeconds(0.1)
+	{
+	}
+
+	void CToolpathBenchmarkRunner::addBenchmark(const std::string& sName, uint64_t nOperationsPerCall, uint64_t nBytesPerCall, ToolpathBenchmarkFunction benchmarkFunction)
+	{
+		if (sName.empty())
+			throw std::runtime_error("invalid benchmark name");
+		if (nOperationsPerCall == 0)
+			throw std::runtime_error("benchmark needs at least one operation per call: " + sName);
+		if (!benchmarkFunction)
+			throw std::runtime_error("invalid benchmark function: " + sName);
+
+		for (auto& benchmarkCase : m_Cases) {
+			if (benchmarkCase.m_sName == sName)
+				throw std::runtime_error("duplicate benchmark name: " + sName);
+		}
+
+		sToolpathBenchmarkCase benchmarkCase;
+		benchmarkCase.m_sName = sName;
+		benchmarkCase.m_nOperationsPerCall = nOperationsPerCall;
+		benchmarkCase.m_nBytesPerCall = nBytesPerCall;
+		benchmarkCase.m_Function = benchmarkFunction;
+		m_Cases.push_back(benchmarkCase);
+	}
+
+	void CToolpathBenchmarkRunner::setSampleCount(uint32_t nSampleCount)
+	{
+		if (nSampleCount == 0)
+			throw std::runtime_error("invalid benchmark sample count");
+		m_nSampleCount = nSampleCount;
+	}
+
+	void CToolpathBenchmarkRunner::setMinSampleTime(double dMinSampleTimeInSeconds)
+	{
+		if (dMinSampleTimeInSeconds <= 0.0)
+			throw std::runtime_error("invalid benchmark sample time");
+		m_dMinSampleTimeInSeconds = dMinSampleTimeInSeconds;
+	}
+
+	void CToolpathBenchmarkRunner::setWarmupTime(double dWarmupTimeInSeconds)
+	{
+		if (dWarmupTimeInSeconds < 0.0)
+			throw std::runtime_error("invalid benchmark warmup time");
+		m_dWarmupTimeInSeconds = dWarmupTimeInSeconds;
+	}
+
+	void CToolpathBenchmarkRunner::setFilter(const std::string& sFilter)
+	{
+		m_sFilter = sFilter;
+	}
+
+	void CToolpathBenchmarkRunner::listBenchmarks()
+	{
+		for (auto& benchmarkCase : m_Cases)
+			std::cout << benchmarkCase.m_sName << "\n";
+	}
+
+	sToolpathBenchmarkResult CToolpathBenchmarkRunner::runCase(const sToolpathBenchmarkCase& benchmarkCase)
+	{
+		// Warmup, which also calibrates the number of calls per sample
+		uint64_t nWarmupCalls = 0;
+		auto warmupStartTime = std::chrono::steady_clock::now();
+		do {
+			benchmarkCase.m_Function();
+			nWarmupCalls++;
+		} while (getElapsedSeconds(warmupStartTime) < m_dWarmupTimeInSeconds);
+
+		double dSecondsPerCall = getElapsedSeconds(warmupStartTime) / (double)nWarmupCalls;
+		uint64_t nCallsPerSample = 1;
+		if (dSecondsPerCall > 0.0)
+			nCallsPerSample = std::max<uint64_t>(1, (uint64_t)(m_dMinSampleTimeInSeconds / dSecondsPerCall));
+
+		std::vector<double> nanosecondsPerOperation;
+		for (uint32_t nSampleIndex = 0; nSampleIndex < m_nSampleCount; nSampleIndex++) {
+			auto sampleStartTime = std::chrono::steady_clock::now();
+			for (uint64_t nCallIndex = 0; nCallIndex < nCallsPerSample; nCallIndex++)
+				benchmarkCase.m_Function();
+			double dSampleTime = getElapsedSeconds(sampleStartTime);
+
+			nanosecondsPerOperation.push_back(dSampleTime * 1.0e9 / ((double)nCallsPerSample * (double)benchmarkCase.m_nOperationsPerCall));
+		}
+
+		std::vector<double> sortedSamples = nanosecondsPerOperation;
+		std::sort(sortedSamples.begin(), sortedSamples.end());
+
+		double dSum = 0.0;
+		for (double dSample : sortedSamples)
+			dSum += dSample;
+
+		sToolpathBenchmarkResult result;
+		result.m_sName = benchmarkCase.m_sName;
+		result.m_nOperationsPerCall = benchmarkCase.m_nOperationsPerCall;
+		result.m_nBytesPerCall = benchmarkCase.m_nBytesPerCall;
+		result.m_nCallsPerSample = nCallsPerSample;
+		result.m_nSampleCount = m_nSampleCount;
+		result.m_dMinNanosecondsPerOperation = sortedSamples.front();
+		result.m_dMedianNanosecondsPerOperation = sortedSamples[sortedSamples.size() / 2];
+		result.m_dMeanNanosecondsPerOperation = dSum / (double)sortedSamples.size();
+		result.m_dMaxNanosecondsPerOperation = sortedSamples.back();
+
+		double dMedianNanosecondsPerCall = result.m_dMedianNanosecondsPerOperation * (double)benchmarkCase.m_nOperationsPerCall;
+		result.m_dBytesPerSecond = 0.0;
+		if (dMedianNanosecondsPerCall > 0.0)
+			result.m_dBytesPerSecond = (double)benchmarkCase.m_nBytesPerCall * 1.0e9 / dMedianNanosecondsPerCall;
+
+		return result;
+	}
+
+	void CToolpathBenchmarkRunner::run()
+	{
+		m_Results.clear();
+
+		std::cout << std::left << std::setw(48) << "benchmark"
+			<< std::right << std::setw(14) << "ns/op" << std::setw(14) << "min ns/op" << std::setw(14) << "MB/s" << "\n";
+
+		for (auto& benchmarkCase : m_Cases) {
+			if (!m_sFilter.empty() && (benchmarkCase.m_sName.find(m_sFilter) == std::string::npos))
+				continue;
+
+			auto result = runCase(benchmarkCase);
+			m_Results.push_back(result);
+
+			std::cout << std::left << std::setw(48) << result.m_sName << std::right << std::fixed << std::setprecision(2)
+				<< std::setw(14) << result.m_dMedianNanosecondsPerOperation
+				<< std::setw(14) << result.m_dMinNanosecondsPerOperation;
+
+			// Benchmarks without a byte count only report ns/op
+			if (result.m_nBytesPerCall > 0)
+				std::cout << std::setw(14) << (result.m_dBytesPerSecond / 1.0e6) << "\n";
+			else
+				std::cout << std::setw(14) << "-" << "\n";
+		}
+	}
+
+	const std::vector<sToolpathBenchmarkResult>& CToolpathBenchmarkRunner::getResults()
+	{
+		return m_Results;
+	}
+
+	void CToolpathBenchmarkRunner::writeToJSON(CToolpathJSONWriter& jsonWriter)
+	{
+		jsonWriter.beginObject();
+
+		jsonWriter.beginObject("configuration");
+		jsonWriter.writeUint64("samples", m_nSampleCount);
+		jsonWriter.writeDouble("minSampleTime", m_dMinSampleTimeInSeconds);
+		jsonWriter.writeDouble("warmupTime", m_dWarmupTimeInSeconds);
+		jsonWriter.writeString("filter", m_sFilter);
+		jsonWriter.endObject();
+
+		jsonWriter.beginArray("benchmarks");
+		for (auto& result : m_Results) {
+			jsonWriter.beginObject();
+			jsonWriter.writeString("name", result.m_sName);
+			jsonWriter.writeUint64("operationsPerCall", result.m_nOperationsPerCall);
+			jsonWriter.writeUint64("bytesPerCall", result.m_nBytesPerCall);
+			jsonWriter.writeUint64("callsPerSample", result.m_nCallsPerSample);
+			jsonWriter.writeUint64("samples", result.m_nSampleCount);
+			jsonWriter.writeDouble("nsPerOp", result.m_dMedianNanosecondsPerOperation);
+			jsonWriter.writeDouble("minNsPerOp", result.m_dMinNanosecondsPerOperation);
+			jsonWriter.writeDouble("meanNsPerOp", result.m_dMeanNanosecondsPerOperation);
+			jsonWriter.writeDouble("maxNsPerOp", result.m_dMaxNanosecondsPerOperation);
+			jsonWriter.writeDouble("bytesPerSecond", result.m_dBytesPerSecond);
+			jsonWriter.endObject();
+		}
+		jsonWriter.endArray();
+
+		jsonWriter.endObject();
+	}
+
+	void CToolpathBenchmarkRunner::writeToFile(const std::string& sFileName)
+	{
+		std::ofstream stream(sFileName, std::ios::out | std::ios::trunc);
+		if (!stream.is_open())
+			throw std::runtime_error("Failed to open benchmark result file: " + sFileName);
+
+		CToolpathJSONWriter jsonWriter(stream);
+		writeToJSON(jsonWriter);
+
+		if (!stream.good())
+			throw std::runtime_error("Failed to write benchmark result file: " + sFileName);
+	}
+
+	void CToolpathBenchmarkRunner::consume(uint64_t nValue)
+	{
+		s_nBenchmarkSink.fetch_add(nValue, std::memory_order_relaxed);
+	}
+
+} // namespace Toolpath
@@ -0,0 +1,113 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#ifndef __TOOLPATH_BENCHMARK
+#define __TOOLPATH_BENCHMARK
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <cstdint>
+
+#include "Toolpath_JSONWriter.hpp"
+
+namespace Toolpath {
+
+	typedef std::function<void()> ToolpathBenchmarkFunction;
+
+	typedef struct _sToolpathBenchmarkCase {
+		std::string m_sName;
+		// Work done by one call of the function, used for ns/op and bytes/s
+		uint64_t m_nOperationsPerCall;
+		uint64_t m_nBytesPerCall;
+		ToolpathBenchmarkFunction m_Function;
+	} sToolpathBenchmarkCase;
+
+	typedef struct _sToolpathBenchmarkResult {
+		std::string m_sName;
+		uint64_t m_nOperationsPerCall;
+		uint64_t m_nBytesPerCall;
+		uint64_t m_nCallsPerSample;
+		uint32_t m_nSampleCount;
+		double m_dMinNanosecondsPerOperation;
+		double m_dMedianNanosecondsPerOperation;
+		double m_dMeanNanosecondsPerOperation;
+		double m_dMaxNanosecondsPerOperation;
+		double m_dBytesPerSecond;
+	} sToolpathBenchmarkResult;
+
+	/**
+	 * Runs registered benchmark functions with warmup and repeated samples.
+	 * Each sample calls the function often enough to last at least the minimum sample time.
+	 * Results are taken from the median sample.
+	 */
+	class CToolpathBenchmarkRunner {
+	private:
+		std::vector<sToolpathBenchmarkCase> m_Cases;
+		std::vector<sToolpathBenchmarkResult> m_Results;
+
+		uint32_t m_nSampleCount;
+		double m_dMinSampleTimeInSeconds;
+		double m_dWarmupTimeInSeconds;
+		std::string m_sFilter;
+
+		sToolpathBenchmarkResult runCase(const sToolpathBenchmarkCase& benchmarkCase);
+
+	public:
+		CToolpathBenchmarkRunner();
+		virtual ~CToolpathBenchmarkRunner() = default;
+
+		void addBenchmark(const std::string& sName, uint64_t nOperationsPerCall, uint64_t nBytesPerCall, ToolpathBenchmarkFunction benchmarkFunction);
+
+		void setSampleCount(uint32_t nSampleCount);
+		void setMinSampleTime(double dMinSampleTimeInSeconds);
+		void setWarmupTime(double dWarmupTimeInSeconds);
+		// Only benchmarks containing the filter string are run
+		void setFilter(const std::string& sFilter);
+
+		void listBenchmarks();
+		void run();
+
+		const std::vector<sToolpathBenchmarkResult>& getResults();
+		void writeToJSON(CToolpathJSONWriter& jsonWriter);
+		void writeToFile(const std::string& sFileName);
+
+		// Keeps the compiler from discarding computed values
+		static void consume(uint64_t nValue);
+	};
+
+	// Benchmark registration, one function per benchmark group
+	void registerMatJobBenchmarks(CToolpathBenchmarkRunner& runner);
+	void registerXMLBenchmarks(CToolpathBenchmarkRunner& runner);
+	void registerCompressionBenchmarks(CToolpathBenchmarkRunner& runner);
+	void registerCLIPlusBenchmarks(CToolpathBenchmarkRunner& runner);
+
+} // namespace Toolpath
+
+#endif // __TOOLPATH_BENCHMARK
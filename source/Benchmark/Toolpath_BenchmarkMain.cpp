@@ -0,0 +1,172 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#include <iostream>
+#include <vector>
+#include <string>
+
+#include "Toolpath_Benchmark.hpp"
+#include "Toolpath_Benchmark_EndToEnd.hpp"
+
+using namespace Toolpath;
+
+int main(int argc, char* argv[])
+{
+	try {
+		std::string sFilter;
+		std::string sJSONFileName;
+		bool bListOnly = false;
+		bool bEndToEnd = false;
+
+		CToolpathBenchmarkRunner runner;
+		CToolpathEndToEndBenchmark endToEndBenchmark;
+		auto& syntheticConfiguration = endToEndBenchmark.getConfiguration();
+
+		std::vector<std::string> commandArguments;
+		for (int idx = 1; idx < argc; idx++)
+			commandArguments.push_back(argv[idx]);
+
+		for (size_t nIndex = 0; nIndex < commandArguments.size(); nIndex++) {
+			std::string sArgument = commandArguments[nIndex];
+
+			if (sArgument == "--filter") {
+				nIndex++;
+				if (nIndex >= commandArguments.size())
+					throw std::runtime_error("missing --filter value");
+
+				sFilter = commandArguments[nIndex];
+			}
+			else if (sArgument == "--repetitions") {
+				nIndex++;
+				if (nIndex >= commandArguments.size())
+					throw std::runtime_error("missing --repetitions value");
+
+				runner.setSampleCount((uint32_t)std::stoul(commandArguments[nIndex]));
+			}
+			else if (sArgument == "--min-time") {
+				nIndex++;
+				if (nIndex >= commandArguments.size())
+					throw std::runtime_error("missing --min-time value");
+
+				runner.setMinSampleTime(std::stod(commandArguments[nIndex]));
+			}
+			else if (sArgument == "--warmup") {
+				nIndex++;
+				if (nIndex >= commandArguments.size())
+					throw std::runtime_error("missing --warmup value");
+
+				runner.setWarmupTime(std::stod(commandArguments[nIndex]));
+			}
+			else if (sArgument == "--json") {
+				nIndex++;
+				if (nIndex >= commandArguments.size())
+					throw std::runtime_error("missing --json path");
+
+				sJSONFileName = commandArguments[nIndex];
+			}
+			else if (sArgument == "--list") {
+				bListOnly = true;
+			}
+			else if (sArgument == "--endtoend") {
+				bEndToEnd = true;
+			}
+			else if ((sArgument == "--seed") || (sArgument == "--layers") || (sArgument == "--parts") || (sArgument == "--profiles") ||
+				(sArgument == "--loops") || (sArgument == "--hatches") || (sArgument == "--threads") || (sArgument == "--format") ||
+				(sArgument == "--sweep") || (sArgument == "--output-dir")) {
+				nIndex++;
+				if (nIndex >= commandArguments.size())
+					throw std::runtime_error("missing " + sArgument + " value");
+
+				std::string sValue = commandArguments[nIndex];
+				if (sArgument == "--seed")
+					syntheticConfiguration.m_nSeed = std::stoull(sValue);
+				else if (sArgument == "--layers")
+					syntheticConfiguration.m_nLayerCount = (uint32_t)std::stoul(sValue);
+				else if (sArgument == "--parts")
+					syntheticConfiguration.m_nPartCount = (uint32_t)std::stoul(sValue);
+				else if (sArgument == "--profiles")
+					syntheticConfiguration.m_nProfileCount = (uint32_t)std::stoul(sValue);
+				else if (sArgument == "--loops")
+					syntheticConfiguration.m_nLoopsPerLayer = (uint32_t)std::stoul(sValue);
+				else if (sArgument == "--hatches")
+					syntheticConfiguration.m_nHatchesPerLayer = (uint32_t)std::stoul(sValue);
+				else if (sArgument == "--threads")
+					endToEndBenchmark.setThreadCounts(CToolpathEndToEndBenchmark::parseThreadCounts(sValue));
+				else if (sArgument == "--format")
+					endToEndBenchmark.setFormat(sValue);
+				else if (sArgument == "--sweep")
+					endToEndBenchmark.setSweep(sValue);
+				else
+					endToEndBenchmark.setOutputDirectory(sValue);
+			}
+			else if (sArgument == "--keep-output") {
+				endToEndBenchmark.setKeepOutput(true);
+			}
+			else
+				throw std::runtime_error("Usage: ToolpathConverterBench [--filter name] [--repetitions n] [--min-time seconds] [--warmup seconds] [--json results.json] [--list]\n"
+					"       ToolpathConverterBench --endtoend [--layers n] [--parts n] [--profiles n] [--loops n] [--hatches n] [--seed n] [--threads 1,2,4] [--format matjob|cliplus|all] [--sweep strong|weak|both] [--output-dir dir] [--keep-output] [--json results.json]");
+		}
+
+		// End-to-end conversion of a synthetic job instead of the microbenchmarks
+		if (bEndToEnd) {
+			endToEndBenchmark.run();
+
+			if (!sJSONFileName.empty()) {
+				std::cout << "Writing benchmark results to " << sJSONFileName << "\n";
+				endToEndBenchmark.writeToFile(sJSONFileName);
+			}
+
+			return 0;
+		}
+
+		registerMatJobBenchmarks(runner);
+		registerXMLBenchmarks(runner);
+		registerCompressionBenchmarks(runner);
+		registerCLIPlusBenchmarks(runner);
+
+		if (bListOnly) {
+			runner.listBenchmarks();
+			return 0;
+		}
+
+		runner.setFilter(sFilter);
+		runner.run();
+
+		if (!sJSONFileName.empty()) {
+			std::cout << "Writing benchmark results to " << sJSONFileName << "\n";
+			runner.writeToFile(sJSONFileName);
+		}
+	}
+	catch (std::exception& E) {
+		std::cout << "fatal error: " << E.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,316 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#include "Toolpath_Benchmark_EndToEnd.hpp"
+
+#include "Toolpath_Exporter_Matjob.hpp"
+#include "Toolpath_Exporter_CLIPlus.hpp"
+#include "Toolpath_ThreadPool.hpp"
+#include "Toolpath_MemoryTracker.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <stdexcept>
+
+namespace Toolpath {
+
+	static double getSecondsSince(std::chrono::steady_clock::time_point startTime)
+	{
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+	}
+
+	static uint64_t getFileSize(const std::string& sFileName)
+	{
+		std::ifstream stream(sFileName, std::ios::in | std::ios::binary | std::ios::ate);
+		if (!stream.is_open())
+			throw std::runtime_error("Failed to open benchmark output: " + sFileName);
+
+		return (uint64_t)stream.tellg();
+	}
+
+	CToolpathEndToEndBenchmark::CToolpathEndToEndBenchmark()
+		: m_Configuration(CToolpathSource_Synthetic::getDefaultConfiguration()),
+		m_bStrongScaling(true),
+		m_bWeakScaling(true),
+		m_sOutputDirectory("."),
+		m_bKeepOutput(false)
+	{
+		uint32_t nHardwareThreads = CToolpathThreadPool::resolveThreadCount(0);
+		for (uint32_t nThreadCount = 1; nThreadCount < nHardwareThreads; nThreadCount *= 2)
+			m_ThreadCounts.push_back(nThreadCount);
+		m_ThreadCounts.push_back(nHardwareThreads);
+
+		m_Formats.push_back("matjob");
+		m_Formats.push_back("cliplus");
+	}
+
+	sToolpathSyntheticConfiguration& CToolpathEndToEndBenchmark::getConfiguration()
+	{
+		return m_Configuration;
+	}
+
+	void CToolpathEndToEndBenchmark::setThreadCounts(const std::vector<uint32_t>& threadCounts)
+	{
+		if (threadCounts.empty())
+			throw std::runtime_error("no benchmark thread counts given");
+
+		m_ThreadCounts.clear();
+		for (uint32_t nThreadCount : threadCounts)
+			m_ThreadCounts.push_back(CToolpathThreadPool::resolveThreadCount(nThreadCount));
+	}
+
+	void CToolpathEndToEndBenchmark::setFormat(const std::string& sFormat)
+	{
+		m_Formats.clear();
+		if ((sFormat == "matjob") || (sFormat == "all"))
+			m_Formats.push_back("matjob");
+		if ((sFormat == "cliplus") || (sFormat == "all"))
+			m_Formats.push_back("cliplus");
+
+		if (m_Formats.empty())
+			throw std::runtime_error("Unknown benchmark format: " + sFormat + ". Supported formats: matjob, cliplus, all");
+	}
+
+	void CToolpathEndToEndBenchmark::setSweep(const std::string& sSweep)
+	{
+		m_bStrongScaling = (sSweep == "strong") || (sSweep == "both");
+		m_bWeakScaling = (sSweep == "weak") || (sSweep == "both");
+
+		if (!m_bStrongScaling && !m_bWeakScaling)
+			throw std::runtime_error("Unknown benchmark sweep: " + sSweep + ". Supported sweeps: strong, weak, both");
+	}
+
+	void CToolpathEndToEndBenchmark::setOutputDirectory(const std::string& sOutputDirectory)
+	{
+		m_sOutputDirectory = sOutputDirectory;
+	}
+
+	void CToolpathEndToEndBenchmark::setKeepOutput(bool bKeepOutput)
+	{
+		m_bKeepOutput = bKeepOutput;
+	}
+
+	sToolpathEndToEndResult CToolpathEndToEndBenchmark::runConversion(const std::string& sFormat, const std::string& sSweep, uint32_t nThreadCount, uint32_t nLayerCount)
+	{
+		sToolpathSyntheticConfiguration configuration = m_Configuration;
+		configuration.m_nLayerCount = nLayerCount;
+		auto pSource = std::make_shared<CToolpathSource_Synthetic>(configuration);
+
+		std::string sOutputFileName = m_sOutputDirectory + "/synthetic_" + sSweep + "_" + std::to_string(nThreadCount) + ((sFormat == "matjob") ? ".matjob" : ".cli");
+
+		PToolpathExporter pExporter;
+		if (sFormat == "matjob") {
+			auto pMatjobExporter = std::make_shared<CToolpathExporter_Matjob>();
+			pMatjobExporter->setThreadCount(nThreadCount);
+			pExporter = pMatjobExporter;
+		}
+		else {
+			pExporter = std::make_shared<CToolpathExporter_CLIPlus>();
+		}
+
+		sToolpathEndToEndResult result;
+		result.m_sFormat = sFormat;
+		result.m_sSweep = sSweep;
+		result.m_nThreadCount = nThreadCount;
+		result.m_nLayerCount = nLayerCount;
+		result.m_nHatchCount = 0;
+		result.m_nPointCount = 0;
+		result.m_dSourceTimeInSeconds = 0.0;
+		result.m_nPeakResidentBytes = CToolpathMemoryTracker::getProcessResidentBytes();
+		result.m_dSpeedup = 1.0;
+		result.m_dEfficiency = 1.0;
+
+		auto startTime = std::chrono::steady_clock::now();
+
+		pExporter->initialize(sOutputFileName);
+		pExporter->beginExport(pSource);
+
+		CToolpathLayerData layerData;
+		for (uint32_t nLayerIndex = 0; nLayerIndex < nLayerCount; nLayerIndex++) {
+			auto readStartTime = std::chrono::steady_clock::now();
+			pSource->readLayer(nLayerIndex, layerData);
+			result.m_dSourceTimeInSeconds += getSecondsSince(readStartTime);
+
+			pExporter->processLayer(layerData);
+
+			result.m_nHatchCount += layerData.getHatches().size();
+			result.m_nPointCount += layerData.getPoints().size();
+			result.m_nPeakResidentBytes = std::max(result.m_nPeakResidentBytes, CToolpathMemoryTracker::getProcessResidentBytes());
+		}
+
+		pExporter->finalize();
+		result.m_nPeakResidentBytes = std::max(result.m_nPeakResidentBytes, CToolpathMemoryTracker::getProcessResidentBytes());
+
+		// Joins the worker threads before the time is taken
+		pExporter = nullptr;
+
+		result.m_dWallTimeInSeconds = getSecondsSince(startTime);
+		result.m_dLayersPerSecond = (result.m_dWallTimeInSeconds > 0.0) ? (nLayerCount / result.m_dWallTimeInSeconds) : 0.0;
+		result.m_nOutputBytes = getFileSize(sOutputFileName);
+
+		if (!m_bKeepOutput)
+			std::remove(sOutputFileName.c_str());
+
+		return result;
+	}
+
+	void CToolpathEndToEndBenchmark::runSweep(const std::string& sFormat, const std::string& sSweep)
+	{
+		uint32_t nMaxThreadCount = *std::max_element(m_ThreadCounts.begin(), m_ThreadCounts.end());
+		uint32_t nLayersPerThread = std::max<uint32_t>(1, m_Configuration.m_nLayerCount / nMaxThreadCount);
+
+		// The CLI+ exporter is single threaded, so it is run once per sweep
+		std::vector<uint32_t> threadCounts = m_ThreadCounts;
+		if (sFormat != "matjob")
+			threadCounts = { 1 };
+
+		size_t nFirstResultIndex = m_Results.size();
+		for (uint32_t nThreadCount : threadCounts) {
+			uint32_t nLayerCount = (sSweep == "weak") ? (nLayersPerThread * nThreadCount) : m_Configuration.m_nLayerCount;
+
+			auto result = runConversion(sFormat, sSweep, nThreadCount, nLayerCount);
+
+			auto& referenceResult = (m_Results.size() > nFirstResultIndex) ? m_Results[nFirstResultIndex] : result;
+			if (result.m_dWallTimeInSeconds > 0.0) {
+				if (sSweep == "weak") {
+					// Same work per thread, so the ideal wall time stays constant
+					result.m_dEfficiency = referenceResult.m_dWallTimeInSeconds / result.m_dWallTimeInSeconds;
+					result.m_dSpeedup = result.m_dEfficiency * ((double)nThreadCount / referenceResult.m_nThreadCount);
+				}
+				else {
+					result.m_dSpeedup = referenceResult.m_dWallTimeInSeconds / result.m_dWallTimeInSeconds;
+					result.m_dEfficiency = result.m_dSpeedup / ((double)nThreadCount / referenceResult.m_nThreadCount);
+				}
+			}
+
+			m_Results.push_back(result);
+
+			std::cout << std::left << std::setw(10) << sFormat << std::setw(8) << sSweep << std::right << std::fixed
+				<< std::setw(8) << nThreadCount
+				<< std::setw(10) << nLayerCount
+				<< std::setw(12) << std::setprecision(3) << result.m_dWallTimeInSeconds
+				<< std::setw(12) << std::setprecision(1) << result.m_dLayersPerSecond
+				<< std::setw(14) << std::setprecision(1) << (result.m_nOutputBytes / 1.0e6)
+				<< std::setw(14) << std::setprecision(1) << (result.m_nPeakResidentBytes / 1.0e6)
+				<< std::setw(10) << std::setprecision(2) << result.m_dSpeedup
+				<< std::setw(10) << std::setprecision(2) << result.m_dEfficiency << std::endl;
+		}
+	}
+
+	void CToolpathEndToEndBenchmark::run()
+	{
+		m_Results.clear();
+
+		std::cout << "Synthetic job: " << m_Configuration.m_nLayerCount << " layers, " << m_Configuration.m_nPartCount << " parts, "
+			<< m_Configuration.m_nProfileCount << " profiles, " << m_Configuration.m_nLoopsPerLayer << " loops and "
+			<< m_Configuration.m_nHatchesPerLayer << " hatches per layer, seed " << m_Configuration.m_nSeed << "\n";
+
+		std::cout << std::left << std::setw(10) << "format" << std::setw(8) << "sweep" << std::right
+			<< std::setw(8) << "threads" << std::setw(10) << "layers" << std::setw(12) << "wall s" << std::setw(12) << "layers/s"
+			<< std::setw(14) << "output MB" << std::setw(14) << "peak RSS MB" << std::setw(10) << "speedup" << std::setw(10) << "effic." << "\n";
+
+		for (auto& sFormat : m_Formats) {
+			if (m_bStrongScaling)
+				runSweep(sFormat, "strong");
+			if (m_bWeakScaling)
+				runSweep(sFormat, "weak");
+		}
+	}
+
+	void CToolpathEndToEndBenchmark::writeToJSON(CToolpathJSONWriter& jsonWriter)
+	{
+		jsonWriter.beginObject();
+
+		jsonWriter.beginObject("job");
+		jsonWriter.writeUint64("seed", m_Configuration.m_nSeed);
+		jsonWriter.writeUint64("layers", m_Configuration.m_nLayerCount);
+		jsonWriter.writeDouble("layerThickness", m_Configuration.m_dLayerThickness);
+		jsonWriter.writeUint64("parts", m_Configuration.m_nPartCount);
+		jsonWriter.writeUint64("profiles", m_Configuration.m_nProfileCount);
+		jsonWriter.writeUint64("loopsPerLayer", m_Configuration.m_nLoopsPerLayer);
+		jsonWriter.writeUint64("pointsPerLoop", m_Configuration.m_nPointsPerLoop);
+		jsonWriter.writeUint64("hatchesPerLayer", m_Configuration.m_nHatchesPerLayer);
+		jsonWriter.writeDouble("plateSize", m_Configuration.m_dPlateSize);
+		jsonWriter.endObject();
+
+		jsonWriter.beginArray("runs");
+		for (auto& result : m_Results) {
+			jsonWriter.beginObject();
+			jsonWriter.writeString("format", result.m_sFormat);
+			jsonWriter.writeString("sweep", result.m_sSweep);
+			jsonWriter.writeUint64("threads", result.m_nThreadCount);
+			jsonWriter.writeUint64("layers", result.m_nLayerCount);
+			jsonWriter.writeUint64("hatches", result.m_nHatchCount);
+			jsonWriter.writeUint64("points", result.m_nPointCount);
+			jsonWriter.writeDouble("wallTime", result.m_dWallTimeInSeconds);
+			jsonWriter.writeDouble("sourceTime", result.m_dSourceTimeInSeconds);
+			jsonWriter.writeDouble("layersPerSecond", result.m_dLayersPerSecond);
+			jsonWriter.writeUint64("outputBytes", result.m_nOutputBytes);
+			jsonWriter.writeUint64("peakResidentBytes", result.m_nPeakResidentBytes);
+			jsonWriter.writeDouble("speedup", result.m_dSpeedup);
+			jsonWriter.writeDouble("efficiency", result.m_dEfficiency);
+			jsonWriter.endObject();
+		}
+		jsonWriter.endArray();
+
+		jsonWriter.endObject();
+	}
+
+	void CToolpathEndToEndBenchmark::writeToFile(const std::string& sFileName)
+	{
+		std::ofstream stream(sFileName, std::ios::out | std::ios::trunc);
+		if (!stream.is_open())
+			throw std::runtime_error("Failed to open benchmark result file: " + sFileName);
+
+		CToolpathJSONWriter jsonWriter(stream);
+		writeToJSON(jsonWriter);
+
+		if (!stream.good())
+			throw std::runtime_error("Failed to write benchmark result file: " + sFileName);
+	}
+
+	std::vector<uint32_t> CToolpathEndToEndBenchmark::parseThreadCounts(const std::string& sThreadCounts)
+	{
+		std::vector<uint32_t> threadCounts;
+		std::istringstream stream(sThreadCounts);
+		std::string sValue;
+		while (std::getline(stream, sValue, ',')) {
+			if (!sValue.empty())
+				threadCounts.push_back((uint32_t)std::stoul(sValue));
+		}
+
+		return threadCounts;
+	}
+
+} // namespace Toolpath
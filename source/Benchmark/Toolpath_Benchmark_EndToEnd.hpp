@@ -0,0 +1,105 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#ifndef __TOOLPATH_BENCHMARK_ENDTOEND
+#define __TOOLPATH_BENCHMARK_ENDTOEND
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "Toolpath_JSONWriter.hpp"
+#include "Toolpath_Source_Synthetic.hpp"
+
+namespace Toolpath {
+
+	typedef struct _sToolpathEndToEndResult {
+		std::string m_sFormat;
+		std::string m_sSweep;
+		uint32_t m_nThreadCount;
+		uint32_t m_nLayerCount;
+		uint64_t m_nHatchCount;
+		uint64_t m_nPointCount;
+		double m_dWallTimeInSeconds;
+		double m_dSourceTimeInSeconds;
+		double m_dLayersPerSecond;
+		uint64_t m_nOutputBytes;
+		// Largest resident set size sampled at layer boundaries and after finalizing
+		uint64_t m_nPeakResidentBytes;
+		// Relative to the first run of the same format and sweep
+		double m_dSpeedup;
+		double m_dEfficiency;
+	} sToolpathEndToEndResult;
+
+	/**
+	 * Runs the exporters over a synthetic job and reports wall time, throughput, output size and memory.
+	 * The strong scaling sweep converts the same job with every thread count. The weak scaling sweep
+	 * gives every thread the same number of layers, so that the largest run equals the strong job.
+	 */
+	class CToolpathEndToEndBenchmark {
+	private:
+		sToolpathSyntheticConfiguration m_Configuration;
+		std::vector<uint32_t> m_ThreadCounts;
+		std::vector<std::string> m_Formats;
+		bool m_bStrongScaling;
+		bool m_bWeakScaling;
+		std::string m_sOutputDirectory;
+		bool m_bKeepOutput;
+
+		std::vector<sToolpathEndToEndResult> m_Results;
+
+		sToolpathEndToEndResult runConversion(const std::string& sFormat, const std::string& sSweep, uint32_t nThreadCount, uint32_t nLayerCount);
+		void runSweep(const std::string& sFormat, const std::string& sSweep);
+
+	public:
+		CToolpathEndToEndBenchmark();
+		virtual ~CToolpathEndToEndBenchmark() = default;
+
+		sToolpathSyntheticConfiguration& getConfiguration();
+
+		void setThreadCounts(const std::vector<uint32_t>& threadCounts);
+		// matjob, cliplus or all
+		void setFormat(const std::string& sFormat);
+		// strong, weak or both
+		void setSweep(const std::string& sSweep);
+		void setOutputDirectory(const std::string& sOutputDirectory);
+		void setKeepOutput(bool bKeepOutput);
+
+		void run();
+
+		void writeToJSON(CToolpathJSONWriter& jsonWriter);
+		void writeToFile(const std::string& sFileName);
+
+		// Parses a comma separated list of thread counts. 0 stands for the hardware concurrency.
+		static std::vector<uint32_t> parseThreadCounts(const std::string& sThreadCounts);
+	};
+
+} // namespace Toolpath
+
+#endif // __TOOLPATH_BENCHMARK_ENDTOEND
@@ -0,0 +1,273 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#include "Toolpath_Benchmark.hpp"
+
+#include "Toolpath_Source.hpp"
+#include "Toolpath_MatjobBinaryFile.hpp"
+#include "Toolpath_MatjobLayer.hpp"
+#include "Toolpath_MatjobPart.hpp"
+
+#include "Common/Platform/NMR_ExportStream_Memory.h"
+#include "Common/Platform/NMR_XmlWriter_Native.h"
+#include "Common/Platform/NMR_PortableZIPWriter.h"
+#include "Common/Platform/NMR_PortableZIPDeflatedData.h"
+
+#include "zlib.h"
+
+#include <sstream>
+#include <iomanip>
+#include <random>
+#include <memory>
+
+// All input data is generated from fixed seeds so that runs are comparable between releases.
+#define TOOLPATHBENCHMARK_SEED 20260101
+
+#define TOOLPATHBENCHMARK_POLYLINECOUNT 256
+#define TOOLPATHBENCHMARK_POINTSPERPOLYLINE 64
+#define TOOLPATHBENCHMARK_HATCHBLOCKCOUNT 16
+#define TOOLPATHBENCHMARK_HATCHESPERBLOCK 256
+#define TOOLPATHBENCHMARK_UINT32RECORDCOUNT 4096
+#define TOOLPATHBENCHMARK_XMLELEMENTCOUNT 1024
+#define TOOLPATHBENCHMARK_COMPRESSIONBUFFERSIZE (1024 * 1024)
+#define TOOLPATHBENCHMARK_CLIPLUSPOINTCOUNT 4096
+
+namespace Toolpath {
+
+	static std::vector<sToolpathPoint2D> createBenchmarkPoints(uint32_t nPointCount, uint32_t nSeed)
+	{
+		std::mt19937 generator(nSeed);
+		std::uniform_real_distribution<float> distribution(-100.0f, 100.0f);
+
+		std::vector<sToolpathPoint2D> points(nPointCount);
+		for (auto& point : points) {
+			point.m_Coordinates[0] = distribution(generator);
+			point.m_Coordinates[1] = distribution(generator);
+		}
+
+		return points;
+	}
+
+	static std::vector<sToolpathHatch2D> createBenchmarkHatches(uint32_t nHatchCount, uint32_t nSeed)
+	{
+		std::mt19937 generator(nSeed);
+		std::uniform_real_distribution<double> distribution(-100.0, 100.0);
+
+		// Parallel hatch lines with 0.1mm spacing, like a typical infill
+		std::vector<sToolpathHatch2D> hatches(nHatchCount);
+		for (uint32_t nHatchIndex = 0; nHatchIndex < nHatchCount; nHatchIndex++) {
+			auto& hatch = hatches[nHatchIndex];
+			double dY = -100.0 + 0.1 * (double)nHatchIndex;
+			hatch.m_Point1Coordinates[0] = distribution(generator);
+			hatch.m_Point1Coordinates[1] = dY;
+			hatch.m_Point2Coordinates[0] = distribution(generator);
+			hatch.m_Point2Coordinates[1] = dY;
+		}
+
+		return hatches;
+	}
+
+	// Compression input with different entropy: all zeros, repetitive text, binary floats and random bytes
+	static std::vector<uint8_t> createCompressionBuffer(const std::string& sEntropy, uint32_t nSize)
+	{
+		std::vector<uint8_t> buffer;
+		buffer.reserve(nSize);
+		std::mt19937 generator(TOOLPATHBENCHMARK_SEED);
+
+		if (sEntropy == "zeros") {
+			buffer.resize(nSize, 0);
+		}
+		else if (sEntropy == "text") {
+			std::uniform_real_distribution<double> distribution(0.0, 250.0);
+			std::ostringstream stream;
+			while ((uint32_t)stream.tellp() < nSize) {
+				stream << "<Layer Z=\"" << std::fixed << std::setprecision(4) << distribution(generator) << "\" ScanTime=\"" << distribution(generator) << "\"/>\n";
+			}
+			std::string sText = stream.str();
+			buffer.assign(sText.begin(), sText.begin() + nSize);
+		}
+		else if (sEntropy == "floats") {
+			std::uniform_real_distribution<float> distribution(-100.0f, 100.0f);
+			while (buffer.size() + sizeof(float) <= nSize) {
+				float fValue = distribution(generator);
+				const uint8_t* pValue = (const uint8_t*)&fValue;
+				buffer.insert(buffer.end(), pValue, pValue + sizeof(float));
+			}
+			buffer.resize(nSize, 0);
+		}
+		else if (sEntropy == "random") {
+			std::uniform_int_distribution<uint32_t> distribution(0, 255);
+			for (uint32_t nIndex = 0; nIndex < nSize; nIndex++)
+				buffer.push_back((uint8_t)distribution(generator));
+		}
+		else
+			throw std::runtime_error("unknown benchmark entropy: " + sEntropy);
+
+		return buffer;
+	}
+
+	void registerMatJobBenchmarks(CToolpathBenchmarkRunner& runner)
+	{
+		auto pPoints = std::make_shared<std::vector<sToolpathPoint2D>>(createBenchmarkPoints(TOOLPATHBENCHMARK_POLYLINECOUNT * TOOLPATHBENCHMARK_POINTSPERPOLYLINE, TOOLPATHBENCHMARK_SEED));
+		auto pHatches = std::make_shared<std::vector<sToolpathHatch2D>>(createBenchmarkHatches(TOOLPATHBENCHMARK_HATCHBLOCKCOUNT * TOOLPATHBENCHMARK_HATCHESPERBLOCK, TOOLPATHBENCHMARK_SEED));
+
+		// Record encoding: one operation is one record, bytes are the encoded record bytes
+		runner.addBenchmark("matjob/binaryfile/uint32", TOOLPATHBENCHMARK_UINT32RECORDCOUNT, TOOLPATHBENCHMARK_UINT32RECORDCOUNT * 12, []() {
+			CMatJobBinaryFile binaryFile(1, "benchmark.bin");
+			for (uint32_t nIndex = 0; nIndex < TOOLPATHBENCHMARK_UINT32RECORDCOUNT; nIndex++)
+				binaryFile.writeUint32(MATJOB_GROUP_ZHEIGHT, nIndex);
+			CToolpathBenchmarkRunner::consume(binaryFile.getCurrentFileSize());
+		});
+
+		runner.addBenchmark("matjob/binaryfile/pointarray", TOOLPATHBENCHMARK_POLYLINECOUNT, TOOLPATHBENCHMARK_POLYLINECOUNT * (12 + 8 * TOOLPATHBENCHMARK_POINTSPERPOLYLINE), [pPoints]() {
+			CMatJobBinaryFile binaryFile(1, "benchmark.bin");
+			for (uint32_t nIndex = 0; nIndex < TOOLPATHBENCHMARK_POLYLINECOUNT; nIndex++)
+				binaryFile.writePointArray(MATJOB_GROUP_DATABLOCKPOINTS, &pPoints->at(nIndex * TOOLPATHBENCHMARK_POINTSPERPOLYLINE), TOOLPATHBENCHMARK_POINTSPERPOLYLINE);
+			CToolpathBenchmarkRunner::consume(binaryFile.getCurrentFileSize());
+		});
+
+		runner.addBenchmark("matjob/binaryfile/hatcharray", TOOLPATHBENCHMARK_HATCHBLOCKCOUNT, TOOLPATHBENCHMARK_HATCHBLOCKCOUNT * (8 + 16 * TOOLPATHBENCHMARK_HATCHESPERBLOCK), [pHatches]() {
+			CMatJobBinaryFile binaryFile(1, "benchmark.bin");
+			for (uint32_t nIndex = 0; nIndex < TOOLPATHBENCHMARK_HATCHBLOCKCOUNT; nIndex++)
+				binaryFile.writeHatchArray(MATJOB_GROUP_DATABLOCKPOINTS, &pHatches->at(nIndex * TOOLPATHBENCHMARK_HATCHESPERBLOCK), TOOLPATHBENCHMARK_HATCHESPERBLOCK);
+			CToolpathBenchmarkRunner::consume(binaryFile.getCurrentFileSize());
+		});
+
+		// Layer statistics: data block encoding plus mark/jump distance and bounds tracking, one operation is one vertex
+		runner.addBenchmark("matjob/layer/polylinestatistics", TOOLPATHBENCHMARK_POLYLINECOUNT * TOOLPATHBENCHMARK_POINTSPERPOLYLINE, 0, [pPoints]() {
+			CMatJobBinaryFile binaryFile(1, "benchmark.bin");
+			CMatJobPart part("benchmark", 1, "");
+			CMatJobLayer layer(0.03);
+			for (uint32_t nIndex = 0; nIndex < TOOLPATHBENCHMARK_POLYLINECOUNT; nIndex++)
+				layer.addPolylineDataBlock(&part, &binaryFile, 1, 1, &pPoints->at(nIndex * TOOLPATHBENCHMARK_POINTSPERPOLYLINE), TOOLPATHBENCHMARK_POINTSPERPOLYLINE, 1000.0, 5000.0);
+			CToolpathBenchmarkRunner::consume((uint64_t)layer.getTotalMarkDistance());
+		});
+
+		runner.addBenchmark("matjob/layer/hatchstatistics", TOOLPATHBENCHMARK_HATCHBLOCKCOUNT * TOOLPATHBENCHMARK_HATCHESPERBLOCK, 0, [pHatches]() {
+			CMatJobBinaryFile binaryFile(1, "benchmark.bin");
+			CMatJobPart part("benchmark", 1, "");
+			CMatJobLayer layer(0.03);
+			for (uint32_t nIndex = 0; nIndex < TOOLPATHBENCHMARK_HATCHBLOCKCOUNT; nIndex++)
+				layer.addHatchDataBlock(&part, &binaryFile, 1, 1, &pHatches->at(nIndex * TOOLPATHBENCHMARK_HATCHESPERBLOCK), TOOLPATHBENCHMARK_HATCHESPERBLOCK, 1000.0, 5000.0);
+			CToolpathBenchmarkRunner::consume((uint64_t)layer.getTotalMarkDistance());
+		});
+	}
+
+	static uint64_t writeBenchmarkXML()
+	{
+		auto pStream = std::make_shared<NMR::CExportStream_Memory>();
+		auto pXMLWriter = std::make_shared<NMR::CXmlWriter_Native>(pStream);
+
+		pXMLWriter->WriteStartDocument();
+		pXMLWriter->WriteStartElement(nullptr, "Layers", nullptr);
+		for (uint32_t nIndex = 0; nIndex < TOOLPATHBENCHMARK_XMLELEMENTCOUNT; nIndex++) {
+			pXMLWriter->WriteStartElement(nullptr, "Layer", nullptr);
+			pXMLWriter->WriteAttributeString(nullptr, "Z", nullptr, "12.3400");
+			pXMLWriter->WriteAttributeString(nullptr, "LayerScanTime", nullptr, "1.2345");
+			pXMLWriter->WriteAttributeString(nullptr, "TotalMarkDistance", nullptr, "1234.5678");
+			pXMLWriter->WriteAttributeString(nullptr, "TotalJumpDistance", nullptr, "234.5678");
+			pXMLWriter->WriteEndElement();
+		}
+		pXMLWriter->WriteFullEndElement();
+		pXMLWriter->WriteEndDocument();
+
+		return pStream->getDataSize();
+	}
+
+	void registerXMLBenchmarks(CToolpathBenchmarkRunner& runner)
+	{
+		// One operation is one element with four attributes
+		uint64_t nBytesPerCall = writeBenchmarkXML();
+		runner.addBenchmark("xml/elements", TOOLPATHBENCHMARK_XMLELEMENTCOUNT, nBytesPerCall, []() {
+			CToolpathBenchmarkRunner::consume(writeBenchmarkXML());
+		});
+	}
+
+	void registerCompressionBenchmarks(CToolpathBenchmarkRunner& runner)
+	{
+		std::vector<std::string> entropies = { "zeros", "text", "floats", "random" };
+
+		for (auto& sEntropy : entropies) {
+			auto pBuffer = std::make_shared<std::vector<uint8_t>>(createCompressionBuffer(sEntropy, TOOLPATHBENCHMARK_COMPRESSIONBUFFERSIZE));
+			uint64_t nBufferSize = pBuffer->size();
+
+			// Streaming path through CExportStream_ZIP, as used for directly written entries
+			runner.addBenchmark("zip/stream/" + sEntropy, 1, nBufferSize, [pBuffer]() {
+				auto pStream = std::make_shared<NMR::CExportStream_Memory>();
+				{
+					NMR::CPortableZIPWriter zipWriter(pStream, true);
+					auto pEntryStream = zipWriter.createEntry("benchmark.bin", 0);
+					pEntryStream->writeBuffer(pBuffer->data(), pBuffer->size());
+					zipWriter.closeEntry();
+				}
+				CToolpathBenchmarkRunner::consume(pStream->getDataSize());
+			});
+
+			// Detached compression, as used by the MatJob worker pool
+			runner.addBenchmark("zip/deflate/" + sEntropy, 1, nBufferSize, [pBuffer]() {
+				NMR::CPortableZIPDeflatedData deflatedData;
+				deflatedData.deflateBuffer(pBuffer->data(), pBuffer->size());
+				CToolpathBenchmarkRunner::consume(deflatedData.getCompressedSize());
+			});
+		}
+
+		auto pCRCBuffer = std::make_shared<std::vector<uint8_t>>(createCompressionBuffer("random", TOOLPATHBENCHMARK_COMPRESSIONBUFFERSIZE));
+		runner.addBenchmark("crc32", 1, pCRCBuffer->size(), [pCRCBuffer]() {
+			uLong nCRC32 = crc32(0L, Z_NULL, 0);
+			nCRC32 = crc32(nCRC32, (const Bytef*)pCRCBuffer->data(), (uInt)pCRCBuffer->size());
+			CToolpathBenchmarkRunner::consume(nCRC32);
+		});
+	}
+
+	static uint64_t writeBenchmarkCLIPlus(const std::vector<sToolpathPoint2D>& points)
+	{
+		// Same formatting as CToolpathExporter_CLIPlus::processLayer
+		std::ostringstream stream;
+		stream << "$$POLYLINE/1,0," << points.size();
+		for (auto& point : points) {
+			stream << "," << std::fixed << std::setprecision(6)
+				<< point.m_Coordinates[0] << "," << point.m_Coordinates[1];
+		}
+		stream << "\n";
+
+		return (uint64_t)stream.tellp();
+	}
+
+	void registerCLIPlusBenchmarks(CToolpathBenchmarkRunner& runner)
+	{
+		auto pPoints = std::make_shared<std::vector<sToolpathPoint2D>>(createBenchmarkPoints(TOOLPATHBENCHMARK_CLIPLUSPOINTCOUNT, TOOLPATHBENCHMARK_SEED));
+
+		// One operation is one formatted coordinate
+		uint64_t nBytesPerCall = writeBenchmarkCLIPlus(*pPoints);
+		runner.addBenchmark("cliplus/coordinates", TOOLPATHBENCHMARK_CLIPLUSPOINTCOUNT * 2, nBytesPerCall, [pPoints]() {
+			CToolpathBenchmarkRunner::consume(writeBenchmarkCLIPlus(*pPoints));
+		});
+	}
+
+} // namespace Toolpath
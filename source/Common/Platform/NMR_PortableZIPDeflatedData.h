@@ -0,0 +1,70 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_PortableZIPDeflatedData.h defines the raw deflate data of a ZIP entry, that has been
+compressed independently of a ZIP writer. This allows several entries to be compressed
+concurrently and appended to a CPortableZIPWriter afterwards.
+
+--*/
+
+#ifndef __NMR_PORTABLEZIPDEFLATEDDATA
+#define __NMR_PORTABLEZIPDEFLATEDDATA
+
+#include "Common/NMR_Types.h"
+#include "Common/NMR_Local.h"
+
+#include <vector>
+
+namespace NMR {
+
+	class CPortableZIPDeflatedData {
+	private:
+		std::vector<nfByte> m_CompressedBuffer;
+		nfUint32 m_nCRC32;
+		nfUint64 m_nUncompressedSize;
+
+	public:
+		CPortableZIPDeflatedData();
+
+		// Compresses a complete entry. May be called from any thread.
+		void deflateBuffer(_In_ const void * pBuffer, _In_ nfUint64 cbUncompressedBytes);
+
+		// Takes over a raw deflate stream that has been compressed earlier, e.g. by another process.
+		void setDeflatedData(_In_ const void * pCompressedBuffer, _In_ nfUint64 cbCompressedBytes, _In_ nfUint64 cbUncompressedBytes, _In_ nfUint32 nCRC32);
+
+		const nfByte * getCompressedData();
+		nfUint64 getCompressedSize();
+		nfUint64 getUncompressedSize();
+		nfUint32 getCRC32();
+	};
+
+	typedef std::shared_ptr <CPortableZIPDeflatedData> PPortableZIPDeflatedData;
+
+}
+
+#endif // __NMR_PORTABLEZIPDEFLATEDDATA
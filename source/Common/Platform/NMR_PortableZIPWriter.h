@@ -36,6 +36,7 @@ NMR_PortableZIPWriter.h defines a portable and fast writer of ZIP files
 #include "Common/Platform/NMR_ExportStream.h"
 #include "Common/Platform/NMR_PortableZIPWriterTypes.h"
 #include "Common/Platform/NMR_PortableZIPWriterEntry.h"
+#include "Common/Platform/NMR_PortableZIPDeflatedData.h"
 #include "Common/NMR_Types.h"
 
 #include <string>
@@ -57,6 +58,8 @@ namespace NMR {
 
 		std::list<PPortableZIPWriterEntry> m_Entries;
 		PExportStream m_pCurrentStream;
+
+		PPortableZIPWriterEntry writeLocalFileHeader(_In_ const std::string sName, _In_ nfUint32 nCRC32, _In_ nfUint64 nCompressedSize, _In_ nfUint64 nUncompressedSize);
 	public:
 		CPortableZIPWriter() = delete;
 		CPortableZIPWriter(_In_ PExportStream pExportStream, _In_ nfBool bWriteZIP64);
@@ -65,6 +68,10 @@ namespace NMR {
 		PExportStream createEntry(_In_ const std::string sName, _In_ nfTimeStamp nUnixTimeStamp);
 		void closeEntry();
 
+		// Appends an entry that has been compressed beforehand, e.g. on a worker thread.
+		// Entries are stored in the order of the calls.
+		void writeDeflatedEntry(_In_ const std::string sName, _In_ CPortableZIPDeflatedData * pDeflatedData);
+
 		void writeDeflatedBuffer(_In_ nfUint32 nEntryKey, _In_ const void * pBuffer, _In_ nfUint32 cbCompressedBytes);
 		void calculateChecksum(_In_ nfUint32 nEntryKey, _In_ const void * pBuffer, _In_ nfUint32 cbUncompressedBytes);
 		nfUint64 getCurrentSize(_In_ nfUint32 nEntryKey);
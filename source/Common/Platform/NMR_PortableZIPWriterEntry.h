@@ -64,6 +64,8 @@ namespace NMR {
 		nfUint64 getDataPosition();
 		void increaseCompressedSize(_In_ nfUint32 nCompressedSize);
 		void increaseUncompressedSize(_In_ nfUint32 nUncompressedSize);
+		void setSizes(_In_ nfUint64 nCompressedSize, _In_ nfUint64 nUncompressedSize);
+		void setCRC32(_In_ nfUint32 nCRC32);
 		void calculateChecksum(_In_ const void * pBuffer, _In_ nfUint32 cbCount);
 
 	};
@@ -59,6 +59,10 @@ namespace NMR {
 
 		std::array<nfChar, NATIVEXMLENCODINGBUFFERSIZE> m_FixedEncodingBuffer;
 
+		// Write-combining buffer, so that small fragments do not hit the export stream one by one
+		std::array<nfByte, NATIVEXMLWRITEBUFFERSIZE> m_WriteBuffer;
+		nfUint32 m_nWriteBufferPosition;
+
 		std::map<std::string, std::string> m_sNameSpaces;
 
 		nfBool m_bElementIsOpen;
@@ -71,6 +75,7 @@ namespace NMR {
 
 		void writeSpaces(_In_ nfUint32 cbCount);
 		void writeData(_In_ const void * pData, _In_ nfUint32 cbLength);
+		void flushWriteBuffer();
 		void writeUTF8(_In_ const nfChar * pszString, _In_ nfBool bNewLine);
 		void writeUTF16(_In_ const nfWChar * pszString, _In_ nfBool bNewLine);
 
@@ -81,6 +86,7 @@ namespace NMR {
 
 	public:
 		CXmlWriter_Native(_In_ PExportStream pExportStream);
+		virtual ~CXmlWriter_Native();
 
 		virtual void WriteStartDocument();
 		virtual void WriteEndDocument();
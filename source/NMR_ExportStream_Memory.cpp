@@ -0,0 +1,120 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_ExportStream_Memory.cpp implements the CExportStream_Memory Class.
+This is an export stream class that writes into a growing memory buffer.
+
+--*/
+
+#include "Common/Platform/NMR_ExportStream_Memory.h"
+#include "Common/NMR_Exception.h"
+
+#include <string.h>
+
+namespace NMR {
+
+	CExportStream_Memory::CExportStream_Memory()
+		: m_nPosition(0)
+	{
+	}
+
+	CExportStream_Memory::~CExportStream_Memory()
+	{
+	}
+
+	nfBool CExportStream_Memory::seekPosition(_In_ nfUint64 position, _In_ nfBool bHasToSucceed)
+	{
+		if (position > m_Buffer.size()) {
+			if (bHasToSucceed)
+				throw CNMRException(NMR_ERROR_COULDNOTSEEKSTREAM);
+			return false;
+		}
+
+		m_nPosition = position;
+		return true;
+	}
+
+	nfBool CExportStream_Memory::seekForward(_In_ nfUint64 bytes, _In_ nfBool bHasToSucceed)
+	{
+		return seekPosition(m_nPosition + bytes, bHasToSucceed);
+	}
+
+	nfBool CExportStream_Memory::seekFromEnd(_In_ nfUint64 bytes, _In_ nfBool bHasToSucceed)
+	{
+		if (bytes > m_Buffer.size()) {
+			if (bHasToSucceed)
+				throw CNMRException(NMR_ERROR_COULDNOTSEEKSTREAM);
+			return false;
+		}
+
+		return seekPosition(m_Buffer.size() - bytes, bHasToSucceed);
+	}
+
+	nfUint64 CExportStream_Memory::getPosition()
+	{
+		return m_nPosition;
+	}
+
+	nfUint64 CExportStream_Memory::writeBuffer(_In_ const void * pBuffer, _In_ nfUint64 cbTotalBytesToWrite)
+	{
+		if (pBuffer == nullptr)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		if (cbTotalBytesToWrite > 0) {
+			nfUint64 nEndPosition = m_nPosition + cbTotalBytesToWrite;
+			if (nEndPosition > m_Buffer.size())
+				m_Buffer.resize((size_t)nEndPosition);
+
+			memcpy(&m_Buffer[(size_t)m_nPosition], pBuffer, (size_t)cbTotalBytesToWrite);
+			m_nPosition = nEndPosition;
+		}
+
+		return cbTotalBytesToWrite;
+	}
+
+	const nfByte * CExportStream_Memory::getData()
+	{
+		if (m_Buffer.empty())
+			return nullptr;
+
+		return m_Buffer.data();
+	}
+
+	nfUint64 CExportStream_Memory::getDataSize()
+	{
+		return m_Buffer.size();
+	}
+
+	void CExportStream_Memory::releaseData()
+	{
+		std::vector<nfByte> emptyBuffer;
+		m_Buffer.swap(emptyBuffer);
+		m_nPosition = 0;
+	}
+
+}
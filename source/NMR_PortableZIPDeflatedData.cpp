@@ -0,0 +1,149 @@
+/*++
+
+Copyright (C) 2019 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Abstract:
+
+NMR_PortableZIPDeflatedData.cpp implements the raw deflate data of a ZIP entry, that has been
+compressed independently of a ZIP writer.
+
+--*/
+
+#include "Common/Platform/NMR_PortableZIPDeflatedData.h"
+#include "Common/Platform/NMR_ExportStream_ZIP.h"
+#include "Common/NMR_Exception.h"
+#include "zlib.h"
+
+namespace NMR {
+
+	CPortableZIPDeflatedData::CPortableZIPDeflatedData()
+		: m_nCRC32(0), m_nUncompressedSize(0)
+	{
+	}
+
+	void CPortableZIPDeflatedData::deflateBuffer(_In_ const void * pBuffer, _In_ nfUint64 cbUncompressedBytes)
+	{
+		if ((pBuffer == nullptr) && (cbUncompressedBytes > 0))
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		m_CompressedBuffer.clear();
+		m_nCRC32 = 0;
+		m_nUncompressedSize = cbUncompressedBytes;
+
+		z_stream zStream;
+		zStream.next_in = nullptr;
+		zStream.avail_in = 0;
+		zStream.total_in = 0;
+		zStream.msg = nullptr;
+		zStream.state = nullptr;
+		zStream.zalloc = nullptr;
+		zStream.zfree = nullptr;
+		zStream.opaque = nullptr;
+		zStream.data_type = 0;
+		zStream.adler = 0;
+		zStream.reserved = 0;
+
+		// Same settings as CExportStream_ZIP, so that both paths produce identical archives
+		nfInt32 nResult = deflateInit2(&zStream, Z_BEST_SPEED, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY);
+		if (nResult < 0)
+			throw CNMRException(NMR_ERROR_DEFLATEINITFAILED);
+
+		try {
+			std::vector<nfByte> OutBuffer;
+			OutBuffer.resize(ZIPEXPORTBUFFERSIZE);
+
+			const nfByte * pByte = (const nfByte *)pBuffer;
+			nfUint64 cbRemaining = cbUncompressedBytes;
+
+			nfBool bFinished = false;
+			while (!bFinished) {
+				if ((zStream.avail_in == 0) && (cbRemaining > 0)) {
+					nfUint32 cbChunk = (cbRemaining > ZIPEXPORTWRITECHUNKSIZE) ? ZIPEXPORTWRITECHUNKSIZE : (nfUint32)cbRemaining;
+					m_nCRC32 = crc32(m_nCRC32, (const Bytef *)pByte, cbChunk);
+
+					zStream.next_in = (Bytef *)pByte;
+					zStream.avail_in = cbChunk;
+					pByte += cbChunk;
+					cbRemaining -= cbChunk;
+				}
+
+				nfInt32 nFlush = ((cbRemaining == 0) && (zStream.avail_in == 0)) ? Z_FINISH : Z_NO_FLUSH;
+
+				zStream.next_out = &OutBuffer[0];
+				zStream.avail_out = ZIPEXPORTBUFFERSIZE;
+
+				nResult = deflate(&zStream, nFlush);
+				if (nResult < 0)
+					throw CNMRException(NMR_ERROR_COULDNOTDEFLATE);
+
+				nfUint32 cbProduced = ZIPEXPORTBUFFERSIZE - zStream.avail_out;
+				m_CompressedBuffer.insert(m_CompressedBuffer.end(), OutBuffer.begin(), OutBuffer.begin() + cbProduced);
+
+				bFinished = (nResult == Z_STREAM_END);
+			}
+		}
+		catch (...) {
+			deflateEnd(&zStream);
+			throw;
+		}
+
+		deflateEnd(&zStream);
+	}
+
+	void CPortableZIPDeflatedData::setDeflatedData(_In_ const void * pCompressedBuffer, _In_ nfUint64 cbCompressedBytes, _In_ nfUint64 cbUncompressedBytes, _In_ nfUint32 nCRC32)
+	{
+		if ((pCompressedBuffer == nullptr) || (cbCompressedBytes == 0))
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		const nfByte * pByte = (const nfByte *)pCompressedBuffer;
+		m_CompressedBuffer.assign(pByte, pByte + cbCompressedBytes);
+		m_nUncompressedSize = cbUncompressedBytes;
+		m_nCRC32 = nCRC32;
+	}
+
+	const nfByte * CPortableZIPDeflatedData::getCompressedData()
+	{
+		if (m_CompressedBuffer.empty())
+			return nullptr;
+
+		return m_CompressedBuffer.data();
+	}
+
+	nfUint64 CPortableZIPDeflatedData::getCompressedSize()
+	{
+		return m_CompressedBuffer.size();
+	}
+
+	nfUint64 CPortableZIPDeflatedData::getUncompressedSize()
+	{
+		return m_nUncompressedSize;
+	}
+
+	nfUint32 CPortableZIPDeflatedData::getCRC32()
+	{
+		return m_nCRC32;
+	}
+
+}
@@ -82,6 +82,16 @@ namespace NMR {
 		if (m_nNextEntryKey >= ZIPFILEMAXENTRIES)
 			throw CNMRException(NMR_ERROR_ZIPENTRYOVERFLOW);
 
+		// CRC and sizes are patched in closeEntry
+		m_pCurrentEntry = writeLocalFileHeader(sName, 0, 0, 0);
+
+		// Return new ZIP Entry stream
+		m_pCurrentStream = std::make_shared<CExportStream_ZIP>(this, m_nCurrentEntryKey);
+		return m_pCurrentStream;
+	}
+
+	PPortableZIPWriterEntry CPortableZIPWriter::writeLocalFileHeader(_In_ const std::string sName, _In_ nfUint32 nCRC32, _In_ nfUint64 nCompressedSize, _In_ nfUint64 nUncompressedSize)
+	{
 		// Convert Name to UTF8
 		std::string sFilteredName = fnRemoveLeadingPathDelimiter(sName);
 		std::string sUTF8Name = sFilteredName;
@@ -102,7 +112,7 @@ namespace NMR {
 		LocalHeader.m_nCompressionMethod = ZIPFILECOMPRESSION_DEFLATED;
 		LocalHeader.m_nLastModTime = nLastModTime;
 		LocalHeader.m_nLastModDate = nLastModDate;
-		LocalHeader.m_nCRC32 = 0;
+		LocalHeader.m_nCRC32 = nCRC32;
 		LocalHeader.m_nCompressedSize = 0;
 		LocalHeader.m_nUnCompressedSize = 0;
 		LocalHeader.m_nFileNameLength = nNameLength;
@@ -110,13 +120,23 @@ namespace NMR {
 
 		if (m_bWriteZIP64) {
 			LocalHeader.m_nExtraFieldLength += sizeof(ZIP64EXTRAINFORMATIONFIELD);
+			if ((nCompressedSize > 0) || (nUncompressedSize > 0)) {
+				LocalHeader.m_nCompressedSize = 0xFFFFFFFF;
+				LocalHeader.m_nUnCompressedSize = 0xFFFFFFFF;
+			}
+		}
+		else {
+			if ((nCompressedSize > ZIPFILEMAXIMUMSIZENON64) || (nUncompressedSize > ZIPFILEMAXIMUMSIZENON64))
+				throw CNMRException(NMR_ERROR_ZIPENTRYNON64_TOOLARGE);
+			LocalHeader.m_nCompressedSize = (nfUint32)nCompressedSize;
+			LocalHeader.m_nUnCompressedSize = (nfUint32)nUncompressedSize;
 		}
 
 		ZIP64EXTRAINFORMATIONFIELD zip64ExtraInformation;
 		zip64ExtraInformation.m_nTag = ZIPFILEDATAZIP64EXTENDEDINFORMATIONEXTRAFIELD;
 		zip64ExtraInformation.m_nFieldSize = sizeof(ZIP64EXTRAINFORMATIONFIELD) - 4;
-		zip64ExtraInformation.m_nCompressedSize = 0;
-		zip64ExtraInformation.m_nUncompressedSize = 0;
+		zip64ExtraInformation.m_nCompressedSize = nCompressedSize;
+		zip64ExtraInformation.m_nUncompressedSize = nUncompressedSize;
 
 		// Write data to ZIP stream
 		nfUint64 nFilePosition = m_pExportStream->getPosition();
@@ -139,12 +159,36 @@ namespace NMR {
 		nfUint64 nDataPosition = m_pExportStream->getPosition();
 
 		// create list entry
-		m_pCurrentEntry = std::make_shared<CPortableZIPWriterEntry>(sUTF8Name, nLastModTime, nLastModDate, nFilePosition, nExtInfoPosition, nDataPosition);
-		m_Entries.push_back(m_pCurrentEntry);
+		PPortableZIPWriterEntry pEntry = std::make_shared<CPortableZIPWriterEntry>(sUTF8Name, nLastModTime, nLastModDate, nFilePosition, nExtInfoPosition, nDataPosition);
+		m_Entries.push_back(pEntry);
 
-		// Return new ZIP Entry stream
-		m_pCurrentStream = std::make_shared<CExportStream_ZIP>(this, m_nCurrentEntryKey);
-		return m_pCurrentStream;
+		return pEntry;
+	}
+
+	void CPortableZIPWriter::writeDeflatedEntry(_In_ const std::string sName, _In_ CPortableZIPDeflatedData * pDeflatedData)
+	{
+		if (m_bIsFinished)
+			throw CNMRException(NMR_ERROR_ZIPALREADYFINISHED);
+		if (pDeflatedData == nullptr)
+			throw CNMRException(NMR_ERROR_INVALIDPARAM);
+
+		// Finish streamed entry, if there is one
+		closeEntry();
+
+		m_nNextEntryKey++;
+		if (m_nNextEntryKey >= ZIPFILEMAXENTRIES)
+			throw CNMRException(NMR_ERROR_ZIPENTRYOVERFLOW);
+
+		nfUint64 nCompressedSize = pDeflatedData->getCompressedSize();
+		nfUint64 nUncompressedSize = pDeflatedData->getUncompressedSize();
+
+		// CRC and sizes are known upfront, so no seeking back is necessary
+		PPortableZIPWriterEntry pEntry = writeLocalFileHeader(sName, pDeflatedData->getCRC32(), nCompressedSize, nUncompressedSize);
+		pEntry->setCRC32(pDeflatedData->getCRC32());
+		pEntry->setSizes(nCompressedSize, nUncompressedSize);
+
+		if (nCompressedSize > 0)
+			m_pExportStream->writeBuffer(pDeflatedData->getCompressedData(), nCompressedSize);
 	}
 
 	void CPortableZIPWriter::closeEntry()
@@ -106,6 +106,17 @@ namespace NMR {
 		m_nUncompressedSize += nUncompressedSize;
 	}
 
+	void CPortableZIPWriterEntry::setSizes(_In_ nfUint64 nCompressedSize, _In_ nfUint64 nUncompressedSize)
+	{
+		m_nCompressedSize = nCompressedSize;
+		m_nUncompressedSize = nUncompressedSize;
+	}
+
+	void CPortableZIPWriterEntry::setCRC32(_In_ nfUint32 nCRC32)
+	{
+		m_nCRC32 = nCRC32;
+	}
+
 	void CPortableZIPWriterEntry::calculateChecksum(_In_ const void * pBuffer, _In_ nfUint32 cbCount)
 	{
 		m_nCRC32 = crc32(m_nCRC32, (Bytef*) pBuffer, cbCount);
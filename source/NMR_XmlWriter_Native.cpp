@@ -60,6 +60,18 @@ namespace NMR {
 
 		m_SpacingBuffer.fill(NATIVEXMLSPACING);
 		m_bElementIsOpen = false;
+
+		m_nWriteBufferPosition = 0;
+	}
+
+	CXmlWriter_Native::~CXmlWriter_Native()
+	{
+		// Destructors must not throw. Callers that need to see write errors call Flush or WriteEndDocument.
+		try {
+			flushWriteBuffer();
+		}
+		catch (...) {
+		}
 	}
 
 	void CXmlWriter_Native::WriteStartDocument()
@@ -69,10 +81,12 @@ namespace NMR {
 
 	void CXmlWriter_Native::WriteEndDocument()
 	{
+		Flush();
 	}
 
 	void CXmlWriter_Native::Flush()
 	{
+		flushWriteBuffer();
 	}
 
 	void CXmlWriter_Native::WriteAttributeString(_In_opt_ LPCSTR pszPrefix, _In_opt_ LPCSTR pszLocalName, _In_opt_ LPCSTR pszNamespaceUri, _In_opt_ LPCSTR pszValue)
@@ -210,7 +224,28 @@ namespace NMR {
 	{
 		if (pData == nullptr)
 			throw CNMRException(NMR_ERROR_INVALIDPARAM);
-		m_pExportStream->writeBuffer(pData, cbLength);
+
+		if (cbLength > (NATIVEXMLWRITEBUFFERSIZE - m_nWriteBufferPosition))
+			flushWriteBuffer();
+
+		if (cbLength >= NATIVEXMLWRITEBUFFERSIZE) {
+			// Large chunks bypass the buffer
+			m_pExportStream->writeBuffer(pData, cbLength);
+		}
+		else {
+			memcpy(&m_WriteBuffer[m_nWriteBufferPosition], pData, cbLength);
+			m_nWriteBufferPosition += cbLength;
+		}
+	}
+
+	void CXmlWriter_Native::flushWriteBuffer()
+	{
+		if (m_nWriteBufferPosition > 0) {
+			// Reset first, so that a failing stream does not get the same data again from the destructor
+			nfUint32 cbBytesToWrite = m_nWriteBufferPosition;
+			m_nWriteBufferPosition = 0;
+			m_pExportStream->writeBuffer(&m_WriteBuffer[0], cbBytesToWrite);
+		}
 	}
 
 	void CXmlWriter_Native::writeUTF8(_In_ const nfChar * pszString, _In_ nfBool bNewLine)
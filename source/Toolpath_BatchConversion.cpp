@@ -0,0 +1,228 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#include "Toolpath_BatchConversion.hpp"
+#include "Toolpath_Conversion.hpp"
+#include "Toolpath_JSONReader.hpp"
+#include "Toolpath_ThreadPool.hpp"
+#include "Toolpath_Statistics.hpp"
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <future>
+#include <stdexcept>
+
+namespace Toolpath {
+
+	static std::mutex s_BatchLogMutex;
+
+	CToolpathBatchConversion::CToolpathBatchConversion(Lib3MF::PWrapper pWrapper)
+		: m_pWrapper(pWrapper),
+		m_nWorkerCount(1),
+		m_nThreadsPerJob(1),
+		m_dWallTimeInSeconds(0.0)
+	{
+		if (pWrapper.get() == nullptr)
+			throw std::runtime_error("Invalid lib3mf wrapper");
+	}
+
+	void CToolpathBatchConversion::setWorkerCount(uint32_t nWorkerCount)
+	{
+		m_nWorkerCount = CToolpathThreadPool::resolveThreadCount(nWorkerCount);
+	}
+
+	void CToolpathBatchConversion::setThreadsPerJob(uint32_t nThreadsPerJob)
+	{
+		m_nThreadsPerJob = CToolpathThreadPool::resolveThreadCount(nThreadsPerJob);
+	}
+
+	void CToolpathBatchConversion::addJob(const std::string& sInputFileName, const std::string& sOutputFileName, const std::string& sOutputFormat)
+	{
+		if (sInputFileName.empty() || sOutputFileName.empty())
+			throw std::runtime_error("batch job needs an input and an output file");
+
+		// Unknown formats are rejected before any job is started
+		CToolpathConversion::createExporter(sOutputFormat, 1);
+
+		sToolpathBatchJob job;
+		job.m_sInputFileName = sInputFileName;
+		job.m_sOutputFileName = sOutputFileName;
+		job.m_sOutputFormat = sOutputFormat;
+		m_Jobs.push_back(job);
+	}
+
+	void CToolpathBatchConversion::loadManifest(const std::string& sManifestFileName)
+	{
+		auto pManifest = CToolpathJSONReader::parseFile(sManifestFileName);
+
+		auto& jobs = pManifest->getMember("jobs");
+		for (uint32_t nIndex = 0; nIndex < jobs.getElementCount(); nIndex++) {
+			auto& job = jobs.getElement(nIndex);
+
+			std::string sOutputFormat = "matjob";
+			if (job.hasMember("format"))
+				sOutputFormat = job.getString("format");
+
+			addJob(job.getString("input"), job.getString("output"), sOutputFormat);
+		}
+	}
+
+	uint32_t CToolpathBatchConversion::getJobCount()
+	{
+		return (uint32_t)m_Jobs.size();
+	}
+
+	void CToolpathBatchConversion::runJob(size_t nJobIndex)
+	{
+		auto& job = m_Jobs[nJobIndex];
+		auto& result = m_Results[nJobIndex];
+
+		uint64_t nStartTime = CToolpathStatistics::getWallTimeInNanoseconds();
+
+		try {
+			CToolpathConversion conversion(m_pWrapper);
+			conversion.setOutputFormat(job.m_sOutputFormat);
+			conversion.setThreadCount(m_nThreadsPerJob);
+			conversion.convert(job.m_sInputFileName, job.m_sOutputFileName);
+
+			result.m_nLayerCount = conversion.getConvertedLayerCount();
+
+			std::ifstream outputStream(job.m_sOutputFileName, std::ios::in | std::ios::binary | std::ios::ate);
+			if (outputStream.is_open())
+				result.m_nOutputSize = (uint64_t)outputStream.tellg();
+
+			result.m_bSucceeded = true;
+		}
+		catch (std::exception& E) {
+			result.m_sErrorMessage = E.what();
+		}
+		catch (...) {
+			result.m_sErrorMessage = "unknown error";
+		}
+
+		result.m_dWallTimeInSeconds = (CToolpathStatistics::getWallTimeInNanoseconds() - nStartTime) * 1.0e-9;
+
+		std::lock_guard<std::mutex> lockGuard(s_BatchLogMutex);
+		std::cout << "[" << (nJobIndex + 1) << "/" << m_Jobs.size() << "] " << (result.m_bSucceeded ? "done   " : "FAILED ")
+			<< job.m_sInputFileName << " -> " << job.m_sOutputFileName
+			<< " (" << std::fixed << std::setprecision(2) << result.m_dWallTimeInSeconds << "s)";
+		if (!result.m_bSucceeded)
+			std::cout << ": " << result.m_sErrorMessage;
+		std::cout << std::endl;
+	}
+
+	uint32_t CToolpathBatchConversion::run()
+	{
+		m_Results.clear();
+		for (size_t nJobIndex = 0; nJobIndex < m_Jobs.size(); nJobIndex++) {
+			sToolpathBatchJobResult result;
+			result.m_bSucceeded = false;
+			result.m_dWallTimeInSeconds = 0.0;
+			result.m_nLayerCount = 0;
+			result.m_nOutputSize = 0;
+			m_Results.push_back(result);
+		}
+
+		uint64_t nStartTime = CToolpathStatistics::getWallTimeInNanoseconds();
+
+		{
+			CToolpathThreadPool workerPool(m_nWorkerCount);
+
+			std::vector<std::future<void>> jobFutures;
+			for (size_t nJobIndex = 0; nJobIndex < m_Jobs.size(); nJobIndex++)
+				jobFutures.push_back(workerPool.submit([this, nJobIndex]() { runJob(nJobIndex); }));
+
+			for (auto& jobFuture : jobFutures)
+				jobFuture.get();
+		}
+
+		m_dWallTimeInSeconds = (CToolpathStatistics::getWallTimeInNanoseconds() - nStartTime) * 1.0e-9;
+
+		uint32_t nFailedCount = 0;
+		for (auto& result : m_Results) {
+			if (!result.m_bSucceeded)
+				nFailedCount++;
+		}
+
+		return nFailedCount;
+	}
+
+	void CToolpathBatchConversion::writeToJSON(CToolpathJSONWriter& jsonWriter)
+	{
+		uint32_t nFailedCount = 0;
+		for (auto& result : m_Results) {
+			if (!result.m_bSucceeded)
+				nFailedCount++;
+		}
+
+		jsonWriter.beginObject();
+		jsonWriter.writeUint64("workers", m_nWorkerCount);
+		jsonWriter.writeUint64("threadsPerJob", m_nThreadsPerJob);
+		jsonWriter.writeUint64("jobCount", m_Results.size());
+		jsonWriter.writeUint64("failedCount", nFailedCount);
+		jsonWriter.writeDouble("wallTimeInSeconds", m_dWallTimeInSeconds);
+
+		jsonWriter.beginArray("jobs");
+		for (size_t nJobIndex = 0; nJobIndex < m_Results.size(); nJobIndex++) {
+			auto& job = m_Jobs[nJobIndex];
+			auto& result = m_Results[nJobIndex];
+
+			jsonWriter.beginObject();
+			jsonWriter.writeString("input", job.m_sInputFileName);
+			jsonWriter.writeString("output", job.m_sOutputFileName);
+			jsonWriter.writeString("format", job.m_sOutputFormat);
+			jsonWriter.writeString("status", result.m_bSucceeded ? "succeeded" : "failed");
+			if (!result.m_bSucceeded)
+				jsonWriter.writeString("error", result.m_sErrorMessage);
+			jsonWriter.writeDouble("wallTimeInSeconds", result.m_dWallTimeInSeconds);
+			jsonWriter.writeUint64("layers", result.m_nLayerCount);
+			jsonWriter.writeUint64("outputSize", result.m_nOutputSize);
+			jsonWriter.endObject();
+		}
+		jsonWriter.endArray();
+
+		jsonWriter.endObject();
+	}
+
+	void CToolpathBatchConversion::writeToFile(const std::string& sFileName)
+	{
+		std::ofstream stream(sFileName, std::ios::out | std::ios::trunc);
+		if (!stream.is_open())
+			throw std::runtime_error("Failed to open batch summary file: " + sFileName);
+
+		CToolpathJSONWriter jsonWriter(stream);
+		writeToJSON(jsonWriter);
+
+		if (!stream.good())
+			throw std::runtime_error("Failed to write batch summary file: " + sFileName);
+	}
+
+} // namespace Toolpath
@@ -0,0 +1,105 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#ifndef __TOOLPATH_BATCHCONVERSION
+#define __TOOLPATH_BATCHCONVERSION
+
+#include <string>
+#include <vector>
+#include <memory>
+
+#include "lib3mf_dynamic.hpp"
+
+#include "Toolpath_JSONWriter.hpp"
+
+namespace Toolpath {
+
+	typedef struct _sToolpathBatchJob {
+		std::string m_sInputFileName;
+		std::string m_sOutputFileName;
+		std::string m_sOutputFormat;
+	} sToolpathBatchJob;
+
+	typedef struct _sToolpathBatchJobResult {
+		bool m_bSucceeded;
+		std::string m_sErrorMessage;
+		double m_dWallTimeInSeconds;
+		uint32_t m_nLayerCount;
+		uint64_t m_nOutputSize;
+	} sToolpathBatchJobResult;
+
+	/**
+	 * Converts a list of files on a bounded pool of workers, sharing one loaded lib3mf library.
+	 * Every job reads into its own model. A failing job is recorded and does not stop the others.
+	 */
+	class CToolpathBatchConversion {
+	private:
+		Lib3MF::PWrapper m_pWrapper;
+
+		uint32_t m_nWorkerCount;
+		uint32_t m_nThreadsPerJob;
+
+		std::vector<sToolpathBatchJob> m_Jobs;
+		std::vector<sToolpathBatchJobResult> m_Results;
+		double m_dWallTimeInSeconds;
+
+		void runJob(size_t nJobIndex);
+
+	public:
+		CToolpathBatchConversion(Lib3MF::PWrapper pWrapper);
+		virtual ~CToolpathBatchConversion() = default;
+
+		// Number of files converted in parallel, 0 selects the hardware concurrency
+		void setWorkerCount(uint32_t nWorkerCount);
+		// Exporter threads of each job
+		void setThreadsPerJob(uint32_t nThreadsPerJob);
+
+		void addJob(const std::string& sInputFileName, const std::string& sOutputFileName, const std::string& sOutputFormat);
+
+		/**
+		 * Reads jobs from a manifest of the form
+		 * { "jobs": [ { "input": "a.3mf", "output": "a.zip", "format": "matjob" }, ... ] }
+		 * The format is optional and defaults to matjob.
+		 */
+		void loadManifest(const std::string& sManifestFileName);
+
+		uint32_t getJobCount();
+
+		// Runs all jobs and returns the number of failed jobs
+		uint32_t run();
+
+		void writeToJSON(CToolpathJSONWriter& jsonWriter);
+		void writeToFile(const std::string& sFileName);
+	};
+
+	typedef std::shared_ptr<CToolpathBatchConversion> PToolpathBatchConversion;
+
+} // namespace Toolpath
+
+#endif // __TOOLPATH_BATCHCONVERSION
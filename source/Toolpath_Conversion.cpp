@@ -0,0 +1,359 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#include "Toolpath_Conversion.hpp"
+#include "Toolpath_Exporter_Matjob.hpp"
+#include "Toolpath_Exporter_CLIPlus.hpp"
+#include "Toolpath_Exporter_Composite.hpp"
+#include "Toolpath_Source_Lib3MF.hpp"
+#include "Toolpath_Trace.hpp"
+#include "Toolpath_MemoryTracker.hpp"
+
+#include <stdexcept>
+#include <cmath>
+
+namespace Toolpath {
+
+	CToolpathConversion::CToolpathConversion(Lib3MF::PWrapper pWrapper)
+		: m_pWrapper(pWrapper),
+		m_sOutputFormat("matjob"),
+		m_nThreadCount(1),
+		m_bHasLayerRange(false),
+		m_nFirstLayer(0),
+		m_nEndLayer(0),
+		m_nHatchBlockTarget(0),
+		m_dCLIResolution(0.0),
+		m_bSampleMemory(false),
+		m_pLog(nullptr),
+		m_nConvertedLayerCount(0)
+	{
+		if (pWrapper.get() == nullptr)
+			throw std::runtime_error("Invalid lib3mf wrapper");
+	}
+
+	void CToolpathConversion::setOutputFormat(const std::string& sOutputFormat)
+	{
+		m_sOutputFormat = sOutputFormat;
+	}
+
+	void CToolpathConversion::setThreadCount(uint32_t nThreadCount)
+	{
+		m_nThreadCount = nThreadCount;
+	}
+
+	void CToolpathConversion::setLayerRange(uint32_t nFirstLayer, uint32_t nEndLayer)
+	{
+		if (nFirstLayer >= nEndLayer)
+			throw std::runtime_error("layer range " + std::to_string(nFirstLayer) + ":" + std::to_string(nEndLayer) + " is empty");
+
+		m_bHasLayerRange = true;
+		m_nFirstLayer = nFirstLayer;
+		m_nEndLayer = nEndLayer;
+	}
+
+	void CToolpathConversion::setLayerCache(PMatJobLayerCache pLayerCache)
+	{
+		m_pLayerCache = pLayerCache;
+	}
+
+	void CToolpathConversion::setLaserAssignment(PMatJobLaserAssignment pLaserAssignment)
+	{
+		m_pLaserAssignment = pLaserAssignment;
+	}
+
+	void CToolpathConversion::setScanTimeModel(PMatJobScanTimeModel pScanTimeModel)
+	{
+		m_pScanTimeModel = pScanTimeModel;
+	}
+
+	void CToolpathConversion::setHatchBlockTarget(uint32_t nHatchBlockTarget)
+	{
+		m_nHatchBlockTarget = nHatchBlockTarget;
+	}
+
+	void CToolpathConversion::setCLIResolution(double dCLIResolution)
+	{
+		if (!std::isfinite(dCLIResolution) || (dCLIResolution < 0.0))
+			throw std::runtime_error("invalid CLI resolution");
+
+		m_dCLIResolution = dCLIResolution;
+	}
+
+	void CToolpathConversion::addLayerProcessor(PToolpathLayerProcessor pLayerProcessor)
+	{
+		if (pLayerProcessor.get() == nullptr)
+			throw std::runtime_error("Invalid layer processor");
+
+		m_LayerProcessors.push_back(pLayerProcessor);
+	}
+
+	void CToolpathConversion::setStatistics(PToolpathStatistics pStatistics)
+	{
+		m_pStatistics = pStatistics;
+	}
+
+	void CToolpathConversion::setSampleMemory(bool bSampleMemory)
+	{
+		m_bSampleMemory = bSampleMemory;
+	}
+
+	void CToolpathConversion::setLog(std::ostream* pLog)
+	{
+		m_pLog = pLog;
+	}
+
+	void CToolpathConversion::setProgressCallback(ToolpathConversionProgressCallback progressCallback)
+	{
+		m_ProgressCallback = progressCallback;
+	}
+
+	uint32_t CToolpathConversion::getConvertedLayerCount()
+	{
+		return m_nConvertedLayerCount;
+	}
+
+	PToolpathExporter CToolpathConversion::createExporter(const std::string& sOutputFormat, uint32_t nThreadCount)
+	{
+		if (sOutputFormat == "matjob") {
+			auto pMatjobExporter = std::make_shared<CToolpathExporter_Matjob>();
+			pMatjobExporter->setThreadCount(nThreadCount);
+			return pMatjobExporter;
+		}
+
+		if (sOutputFormat == "cliplus" || sOutputFormat == "cli") {
+			auto pCLIPlusExporter = std::make_shared<CToolpathExporter_CLIPlus>();
+			pCLIPlusExporter->setThreadCount(nThreadCount);
+			return pCLIPlusExporter;
+		}
+
+		throw std::runtime_error("Unknown output format: " + sOutputFormat + ". Supported formats: matjob, cliplus, cli");
+	}
+
+	PMatJobScanTimeModel CToolpathConversion::createScanTimeModel(const std::string& sScanTimeModel)
+	{
+		if (sScanTimeModel == "distance")
+			return std::make_shared<CMatJobScanTimeModel_Distance>();
+
+		if (sScanTimeModel == "scanner")
+			return std::make_shared<CMatJobScanTimeModel_Scanner>();
+
+		throw std::runtime_error("Unknown scan time model: " + sScanTimeModel + ". Supported models: distance, scanner");
+	}
+
+	void CToolpathConversion::convert(const std::string& sInputFileName, const std::string& sOutputFileName)
+	{
+		sToolpathConversionOutput output;
+		output.m_sOutputFormat = m_sOutputFormat;
+		output.m_sOutputFileName = sOutputFileName;
+
+		convert(sInputFileName, std::vector<sToolpathConversionOutput>({ output }));
+	}
+
+	void CToolpathConversion::convert(const std::string& sInputFileName, const std::vector<sToolpathConversionOutput>& outputs)
+	{
+		CToolpathStatistics* pStatistics = m_pStatistics.get();
+		m_nConvertedLayerCount = 0;
+
+		if (outputs.empty())
+			throw std::runtime_error("conversion has no outputs");
+
+		// Create the appropriate exporters based on format
+		std::vector<PToolpathExporter> exporters;
+		std::vector<PToolpathExporter_Matjob> matjobExporters;
+		for (auto& output : outputs) {
+			PToolpathExporter pOutputExporter = createExporter(output.m_sOutputFormat, m_nThreadCount);
+
+			auto pMatjobExporter = std::dynamic_pointer_cast<CToolpathExporter_Matjob>(pOutputExporter);
+			if (pMatjobExporter.get() != nullptr) {
+				pMatjobExporter->setLayerCache(m_pLayerCache);
+				pMatjobExporter->setLaserAssignment(m_pLaserAssignment);
+				if (m_pScanTimeModel.get() != nullptr)
+					pMatjobExporter->setScanTimeModel(m_pScanTimeModel);
+				pMatjobExporter->setHatchBlockTarget(m_nHatchBlockTarget);
+				matjobExporters.push_back(pMatjobExporter);
+			}
+			else if (m_bHasLayerRange || (m_pLayerCache.get() != nullptr)) {
+				throw std::runtime_error("layer ranges and the layer cache are only supported for the matjob format");
+			}
+
+			auto pCLIPlusExporter = std::dynamic_pointer_cast<CToolpathExporter_CLIPlus>(pOutputExporter);
+			if (pCLIPlusExporter.get() != nullptr)
+				pCLIPlusExporter->setResolution(m_dCLIResolution);
+
+			exporters.push_back(pOutputExporter);
+		}
+
+		if ((m_pLayerCache.get() != nullptr) && (matjobExporters.size() > 1))
+			throw std::runtime_error("the layer cache can only be used by one matjob output");
+
+		// The laser assignment sums the laser times of the layers of one output
+		if ((m_pLaserAssignment.get() != nullptr) && (matjobExporters.size() != 1))
+			throw std::runtime_error("a laser assignment needs exactly one matjob output");
+
+		// Several outputs share every layer that is read through a composite exporter
+		PToolpathExporter pExporter = exporters[0];
+		std::string sOutputFileName = outputs[0].m_sOutputFileName;
+		if (outputs.size() > 1) {
+			auto pCompositeExporter = std::make_shared<CToolpathExporter_Composite>();
+			for (size_t nIndex = 0; nIndex < outputs.size(); nIndex++)
+				pCompositeExporter->addExporter(exporters[nIndex], outputs[nIndex].m_sOutputFileName);
+
+			pExporter = pCompositeExporter;
+			sOutputFileName.clear();
+		}
+
+		if (m_pLog != nullptr)
+			*m_pLog << "Reading 3MF file " << sInputFileName << "\n";
+
+		auto pModel = m_pWrapper->CreateModel();
+
+		{
+			CToolpathScopedTimer decodeTimer(pStatistics, eToolpathStatisticsPhase::Decode);
+			auto pSource = pModel->CreatePersistentSourceFromFile(sInputFileName);
+			auto pReader = pModel->QueryReader("3mf");
+			pReader->ReadFromPersistentSource(pSource);
+		}
+
+		if (m_pLog != nullptr)
+			*m_pLog << "3MF File opened..\n";
+
+		auto pLib3MFToolpaths = pModel->GetToolpaths();
+		if (!pLib3MFToolpaths->MoveNext()) {
+			throw std::runtime_error("No toolpath data found in 3MF file.");
+		}
+		auto pLib3MFToolpath = pLib3MFToolpaths->GetCurrentToolpath();
+
+		if (pLib3MFToolpaths->MoveNext()) {
+			throw std::runtime_error("Multiple toolpath data sets found in 3MF file. Only one is supported.");
+		}
+
+		auto pToolpathSource = std::make_shared<CToolpathSource_Lib3MF>(pModel, pLib3MFToolpath);
+		pToolpathSource->setStatistics(m_pStatistics);
+
+		double dUnits = pToolpathSource->getUnits();
+		uint32_t nLayerCount = pToolpathSource->getLayerCount();
+
+		if (m_pLog != nullptr)
+			*m_pLog << "Layer Count: " << nLayerCount << ", Units: " << dUnits << "\n";
+
+		// Export a job slice with only the layers of the range
+		uint32_t nFirstLayer = 0;
+		uint32_t nEndLayer = nLayerCount;
+		if (m_bHasLayerRange) {
+			nFirstLayer = m_nFirstLayer;
+			if (m_nEndLayer < nLayerCount)
+				nEndLayer = m_nEndLayer;
+
+			if (m_pLog != nullptr)
+				*m_pLog << "Layer range: " << nFirstLayer << ":" << nEndLayer << "\n";
+
+			for (auto pMatjobExporter : matjobExporters)
+				pMatjobExporter->setLayerRange(nFirstLayer, nEndLayer);
+		}
+
+		if (m_pLog != nullptr)
+			*m_pLog << "Initializing" << std::endl;
+
+		// Use the abstract exporter interface
+		pExporter->setStatistics(m_pStatistics);
+		pExporter->initialize(sOutputFileName);
+
+		if (m_pLog != nullptr)
+			*m_pLog << "Beginning export" << std::endl;
+		{
+			CToolpathTraceSpan traceSpan("beginExport");
+			pExporter->beginExport(pToolpathSource);
+		}
+
+		for (auto pLayerProcessor : m_LayerProcessors) {
+			if (m_pLog != nullptr)
+				*m_pLog << "Layer processing: " << pLayerProcessor->getName() << "\n";
+
+			pLayerProcessor->setStatistics(m_pStatistics);
+			pLayerProcessor->beginProcessing(pToolpathSource);
+		}
+
+		// Process all layers. The layer container is reused to keep its allocations.
+		CToolpathLayerData layerData;
+		for (uint32_t nLayerIndex = nFirstLayer; nLayerIndex < nEndLayer; nLayerIndex++) {
+			if (m_pLog != nullptr)
+				*m_pLog << "Writing layer " << nLayerIndex << "..." << std::endl;
+
+			{
+				CToolpathTraceSpan traceSpan("ReadLayerData", "layer", nLayerIndex);
+				pToolpathSource->readLayer(nLayerIndex, layerData);
+			}
+
+			for (auto pLayerProcessor : m_LayerProcessors) {
+				{
+					CToolpathTraceSpan traceSpan("processLayerStage", "layer", nLayerIndex);
+					pLayerProcessor->processLayer(layerData);
+				}
+
+				if (m_pLog != nullptr)
+					*m_pLog << "  " << pLayerProcessor->getLayerSummary() << "\n";
+			}
+
+			{
+				CToolpathTraceSpan traceSpan("processLayer", "layer", nLayerIndex);
+				pExporter->processLayer(layerData);
+			}
+
+			if (pStatistics != nullptr) {
+				pStatistics->addLayers(1);
+				pStatistics->addSegments(layerData.getSegmentCount());
+				pStatistics->addPoints(layerData.getPoints().size() + 2 * layerData.getHatches().size());
+				pStatistics->addHatches(layerData.getHatches().size());
+			}
+
+			if (m_bSampleMemory)
+				CToolpathMemoryTracker::sampleLayer(nLayerIndex, m_pLog);
+
+			m_nConvertedLayerCount++;
+
+			if (m_ProgressCallback)
+				m_ProgressCallback(m_nConvertedLayerCount, nEndLayer - nFirstLayer);
+		}
+
+		for (auto pLayerProcessor : m_LayerProcessors)
+			pLayerProcessor->endProcessing();
+
+		uint64_t nSkippedArcSegmentCount = pToolpathSource->getSkippedArcSegmentCount();
+		if ((nSkippedArcSegmentCount > 0) && (m_pLog != nullptr))
+			*m_pLog << "warning: skipped " << nSkippedArcSegmentCount << " arc segments, lib3mf provides no arc point data\n";
+
+		if (m_pLog != nullptr)
+			*m_pLog << "finalizing..." << std::endl;
+		{
+			CToolpathTraceSpan traceSpan("finalize");
+			pExporter->finalize();
+		}
+	}
+
+} // namespace Toolpath
@@ -0,0 +1,139 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#ifndef __TOOLPATH_CONVERSION
+#define __TOOLPATH_CONVERSION
+
+#include <string>
+#include <memory>
+#include <ostream>
+#include <vector>
+#include <functional>
+
+#include "lib3mf_dynamic.hpp"
+
+#include "Toolpath_Exporter.hpp"
+#include "Toolpath_LayerProcessor.hpp"
+#include "Toolpath_MatjobLayerCache.hpp"
+#include "Toolpath_MatjobLaserAssignment.hpp"
+#include "Toolpath_Statistics.hpp"
+
+namespace Toolpath {
+
+	typedef struct _sToolpathConversionOutput {
+		std::string m_sOutputFormat;
+		std::string m_sOutputFileName;
+	} sToolpathConversionOutput;
+
+	// Called after each converted layer with the number of layers done and the number of layers to convert
+	typedef std::function<void(uint32_t nLayersDone, uint32_t nLayerCount)> ToolpathConversionProgressCallback;
+
+	/**
+	 * Conversion of one 3MF toolpath file into an output format.
+	 * The lib3mf wrapper may be shared between conversions running on different threads,
+	 * each conversion reads its file into its own model.
+	 */
+	class CToolpathConversion {
+	private:
+		Lib3MF::PWrapper m_pWrapper;
+
+		std::string m_sOutputFormat;
+		uint32_t m_nThreadCount;
+
+		bool m_bHasLayerRange;
+		uint32_t m_nFirstLayer;
+		uint32_t m_nEndLayer;
+
+		PMatJobLayerCache m_pLayerCache;
+		PMatJobLaserAssignment m_pLaserAssignment;
+		PMatJobScanTimeModel m_pScanTimeModel;
+		uint32_t m_nHatchBlockTarget;
+		double m_dCLIResolution;
+		std::vector<PToolpathLayerProcessor> m_LayerProcessors;
+		PToolpathStatistics m_pStatistics;
+		bool m_bSampleMemory;
+
+		// Progress output, nullptr for quiet conversions
+		std::ostream* m_pLog;
+		ToolpathConversionProgressCallback m_ProgressCallback;
+
+		uint32_t m_nConvertedLayerCount;
+
+	public:
+		CToolpathConversion(Lib3MF::PWrapper pWrapper);
+		virtual ~CToolpathConversion() = default;
+
+		// matjob, cliplus or cli
+		void setOutputFormat(const std::string& sOutputFormat);
+		void setThreadCount(uint32_t nThreadCount);
+
+		// Exports a MatJob slice with the layers [nFirstLayer, nEndLayer), see CToolpathExporter_Matjob::setLayerRange
+		void setLayerRange(uint32_t nFirstLayer, uint32_t nEndLayer);
+		void setLayerCache(PMatJobLayerCache pLayerCache);
+
+		// Scan fields and laser balancing of the matjob output, see CToolpathExporter_Matjob::setLaserAssignment
+		void setLaserAssignment(PMatJobLaserAssignment pLaserAssignment);
+
+		// Layer scan time model of the matjob output, nullptr for the exporter default
+		void setScanTimeModel(PMatJobScanTimeModel pScanTimeModel);
+
+		// Hatch count up to which hatch segments share a data block, see CToolpathExporter_Matjob::setHatchBlockTarget
+		void setHatchBlockTarget(uint32_t nHatchBlockTarget);
+
+		// Integer coordinates of the CLI+ outputs, see CToolpathExporter_CLIPlus::setResolution
+		void setCLIResolution(double dCLIResolution);
+
+		// Adds a stage that processes every layer before it is exported, stages run in the order added
+		void addLayerProcessor(PToolpathLayerProcessor pLayerProcessor);
+
+		void setStatistics(PToolpathStatistics pStatistics);
+		void setSampleMemory(bool bSampleMemory);
+		void setLog(std::ostream* pLog);
+		void setProgressCallback(ToolpathConversionProgressCallback progressCallback);
+
+		// Converts into one file of the output format
+		void convert(const std::string& sInputFileName, const std::string& sOutputFileName);
+
+		// Converts into several files in one pass, each layer is read once for all outputs
+		void convert(const std::string& sInputFileName, const std::vector<sToolpathConversionOutput>& outputs);
+
+		uint32_t getConvertedLayerCount();
+
+		// Throws for unknown formats
+		static PToolpathExporter createExporter(const std::string& sOutputFormat, uint32_t nThreadCount);
+
+		// distance or scanner, throws for unknown models
+		static PMatJobScanTimeModel createScanTimeModel(const std::string& sScanTimeModel);
+	};
+
+	typedef std::shared_ptr<CToolpathConversion> PToolpathConversion;
+
+} // namespace Toolpath
+
+#endif // __TOOLPATH_CONVERSION
@@ -29,21 +29,60 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include <iostream>
+#include <sstream>
 #include <vector>
 #include "lib3mf_dynamic.hpp"
 
-#include "Toolpath_Exporter.hpp"
 #include "Toolpath_Exporter_Matjob.hpp"
-#include "Toolpath_Exporter_CLIPlus.hpp"
+#include "Toolpath_Conversion.hpp"
+#include "Toolpath_BatchConversion.hpp"
+#include "Toolpath_Daemon.hpp"
+#include "Toolpath_JSONWriter.hpp"
+#include "Toolpath_LayerProcessor_HatchOrdering.hpp"
+#include "Toolpath_LayerProcessor_LoopSeam.hpp"
+#include "Toolpath_LayerProcessor_Simplification.hpp"
+#include "Toolpath_LayerProcessor_HatchConsolidation.hpp"
+#include "Toolpath_LayerProcessor_PolylineChaining.hpp"
+#include "Toolpath_LayerProcessor_SegmentOrdering.hpp"
+#include "Toolpath_ThreadPool.hpp"
+#include "Toolpath_Statistics.hpp"
+#include "Toolpath_Trace.hpp"
+#include "Toolpath_MemoryTracker.hpp"
 
 using namespace Toolpath;
 
 int main(int argc, char* argv[])
 {
+	std::string sTraceFileName;
+	int nExitCode = 0;
+
     try {
 		std::string sInputFileName;
-		std::string sOutputFileName;
-		std::string sOutputFormat = "matjob"; // Default format
+		std::vector<std::string> outputFileNames;
+		std::vector<std::string> outputFormats;
+		uint32_t nThreadCount = 1;
+		std::string sStatisticsFileName;
+		std::string sMemoryStatisticsFileName;
+		uint64_t nMemoryBudgetInMB = 0;
+		bool bHasLayerRange = false;
+		uint32_t nFirstLayer = 0;
+		uint32_t nEndLayer = UINT32_MAX;
+		std::vector<std::string> mergeDirectories;
+		std::string sCacheDirectory;
+		uint64_t nCacheSizeInMB = 4096;
+		std::string sBatchManifestFileName;
+		std::string sBatchSummaryFileName;
+		uint32_t nWorkerCount = 1;
+		std::string sDaemonSocketPath;
+		std::string sConnectSocketPath;
+		std::string sDaemonRequest;
+		uint32_t nQueueLimit = 64;
+		std::vector<PToolpathLayerProcessor> layerProcessors;
+		std::vector<PToolpathLayerProcessor_Simplification> simplifications;
+		PMatJobLaserAssignment pLaserAssignment;
+		PMatJobScanTimeModel pScanTimeModel;
+		uint32_t nHatchBlockTarget = 0;
+		double dCLIResolution = 0.0;
 
 		std::vector<std::string> commandArguments;
 		for (int idx = 1; idx < argc; idx++)
@@ -65,7 +104,7 @@ int main(int argc, char* argv[])
 				if (nIndex >= commandArguments.size())
 					throw std::runtime_error("missing --output path");
 
-				sOutputFileName = commandArguments[nIndex];
+				outputFileNames.push_back(commandArguments[nIndex]);
 			}
 
 			if (sArgument == "--format") {
@@ -73,80 +112,530 @@ int main(int argc, char* argv[])
 				if (nIndex >= commandArguments.size())
 					throw std::runtime_error("missing --format value");
 
-				sOutputFormat = commandArguments[nIndex];
+				outputFormats.push_back(commandArguments[nIndex]);
 			}
-		}
 
-		std::cout << "Input filename: " << sInputFileName << "\n";
-		std::cout << "Output filename: " << sOutputFileName << "\n";
-		std::cout << "Output format: " << sOutputFormat << "\n";
+			if (sArgument == "--threads") {
+				nIndex++;
+				if (nIndex >= commandArguments.size())
+					throw std::runtime_error("missing --threads value");
 
-		if (sInputFileName.empty() || sOutputFileName.empty())
-			throw std::runtime_error("Usage: converter.exe --input toolpath.3mf --output output_file [--format matjob|cliplus]");
+				nThreadCount = CToolpathThreadPool::resolveThreadCount((uint32_t)std::stoul(commandArguments[nIndex]));
+			}
 
-		// Create the appropriate exporter based on format
-		PToolpathExporter pExporter;
-		if (sOutputFormat == "matjob") {
-			pExporter = std::make_shared<CToolpathExporter_Matjob>();
-		}
-		else if (sOutputFormat == "cliplus" || sOutputFormat == "cli") {
-			pExporter = std::make_shared<CToolpathExporter_CLIPlus>();
-		}
-		else {
-			throw std::runtime_error("Unknown output format: " + sOutputFormat + ". Supported formats: matjob, cliplus, cli");
-		}
+			if (sArgument == "--stats") {
+				nIndex++;
+				if (nIndex >= commandArguments.size())
+					throw std::runtime_error("missing --stats path");
+
+				sStatisticsFileName = commandArguments[nIndex];
+			}
+
+			if (sArgument == "--trace") {
+				nIndex++;
+				if (nIndex >= commandArguments.size())
+					throw std::runtime_error("missing --trace path");
+
+				sTraceFileName = commandArguments[nIndex];
+			}
+
+			if (sArgument == "--memstats") {
+				nIndex++;
+				if (nIndex >= commandArguments.size())
+					throw std::runtime_error("missing --memstats path");
+
+				sMemoryStatisticsFileName = commandArguments[nIndex];
+			}
+
+			if (sArgument == "--memory-budget") {
+				nIndex++;
+				if (nIndex >= commandArguments.size())
+					throw std::runtime_error("missing --memory-budget value");
+
+				nMemoryBudgetInMB = std::stoull(commandArguments[nIndex]);
+			}
+
+			if (sArgument == "--layers") {
+				nIndex++;
+				if (nIndex >= commandArguments.size())
+					throw std::runtime_error("missing --layers range");
+
+				// from:to with an exclusive end, an empty end exports up to the last layer
+				std::string sRange = commandArguments[nIndex];
+				size_t nSeparator = sRange.find(':');
+				if ((nSeparator == std::string::npos) || (nSeparator == 0))
+					throw std::runtime_error("invalid --layers range: " + sRange);
+
+				nFirstLayer = (uint32_t)std::stoul(sRange.substr(0, nSeparator));
+				if (nSeparator + 1 < sRange.length())
+					nEndLayer = (uint32_t)std::stoul(sRange.substr(nSeparator + 1));
+				bHasLayerRange = true;
+			}
+
+			if (sArgument == "--merge") {
+				nIndex++;
+				if (nIndex >= commandArguments.size())
+					throw std::runtime_error("missing --merge directory");
+
+				mergeDirectories.push_back(commandArguments[nIndex]);
+			}
+
+			if (sArgument == "--cache") {
+				nIndex++;
+				if (nIndex >= commandArguments.size())
+					throw std::runtime_error("missing --cache directory");
+
+				sCacheDirectory = commandArguments[nIndex];
+			}
+
+			if (sArgument == "--cache-size") {
+				nIndex++;
+				if (nIndex >= commandArguments.size())
+					throw std::runtime_error("missing --cache-size value");
+
+				nCacheSizeInMB = std::stoull(commandArguments[nIndex]);
+			}
+
+			if (sArgument == "--batch") {
+				nIndex++;
+				if (nIndex >= commandArguments.size())
+					throw std::runtime_error("missing --batch manifest");
+
+				sBatchManifestFileName = commandArguments[nIndex];
+			}
+
+			if (sArgument == "--workers") {
+				nIndex++;
+				if (nIndex >= commandArguments.size())
+					throw std::runtime_error("missing --workers value");
+
+				nWorkerCount = CToolpathThreadPool::resolveThreadCount((uint32_t)std::stoul(commandArguments[nIndex]));
+			}
+
+			if (sArgument == "--summary") {
+				nIndex++;
+				if (nIndex >= commandArguments.size())
+					throw std::runtime_error("missing --summary path");
+
+				sBatchSummaryFileName = commandArguments[nIndex];
+			}
+
+			if (sArgument == "--order-hatches") {
+				nIndex++;
+				if (nIndex >= commandArguments.size())
+					throw std::runtime_error("missing --order-hatches time budget");
+
+				// 2-opt time budget per layer in milliseconds
+				auto pHatchOrdering = std::make_shared<CToolpathLayerProcessor_HatchOrdering>();
+				pHatchOrdering->setTimeBudget(std::stod(commandArguments[nIndex]));
+				layerProcessors.push_back(pHatchOrdering);
+			}
+
+			// Layer processing stages run in the order of their arguments
+			if (sArgument == "--optimize-seams")
+				layerProcessors.push_back(std::make_shared<CToolpathLayerProcessor_LoopSeam>());
+
+			if (sArgument == "--order-segments") {
+				nIndex++;
+				if (nIndex >= commandArguments.size())
+					throw std::runtime_error("missing --order-segments constraints");
+
+				// Comma separated constraints: none, contours-first, profiles
+				auto pSegmentOrdering = std::make_shared<CToolpathLayerProcessor_SegmentOrdering>();
+				std::stringstream constraintStream(commandArguments[nIndex]);
+				std::string sConstraint;
+				while (std::getline(constraintStream, sConstraint, ',')) {
+					if (sConstraint == "contours-first")
+						pSegmentOrdering->setContoursBeforeHatches(true);
+					else if (sConstraint == "profiles")
+						pSegmentOrdering->setGroupByProfile(true);
+					else if (sConstraint != "none")
+						throw std::runtime_error("invalid segment ordering constraint: " + sConstraint);
+				}
+				layerProcessors.push_back(pSegmentOrdering);
+			}
+
+			if (sArgument == "--simplify") {
+				nIndex++;
+				if (nIndex >= commandArguments.size())
+					throw std::runtime_error("missing --simplify tolerance");
 
-		std::cout << "Reading 3MF file " << sInputFileName << "\n";
+				// Chord tolerance in mm, the thread count is set once all arguments are known
+				auto pSimplification = std::make_shared<CToolpathLayerProcessor_Simplification>();
+				pSimplification->setTolerance(std::stod(commandArguments[nIndex]));
+				simplifications.push_back(pSimplification);
+				layerProcessors.push_back(pSimplification);
+			}
+
+			if (sArgument == "--consolidate-hatches") {
+				nIndex++;
+				if (nIndex >= commandArguments.size())
+					throw std::runtime_error("missing --consolidate-hatches tolerance");
+
+				// Join tolerance in mm, optionally followed by the minimum hatch length in mm
+				auto pHatchConsolidation = std::make_shared<CToolpathLayerProcessor_HatchConsolidation>();
+				std::stringstream valueStream(commandArguments[nIndex]);
+				std::string sValue;
+				if (std::getline(valueStream, sValue, ','))
+					pHatchConsolidation->setMergeTolerance(std::stod(sValue));
+				if (std::getline(valueStream, sValue, ','))
+					pHatchConsolidation->setMinimumLength(std::stod(sValue));
+				layerProcessors.push_back(pHatchConsolidation);
+			}
+
+			if (sArgument == "--chain-polylines") {
+				nIndex++;
+				if (nIndex >= commandArguments.size())
+					throw std::runtime_error("missing --chain-polylines tolerance");
+
+				// End point tolerance in mm, optionally followed by keep-direction
+				auto pPolylineChaining = std::make_shared<CToolpathLayerProcessor_PolylineChaining>();
+				std::stringstream valueStream(commandArguments[nIndex]);
+				std::string sValue;
+				if (std::getline(valueStream, sValue, ','))
+					pPolylineChaining->setTolerance(std::stod(sValue));
+				while (std::getline(valueStream, sValue, ',')) {
+					if (sValue == "keep-direction")
+						pPolylineChaining->setKeepDirection(true);
+					else
+						throw std::runtime_error("invalid polyline chaining option: " + sValue);
+				}
+				layerProcessors.push_back(pPolylineChaining);
+			}
+
+			if (sArgument == "--scan-field") {
+				nIndex++;
+				if (nIndex >= commandArguments.size())
+					throw std::runtime_error("missing --scan-field bounds");
+
+				// minX,minY,maxX,maxY of the next laser
+				std::stringstream boundsStream(commandArguments[nIndex]);
+				std::vector<double> bounds;
+				std::string sBound;
+				while (std::getline(boundsStream, sBound, ','))
+					bounds.push_back(std::stod(sBound));
+				if (bounds.size() != 4)
+					throw std::runtime_error("invalid --scan-field bounds: " + commandArguments[nIndex]);
+
+				if (pLaserAssignment.get() == nullptr)
+					pLaserAssignment = std::make_shared<CMatJobLaserAssignment>();
+				pLaserAssignment->addLaserField(bounds[0], bounds[1], bounds[2], bounds[3]);
+			}
+
+			if (sArgument == "--laser-overlap") {
+				nIndex++;
+				if (nIndex >= commandArguments.size())
+					throw std::runtime_error("missing --laser-overlap width");
+
+				if (pLaserAssignment.get() == nullptr)
+					pLaserAssignment = std::make_shared<CMatJobLaserAssignment>();
+				pLaserAssignment->setOverlapWidth(std::stod(commandArguments[nIndex]));
+			}
+
+			if (sArgument == "--balance-lasers") {
+				if (pLaserAssignment.get() == nullptr)
+					pLaserAssignment = std::make_shared<CMatJobLaserAssignment>();
+				pLaserAssignment->setBalancing(true);
+			}
+
+			if (sArgument == "--scan-time-model") {
+				nIndex++;
+				if (nIndex >= commandArguments.size())
+					throw std::runtime_error("missing --scan-time-model value");
+
+				pScanTimeModel = CToolpathConversion::createScanTimeModel(commandArguments[nIndex]);
+			}
+
+			if (sArgument == "--hatch-block-size") {
+				nIndex++;
+				if (nIndex >= commandArguments.size())
+					throw std::runtime_error("missing --hatch-block-size hatch count");
+
+				nHatchBlockTarget = (uint32_t)std::stoul(commandArguments[nIndex]);
+			}
+
+			if (sArgument == "--cli-resolution") {
+				nIndex++;
+				if (nIndex >= commandArguments.size())
+					throw std::runtime_error("missing --cli-resolution value");
+
+				dCLIResolution = std::stod(commandArguments[nIndex]);
+				if (!(dCLIResolution > 0.0))
+					throw std::runtime_error("--cli-resolution must be positive");
+			}
+
+			if (sArgument == "--daemon") {
+				nIndex++;
+				if (nIndex >= commandArguments.size())
+					throw std::runtime_error("missing --daemon socket path");
 
-		auto pLib3MFWrapper = Lib3MF::CWrapper::loadLibrary("lib3mf_win64.dll");
-		auto pModel = pLib3MFWrapper->CreateModel();
+				sDaemonSocketPath = commandArguments[nIndex];
+			}
+
+			if (sArgument == "--queue-limit") {
+				nIndex++;
+				if (nIndex >= commandArguments.size())
+					throw std::runtime_error("missing --queue-limit value");
+
+				nQueueLimit = (uint32_t)std::stoul(commandArguments[nIndex]);
+			}
 
-		auto pSource = pModel->CreatePersistentSourceFromFile(sInputFileName);
-		auto pReader = pModel->QueryReader("3mf");
-		pReader->ReadFromPersistentSource(pSource);
+			if (sArgument == "--connect") {
+				nIndex++;
+				if (nIndex >= commandArguments.size())
+					throw std::runtime_error("missing --connect socket path");
 
-		std::cout << "3MF File opened..\n";
+				sConnectSocketPath = commandArguments[nIndex];
+			}
 
-		auto pLib3MFToolpaths = pModel->GetToolpaths();
-		if (!pLib3MFToolpaths->MoveNext()) {
-			throw std::runtime_error("No toolpath data found in 3MF file.");
+			if (sArgument == "--request") {
+				nIndex++;
+				if (nIndex >= commandArguments.size())
+					throw std::runtime_error("missing --request command");
+
+				sDaemonRequest = commandArguments[nIndex];
+			}
 		}
-		auto pLib3MFToolpath = pLib3MFToolpaths->GetCurrentToolpath();
 
-		if (pLib3MFToolpaths->MoveNext()) {
-			throw std::runtime_error("Multiple toolpath data sets found in 3MF file. Only one is supported.");
+		// Several --format/--output pairs are exported in one pass, in the order given
+		if (outputFormats.empty())
+			outputFormats.push_back("matjob"); // Default format
+		if ((outputFileNames.size() > 1) && (outputFormats.size() != outputFileNames.size()))
+			throw std::runtime_error("every --output needs its own --format when exporting several outputs");
+		if ((outputFileNames.size() <= 1) && (outputFormats.size() > 1))
+			throw std::runtime_error("several --format values need the same number of --output paths");
+
+		std::string sOutputFormat = outputFormats[0];
+		std::string sOutputFileName;
+		if (!outputFileNames.empty())
+			sOutputFileName = outputFileNames[0];
+
+		if (!sDaemonSocketPath.empty()) {
+			if (!sConnectSocketPath.empty() || !sBatchManifestFileName.empty() || !sInputFileName.empty() || !outputFileNames.empty() || !mergeDirectories.empty() || !layerProcessors.empty() || (pLaserAssignment.get() != nullptr) || (pScanTimeModel.get() != nullptr) || (nHatchBlockTarget > 0) || (dCLIResolution > 0.0))
+				throw std::runtime_error("--daemon can only be combined with --workers, --threads and --queue-limit");
+
+			// Loaded once, shared by all jobs of the daemon
+			auto pLib3MFWrapper = Lib3MF::CWrapper::loadLibrary("lib3mf_win64.dll");
+
+			CToolpathDaemon daemon(pLib3MFWrapper, sDaemonSocketPath);
+			daemon.setWorkerCount(nWorkerCount);
+			daemon.setThreadsPerJob(nThreadCount);
+			daemon.setQueueLimit(nQueueLimit);
+			daemon.setLog(&std::cout);
+			daemon.run();
+		}
+		else if (!sConnectSocketPath.empty()) {
+			// Relative paths are resolved by the daemon, in its working directory
+			std::ostringstream requestStream;
+			CToolpathJSONWriter jsonWriter(requestStream);
+			jsonWriter.setCompact(true);
+			jsonWriter.beginObject();
+
+			if (!sDaemonRequest.empty()) {
+				if ((sDaemonRequest != "status") && (sDaemonRequest != "shutdown"))
+					throw std::runtime_error("invalid --request command: " + sDaemonRequest);
+				jsonWriter.writeString("command", sDaemonRequest);
+			}
+			else {
+				if (sInputFileName.empty() || outputFileNames.empty())
+					throw std::runtime_error("--connect needs --input and --output, or --request status|shutdown");
+
+				jsonWriter.writeString("command", "convert");
+				jsonWriter.writeString("input", sInputFileName);
+				jsonWriter.beginArray("outputs");
+				for (size_t nOutputIndex = 0; nOutputIndex < outputFileNames.size(); nOutputIndex++) {
+					jsonWriter.beginObject();
+					jsonWriter.writeString("output", outputFileNames[nOutputIndex]);
+					jsonWriter.writeString("format", (nOutputIndex < outputFormats.size()) ? outputFormats[nOutputIndex] : sOutputFormat);
+					jsonWriter.endObject();
+				}
+				jsonWriter.endArray();
+			}
+
+			jsonWriter.endObject();
+
+			if (!CToolpathDaemon::sendRequest(sConnectSocketPath, requestStream.str(), std::cout))
+				nExitCode = 1;
 		}
+		else if (!sBatchManifestFileName.empty()) {
+			if (!sInputFileName.empty() || !outputFileNames.empty() || !mergeDirectories.empty() || bHasLayerRange || !sCacheDirectory.empty() || !sStatisticsFileName.empty() || !sMemoryStatisticsFileName.empty() || !layerProcessors.empty() || (pLaserAssignment.get() != nullptr) || (pScanTimeModel.get() != nullptr) || (nHatchBlockTarget > 0) || (dCLIResolution > 0.0))
+				throw std::runtime_error("--batch can only be combined with --workers, --threads, --summary and --trace");
+
+			// Tracing must be enabled before the exporters start their worker threads
+			if (!sTraceFileName.empty())
+				CToolpathTrace::enable();
 
-		double dUnits = pLib3MFToolpath->GetUnits();
-		uint32_t nLayerCount = pLib3MFToolpath->GetLayerCount();
+			auto pLib3MFWrapper = Lib3MF::CWrapper::loadLibrary("lib3mf_win64.dll");
 
-		std::cout << "Layer Count: " << nLayerCount << ", Units: " << dUnits << "\n";
+			CToolpathBatchConversion batchConversion(pLib3MFWrapper);
+			batchConversion.setWorkerCount(nWorkerCount);
+			batchConversion.setThreadsPerJob(nThreadCount);
+			batchConversion.loadManifest(sBatchManifestFileName);
 
-		std::cout << "Initializing" << std::endl;
-		// Use the abstract exporter interface
-		pExporter->initialize(sOutputFileName);
+			std::cout << "Batch conversion of " << batchConversion.getJobCount() << " jobs\n";
 
-		std::cout << "Beginning export" << std::endl;
-		pExporter->beginExport(pLib3MFToolpath, pModel);
+			uint32_t nFailedCount = batchConversion.run();
+			std::cout << (batchConversion.getJobCount() - nFailedCount) << " jobs succeeded, " << nFailedCount << " failed\n";
 
-		// Process all layers
-		for (uint32_t nLayerIndex = 0; nLayerIndex < nLayerCount; nLayerIndex++) {
-			std::cout << "Writing layer " << nLayerIndex << "..." << std::endl;
+			if (!sBatchSummaryFileName.empty()) {
+				std::cout << "Writing batch summary to " << sBatchSummaryFileName << "\n";
+				batchConversion.writeToFile(sBatchSummaryFileName);
+			}
 
-			auto pLayerReader = pLib3MFToolpath->ReadLayerData(nLayerIndex);
-			pExporter->processLayer(nLayerIndex, pLayerReader);
+			if (nFailedCount > 0)
+				nExitCode = 1;
 		}
+		else {
+			std::cout << "Input filename: " << sInputFileName << "\n";
+			for (size_t nOutputIndex = 0; nOutputIndex < outputFileNames.size(); nOutputIndex++) {
+				std::cout << "Output filename: " << outputFileNames[nOutputIndex] << "\n";
+				std::cout << "Output format: " << outputFormats[nOutputIndex] << "\n";
+			}
+			std::cout << "Threads: " << nThreadCount << "\n";
+
+			if ((sInputFileName.empty() == mergeDirectories.empty()) || sOutputFileName.empty())
+				throw std::runtime_error("Usage: converter.exe --input toolpath.3mf --output output_file [--format matjob|cliplus] [--format f --output file ...] [--threads n] [--layers from:to] [--optimize-seams] [--order-hatches ms] [--order-segments none|contours-first,profiles] [--simplify mm] [--consolidate-hatches mm[,minLength]] [--chain-polylines mm[,keep-direction]] [--scan-field minX,minY,maxX,maxY ...] [--laser-overlap mm] [--balance-lasers] [--scan-time-model distance|scanner] [--hatch-block-size n] [--cli-resolution mm] [--cache dir] [--cache-size MB] [--stats stats.json] [--trace trace.json] [--memstats memory.json] [--memory-budget MB]\n"
+					"       converter.exe --merge slice_dir [--merge slice_dir ...] --output output_file [--threads n]\n"
+					"       converter.exe --batch manifest.json [--workers n] [--threads n] [--summary summary.json] [--trace trace.json]\n"
+					"       converter.exe --daemon socket_path [--workers n] [--threads n] [--queue-limit n]\n"
+					"       converter.exe --connect socket_path (--input toolpath.3mf --output output_file [--format f] ... | --request status|shutdown)");
+
+			if (!mergeDirectories.empty() && ((sOutputFormat != "matjob") || (outputFileNames.size() > 1)))
+				throw std::runtime_error("merging is only supported for a single matjob output");
+			if (bHasLayerRange && !mergeDirectories.empty())
+				throw std::runtime_error("--layers cannot be combined with --merge");
+			if (!layerProcessors.empty() && !mergeDirectories.empty())
+				throw std::runtime_error("layer processing cannot be combined with --merge");
+			if ((pLaserAssignment.get() != nullptr) && !mergeDirectories.empty())
+				throw std::runtime_error("laser assignment cannot be combined with --merge");
+
+			// Balancing without scan fields uses the fields of the default machine
+			if ((pLaserAssignment.get() != nullptr) && (pLaserAssignment->getLaserCount() == 0))
+				pLaserAssignment->addDefaultLaserFields();
+
+			bool bSampleMemory = !sMemoryStatisticsFileName.empty() || (nMemoryBudgetInMB > 0);
+			CToolpathMemoryTracker::setBudget(nMemoryBudgetInMB * 1024 * 1024);
+
+			// Tracing must be enabled before the exporters start their worker threads
+			if (!sTraceFileName.empty())
+				CToolpathTrace::enable();
+
+			PToolpathStatistics pStatistics;
+			if (!sStatisticsFileName.empty()) {
+				pStatistics = std::make_shared<CToolpathStatistics>();
+				pStatistics->setInformation("input", sInputFileName);
+				// Several outputs are listed comma separated
+				std::string sOutputList, sFormatList;
+				for (size_t nOutputIndex = 0; nOutputIndex < outputFileNames.size(); nOutputIndex++) {
+					std::string sSeparator = (nOutputIndex > 0) ? "," : "";
+					sOutputList += sSeparator + outputFileNames[nOutputIndex];
+					sFormatList += sSeparator + outputFormats[nOutputIndex];
+				}
+				pStatistics->setInformation("output", sOutputList);
+				pStatistics->setInformation("format", sFormatList);
+				pStatistics->setInformation("threads", std::to_string(nThreadCount));
+			}
 
-		std::cout << "finalizing..." << std::endl;
-		pExporter->finalize();
+			PMatJobLayerCache pLayerCache;
+
+			if (!mergeDirectories.empty()) {
+				// Combine job slices of a sharded conversion, without reading the 3MF file
+				auto pMatjobExporter = std::make_shared<CToolpathExporter_Matjob>();
+				pMatjobExporter->setThreadCount(nThreadCount);
+				pMatjobExporter->setStatistics(pStatistics);
+				pMatjobExporter->initialize(sOutputFileName);
+
+				for (auto& sMergeDirectory : mergeDirectories) {
+					std::cout << "Merging slice " << sMergeDirectory << "\n";
+					CToolpathTraceSpan traceSpan("mergeSlice");
+					pMatjobExporter->mergeSlice(sMergeDirectory);
+				}
+
+				std::cout << "finalizing..." << std::endl;
+				{
+					CToolpathTraceSpan traceSpan("finalize");
+					pMatjobExporter->finalize();
+				}
+			}
+			else {
+				if (!sCacheDirectory.empty()) {
+					std::cout << "Layer cache: " << sCacheDirectory << "\n";
+					pLayerCache = std::make_shared<CMatJobLayerCache>(sCacheDirectory, nCacheSizeInMB * 1024 * 1024);
+				}
+
+				// Fails early for unknown formats, before the library is loaded
+				std::vector<sToolpathConversionOutput> outputs;
+				for (size_t nOutputIndex = 0; nOutputIndex < outputFileNames.size(); nOutputIndex++) {
+					CToolpathConversion::createExporter(outputFormats[nOutputIndex], nThreadCount);
+
+					sToolpathConversionOutput output;
+					output.m_sOutputFormat = outputFormats[nOutputIndex];
+					output.m_sOutputFileName = outputFileNames[nOutputIndex];
+					outputs.push_back(output);
+				}
+
+				auto pLib3MFWrapper = Lib3MF::CWrapper::loadLibrary("lib3mf_win64.dll");
+
+				CToolpathConversion conversion(pLib3MFWrapper);
+				conversion.setThreadCount(nThreadCount);
+				for (auto pSimplification : simplifications)
+					pSimplification->setThreadCount(nThreadCount);
+				if (bHasLayerRange)
+					conversion.setLayerRange(nFirstLayer, nEndLayer);
+				conversion.setLayerCache(pLayerCache);
+				conversion.setLaserAssignment(pLaserAssignment);
+				conversion.setScanTimeModel(pScanTimeModel);
+				conversion.setHatchBlockTarget(nHatchBlockTarget);
+				conversion.setCLIResolution(dCLIResolution);
+				for (auto pLayerProcessor : layerProcessors)
+					conversion.addLayerProcessor(pLayerProcessor);
+				conversion.setStatistics(pStatistics);
+				conversion.setSampleMemory(bSampleMemory);
+				conversion.setLog(&std::cout);
+
+				// The exporter and its worker threads are released before the trace is written
+				conversion.convert(sInputFileName, outputs);
+			}
 
-		pExporter = nullptr;
+			if (pLayerCache.get() != nullptr) {
+				pLayerCache->flush();
+				std::cout << "Layer cache: " << pLayerCache->getHitCount() << " hits, " << pLayerCache->getMissCount() << " misses, "
+					<< pLayerCache->getEvictionCount() << " evictions, " << pLayerCache->getTotalSize() << " bytes\n";
+
+				if (pStatistics.get() != nullptr) {
+					pStatistics->setInformation("layerCacheHits", std::to_string(pLayerCache->getHitCount()));
+					pStatistics->setInformation("layerCacheMisses", std::to_string(pLayerCache->getMissCount()));
+				}
+			}
 
-		std::cout << "Done.\n";
+			if (pStatistics.get() != nullptr) {
+				pStatistics->stop();
+				std::cout << "Writing statistics to " << sStatisticsFileName << "\n";
+				pStatistics->writeToFile(sStatisticsFileName);
+			}
+
+			if (!sMemoryStatisticsFileName.empty()) {
+				std::cout << "Writing memory statistics to " << sMemoryStatisticsFileName << "\n";
+				CToolpathMemoryTracker::writeToFile(sMemoryStatisticsFileName);
+			}
+
+			std::cout << "Done.\n";
+		}
     }
     catch (std::exception& E) {
         std::cout << "fatal error: " << E.what() << std::endl;
     }
-    
+
+	if (!sTraceFileName.empty()) {
+		try {
+			std::cout << "Writing trace to " << sTraceFileName << "\n";
+			CToolpathTrace::writeToFile(sTraceFileName);
+		}
+		catch (std::exception& E) {
+			std::cout << "error writing trace: " << E.what() << std::endl;
+		}
+	}
+
+	return nExitCode;
 }
 
@@ -0,0 +1,433 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#include "Toolpath_Daemon.hpp"
+#include "Toolpath_JSONWriter.hpp"
+#include "Toolpath_ThreadPool.hpp"
+#include "Toolpath_Statistics.hpp"
+
+#include <sstream>
+#include <thread>
+#include <functional>
+#include <algorithm>
+#include <stdexcept>
+#include <chrono>
+
+// Milliseconds to wait before accepting again after a failed accept
+#define TOOLPATHDAEMON_ACCEPTRETRYDELAY 100
+
+namespace Toolpath {
+
+	// Formats one protocol line, the members of the event are written by writeMembers
+	static std::string makeEvent(const std::string& sEvent, std::function<void(CToolpathJSONWriter&)> writeMembers)
+	{
+		std::ostringstream stream;
+		CToolpathJSONWriter jsonWriter(stream);
+		jsonWriter.setCompact(true);
+		jsonWriter.beginObject();
+		jsonWriter.writeString("event", sEvent);
+		if (writeMembers)
+			writeMembers(jsonWriter);
+		jsonWriter.endObject();
+		return stream.str();
+	}
+
+	static std::string makeJobEvent(const std::string& sEvent, uint64_t nJobID, std::function<void(CToolpathJSONWriter&)> writeMembers = nullptr)
+	{
+		return makeEvent(sEvent, [nJobID, writeMembers](CToolpathJSONWriter& jsonWriter) {
+			jsonWriter.writeUint64("job", nJobID);
+			if (writeMembers)
+				writeMembers(jsonWriter);
+		});
+	}
+
+	CToolpathDaemon::CToolpathDaemon(Lib3MF::PWrapper pWrapper, const std::string& sSocketPath)
+		: m_pWrapper(pWrapper),
+		m_sSocketPath(sSocketPath),
+		m_nWorkerCount(1),
+		m_nThreadsPerJob(1),
+		m_nQueueLimit(64),
+		m_pLog(nullptr),
+		m_bIsShuttingDown(false),
+		m_nNextJobID(1),
+		m_nRunningJobCount(0),
+		m_nCompletedJobCount(0),
+		m_nFailedJobCount(0)
+	{
+		if (pWrapper.get() == nullptr)
+			throw std::runtime_error("Invalid lib3mf wrapper");
+		if (sSocketPath.empty())
+			throw std::runtime_error("Invalid daemon socket path");
+	}
+
+	void CToolpathDaemon::setWorkerCount(uint32_t nWorkerCount)
+	{
+		m_nWorkerCount = CToolpathThreadPool::resolveThreadCount(nWorkerCount);
+	}
+
+	void CToolpathDaemon::setThreadsPerJob(uint32_t nThreadsPerJob)
+	{
+		m_nThreadsPerJob = CToolpathThreadPool::resolveThreadCount(nThreadsPerJob);
+	}
+
+	void CToolpathDaemon::setQueueLimit(uint32_t nQueueLimit)
+	{
+		if (nQueueLimit == 0)
+			throw std::runtime_error("daemon queue limit must be positive");
+
+		m_nQueueLimit = nQueueLimit;
+	}
+
+	void CToolpathDaemon::setLog(std::ostream* pLog)
+	{
+		m_pLog = pLog;
+	}
+
+	void CToolpathDaemon::log(const std::string& sMessage)
+	{
+		if (m_pLog == nullptr)
+			return;
+
+		std::lock_guard<std::mutex> lockGuard(m_LogMutex);
+		*m_pLog << sMessage << std::endl;
+	}
+
+	void CToolpathDaemon::run()
+	{
+		auto pListenSocket = CToolpathLocalSocket::listen(m_sSocketPath);
+		log("Listening on " + m_sSocketPath + " with " + std::to_string(m_nWorkerCount) + " worker(s)");
+
+		std::vector<std::thread> workers;
+		for (uint32_t nWorkerIndex = 0; nWorkerIndex < m_nWorkerCount; nWorkerIndex++)
+			workers.push_back(std::thread([this]() { runWorker(); }));
+
+		while (true) {
+			auto pConnection = pListenSocket->accept();
+
+			// A failed accept does not stop the daemon, only a shutdown request does
+			if (pConnection.get() == nullptr) {
+				{
+					std::lock_guard<std::mutex> lockGuard(m_Mutex);
+					if (m_bIsShuttingDown)
+						break;
+				}
+
+				log("Could not accept a connection, retrying");
+				std::this_thread::sleep_for(std::chrono::milliseconds(TOOLPATHDAEMON_ACCEPTRETRYDELAY));
+				continue;
+			}
+
+			std::lock_guard<std::mutex> lockGuard(m_Mutex);
+			// The connection that woke up accept after a shutdown request is dropped here
+			if (m_bIsShuttingDown)
+				break;
+
+			m_Connections.push_back(pConnection);
+			std::thread([this, pConnection]() { handleConnection(pConnection); }).detach();
+		}
+
+		pListenSocket = nullptr;
+		CToolpathLocalSocket::removeSocketFile(m_sSocketPath);
+
+		// Queued jobs are still converted, their clients wait for the results
+		{
+			std::lock_guard<std::mutex> lockGuard(m_Mutex);
+			m_bIsShuttingDown = true;
+		}
+		m_QueueCondition.notify_all();
+		for (auto& worker : workers)
+			worker.join();
+
+		// Clients that keep their connection open are disconnected
+		std::unique_lock<std::mutex> connectionLock(m_Mutex);
+		for (auto& pConnection : m_Connections)
+			pConnection->shutdown();
+		m_ConnectionCondition.wait(connectionLock, [this]() { return m_Connections.empty(); });
+
+		log("Daemon stopped");
+	}
+
+	void CToolpathDaemon::requestShutdown()
+	{
+		{
+			std::lock_guard<std::mutex> lockGuard(m_Mutex);
+			if (m_bIsShuttingDown)
+				return;
+			m_bIsShuttingDown = true;
+		}
+
+		log("Shutdown requested");
+
+		// Wakes up the accept loop
+		try {
+			CToolpathLocalSocket::connect(m_sSocketPath);
+		}
+		catch (std::runtime_error&) {
+		}
+	}
+
+	void CToolpathDaemon::handleConnection(PToolpathLocalSocket pConnection)
+	{
+		std::string sRequest;
+		while (pConnection->receiveLine(sRequest)) {
+			if (sRequest.find_first_not_of(" \t\r") == std::string::npos)
+				continue;
+
+			handleRequest(pConnection, sRequest);
+		}
+
+		std::lock_guard<std::mutex> lockGuard(m_Mutex);
+		m_Connections.erase(std::remove(m_Connections.begin(), m_Connections.end(), pConnection), m_Connections.end());
+		m_ConnectionCondition.notify_all();
+	}
+
+	void CToolpathDaemon::handleRequest(PToolpathLocalSocket pConnection, const std::string& sRequest)
+	{
+		try {
+			auto pRequest = CToolpathJSONReader::parse(sRequest);
+			const std::string& sCommand = pRequest->getString("command");
+
+			if (sCommand == "convert") {
+				submitJob(pConnection, *pRequest);
+			}
+			else if (sCommand == "status") {
+				sendStatus(pConnection);
+			}
+			else if (sCommand == "shutdown") {
+				pConnection->sendLine(makeEvent("shutdown", nullptr));
+				requestShutdown();
+			}
+			else {
+				throw std::runtime_error("unknown command: " + sCommand);
+			}
+		}
+		catch (std::exception& E) {
+			std::string sMessage = E.what();
+			pConnection->sendLine(makeEvent("error", [&sMessage](CToolpathJSONWriter& jsonWriter) {
+				jsonWriter.writeString("error", sMessage);
+			}));
+		}
+	}
+
+	void CToolpathDaemon::submitJob(PToolpathLocalSocket pConnection, const CToolpathJSONValue& request)
+	{
+		sToolpathDaemonJob job;
+		job.m_sInputFileName = request.getString("input");
+		job.m_pConnection = pConnection;
+
+		if (request.hasMember("outputs")) {
+			auto& outputs = request.getMember("outputs");
+			for (uint32_t nIndex = 0; nIndex < outputs.getElementCount(); nIndex++) {
+				auto& output = outputs.getElement(nIndex);
+
+				sToolpathConversionOutput conversionOutput;
+				conversionOutput.m_sOutputFileName = output.getString("output");
+				conversionOutput.m_sOutputFormat = output.hasMember("format") ? output.getString("format") : "matjob";
+				job.m_Outputs.push_back(conversionOutput);
+			}
+		}
+		else {
+			sToolpathConversionOutput conversionOutput;
+			conversionOutput.m_sOutputFileName = request.getString("output");
+			conversionOutput.m_sOutputFormat = request.hasMember("format") ? request.getString("format") : "matjob";
+			job.m_Outputs.push_back(conversionOutput);
+		}
+
+		if (job.m_sInputFileName.empty() || job.m_Outputs.empty())
+			throw std::runtime_error("convert request needs an input and an output file");
+
+		// Unknown formats are rejected before the job is queued
+		for (auto& output : job.m_Outputs) {
+			if (output.m_sOutputFileName.empty())
+				throw std::runtime_error("convert request has an empty output file name");
+			CToolpathConversion::createExporter(output.m_sOutputFormat, 1);
+		}
+
+		std::string sRejection;
+		size_t nQueuePosition = 0;
+		{
+			std::lock_guard<std::mutex> lockGuard(m_Mutex);
+			job.m_nJobID = m_nNextJobID++;
+
+			if (m_bIsShuttingDown)
+				sRejection = "daemon is shutting down";
+			else if (m_Queue.size() >= m_nQueueLimit)
+				sRejection = "job queue is full (" + std::to_string(m_nQueueLimit) + " jobs)";
+			else {
+				m_Queue.push_back(job);
+				nQueuePosition = m_Queue.size();
+
+				// Sent before a worker can report the start of the job
+				pConnection->sendLine(makeJobEvent("accepted", job.m_nJobID, [nQueuePosition](CToolpathJSONWriter& jsonWriter) {
+					jsonWriter.writeUint64("queuePosition", nQueuePosition);
+				}));
+			}
+		}
+
+		if (!sRejection.empty()) {
+			pConnection->sendLine(makeJobEvent("rejected", job.m_nJobID, [&sRejection](CToolpathJSONWriter& jsonWriter) {
+				jsonWriter.writeString("error", sRejection);
+			}));
+			return;
+		}
+
+		log("Job " + std::to_string(job.m_nJobID) + " queued: " + job.m_sInputFileName);
+		m_QueueCondition.notify_one();
+	}
+
+	void CToolpathDaemon::sendStatus(PToolpathLocalSocket pConnection)
+	{
+		uint64_t nQueuedCount, nRunningCount, nCompletedCount, nFailedCount;
+		{
+			std::lock_guard<std::mutex> lockGuard(m_Mutex);
+			nQueuedCount = m_Queue.size();
+			nRunningCount = m_nRunningJobCount;
+			nCompletedCount = m_nCompletedJobCount;
+			nFailedCount = m_nFailedJobCount;
+		}
+
+		pConnection->sendLine(makeEvent("status", [&](CToolpathJSONWriter& jsonWriter) {
+			jsonWriter.writeUint64("workers", m_nWorkerCount);
+			jsonWriter.writeUint64("threadsPerJob", m_nThreadsPerJob);
+			jsonWriter.writeUint64("queueLimit", m_nQueueLimit);
+			jsonWriter.writeUint64("queued", nQueuedCount);
+			jsonWriter.writeUint64("running", nRunningCount);
+			jsonWriter.writeUint64("completed", nCompletedCount);
+			jsonWriter.writeUint64("failed", nFailedCount);
+		}));
+	}
+
+	void CToolpathDaemon::runWorker()
+	{
+		while (true) {
+			sToolpathDaemonJob job;
+			{
+				std::unique_lock<std::mutex> queueLock(m_Mutex);
+				m_QueueCondition.wait(queueLock, [this]() { return m_bIsShuttingDown || !m_Queue.empty(); });
+				if (m_Queue.empty())
+					return;
+
+				job = m_Queue.front();
+				m_Queue.pop_front();
+				m_nRunningJobCount++;
+			}
+
+			runJob(job);
+		}
+	}
+
+	void CToolpathDaemon::runJob(const sToolpathDaemonJob& job)
+	{
+		auto pConnection = job.m_pConnection;
+		uint64_t nJobID = job.m_nJobID;
+
+		pConnection->sendLine(makeJobEvent("started", nJobID));
+		log("Job " + std::to_string(nJobID) + " started");
+
+		uint64_t nStartTime = CToolpathStatistics::getWallTimeInNanoseconds();
+		bool bSucceeded = false;
+		std::string sErrorMessage;
+		uint32_t nLayerCount = 0;
+
+		try {
+			CToolpathConversion conversion(m_pWrapper);
+			conversion.setThreadCount(m_nThreadsPerJob);
+
+			// About a hundred progress events per job
+			conversion.setProgressCallback([pConnection, nJobID](uint32_t nLayersDone, uint32_t nTotalLayerCount) {
+				uint32_t nInterval = std::max<uint32_t>(nTotalLayerCount / 100, 1);
+				if ((nLayersDone % nInterval == 0) || (nLayersDone == nTotalLayerCount)) {
+					pConnection->sendLine(makeJobEvent("progress", nJobID, [nLayersDone, nTotalLayerCount](CToolpathJSONWriter& jsonWriter) {
+						jsonWriter.writeUint64("layer", nLayersDone);
+						jsonWriter.writeUint64("layerCount", nTotalLayerCount);
+					}));
+				}
+			});
+
+			conversion.convert(job.m_sInputFileName, job.m_Outputs);
+			nLayerCount = conversion.getConvertedLayerCount();
+			bSucceeded = true;
+		}
+		catch (std::exception& E) {
+			sErrorMessage = E.what();
+		}
+		catch (...) {
+			sErrorMessage = "unknown error";
+		}
+
+		double dWallTimeInSeconds = (CToolpathStatistics::getWallTimeInNanoseconds() - nStartTime) * 1.0e-9;
+
+		{
+			std::lock_guard<std::mutex> lockGuard(m_Mutex);
+			m_nRunningJobCount--;
+			if (bSucceeded)
+				m_nCompletedJobCount++;
+			else
+				m_nFailedJobCount++;
+		}
+
+		if (bSucceeded) {
+			pConnection->sendLine(makeJobEvent("completed", nJobID, [nLayerCount, dWallTimeInSeconds](CToolpathJSONWriter& jsonWriter) {
+				jsonWriter.writeUint64("layers", nLayerCount);
+				jsonWriter.writeDouble("wallTimeInSeconds", dWallTimeInSeconds);
+			}));
+			log("Job " + std::to_string(nJobID) + " completed");
+		}
+		else {
+			pConnection->sendLine(makeJobEvent("failed", nJobID, [&sErrorMessage, dWallTimeInSeconds](CToolpathJSONWriter& jsonWriter) {
+				jsonWriter.writeString("error", sErrorMessage);
+				jsonWriter.writeDouble("wallTimeInSeconds", dWallTimeInSeconds);
+			}));
+			log("Job " + std::to_string(nJobID) + " failed: " + sErrorMessage);
+		}
+	}
+
+	bool CToolpathDaemon::sendRequest(const std::string& sSocketPath, const std::string& sRequest, std::ostream& outputStream)
+	{
+		auto pConnection = CToolpathLocalSocket::connect(sSocketPath);
+		if (!pConnection->sendLine(sRequest))
+			throw std::runtime_error("Could not send request to " + sSocketPath);
+
+		std::string sLine;
+		while (pConnection->receiveLine(sLine)) {
+			outputStream << sLine << std::endl;
+
+			auto pEvent = CToolpathJSONReader::parse(sLine);
+			const std::string& sEvent = pEvent->getString("event");
+
+			if ((sEvent == "completed") || (sEvent == "status") || (sEvent == "shutdown"))
+				return true;
+			if ((sEvent == "failed") || (sEvent == "rejected") || (sEvent == "error"))
+				return false;
+		}
+
+		throw std::runtime_error("Daemon closed the connection before answering");
+	}
+
+} // namespace Toolpath
@@ -0,0 +1,129 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#ifndef __TOOLPATH_DAEMON
+#define __TOOLPATH_DAEMON
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <ostream>
+#include <cstdint>
+
+#include "lib3mf_dynamic.hpp"
+
+#include "Toolpath_Conversion.hpp"
+#include "Toolpath_JSONReader.hpp"
+#include "Toolpath_LocalSocket.hpp"
+
+namespace Toolpath {
+
+	typedef struct _sToolpathDaemonJob {
+		uint64_t m_nJobID;
+		std::string m_sInputFileName;
+		std::vector<sToolpathConversionOutput> m_Outputs;
+		// Receives the events of the job, may have been closed by the client meanwhile
+		PToolpathLocalSocket m_pConnection;
+	} sToolpathDaemonJob;
+
+	/**
+	 * Resident conversion service on a local socket. The lib3mf library is loaded once and
+	 * the workers stay alive between jobs, so a job does not pay the process start up.
+	 *
+	 * Protocol: one JSON object per line in both directions.
+	 *   {"command":"convert","input":"a.3mf","output":"a.zip","format":"matjob"}
+	 *   {"command":"convert","input":"a.3mf","outputs":[{"output":"a.zip","format":"matjob"},...]}
+	 *   {"command":"status"}
+	 *   {"command":"shutdown"}
+	 * A convert request is answered with "accepted" or "rejected", followed by "started",
+	 * "progress" and finally "completed" or "failed", each carrying the job id.
+	 */
+	class CToolpathDaemon {
+	private:
+		Lib3MF::PWrapper m_pWrapper;
+		std::string m_sSocketPath;
+
+		uint32_t m_nWorkerCount;
+		uint32_t m_nThreadsPerJob;
+		uint32_t m_nQueueLimit;
+
+		// Progress output, nullptr for a quiet daemon
+		std::ostream* m_pLog;
+		std::mutex m_LogMutex;
+
+		std::mutex m_Mutex;
+		std::condition_variable m_QueueCondition;
+		std::condition_variable m_ConnectionCondition;
+		std::deque<sToolpathDaemonJob> m_Queue;
+		std::vector<PToolpathLocalSocket> m_Connections;
+		bool m_bIsShuttingDown;
+		uint64_t m_nNextJobID;
+		uint32_t m_nRunningJobCount;
+		uint64_t m_nCompletedJobCount;
+		uint64_t m_nFailedJobCount;
+
+		void log(const std::string& sMessage);
+
+		void runWorker();
+		void runJob(const sToolpathDaemonJob& job);
+
+		void handleConnection(PToolpathLocalSocket pConnection);
+		void handleRequest(PToolpathLocalSocket pConnection, const std::string& sRequest);
+		void submitJob(PToolpathLocalSocket pConnection, const CToolpathJSONValue& request);
+		void sendStatus(PToolpathLocalSocket pConnection);
+		void requestShutdown();
+
+	public:
+		CToolpathDaemon(Lib3MF::PWrapper pWrapper, const std::string& sSocketPath);
+		virtual ~CToolpathDaemon() = default;
+
+		// Number of jobs converted in parallel, 0 selects the hardware concurrency
+		void setWorkerCount(uint32_t nWorkerCount);
+		// Exporter threads of each job
+		void setThreadsPerJob(uint32_t nThreadsPerJob);
+		// Jobs waiting for a worker, further jobs are rejected
+		void setQueueLimit(uint32_t nQueueLimit);
+		void setLog(std::ostream* pLog);
+
+		// Serves requests until a shutdown request; queued and running jobs are finished before returning
+		void run();
+
+		// Sends one request to a daemon and copies the events to outputStream until the request is answered.
+		// Returns false if the request was rejected or the job failed.
+		static bool sendRequest(const std::string& sSocketPath, const std::string& sRequest, std::ostream& outputStream);
+	};
+
+	typedef std::shared_ptr<CToolpathDaemon> PToolpathDaemon;
+
+} // namespace Toolpath
+
+#endif // __TOOLPATH_DAEMON
@@ -32,7 +32,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <string>
 #include <vector>
 #include <memory>
-#include "lib3mf_dynamic.hpp"
+#include "Toolpath_Source.hpp"
+#include "Toolpath_Statistics.hpp"
 
 namespace Toolpath {
 
@@ -51,19 +52,23 @@ namespace Toolpath {
 		virtual void initialize(const std::string& sOutputFileName) = 0;
 
 		/**
-		 * Begin exporting from a 3MF toolpath.
+		 * Attach a statistics collector for phase timings and counters.
+		 * @param pStatistics Statistics of the conversion job, may be nullptr
+		 */
+		virtual void setStatistics(PToolpathStatistics pStatistics) = 0;
+
+		/**
+		 * Begin exporting from a toolpath source.
 		 * This sets up internal state based on the toolpath metadata.
-		 * @param pToolpath The lib3mf toolpath to export
-		 * @param pModel The lib3mf model containing build items
+		 * @param pSource The toolpath source with layers, parts and profiles
 		 */
-		virtual void beginExport(Lib3MF::PToolpath pToolpath, Lib3MF::PModel pModel) = 0;
+		virtual void beginExport(PToolpathSource pSource) = 0;
 
 		/**
 		 * Process a single layer from the toolpath.
-		 * @param nLayerIndex Index of the layer to process
-		 * @param pLayerReader Layer reader for the layer data
+		 * @param layerData Geometry of the layer, read from the source of beginExport
 		 */
-		virtual void processLayer(uint32_t nLayerIndex, Lib3MF::PToolpathLayerReader pLayerReader) = 0;
+		virtual void processLayer(const CToolpathLayerData& layerData) = 0;
 
 		/**
 		 * Finalize and write the export file.
@@ -35,11 +35,37 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <ctime>
 #include <limits>
 #include <cfloat>
+#include <cmath>
+
+// Decimals of the $$UNITS value of quantized output
+#define CLIPLUS_UNITSDECIMALS 9
+
+// zlib compression level of .gz output
+#define CLIPLUS_GZIPCOMPRESSIONLEVEL 6
+
+// Largest integer coordinate, so that it converts back to a double exactly
+#define CLIPLUS_MAXQUANTIZEDVALUE 9007199254740992.0
 
 namespace Toolpath {
 
+	static void appendInteger(std::string& sBuffer, int64_t nValue)
+	{
+		char digits[24];
+		uint32_t nDigitCount = 0;
+		uint64_t nMagnitude = (nValue < 0) ? (0 - (uint64_t)nValue) : (uint64_t)nValue;
+		do {
+			digits[nDigitCount++] = (char)('0' + (nMagnitude % 10));
+			nMagnitude /= 10;
+		} while (nMagnitude > 0);
+
+		if (nValue < 0)
+			sBuffer.push_back('-');
+		while (nDigitCount > 0)
+			sBuffer.push_back(digits[--nDigitCount]);
+	}
+
 	CToolpathExporter_CLIPlus::CToolpathExporter_CLIPlus()
-		: m_dUnits(1.0)
+		: m_GeometryBufferGauge(eToolpathMemorySubsystem::CLIGeometryBuffer)
 		, m_nLayerCount(0)
 		, m_dMinX(DBL_MAX)
 		, m_dMinY(DBL_MAX)
@@ -50,118 +76,173 @@ namespace Toolpath {
 		, m_nNextPartID(1)
 		, m_nNextProfileID(1)
 		, m_bIncludeLaserParams(true)
+		, m_dResolution(0.0)
+		, m_sUnits("1.000000")
+		, m_dUnits(1.0)
+		, m_bCompressOutput(false)
+		, m_nThreadCount(1)
+		, m_nQuantizedCount(0)
+		, m_dMaxQuantizationError(0.0)
+		, m_dQuantizationErrorSum(0.0)
 	{
 	}
 
 	void CToolpathExporter_CLIPlus::initialize(const std::string& sOutputFileName)
 	{
 		m_sOutputFileName = sOutputFileName;
-		std::cout << "Writing CLI+ file " << sOutputFileName << "\n";
+
+		std::string sCompressedExtension = ".gz";
+		m_bCompressOutput = (sOutputFileName.size() > sCompressedExtension.size()) &&
+			(sOutputFileName.compare(sOutputFileName.size() - sCompressedExtension.size(), sCompressedExtension.size(), sCompressedExtension) == 0);
+
+		if (m_bCompressOutput)
+			std::cout << "Writing gzip compressed CLI+ file " << sOutputFileName << "\n";
+		else
+			std::cout << "Writing CLI+ file " << sOutputFileName << "\n";
 	}
 
-	void CToolpathExporter_CLIPlus::beginExport(Lib3MF::PToolpath pToolpath, Lib3MF::PModel pModel)
+	void CToolpathExporter_CLIPlus::setStatistics(PToolpathStatistics pStatistics)
 	{
-		m_pToolpath = pToolpath;
-		m_dUnits = pToolpath->GetUnits();
-		m_nLayerCount = pToolpath->GetLayerCount();
+		m_pStatistics = pStatistics;
+	}
+
+	void CToolpathExporter_CLIPlus::beginExport(PToolpathSource pSource)
+	{
+		if (pSource.get() == nullptr)
+			throw std::runtime_error("Invalid toolpath source");
+
+		m_pSource = pSource;
+		m_nLayerCount = pSource->getLayerCount();
+
+		m_nQuantizedCount = 0;
+		m_dMaxQuantizationError = 0.0;
+		m_dQuantizationErrorSum = 0.0;
 
 		// Calculate bounding box from layers
 		for (uint32_t i = 0; i < m_nLayerCount; i++) {
-			double zMin = pToolpath->GetLayerZMin(i) * m_dUnits;
-			double zMax = pToolpath->GetLayerZMax(i) * m_dUnits;
+			double zMin = pSource->getLayerZMin(i);
+			double zMax = pSource->getLayerZMax(i);
 			if (zMin < m_dMinZ) m_dMinZ = zMin;
 			if (zMax > m_dMaxZ) m_dMaxZ = zMax;
 		}
 
 		// Pre-register parts from build items
-		auto pBuildItems = pModel->GetBuildItems();
-		while (pBuildItems->MoveNext()) {
-			auto pBuildItem = pBuildItems->GetCurrent();
-			bool bHasUUID = false;
-			std::string sUUID = pBuildItem->GetUUID(bHasUUID);
-			if (bHasUUID) {
-				getOrCreatePartID(sUUID);
-
+		uint32_t nPartCount = pSource->getPartCount();
+		m_PartIDsBySourceIndex.resize(nPartCount);
+		for (uint32_t i = 0; i < nPartCount; i++) {
+			auto& part = pSource->getPart(i);
+			std::string sUUID = part.getBuildItemUUID();
+			m_PartIDsBySourceIndex[i] = getOrCreatePartID(sUUID);
+
+			if (!sUUID.empty() && part.hasOutbox()) {
 				// Update bounding box from part outbox
-				auto pObject = pBuildItem->GetObjectResource();
-				auto outbox = pObject->GetOutbox();
-				if (outbox.m_MinCoordinate[0] < m_dMinX) m_dMinX = outbox.m_MinCoordinate[0];
-				if (outbox.m_MinCoordinate[1] < m_dMinY) m_dMinY = outbox.m_MinCoordinate[1];
-				if (outbox.m_MaxCoordinate[0] > m_dMaxX) m_dMaxX = outbox.m_MaxCoordinate[0];
-				if (outbox.m_MaxCoordinate[1] > m_dMaxY) m_dMaxY = outbox.m_MaxCoordinate[1];
+				if (part.getOutboxMin(0) < m_dMinX) m_dMinX = part.getOutboxMin(0);
+				if (part.getOutboxMin(1) < m_dMinY) m_dMinY = part.getOutboxMin(1);
+				if (part.getOutboxMax(0) > m_dMaxX) m_dMaxX = part.getOutboxMax(0);
+				if (part.getOutboxMax(1) > m_dMaxY) m_dMaxY = part.getOutboxMax(1);
 			}
 		}
 
 		// Pre-register profiles
-		uint32_t nProfileCount = pToolpath->GetProfileCount();
+		uint32_t nProfileCount = pSource->getProfileCount();
+		m_ProfileIDsBySourceIndex.resize(nProfileCount);
+		m_ProfileLaserPowers.resize(nProfileCount);
+		m_ProfileLaserSpeeds.resize(nProfileCount);
 		for (uint32_t i = 0; i < nProfileCount; i++) {
-			auto pProfile = pToolpath->GetProfile(i);
-			getOrCreateProfileID(pProfile->GetUUID());
+			auto& profile = pSource->getProfile(i);
+			m_ProfileIDsBySourceIndex[i] = getOrCreateProfileID(profile.getUUID());
+			m_ProfileLaserPowers[i] = profile.getParameterDoubleValueDef("", "laserpower", 0.0);
+			m_ProfileLaserSpeeds[i] = profile.getParameterDoubleValueDef("", "laserspeed", 0.0);
+		}
+
+		if (m_bCompressOutput) {
+			// The header only depends on the source, so the file is written while the layers are exported
+			auto pThreadPool = std::make_shared<CToolpathThreadPool>(m_nThreadCount);
+			m_pGzipWriter = std::make_shared<CToolpathGzipWriter>(m_sOutputFileName, CLIPLUS_GZIPCOMPRESSIONLEVEL, pThreadPool, m_pStatistics);
+
+			std::ostringstream headerStream;
+			writeHeader(headerStream);
+			writeGeometryStart(headerStream);
+			std::string sHeader = headerStream.str();
+			m_pGzipWriter->write(sHeader.data(), sHeader.size());
 		}
 	}
 
-	void CToolpathExporter_CLIPlus::processLayer(uint32_t nLayerIndex, Lib3MF::PToolpathLayerReader pLayerReader)
+	void CToolpathExporter_CLIPlus::processLayer(const CToolpathLayerData& layerData)
 	{
-		double dZValue = m_pToolpath->GetLayerZMax(nLayerIndex) * m_dUnits;
+		CToolpathScopedTimer encodeTimer(m_pStatistics.get(), eToolpathStatisticsPhase::Encode);
 
-		// Write layer start command
-		m_GeometryBuffer << "$$LAYER/" << std::fixed << std::setprecision(6) << dZValue << "\n";
+		double dZValue = layerData.getZMax();
 
-		uint32_t nSegmentCount = pLayerReader->GetSegmentCount();
+		// Write layer start command
+		if (m_dResolution > 0.0) {
+			m_LineBuffer.assign("$$LAYER/");
+			appendQuantized(dZValue);
+			m_LineBuffer.push_back('\n');
+			m_GeometryBuffer.write(m_LineBuffer.data(), m_LineBuffer.size());
+		}
+		else {
+			m_GeometryBuffer << "$$LAYER/" << std::fixed << std::setprecision(6) << dZValue << "\n";
+		}
 
-		for (uint32_t nSegmentIndex = 0; nSegmentIndex < nSegmentCount; nSegmentIndex++) {
-			Lib3MF::eToolpathSegmentType segmentType;
-			uint32_t nPointCount = 0;
-			pLayerReader->GetSegmentInfo(nSegmentIndex, segmentType, nPointCount);
+		for (auto& segment : layerData.getSegments()) {
 
 			// Get part and profile IDs
-			std::string sProfileUUID = pLayerReader->GetSegmentDefaultProfileUUID(nSegmentIndex);
-			std::string sBuildItemUUID = pLayerReader->GetSegmentBuildItemUUID(nSegmentIndex);
-			uint32_t nPartID = getOrCreatePartID(sBuildItemUUID);
-			uint32_t nProfileID = getOrCreateProfileID(sProfileUUID);
+			uint32_t nPartID = 0;
+			if (segment.m_nPartIndex != TOOLPATH_INDEX_NONE) {
+				if (segment.m_nPartIndex >= m_PartIDsBySourceIndex.size())
+					throw std::runtime_error("invalid part index in toolpath segment");
+				nPartID = m_PartIDsBySourceIndex[segment.m_nPartIndex];
+			}
 
 			// Get laser parameters if we want to include them (CLI+ extension)
+			uint32_t nProfileID = 0;
 			double dLaserPower = 0.0;
 			double dLaserSpeed = 0.0;
-			if (m_bIncludeLaserParams && !sProfileUUID.empty()) {
-				auto pProfile = m_pToolpath->GetProfileByUUID(sProfileUUID);
-				if (pProfile) {
-					dLaserPower = pProfile->GetParameterDoubleValueDef("", "laserpower", 0.0);
-					dLaserSpeed = pProfile->GetParameterDoubleValueDef("", "laserspeed", 0.0);
+			if (segment.m_nProfileIndex != TOOLPATH_INDEX_NONE) {
+				if (segment.m_nProfileIndex >= m_ProfileIDsBySourceIndex.size())
+					throw std::runtime_error("invalid profile index in toolpath segment");
+				nProfileID = m_ProfileIDsBySourceIndex[segment.m_nProfileIndex];
+				if (m_bIncludeLaserParams) {
+					dLaserPower = m_ProfileLaserPowers[segment.m_nProfileIndex];
+					dLaserSpeed = m_ProfileLaserSpeeds[segment.m_nProfileIndex];
 				}
 			}
 
-			switch (segmentType) {
-			case Lib3MF::eToolpathSegmentType::Loop:
-			case Lib3MF::eToolpathSegmentType::Polyline:
+			switch (segment.m_Type) {
+			case eToolpathSegmentType::Loop:
+			case eToolpathSegmentType::Polyline:
 			{
-				std::vector<Lib3MF::sPosition2D> points;
-				pLayerReader->GetSegmentPointDataInModelUnits(nSegmentIndex, points);
-
-				if (points.size() < 2)
+				if (segment.m_nElementCount < 2)
 					continue;
 
-				// Determine direction
-				int nDir = (segmentType == Lib3MF::eToolpathSegmentType::Loop) 
+				// Determine direction. Loops are already closed by the source.
+				int nDir = (segment.m_Type == eToolpathSegmentType::Loop) 
 					? static_cast<int>(eCLIPolylineDirection::CounterClockwise)
 					: static_cast<int>(eCLIPolylineDirection::Open);
 
-				// For loops, ensure the polyline is closed
-				if (segmentType == Lib3MF::eToolpathSegmentType::Loop) {
-					auto firstPoint = points.front();
-					auto lastPoint = points.back();
-					if ((firstPoint.m_Coordinates[0] != lastPoint.m_Coordinates[0]) ||
-						(firstPoint.m_Coordinates[1] != lastPoint.m_Coordinates[1])) {
-						points.push_back(firstPoint);
-					}
-				}
+				const sToolpathPoint2D* pPoints = layerData.getSegmentPoints(segment);
 
 				// Write polyline command
 				// $$POLYLINE/id,dir,n,x1,y1,x2,y2,...
-				m_GeometryBuffer << "$$POLYLINE/" << nPartID << "," << nDir << "," << points.size();
-				for (const auto& pt : points) {
-					m_GeometryBuffer << "," << std::fixed << std::setprecision(6) 
-						<< pt.m_Coordinates[0] << "," << pt.m_Coordinates[1];
+				m_GeometryBuffer << "$$POLYLINE/" << nPartID << "," << nDir << "," << segment.m_nElementCount;
+				if (m_dResolution > 0.0) {
+					m_LineBuffer.clear();
+					for (uint32_t nPointIndex = 0; nPointIndex < segment.m_nElementCount; nPointIndex++) {
+						const auto& pt = pPoints[nPointIndex];
+						m_LineBuffer.push_back(',');
+						appendQuantized(pt.m_Coordinates[0]);
+						m_LineBuffer.push_back(',');
+						appendQuantized(pt.m_Coordinates[1]);
+					}
+					m_GeometryBuffer.write(m_LineBuffer.data(), m_LineBuffer.size());
+				}
+				else {
+					for (uint32_t nPointIndex = 0; nPointIndex < segment.m_nElementCount; nPointIndex++) {
+						const auto& pt = pPoints[nPointIndex];
+						m_GeometryBuffer << "," << std::fixed << std::setprecision(6) 
+							<< pt.m_Coordinates[0] << "," << pt.m_Coordinates[1];
+					}
 				}
 				m_GeometryBuffer << "\n";
 
@@ -174,21 +255,38 @@ namespace Toolpath {
 				break;
 			}
 
-			case Lib3MF::eToolpathSegmentType::Hatch:
+			case eToolpathSegmentType::Hatch:
 			{
-				std::vector<Lib3MF::sHatch2D> hatches;
-				pLayerReader->GetSegmentHatchDataInModelUnits(nSegmentIndex, hatches);
-
-				if (hatches.empty())
+				if (segment.m_nElementCount == 0)
 					continue;
 
+				const sToolpathHatch2D* pHatches = layerData.getSegmentHatches(segment);
+
 				// Write hatches command
 				// $$HATCHES/id,n,x1s,y1s,x1e,y1e,x2s,y2s,x2e,y2e,...
-				m_GeometryBuffer << "$$HATCHES/" << nPartID << "," << hatches.size();
-				for (const auto& hatch : hatches) {
-					m_GeometryBuffer << "," << std::fixed << std::setprecision(6)
-						<< hatch.m_Point1Coordinates[0] << "," << hatch.m_Point1Coordinates[1] << ","
-						<< hatch.m_Point2Coordinates[0] << "," << hatch.m_Point2Coordinates[1];
+				m_GeometryBuffer << "$$HATCHES/" << nPartID << "," << segment.m_nElementCount;
+				if (m_dResolution > 0.0) {
+					m_LineBuffer.clear();
+					for (uint32_t nHatchIndex = 0; nHatchIndex < segment.m_nElementCount; nHatchIndex++) {
+						const auto& hatch = pHatches[nHatchIndex];
+						m_LineBuffer.push_back(',');
+						appendQuantized(hatch.m_Point1Coordinates[0]);
+						m_LineBuffer.push_back(',');
+						appendQuantized(hatch.m_Point1Coordinates[1]);
+						m_LineBuffer.push_back(',');
+						appendQuantized(hatch.m_Point2Coordinates[0]);
+						m_LineBuffer.push_back(',');
+						appendQuantized(hatch.m_Point2Coordinates[1]);
+					}
+					m_GeometryBuffer.write(m_LineBuffer.data(), m_LineBuffer.size());
+				}
+				else {
+					for (uint32_t nHatchIndex = 0; nHatchIndex < segment.m_nElementCount; nHatchIndex++) {
+						const auto& hatch = pHatches[nHatchIndex];
+						m_GeometryBuffer << "," << std::fixed << std::setprecision(6)
+							<< hatch.m_Point1Coordinates[0] << "," << hatch.m_Point1Coordinates[1] << ","
+							<< hatch.m_Point2Coordinates[0] << "," << hatch.m_Point2Coordinates[1];
+					}
 				}
 				m_GeometryBuffer << "\n";
 
@@ -206,86 +304,136 @@ namespace Toolpath {
 				break;
 			}
 		}
+
+		if (m_pGzipWriter.get() != nullptr) {
+			std::string sLayerData = m_GeometryBuffer.str();
+			m_GeometryBuffer.str(std::string());
+			m_pGzipWriter->write(sLayerData.data(), sLayerData.size());
+		}
+
+		m_GeometryBufferGauge.update((uint64_t)m_GeometryBuffer.tellp());
 	}
 
 	void CToolpathExporter_CLIPlus::finalize()
 	{
-		// Open the output file
-		m_OutputStream.open(m_sOutputFileName, std::ios::out | std::ios::trunc);
-		if (!m_OutputStream.is_open()) {
-			throw std::runtime_error("Failed to open output file: " + m_sOutputFileName);
+		CToolpathScopedTimer diskTimer(m_pStatistics.get(), eToolpathStatisticsPhase::DiskIO);
+
+		if (m_pGzipWriter.get() != nullptr) {
+			std::ostringstream footerStream;
+			writeGeometryEnd(footerStream);
+			std::string sFooter = footerStream.str();
+			m_pGzipWriter->write(sFooter.data(), sFooter.size());
+			m_pGzipWriter->finish();
+
+			uint64_t nUncompressedSize = m_pGzipWriter->getUncompressedSize();
+			uint64_t nCompressedSize = m_pGzipWriter->getCompressedSize();
+
+			if (m_pStatistics.get() != nullptr) {
+				m_pStatistics->setOutputSize(nCompressedSize);
+				m_pStatistics->setProcessingValue("cliCompression", "uncompressedBytes", (double)nUncompressedSize);
+				m_pStatistics->setProcessingValue("cliCompression", "compressedBytes", (double)nCompressedSize);
+			}
+
+			m_pGzipWriter.reset();
 		}
+		else {
+			// Open the output file
+			m_OutputStream.open(m_sOutputFileName, std::ios::out | std::ios::trunc);
+			if (!m_OutputStream.is_open()) {
+				throw std::runtime_error("Failed to open output file: " + m_sOutputFileName);
+			}
 
-		// Write header
-		writeHeader();
+			// Write header
+			writeHeader(m_OutputStream);
 
-		// Write geometry section
-		writeGeometryStart();
-		m_OutputStream << m_GeometryBuffer.str();
-		writeGeometryEnd();
+			// Write geometry section
+			writeGeometryStart(m_OutputStream);
+			// Streaming the buffer avoids a second in-memory copy of the geometry.
+			// An empty buffer is skipped, as streaming it would set the failbit of the output.
+			if (m_GeometryBuffer.tellp() > 0)
+				m_OutputStream << m_GeometryBuffer.rdbuf();
+			writeGeometryEnd(m_OutputStream);
+
+			m_GeometryBuffer.str(std::string());
+			m_GeometryBufferGauge.update(0);
+
+			if (m_pStatistics.get() != nullptr)
+				m_pStatistics->setOutputSize((uint64_t)m_OutputStream.tellp());
+
+			m_OutputStream.close();
+		}
+
+		if (m_dResolution > 0.0) {
+			double dMeanError = (m_nQuantizedCount > 0) ? (m_dQuantizationErrorSum / (double)m_nQuantizedCount) : 0.0;
+			if (m_pStatistics.get() != nullptr) {
+				m_pStatistics->setProcessingValue("cliQuantization", "units", m_dUnits);
+				m_pStatistics->setProcessingValue("cliQuantization", "coordinates", (double)m_nQuantizedCount);
+				m_pStatistics->setProcessingValue("cliQuantization", "maxError", m_dMaxQuantizationError);
+				m_pStatistics->setProcessingValue("cliQuantization", "meanError", dMeanError);
+			}
+		}
 
-		m_OutputStream.close();
 		std::cout << "CLI+ export complete.\n";
 	}
 
-	void CToolpathExporter_CLIPlus::writeHeader()
+	void CToolpathExporter_CLIPlus::writeHeader(std::ostream& outputStream)
 	{
-		m_OutputStream << "$$HEADERSTART\n";
-		m_OutputStream << "$$ASCII\n";
-		m_OutputStream << "$$UNITS/" << std::fixed << std::setprecision(6) << 1.0 << "\n"; // Units in mm
-		m_OutputStream << "$$VERSION/200\n"; // CLI version 2.00
+		outputStream << "$$HEADERSTART\n";
+		outputStream << "$$ASCII\n";
+		outputStream << "$$UNITS/" << m_sUnits << "\n"; // Units in mm
+		outputStream << "$$VERSION/200\n"; // CLI version 2.00
 
 		// Get current date
 		std::time_t now = std::time(nullptr);
 		std::tm* ltm = std::localtime(&now);
 		int dateValue = (ltm->tm_mday * 10000) + ((ltm->tm_mon + 1) * 100) + (ltm->tm_year % 100);
-		m_OutputStream << "$$DATE/" << dateValue << "\n";
+		outputStream << "$$DATE/" << dateValue << "\n";
 
 		// Write dimension (bounding box)
 		if (m_dMinX < m_dMaxX && m_dMinY < m_dMaxY && m_dMinZ < m_dMaxZ) {
-			m_OutputStream << "$$DIMENSION/" 
+			outputStream << "$$DIMENSION/" 
 				<< std::fixed << std::setprecision(6)
 				<< m_dMinX << "," << m_dMinY << "," << m_dMinZ << ","
 				<< m_dMaxX << "," << m_dMaxY << "," << m_dMaxZ << "\n";
 		}
 
-		m_OutputStream << "$$LAYERS/" << m_nLayerCount << "\n";
+		outputStream << "$$LAYERS/" << m_nLayerCount << "\n";
 
 		// Write labels for parts
 		for (const auto& partEntry : m_PartIDMap) {
-			m_OutputStream << "$$LABEL/" << partEntry.second << ",part_" << partEntry.second << "\n";
+			outputStream << "$$LABEL/" << partEntry.second << ",part_" << partEntry.second << "\n";
 		}
 
 		// CLI+ extension: Write profile information as user data
-		if (m_bIncludeLaserParams && m_pToolpath) {
-			m_OutputStream << "// CLI+ EXTENSION: PROFILE DEFINITIONS //\n";
-			uint32_t nProfileCount = m_pToolpath->GetProfileCount();
+		if (m_bIncludeLaserParams && m_pSource) {
+			outputStream << "// CLI+ EXTENSION: PROFILE DEFINITIONS //\n";
+			uint32_t nProfileCount = m_pSource->getProfileCount();
 			for (uint32_t i = 0; i < nProfileCount; i++) {
-				auto pProfile = m_pToolpath->GetProfile(i);
-				std::string sUUID = pProfile->GetUUID();
-				std::string sName = pProfile->GetName();
-				double dPower = pProfile->GetParameterDoubleValueDef("", "laserpower", 0.0);
-				double dSpeed = pProfile->GetParameterDoubleValueDef("", "laserspeed", 0.0);
+				auto& profile = m_pSource->getProfile(i);
+				std::string sUUID = profile.getUUID();
+				std::string sName = profile.getName();
+				double dPower = m_ProfileLaserPowers[i];
+				double dSpeed = m_ProfileLaserSpeeds[i];
 
 				uint32_t nProfileID = m_ProfileIDMap[sUUID];
-				m_OutputStream << "// PROFILE_DEF=" << nProfileID 
+				outputStream << "// PROFILE_DEF=" << nProfileID 
 					<< " NAME=\"" << sName << "\""
 					<< " POWER=" << dPower 
 					<< " SPEED=" << dSpeed << " //\n";
 			}
 		}
 
-		m_OutputStream << "$$HEADEREND\n";
+		outputStream << "$$HEADEREND\n";
 	}
 
-	void CToolpathExporter_CLIPlus::writeGeometryStart()
+	void CToolpathExporter_CLIPlus::writeGeometryStart(std::ostream& outputStream)
 	{
-		m_OutputStream << "$$GEOMETRYSTART\n";
+		outputStream << "$$GEOMETRYSTART\n";
 	}
 
-	void CToolpathExporter_CLIPlus::writeGeometryEnd()
+	void CToolpathExporter_CLIPlus::writeGeometryEnd(std::ostream& outputStream)
 	{
-		m_OutputStream << "$$GEOMETRYEND\n";
+		outputStream << "$$GEOMETRYEND\n";
 	}
 
 	uint32_t CToolpathExporter_CLIPlus::getOrCreatePartID(const std::string& sBuildItemUUID)
@@ -325,5 +473,60 @@ namespace Toolpath {
 		m_bIncludeLaserParams = bInclude;
 	}
 
+	void CToolpathExporter_CLIPlus::setResolution(double dResolution)
+	{
+		if (!std::isfinite(dResolution) || (dResolution < 0.0))
+			throw std::runtime_error("invalid CLI resolution");
+
+		if (dResolution == 0.0) {
+			m_dResolution = 0.0;
+			m_sUnits = "1.000000";
+			m_dUnits = 1.0;
+			return;
+		}
+
+		// The units are quantized against the value a reader parses from the header
+		std::ostringstream unitsStream;
+		unitsStream << std::fixed << std::setprecision(CLIPLUS_UNITSDECIMALS) << dResolution;
+		std::string sUnits = unitsStream.str();
+		while (sUnits.back() == '0')
+			sUnits.pop_back();
+		if (sUnits.back() == '.')
+			sUnits.push_back('0');
+
+		double dUnits = std::stod(sUnits);
+		if (dUnits <= 0.0)
+			throw std::runtime_error("CLI resolution is too fine: " + std::to_string(dResolution));
+
+		m_dResolution = dResolution;
+		m_sUnits = sUnits;
+		m_dUnits = dUnits;
+	}
+
+	double CToolpathExporter_CLIPlus::getResolution()
+	{
+		return m_dResolution;
+	}
+
+	void CToolpathExporter_CLIPlus::setThreadCount(uint32_t nThreadCount)
+	{
+		m_nThreadCount = nThreadCount;
+	}
+
+	void CToolpathExporter_CLIPlus::appendQuantized(double dValue)
+	{
+		double dQuantized = std::round(dValue / m_dUnits);
+		if (!(std::fabs(dQuantized) <= CLIPLUS_MAXQUANTIZEDVALUE))
+			throw std::runtime_error("coordinate exceeds the range of the CLI resolution: " + std::to_string(dValue));
+
+		double dError = std::fabs(dQuantized * m_dUnits - dValue);
+		if (dError > m_dMaxQuantizationError)
+			m_dMaxQuantizationError = dError;
+		m_dQuantizationErrorSum += dError;
+		m_nQuantizedCount++;
+
+		appendInteger(m_LineBuffer, (int64_t)dQuantized);
+	}
+
 } // namespace Toolpath
 
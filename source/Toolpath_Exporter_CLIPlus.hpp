@@ -30,6 +30,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define __TOOLPATH_EXPORTER_CLIPLUS
 
 #include "Toolpath_Exporter.hpp"
+#include "Toolpath_MemoryTracker.hpp"
+#include "Toolpath_GzipWriter.hpp"
 #include <fstream>
 #include <sstream>
 #include <map>
@@ -54,16 +56,19 @@ namespace Toolpath {
 	 * 
 	 * Output format: ASCII CLI version 2.0 with extensions for
 	 * laser power, speed, and profile information.
+	 * 
+	 * Output files ending in .gz are gzip compressed while the layers
+	 * are exported, instead of being buffered until finalize.
 	 */
 	class CToolpathExporter_CLIPlus : public IToolpathExporter {
 	private:
 		std::string m_sOutputFileName;
 		std::ofstream m_OutputStream;
 		std::stringstream m_GeometryBuffer;
+		CToolpathMemoryGauge m_GeometryBufferGauge;
 
 		// Cached toolpath info
-		Lib3MF::PToolpath m_pToolpath;
-		double m_dUnits;
+		PToolpathSource m_pSource;
 		uint32_t m_nLayerCount;
 
 		// Bounding box
@@ -76,27 +81,60 @@ namespace Toolpath {
 		uint32_t m_nNextPartID;
 		uint32_t m_nNextProfileID;
 
+		// CLI IDs and laser parameters by source part and profile index
+		std::vector<uint32_t> m_PartIDsBySourceIndex;
+		std::vector<uint32_t> m_ProfileIDsBySourceIndex;
+		std::vector<double> m_ProfileLaserPowers;
+		std::vector<double> m_ProfileLaserSpeeds;
+
 		// Configuration
 		bool m_bIncludeLaserParams;
 
+		// Quantized output writes integer coordinates in multiples of the units, 0 writes mm
+		double m_dResolution;
+		std::string m_sUnits;
+		double m_dUnits;
+		std::string m_LineBuffer;
+
+		// Compressed output, the header is written by beginExport and every layer by processLayer
+		bool m_bCompressOutput;
+		uint32_t m_nThreadCount;
+		PToolpathGzipWriter m_pGzipWriter;
+
+		// Round-trip error of the quantized coordinates in mm
+		uint64_t m_nQuantizedCount;
+		double m_dMaxQuantizationError;
+		double m_dQuantizationErrorSum;
+
+		PToolpathStatistics m_pStatistics;
+
 		// Internal methods
-		void writeHeader();
-		void writeGeometryStart();
-		void writeGeometryEnd();
+		void writeHeader(std::ostream& outputStream);
+		void writeGeometryStart(std::ostream& outputStream);
+		void writeGeometryEnd(std::ostream& outputStream);
 		uint32_t getOrCreatePartID(const std::string& sBuildItemUUID);
 		uint32_t getOrCreateProfileID(const std::string& sProfileUUID);
+		void appendQuantized(double dValue);
 
 	public:
 		CToolpathExporter_CLIPlus();
 		virtual ~CToolpathExporter_CLIPlus() = default;
 
 		void initialize(const std::string& sOutputFileName) override;
-		void beginExport(Lib3MF::PToolpath pToolpath, Lib3MF::PModel pModel) override;
-		void processLayer(uint32_t nLayerIndex, Lib3MF::PToolpathLayerReader pLayerReader) override;
+		void setStatistics(PToolpathStatistics pStatistics) override;
+		void beginExport(PToolpathSource pSource) override;
+		void processLayer(const CToolpathLayerData& layerData) override;
 		void finalize() override;
 
 		// CLI+-specific configuration
 		void setIncludeLaserParams(bool bInclude);
+
+		// Writes $$UNITS as the resolution in mm and every coordinate as an integer, 0 for floating point coordinates
+		void setResolution(double dResolution);
+		double getResolution();
+
+		// Threads that compress the blocks of .gz output
+		void setThreadCount(uint32_t nThreadCount);
 	};
 
 	typedef std::shared_ptr<CToolpathExporter_CLIPlus> PToolpathExporter_CLIPlus;
@@ -0,0 +1,244 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#include "Toolpath_Exporter_Composite.hpp"
+
+#include <fstream>
+#include <future>
+#include <stdexcept>
+
+namespace Toolpath {
+
+	CToolpathSource_Tables::CToolpathSource_Tables(PToolpathSource pSource)
+		: m_pSource(pSource), m_dUnits(1.0)
+	{
+		if (pSource.get() == nullptr)
+			throw std::runtime_error("Invalid toolpath source");
+
+		m_dUnits = pSource->getUnits();
+
+		uint32_t nLayerCount = pSource->getLayerCount();
+		m_LayerZMin.reserve(nLayerCount);
+		m_LayerZMax.reserve(nLayerCount);
+		for (uint32_t nLayerIndex = 0; nLayerIndex < nLayerCount; nLayerIndex++) {
+			m_LayerZMin.push_back(pSource->getLayerZMin(nLayerIndex));
+			m_LayerZMax.push_back(pSource->getLayerZMax(nLayerIndex));
+		}
+
+		uint32_t nPartCount = pSource->getPartCount();
+		for (uint32_t nPartIndex = 0; nPartIndex < nPartCount; nPartIndex++)
+			m_Parts.push_back(pSource->getPart(nPartIndex));
+
+		uint32_t nProfileCount = pSource->getProfileCount();
+		for (uint32_t nProfileIndex = 0; nProfileIndex < nProfileCount; nProfileIndex++)
+			m_Profiles.push_back(pSource->getProfile(nProfileIndex));
+	}
+
+	void CToolpathSource_Tables::setStatistics(PToolpathStatistics pStatistics)
+	{
+		m_pSource->setStatistics(pStatistics);
+	}
+
+	double CToolpathSource_Tables::getUnits()
+	{
+		return m_dUnits;
+	}
+
+	uint32_t CToolpathSource_Tables::getLayerCount()
+	{
+		return (uint32_t)m_LayerZMin.size();
+	}
+
+	double CToolpathSource_Tables::getLayerZMin(uint32_t nLayerIndex)
+	{
+		if (nLayerIndex >= m_LayerZMin.size())
+			throw std::runtime_error("Invalid layer index: " + std::to_string(nLayerIndex));
+
+		return m_LayerZMin[nLayerIndex];
+	}
+
+	double CToolpathSource_Tables::getLayerZMax(uint32_t nLayerIndex)
+	{
+		if (nLayerIndex >= m_LayerZMax.size())
+			throw std::runtime_error("Invalid layer index: " + std::to_string(nLayerIndex));
+
+		return m_LayerZMax[nLayerIndex];
+	}
+
+	uint32_t CToolpathSource_Tables::getPartCount()
+	{
+		return (uint32_t)m_Parts.size();
+	}
+
+	const CToolpathSourcePart& CToolpathSource_Tables::getPart(uint32_t nPartIndex)
+	{
+		if (nPartIndex >= m_Parts.size())
+			throw std::runtime_error("Invalid part index: " + std::to_string(nPartIndex));
+
+		return m_Parts[nPartIndex];
+	}
+
+	uint32_t CToolpathSource_Tables::getProfileCount()
+	{
+		return (uint32_t)m_Profiles.size();
+	}
+
+	const CToolpathSourceProfile& CToolpathSource_Tables::getProfile(uint32_t nProfileIndex)
+	{
+		if (nProfileIndex >= m_Profiles.size())
+			throw std::runtime_error("Invalid profile index: " + std::to_string(nProfileIndex));
+
+		return m_Profiles[nProfileIndex];
+	}
+
+	void CToolpathSource_Tables::readLayer(uint32_t nLayerIndex, CToolpathLayerData& layerData)
+	{
+		m_pSource->readLayer(nLayerIndex, layerData);
+	}
+
+	CToolpathExporter_Composite::CToolpathExporter_Composite()
+		: m_bIsConcurrent(true)
+	{
+	}
+
+	void CToolpathExporter_Composite::addExporter(PToolpathExporter pExporter, const std::string& sOutputFileName)
+	{
+		if (pExporter.get() == nullptr)
+			throw std::runtime_error("Invalid exporter");
+		if (m_pThreadPool.get() != nullptr)
+			throw std::runtime_error("exporters must be added before initialize");
+
+		for (auto& target : m_Targets) {
+			if (target.m_sOutputFileName == sOutputFileName)
+				throw std::runtime_error("duplicate output file: " + sOutputFileName);
+		}
+
+		sToolpathCompositeTarget target;
+		target.m_pExporter = pExporter;
+		target.m_sOutputFileName = sOutputFileName;
+		m_Targets.push_back(target);
+	}
+
+	uint32_t CToolpathExporter_Composite::getExporterCount()
+	{
+		return (uint32_t)m_Targets.size();
+	}
+
+	void CToolpathExporter_Composite::setConcurrent(bool bIsConcurrent)
+	{
+		if (m_pThreadPool.get() != nullptr)
+			throw std::runtime_error("concurrency must be set before initialize");
+
+		m_bIsConcurrent = bIsConcurrent;
+	}
+
+	template <typename FunctionType> void CToolpathExporter_Composite::forEachExporter(FunctionType function)
+	{
+		if (m_pThreadPool->isSynchronous()) {
+			for (auto& target : m_Targets)
+				function(target);
+			return;
+		}
+
+		std::vector<std::future<void>> futures;
+		for (auto& target : m_Targets) {
+			sToolpathCompositeTarget* pTarget = &target;
+			futures.push_back(m_pThreadPool->submit([function, pTarget]() { function(*pTarget); }));
+		}
+
+		// All exporters must be idle before an error leaves, they reference the layer data
+		std::exception_ptr pFirstException;
+		for (auto& future : futures) {
+			try {
+				future.get();
+			}
+			catch (...) {
+				if (!pFirstException)
+					pFirstException = std::current_exception();
+			}
+		}
+
+		if (pFirstException)
+			std::rethrow_exception(pFirstException);
+	}
+
+	void CToolpathExporter_Composite::initialize(const std::string& /*sOutputFileName*/)
+	{
+		if (m_Targets.empty())
+			throw std::runtime_error("composite exporter has no exporters");
+
+		// One worker per exporter, a single exporter is processed on the calling thread
+		uint32_t nThreadCount = m_bIsConcurrent ? (uint32_t)m_Targets.size() : 1;
+		m_pThreadPool = std::make_shared<CToolpathThreadPool>(nThreadCount);
+
+		for (auto& target : m_Targets)
+			target.m_pExporter->initialize(target.m_sOutputFileName);
+	}
+
+	void CToolpathExporter_Composite::setStatistics(PToolpathStatistics pStatistics)
+	{
+		m_pStatistics = pStatistics;
+		for (auto& target : m_Targets)
+			target.m_pExporter->setStatistics(pStatistics);
+	}
+
+	void CToolpathExporter_Composite::beginExport(PToolpathSource pSource)
+	{
+		auto pTables = std::make_shared<CToolpathSource_Tables>(pSource);
+
+		for (auto& target : m_Targets)
+			target.m_pExporter->beginExport(pTables);
+	}
+
+	void CToolpathExporter_Composite::processLayer(const CToolpathLayerData& layerData)
+	{
+		forEachExporter([&layerData](sToolpathCompositeTarget& target) {
+			target.m_pExporter->processLayer(layerData);
+		});
+	}
+
+	void CToolpathExporter_Composite::finalize()
+	{
+		forEachExporter([](sToolpathCompositeTarget& target) {
+			target.m_pExporter->finalize();
+		});
+
+		// Each exporter reports its own output size, the job output is the sum of all files
+		if (m_pStatistics.get() != nullptr) {
+			uint64_t nOutputSize = 0;
+			for (auto& target : m_Targets) {
+				std::ifstream stream(target.m_sOutputFileName, std::ios::in | std::ios::binary | std::ios::ate);
+				if (stream.is_open())
+					nOutputSize += (uint64_t)stream.tellg();
+			}
+			m_pStatistics->setOutputSize(nOutputSize);
+		}
+	}
+
+} // namespace Toolpath
@@ -0,0 +1,117 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#ifndef __TOOLPATH_EXPORTER_COMPOSITE
+#define __TOOLPATH_EXPORTER_COMPOSITE
+
+#include "Toolpath_Exporter.hpp"
+#include "Toolpath_ThreadPool.hpp"
+
+#include <string>
+#include <vector>
+
+namespace Toolpath {
+
+	/**
+	 * Copy of the layer heights, parts and profiles of a source, taken once so that several
+	 * exporters can query them concurrently. Reading layers is forwarded to the source.
+	 */
+	class CToolpathSource_Tables : public IToolpathSource {
+	private:
+		PToolpathSource m_pSource;
+		double m_dUnits;
+		std::vector<double> m_LayerZMin;
+		std::vector<double> m_LayerZMax;
+		std::vector<CToolpathSourcePart> m_Parts;
+		std::vector<CToolpathSourceProfile> m_Profiles;
+
+	public:
+		CToolpathSource_Tables(PToolpathSource pSource);
+		virtual ~CToolpathSource_Tables() = default;
+
+		void setStatistics(PToolpathStatistics pStatistics) override;
+
+		double getUnits() override;
+
+		uint32_t getLayerCount() override;
+		double getLayerZMin(uint32_t nLayerIndex) override;
+		double getLayerZMax(uint32_t nLayerIndex) override;
+
+		uint32_t getPartCount() override;
+		const CToolpathSourcePart& getPart(uint32_t nPartIndex) override;
+
+		uint32_t getProfileCount() override;
+		const CToolpathSourceProfile& getProfile(uint32_t nProfileIndex) override;
+
+		void readLayer(uint32_t nLayerIndex, CToolpathLayerData& layerData) override;
+	};
+
+	typedef struct _sToolpathCompositeTarget {
+		PToolpathExporter m_pExporter;
+		std::string m_sOutputFileName;
+	} sToolpathCompositeTarget;
+
+	/**
+	 * Exports a source into several outputs in one pass. Every layer is read once and the same
+	 * layer data is handed to all exporters, which process it concurrently.
+	 */
+	class CToolpathExporter_Composite : public IToolpathExporter {
+	private:
+		std::vector<sToolpathCompositeTarget> m_Targets;
+		bool m_bIsConcurrent;
+		PToolpathThreadPool m_pThreadPool;
+
+		PToolpathStatistics m_pStatistics;
+
+		// Runs the function for every exporter and rethrows the first error
+		template <typename FunctionType> void forEachExporter(FunctionType function);
+
+	public:
+		CToolpathExporter_Composite();
+		virtual ~CToolpathExporter_Composite() = default;
+
+		void addExporter(PToolpathExporter pExporter, const std::string& sOutputFileName);
+		uint32_t getExporterCount();
+
+		// Process the exporters one after another, e.g. for debugging
+		void setConcurrent(bool bIsConcurrent);
+
+		// Initializes every exporter with the output file passed to addExporter, the composite ignores the path it is given
+		void initialize(const std::string& sOutputFileName) override;
+		void setStatistics(PToolpathStatistics pStatistics) override;
+		void beginExport(PToolpathSource pSource) override;
+		void processLayer(const CToolpathLayerData& layerData) override;
+		void finalize() override;
+	};
+
+	typedef std::shared_ptr<CToolpathExporter_Composite> PToolpathExporter_Composite;
+
+} // namespace Toolpath
+
+#endif // __TOOLPATH_EXPORTER_COMPOSITE
@@ -32,14 +32,31 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "Toolpath_Exporter_Matjob.hpp"
 #include "Toolpath_MatjobConst.hpp"
 
+#include <algorithm>
+
 
 namespace Toolpath {
 
+	static void addCachedPartBounds(sMatJobCachedPartBounds& partBounds, double dX, double dY)
+	{
+		partBounds.m_dMinX = std::min(partBounds.m_dMinX, dX);
+		partBounds.m_dMinY = std::min(partBounds.m_dMinY, dY);
+		partBounds.m_dMaxX = std::max(partBounds.m_dMaxX, dX);
+		partBounds.m_dMaxY = std::max(partBounds.m_dMaxY, dY);
+	}
+
 	CToolpathExporter_Matjob::CToolpathExporter_Matjob()
-		: m_dUnits(1.0)
-		, m_nLayerCount(0)
+		: m_nLayerCount(0)
 		, m_nLayersPerBatch(50)
+		, m_bIsSlice(false)
+		, m_nFirstLayer(0)
+		, m_nEndLayer(0)
+		, m_nMergedLayerCount(0)
+		, m_nMergedLayerEnd(0)
 		, m_dGlobalLaserDiameter(0.1)
+		, m_pScanTimeModel(std::make_shared<CMatJobScanTimeModel_Scanner>())
+		, m_bRetimeCachedLayers(true)
+		, m_nThreadCount(1)
 	{
 	}
 
@@ -47,16 +64,45 @@ namespace Toolpath {
 	{
 		m_sOutputFileName = sOutputFileName;
 
-		std::wstring sOutputFileNameW = NMR::fnUTF8toUTF16(sOutputFileName);
-		m_pExportStream = std::make_shared<NMR::CExportStream_Native>(sOutputFileNameW.c_str());
-		m_pMatJobWriter = std::make_unique<CMatJobWriter>(m_pExportStream);
+		m_pThreadPool = std::make_shared<CToolpathThreadPool>(m_nThreadCount);
+
+		if (m_bIsSlice) {
+			m_pMatJobWriter = std::make_unique<CMatJobWriter>(sOutputFileName, m_pThreadPool);
+		}
+		else {
+			std::wstring sOutputFileNameW = NMR::fnUTF8toUTF16(sOutputFileName);
+			m_pExportStream = std::make_shared<NMR::CExportStream_Native>(sOutputFileNameW.c_str());
+			m_pMatJobWriter = std::make_unique<CMatJobWriter>(m_pExportStream, m_pThreadPool);
+		}
+		m_pMatJobWriter->setStatistics(m_pStatistics);
+		m_pMatJobWriter->setScanTimeModel(m_pScanTimeModel);
+	}
+
+	void CToolpathExporter_Matjob::setStatistics(PToolpathStatistics pStatistics)
+	{
+		m_pStatistics = pStatistics;
+		if (m_pMatJobWriter.get() != nullptr)
+			m_pMatJobWriter->setStatistics(pStatistics);
 	}
 
-	void CToolpathExporter_Matjob::beginExport(Lib3MF::PToolpath pToolpath, Lib3MF::PModel pModel)
+	void CToolpathExporter_Matjob::beginExport(PToolpathSource pSource)
 	{
-		m_pToolpath = pToolpath;
-		m_dUnits = pToolpath->GetUnits();
-		m_nLayerCount = pToolpath->GetLayerCount();
+		if (pSource.get() == nullptr)
+			throw std::runtime_error("Invalid toolpath source");
+
+		m_pSource = pSource;
+		m_nLayerCount = pSource->getLayerCount();
+
+		if (m_bIsSlice) {
+			if (m_nEndLayer > m_nLayerCount)
+				m_nEndLayer = m_nLayerCount;
+			if (m_nFirstLayer >= m_nEndLayer)
+				throw std::runtime_error("layer range " + std::to_string(m_nFirstLayer) + ":" + std::to_string(m_nEndLayer) + " is empty");
+		}
+		else {
+			m_nFirstLayer = 0;
+			m_nEndLayer = m_nLayerCount;
+		}
 
 		// Build feed factors JSON
 		std::stringstream feedFactorStream;
@@ -65,7 +111,7 @@ namespace Toolpath {
 			if (nFeedFactorIndex > 0)
 				feedFactorStream << ", ";
 
-			double dZMin = pToolpath->GetLayerZMin(nFeedFactorIndex) * m_dUnits;
+			double dZMin = pSource->getLayerZMin(nFeedFactorIndex);
 			feedFactorStream << "\"" << dZMin << "\": 1.5";
 		}
 		feedFactorStream << "}";
@@ -83,146 +129,240 @@ namespace Toolpath {
 		m_pMatJobWriter->addProperty("buildplate_heater_enable", "false", eMatJobPropertyType::mjpBool);
 		m_pMatJobWriter->addProperty("buildplate_temp", "100", eMatJobPropertyType::mjpInteger);
 
-		// Add default scan fields
-		m_pMatJobWriter->addScanField("Scan Field 1", 0, 0, 0.0, 0.0, 450.0, 300.0);
-		m_pMatJobWriter->addScanField("Scan Field 2", 1, 1, 0.0, 0.0, 450.0, 300.0);
-		m_pMatJobWriter->addScanField("Scan Field 3", 2, 2, 0.0, 0.0, 450.0, 300.0);
-		m_pMatJobWriter->addScanField("Scan Field 4", 3, 3, 0.0, 0.0, 450.0, 300.0);
+		// Add scan fields, one per laser
+		if (m_pLaserAssignment.get() != nullptr) {
+			m_pLaserAssignment->readProfiles(*pSource);
+
+			uint32_t nLaserCount = m_pLaserAssignment->getLaserCount();
+			for (uint32_t nLaserIndex = 0; nLaserIndex < nLaserCount; nLaserIndex++) {
+				auto& laserField = m_pLaserAssignment->getLaserField(nLaserIndex);
+				m_pMatJobWriter->addScanField("Scan Field " + std::to_string(nLaserIndex + 1), nLaserIndex, nLaserIndex,
+					laserField.m_dMinX, laserField.m_dMinY, laserField.m_dMaxX, laserField.m_dMaxY);
+			}
+		}
+		else {
+			for (uint32_t nLaserIndex = 0; nLaserIndex < MATJOB_DEFAULTSCANFIELDCOUNT; nLaserIndex++)
+				m_pMatJobWriter->addScanField("Scan Field " + std::to_string(nLaserIndex + 1), nLaserIndex, nLaserIndex,
+					0.0, 0.0, MATJOB_DEFAULTSCANFIELDSIZEX, MATJOB_DEFAULTSCANFIELDSIZEY);
+		}
 
 		// Add parts from build items
-		auto pBuildItems = pModel->GetBuildItems();
-		while (pBuildItems->MoveNext()) {
-			auto pBuildItem = pBuildItems->GetCurrent();
-			auto pObject = pBuildItem->GetObjectResource();
-			std::string sName = pObject->GetName();
+		m_PartsBySourceIndex.clear();
+		m_PartsByID.clear();
+		uint32_t nPartCount = pSource->getPartCount();
+		for (uint32_t nPartIndex = 0; nPartIndex < nPartCount; nPartIndex++) {
+			auto& sourcePart = pSource->getPart(nPartIndex);
+			std::string sName = sourcePart.getName();
 
 			if (sName.empty())
 				sName = "default name";
 
-			bool bHasUUID = false;
-			std::string sUUID = pBuildItem->GetUUID(bHasUUID);
-			if (!bHasUUID) {
+			std::string sUUID = sourcePart.getBuildItemUUID();
+			if (sUUID.empty()) {
 				throw std::runtime_error("Build item has no UUID");
 			}
 
 			m_pMatJobWriter->addPart(sName, sUUID);
+			auto pMatJobPart = m_pMatJobWriter->findPartByBuildItemUUID(sUUID);
+			m_PartsBySourceIndex.push_back(pMatJobPart);
+			m_PartsByID.insert(std::make_pair(pMatJobPart->getPartID(), pMatJobPart));
 
 		}
 
-		// Add parameter sets from profiles
-		uint32_t nProfileCount = pToolpath->GetProfileCount();
+		// Add parameter sets from profiles. With a laser assignment, every profile has one parameter set per laser,
+		// the set of the profile's own laser keeps the UUID and name of the profile
+		m_ParameterSetsBySourceIndex.clear();
+		m_ParameterSetsByID.clear();
+		m_LaserParameterSets.clear();
+		m_bRetimeCachedLayers = true;
+		uint32_t nProfileCount = pSource->getProfileCount();
 		for (uint32_t nProfileIndex = 0; nProfileIndex < nProfileCount; nProfileIndex++) {
-			auto pProfile = pToolpath->GetProfile(nProfileIndex);
-			std::string sUUID = pProfile->GetUUID();
-			std::string sProfileName = pProfile->GetName();
-
-			int64_t nLaserIndex = pProfile->GetParameterIntegerValueDef("", "laserindex", 0);
-			double dLaserSpeed = pProfile->GetParameterDoubleValue("", "laserspeed");
-			double dLaserPower = pProfile->GetParameterDoubleValue("", "laserpower");
-			double dJumpSpeed = pProfile->GetParameterDoubleValueDef("", "jumpspeed", dLaserSpeed);
-
-			auto pParameterSet = m_pMatJobWriter->addParameterSet(sUUID, sProfileName, (uint32_t)nLaserIndex, 
-				dLaserSpeed, 0, m_dGlobalLaserDiameter, dLaserPower, dJumpSpeed);
-
-			auto nParameterCount = pProfile->GetParameterCount();
-			for (uint32_t nParameterIndex = 0; nParameterIndex < nParameterCount; nParameterIndex++) {
-				std::string sParameterName = pProfile->GetParameterName(nParameterIndex);
-				std::string sParameterNamespace = pProfile->GetParameterNameSpace(nParameterIndex);				
-
-				if (sParameterNamespace == MATJOB_3MFNAMESPACEDOUBLE) {
-					double dParameterValue = pProfile->GetParameterDoubleValue(sParameterNamespace, sParameterName);
-					pParameterSet->addProperty(sParameterName, std::to_string(dParameterValue), eMatJobPropertyType::mjpDouble);
-				}
-				
-				if (sParameterNamespace == MATJOB_3MFNAMESPACEINTEGER) {
-					int64_t nParameterValue = pProfile->GetParameterIntegerValue(sParameterNamespace, sParameterName);
-					pParameterSet->addProperty(sParameterName, std::to_string(nParameterValue), eMatJobPropertyType::mjpInteger);
-				}
+			auto& profile = pSource->getProfile(nProfileIndex);
+			std::string sUUID = profile.getUUID();
+			std::string sProfileName = profile.getName();
+
+			int64_t nLaserIndex = profile.getParameterIntegerValueDef("", "laserindex", 0);
+			double dLaserSpeed = profile.getParameterDoubleValue("", "laserspeed");
+			double dLaserPower = profile.getParameterDoubleValue("", "laserpower");
+			double dJumpSpeed = profile.getParameterDoubleValueDef("", "jumpspeed", dLaserSpeed);
+
+			// Delays are given in microseconds
+			sMatJobScanTimeParameters scanTimeParameters;
+			scanTimeParameters.m_dJumpDelay = profile.getParameterDoubleValueDef(MATJOB_3MFNAMESPACEDOUBLE, "jumpdelay", 0.0) * 1.0e-6;
+			scanTimeParameters.m_dMarkDelay = profile.getParameterDoubleValueDef(MATJOB_3MFNAMESPACEDOUBLE, "markdelay", 0.0) * 1.0e-6;
+			scanTimeParameters.m_dPolygonDelay = profile.getParameterDoubleValueDef(MATJOB_3MFNAMESPACEDOUBLE, "polygondelay", 0.0) * 1.0e-6;
+			scanTimeParameters.m_dAcceleration = profile.getParameterDoubleValueDef(MATJOB_3MFNAMESPACEDOUBLE, "acceleration", 0.0);
+			scanTimeParameters.m_dSkywritingTime = profile.getParameterDoubleValueDef(MATJOB_3MFNAMESPACEDOUBLE, "skywritingtime", 0.0) * 1.0e-6;
+			scanTimeParameters.m_bSkywriting = (profile.getParameterDoubleValueDef(MATJOB_3MFNAMESPACEDOUBLE, "skywriting", 0.0) != 0.0);
+			if (!m_pScanTimeModel->isDistanceOverSpeed(scanTimeParameters))
+				m_bRetimeCachedLayers = false;
+
+			std::vector<uint32_t> laserIndices;
+			if (m_pLaserAssignment.get() != nullptr) {
+				for (uint32_t nAssignedLaserIndex = 0; nAssignedLaserIndex < m_pLaserAssignment->getLaserCount(); nAssignedLaserIndex++)
+					laserIndices.push_back(nAssignedLaserIndex);
+			}
+			else {
+				laserIndices.push_back((uint32_t)nLaserIndex);
+			}
 
+			for (uint32_t nParameterSetLaserIndex : laserIndices) {
+				bool bIsProfileLaser = (nParameterSetLaserIndex == (uint32_t)nLaserIndex);
+				std::string sParameterSetUUID = bIsProfileLaser ? sUUID : CMatJobLaserAssignment::makeLaserParameterSetUUID(sUUID, nParameterSetLaserIndex);
+				std::string sParameterSetName = bIsProfileLaser ? sProfileName : sProfileName + " (laser " + std::to_string(nParameterSetLaserIndex) + ")";
+
+				auto pParameterSet = m_pMatJobWriter->addParameterSet(sParameterSetUUID, sParameterSetName, nParameterSetLaserIndex,
+					dLaserSpeed, 0, m_dGlobalLaserDiameter, dLaserPower, dJumpSpeed);
+				pParameterSet->setScanTimeParameters(scanTimeParameters);
+				if (bIsProfileLaser)
+					m_ParameterSetsBySourceIndex.push_back(pParameterSet.get());
+				if (m_pLaserAssignment.get() != nullptr)
+					m_LaserParameterSets.push_back(pParameterSet.get());
+				m_ParameterSetsByID.insert(std::make_pair(pParameterSet->getID(), pParameterSet.get()));
+
+				auto nParameterCount = profile.getParameterCount();
+				for (uint32_t nParameterIndex = 0; nParameterIndex < nParameterCount; nParameterIndex++) {
+					auto& parameter = profile.getParameter(nParameterIndex);
+
+					if (parameter.m_sNameSpace == MATJOB_3MFNAMESPACEDOUBLE) {
+						double dParameterValue = profile.getParameterDoubleValue(parameter.m_sNameSpace, parameter.m_sName);
+						pParameterSet->addProperty(parameter.m_sName, std::to_string(dParameterValue), eMatJobPropertyType::mjpDouble);
+					}
+
+					if (parameter.m_sNameSpace == MATJOB_3MFNAMESPACEINTEGER) {
+						int64_t nParameterValue = profile.getParameterIntegerValue(parameter.m_sNameSpace, parameter.m_sName);
+						pParameterSet->addProperty(parameter.m_sName, std::to_string(nParameterValue), eMatJobPropertyType::mjpInteger);
+					}
+
+				}
 			}
 		}
 	}
 
-	void CToolpathExporter_Matjob::processLayer(uint32_t nLayerIndex, Lib3MF::PToolpathLayerReader pLayerReader)
+	void CToolpathExporter_Matjob::processLayer(const CToolpathLayerData& layerData)
 	{
-		double dZValue = m_pToolpath->GetLayerZMin(nLayerIndex) * m_dUnits;
+		uint32_t nLayerIndex = layerData.getLayerIndex();
+		double dZValue = layerData.getZMin();
 
-		// Start a new binary file batch if needed
-		if (nLayerIndex % m_nLayersPerBatch == 0) {
+		if ((nLayerIndex < m_nFirstLayer) || (nLayerIndex >= m_nEndLayer))
+			throw std::runtime_error("layer " + std::to_string(nLayerIndex) + " is outside of the exported layer range");
+
+		// Start a new binary file batch if needed. Batches are counted from the first layer of a slice.
+		if ((m_pCurrentFile.get() == nullptr) || ((nLayerIndex - m_nFirstLayer) % m_nLayersPerBatch == 0)) {
 			uint32_t nLayerEndIndexOfBatch = nLayerIndex + m_nLayersPerBatch - 1;
-			if (nLayerEndIndexOfBatch >= m_nLayerCount)
-				nLayerEndIndexOfBatch = m_nLayerCount - 1;
+			if (nLayerEndIndexOfBatch >= m_nEndLayer)
+				nLayerEndIndexOfBatch = m_nEndLayer - 1;
 
-			double dFromZValueInMM = m_pToolpath->GetLayerZMin(nLayerIndex) * m_dUnits;
+			double dFromZValueInMM = layerData.getZMin();
 			int64_t nFromZValueInMicron = (int64_t)round(dFromZValueInMM * 1000.0);
 
-			double dToZValueInMM = m_pToolpath->GetLayerZMax(nLayerEndIndexOfBatch) * m_dUnits;
+			double dToZValueInMM = m_pSource->getLayerZMax(nLayerEndIndexOfBatch);
 			int64_t nToValueInMicron = (int64_t)round(dToZValueInMM * 1000.0);
 
 			m_pCurrentFile = m_pMatJobWriter->beginBinaryFile(
 				"layer_from_" + std::to_string(nFromZValueInMicron) + "_to_" + std::to_string(nToValueInMicron) + ".bin");
 		}
 
+		CToolpathScopedTimer encodeTimer(m_pStatistics.get(), eToolpathStatisticsPhase::Encode);
+
+		std::string sCacheKey;
+		if (m_pLayerCache.get() != nullptr) {
+			sCacheKey = computeLayerCacheKey(layerData);
+			if (m_pLayerCache->lookup(sCacheKey, m_CachedLayer)) {
+				auto pMatJobLayer = m_pMatJobWriter->beginNewLayer(dZValue);
+				spliceCachedLayer(pMatJobLayer.get(), dZValue);
+				if (m_pLaserAssignment.get() != nullptr)
+					recordLaserTimes(pMatJobLayer.get());
+				return;
+			}
+		}
+
+		if (m_pLaserAssignment.get() != nullptr)
+			m_pLaserAssignment->assignLayer(layerData, m_SegmentLasers);
+
+		uint64_t nLayerStartPosition = m_pCurrentFile->getCurrentFileSize();
 		m_pCurrentFile->beginLayer(dZValue);
 		auto pMatJobLayer = m_pMatJobWriter->beginNewLayer(dZValue);
 
-		uint32_t nSegmentCount = pLayerReader->GetSegmentCount();
-
+		// Map Profile and Part references
+		uint32_t nSegmentCount = layerData.getSegmentCount();
+		m_SegmentParameterSets.resize(nSegmentCount);
+		m_SegmentParameterSetIDs.resize(nSegmentCount);
 		for (uint32_t nSegmentIndex = 0; nSegmentIndex < nSegmentCount; nSegmentIndex++) {
-			Lib3MF::eToolpathSegmentType segmentType;
-			uint32_t nPointCount = 0;
-			pLayerReader->GetSegmentInfo(nSegmentIndex, segmentType, nPointCount);
+			auto& segment = layerData.getSegment(nSegmentIndex);
+
+			if (segment.m_nPartIndex >= m_PartsBySourceIndex.size())
+				throw std::runtime_error("toolpath segment has no valid build item reference");
+			if (segment.m_nProfileIndex >= m_ParameterSetsBySourceIndex.size())
+				throw std::runtime_error("toolpath segment has no valid profile reference");
+
+			auto pMatJobParameterSet = m_ParameterSetsBySourceIndex[segment.m_nProfileIndex];
+			if (m_pLaserAssignment.get() != nullptr)
+				pMatJobParameterSet = m_LaserParameterSets[segment.m_nProfileIndex * m_pLaserAssignment->getLaserCount() + m_SegmentLasers[nSegmentIndex]];
+
+			m_SegmentParameterSets[nSegmentIndex] = pMatJobParameterSet;
+			m_SegmentParameterSetIDs[nSegmentIndex] = pMatJobParameterSet->getID();
+		}
+
+		m_BlockPlanner.planLayer(layerData, m_SegmentParameterSetIDs, m_PlannedBlocks);
 
-			// Map Profile and Part references
-			std::string sProfileUUID = pLayerReader->GetSegmentDefaultProfileUUID(nSegmentIndex);
-			std::string sBuildItemUUID = pLayerReader->GetSegmentBuildItemUUID(nSegmentIndex);
-			auto pMatJobPart = m_pMatJobWriter->findPartByBuildItemUUID(sBuildItemUUID);
-			auto pMatJobParameterSet = m_pMatJobWriter->findParameterSetByUUID(sProfileUUID);
+		for (auto& block : m_PlannedBlocks) {
+			auto& segment = layerData.getSegment(block.m_nFirstSegmentIndex);
+			auto pMatJobPart = m_PartsBySourceIndex[segment.m_nPartIndex];
+			auto pMatJobParameterSet = m_SegmentParameterSets[block.m_nFirstSegmentIndex];
 
 			pMatJobPart->addCoordinatesZ(dZValue);
 
 			double dMarkSpeed = pMatJobParameterSet->getLaserSpeed();
 			double dJumpSpeed = pMatJobParameterSet->getJumpSpeed();
 
-			switch (segmentType) {
-			case Lib3MF::eToolpathSegmentType::Loop:
-			case Lib3MF::eToolpathSegmentType::Polyline:
+			switch (block.m_Type) {
+			case eToolpathSegmentType::Loop:
+			case eToolpathSegmentType::Polyline:
 			{
-				std::vector<Lib3MF::sPosition2D> points;
-				pLayerReader->GetSegmentPointDataInModelUnits(nSegmentIndex, points);
-
-				if (points.size() != nPointCount)
-					throw std::runtime_error("Point count mismatch reading polyline segment");
-				if (nPointCount < 2)
+				// Loops are already closed by the source
+				if (block.m_nElementCount < 2)
 					throw std::runtime_error("Invalid point count in polyline segment");
 
-				if (segmentType == Lib3MF::eToolpathSegmentType::Loop) {
-					// Convert loop to polyline by closing it if not already closed
-					auto firstPoint = points.at(0);
-					auto lastPoint = points.at(points.size() - 1);
-					if ((firstPoint.m_Coordinates[0] != lastPoint.m_Coordinates[0]) || 
-						(firstPoint.m_Coordinates[1] != lastPoint.m_Coordinates[1])) {
-						points.push_back(firstPoint);
-					}
-				}
-
 				pMatJobLayer->addPolylineDataBlock(pMatJobPart, m_pCurrentFile.get(), pMatJobPart->getPartID(),
-					pMatJobParameterSet->getID(), points, dMarkSpeed, dJumpSpeed);
+					pMatJobParameterSet->getID(), layerData.getSegmentPoints(segment) + block.m_nFirstElementOffset, block.m_nElementCount, dMarkSpeed, dJumpSpeed,
+					pMatJobParameterSet->getScanTimeParameters());
 				break;
 			}
 
-			case Lib3MF::eToolpathSegmentType::Hatch:
+			case eToolpathSegmentType::Hatch:
 			{
-				std::vector<Lib3MF::sHatch2D> hatches;
-				pLayerReader->GetSegmentHatchDataInModelUnits(nSegmentIndex, hatches);
+				const sToolpathHatch2D* pHatches = layerData.getSegmentHatches(segment) + block.m_nFirstElementOffset;
+
+				// Joined segments are usually stored back to back, otherwise their hatches are gathered
+				if (block.m_nSegmentCount > 1) {
+					bool bIsContiguous = true;
+					uint64_t nNextElementIndex = (uint64_t)segment.m_nFirstElementIndex + segment.m_nElementCount;
+					for (uint32_t nBlockSegment = 1; nBlockSegment < block.m_nSegmentCount; nBlockSegment++) {
+						auto& blockSegment = layerData.getSegment(block.m_nFirstSegmentIndex + nBlockSegment);
+						if ((blockSegment.m_nElementCount > 0) && (blockSegment.m_nFirstElementIndex != nNextElementIndex)) {
+							bIsContiguous = false;
+							break;
+						}
+						nNextElementIndex += blockSegment.m_nElementCount;
+					}
 
-				if (hatches.size() * 2 != nPointCount)
-					throw std::runtime_error("Point count mismatch reading hatch segment");
-				if (nPointCount < 2)
-					throw std::runtime_error("Invalid point count in hatch segment");
+					if (!bIsContiguous) {
+						m_BlockHatches.clear();
+						for (uint32_t nBlockSegment = 0; nBlockSegment < block.m_nSegmentCount; nBlockSegment++) {
+							auto& blockSegment = layerData.getSegment(block.m_nFirstSegmentIndex + nBlockSegment);
+							if (blockSegment.m_nElementCount > 0) {
+								auto pSegmentHatches = layerData.getSegmentHatches(blockSegment);
+								m_BlockHatches.insert(m_BlockHatches.end(), pSegmentHatches, pSegmentHatches + blockSegment.m_nElementCount);
+							}
+						}
+						pHatches = m_BlockHatches.data();
+					}
+				}
 
 				pMatJobLayer->addHatchDataBlock(pMatJobPart, m_pCurrentFile.get(), pMatJobPart->getPartID(),
-					pMatJobParameterSet->getID(), hatches, dMarkSpeed, dJumpSpeed);
+					pMatJobParameterSet->getID(), pHatches, block.m_nElementCount, dMarkSpeed, dJumpSpeed,
+					pMatJobParameterSet->getScanTimeParameters());
 				break;
 			}
 
@@ -233,13 +373,330 @@ namespace Toolpath {
 		}
 
 		m_pCurrentFile->finishLayer();
+
+		if (m_pLayerCache.get() != nullptr)
+			storeCachedLayer(sCacheKey, layerData, pMatJobLayer.get(), nLayerStartPosition);
+
+		if (m_pLaserAssignment.get() != nullptr)
+			recordLaserTimes(pMatJobLayer.get());
+	}
+
+	void CToolpathExporter_Matjob::recordLaserTimes(CMatJobLayer* pMatJobLayer)
+	{
+		// The scan field of a parameter set is its laser. The jump into a data block is counted for the laser
+		// of the block, from the end of the previous block of the layer.
+		m_LaserTimes.assign(m_pLaserAssignment->getLaserCount(), 0.0);
+
+		uint32_t nDataBlockCount = pMatJobLayer->getDataBlockCount();
+		for (uint32_t nIndex = 0; nIndex < nDataBlockCount; nIndex++) {
+			auto& dataBlock = pMatJobLayer->getDataBlock(nIndex);
+			auto& scanDistance = pMatJobLayer->getScanDistance(nIndex);
+
+			auto pMatJobParameterSet = findParameterSetByID(dataBlock.m_nParameterSetID);
+			uint32_t nLaserIndex = pMatJobParameterSet->getScanFieldID();
+			if (nLaserIndex >= m_LaserTimes.size())
+				throw std::runtime_error("parameter set " + pMatJobParameterSet->getName() + " has no laser");
+
+			m_LaserTimes[nLaserIndex] += scanDistance.m_dScanTime;
+		}
+
+		m_pLaserAssignment->recordLayer(m_LaserTimes);
+	}
+
+	CMatJobPart* CToolpathExporter_Matjob::findPartByID(uint32_t nPartID)
+	{
+		auto iPartIter = m_PartsByID.find(nPartID);
+		if (iPartIter != m_PartsByID.end())
+			return iPartIter->second;
+
+		throw std::runtime_error("cached layer references unknown part " + std::to_string(nPartID));
+	}
+
+	CMatJobParameterSet* CToolpathExporter_Matjob::findParameterSetByID(uint32_t nParameterSetID)
+	{
+		auto iParameterSetIter = m_ParameterSetsByID.find(nParameterSetID);
+		if (iParameterSetIter != m_ParameterSetsByID.end())
+			return iParameterSetIter->second;
+
+		throw std::runtime_error("cached layer references unknown parameter set " + std::to_string(nParameterSetID));
+	}
+
+	std::string CToolpathExporter_Matjob::computeLayerCacheKey(const CToolpathLayerData& layerData)
+	{
+		uint64_t nHash = CMatJobLayerCache::getInitialHash();
+
+		double dZValue = layerData.getZMin();
+		nHash = CMatJobLayerCache::hashData(nHash, &dZValue, sizeof(dZValue));
+
+		// Scan times that cannot be re-timed from the distances depend on the speeds and delays of all parameter sets
+		if (!m_bRetimeCachedLayers) {
+			std::string sScanTimeModelName = m_pScanTimeModel->getName();
+			nHash = CMatJobLayerCache::hashData(nHash, sScanTimeModelName.data(), sScanTimeModelName.size());
+			for (auto& parameterSetIter : m_ParameterSetsByID) {
+				double speeds[2];
+				speeds[0] = parameterSetIter.second->getLaserSpeed();
+				speeds[1] = parameterSetIter.second->getJumpSpeed();
+				auto& scanTimeParameters = parameterSetIter.second->getScanTimeParameters();
+				double timeParameters[6] = { scanTimeParameters.m_dJumpDelay, scanTimeParameters.m_dMarkDelay, scanTimeParameters.m_dPolygonDelay,
+					scanTimeParameters.m_dAcceleration, scanTimeParameters.m_dSkywritingTime, scanTimeParameters.m_bSkywriting ? 1.0 : 0.0 };
+				nHash = CMatJobLayerCache::hashData(nHash, speeds, sizeof(speeds));
+				nHash = CMatJobLayerCache::hashData(nHash, timeParameters, sizeof(timeParameters));
+			}
+		}
+
+		// The parameter sets of the data blocks depend on the laser assignment
+		if (m_pLaserAssignment.get() != nullptr) {
+			uint64_t nFingerprint = m_pLaserAssignment->getFingerprint();
+			nHash = CMatJobLayerCache::hashData(nHash, &nFingerprint, sizeof(nFingerprint));
+		}
+
+		// Joined hatch segments change the data blocks
+		uint32_t nHatchTargetCount = m_BlockPlanner.getHatchTargetCount();
+		if (nHatchTargetCount > 0)
+			nHash = CMatJobLayerCache::hashData(nHash, &nHatchTargetCount, sizeof(nHatchTargetCount));
+
+		for (auto& segment : layerData.getSegments()) {
+			if (segment.m_nPartIndex >= m_PartsBySourceIndex.size())
+				throw std::runtime_error("toolpath segment has no valid build item reference");
+			if (segment.m_nProfileIndex >= m_ParameterSetsBySourceIndex.size())
+				throw std::runtime_error("toolpath segment has no valid profile reference");
+
+			// IDs of the output, which are stored in the cached data blocks
+			uint32_t segmentHeader[4];
+			segmentHeader[0] = (uint32_t)segment.m_Type;
+			segmentHeader[1] = m_PartsBySourceIndex[segment.m_nPartIndex]->getPartID();
+			segmentHeader[2] = m_ParameterSetsBySourceIndex[segment.m_nProfileIndex]->getID();
+			segmentHeader[3] = segment.m_nElementCount;
+			nHash = CMatJobLayerCache::hashData(nHash, segmentHeader, sizeof(segmentHeader));
+
+			switch (segment.m_Type) {
+			case eToolpathSegmentType::Loop:
+			case eToolpathSegmentType::Polyline:
+				nHash = CMatJobLayerCache::hashData(nHash, layerData.getSegmentPoints(segment), segment.m_nElementCount * sizeof(sToolpathPoint2D));
+				break;
+
+			case eToolpathSegmentType::Hatch:
+				nHash = CMatJobLayerCache::hashData(nHash, layerData.getSegmentHatches(segment), segment.m_nElementCount * sizeof(sToolpathHatch2D));
+				break;
+
+			default:
+				break;
+			}
+		}
+
+		return CMatJobLayerCache::makeKey(layerData.getLayerDataUUID(), nHash);
+	}
+
+	void CToolpathExporter_Matjob::spliceCachedLayer(CMatJobLayer* pMatJobLayer, double dZValue)
+	{
+		uint64_t nLayerStartPosition = m_pCurrentFile->getCurrentFileSize();
+		m_pCurrentFile->writeRaw(m_CachedLayer.m_LayerData.data(), (uint32_t)m_CachedLayer.m_LayerData.size());
+
+		// The scan time depends on the speeds of the current parameter sets, unless the cache key covers them
+		double dLayerScanTime = 0.0;
+		size_t nDataBlockCount = m_CachedLayer.m_DataBlocks.size();
+		for (size_t nIndex = 0; nIndex < nDataBlockCount; nIndex++) {
+			sMatJobDataBlock dataBlock = m_CachedLayer.m_DataBlocks[nIndex];
+			auto& scanDistance = m_CachedLayer.m_ScanDistances[nIndex];
+
+			if (m_bRetimeCachedLayers) {
+				auto pMatJobParameterSet = findParameterSetByID(dataBlock.m_nParameterSetID);
+				double dMarkSpeed = pMatJobParameterSet->getLaserSpeed();
+				double dJumpSpeed = pMatJobParameterSet->getJumpSpeed();
+				scanDistance.m_dScanTime = 0.0;
+				if (dMarkSpeed > 0.0)
+					scanDistance.m_dScanTime += scanDistance.m_dMarkDistance / dMarkSpeed;
+				if (dJumpSpeed > 0.0)
+					scanDistance.m_dScanTime += scanDistance.m_dJumpDistance / dJumpSpeed;
+			}
+			dLayerScanTime += scanDistance.m_dScanTime;
+
+			dataBlock.m_nFileID = m_pCurrentFile->getFileID();
+			dataBlock.m_nDataPosition += nLayerStartPosition;
+			pMatJobLayer->addDataBlock(dataBlock, scanDistance);
+		}
+
+		pMatJobLayer->restoreSummary(dLayerScanTime, m_CachedLayer.m_dTotalMarkDistance, m_CachedLayer.m_dTotalJumpDistance,
+			m_CachedLayer.m_dMinX, m_CachedLayer.m_dMinY, m_CachedLayer.m_dMaxX, m_CachedLayer.m_dMaxY);
+
+		for (auto& partBounds : m_CachedLayer.m_PartBounds) {
+			auto pMatJobPart = findPartByID(partBounds.m_nPartID);
+			pMatJobPart->addCoordinatesZ(dZValue);
+			pMatJobPart->addCoordinatesXY(partBounds.m_dMinX, partBounds.m_dMinY);
+			pMatJobPart->addCoordinatesXY(partBounds.m_dMaxX, partBounds.m_dMaxY);
+		}
+	}
+
+	void CToolpathExporter_Matjob::storeCachedLayer(const std::string& sCacheKey, const CToolpathLayerData& layerData, CMatJobLayer* pMatJobLayer, uint64_t nLayerStartPosition)
+	{
+		m_CachedLayer.m_dTotalMarkDistance = pMatJobLayer->getTotalMarkDistance();
+		m_CachedLayer.m_dTotalJumpDistance = pMatJobLayer->getTotalJumpDistance();
+		m_CachedLayer.m_dMinX = pMatJobLayer->getMinX();
+		m_CachedLayer.m_dMinY = pMatJobLayer->getMinY();
+		m_CachedLayer.m_dMaxX = pMatJobLayer->getMaxX();
+		m_CachedLayer.m_dMaxY = pMatJobLayer->getMaxY();
+
+		m_CachedLayer.m_DataBlocks.clear();
+		m_CachedLayer.m_ScanDistances.clear();
+		uint32_t nDataBlockCount = pMatJobLayer->getDataBlockCount();
+		for (uint32_t nIndex = 0; nIndex < nDataBlockCount; nIndex++) {
+			sMatJobDataBlock dataBlock = pMatJobLayer->getDataBlock(nIndex);
+			dataBlock.m_nFileID = 0;
+			dataBlock.m_nDataPosition -= nLayerStartPosition;
+			m_CachedLayer.m_DataBlocks.push_back(dataBlock);
+			m_CachedLayer.m_ScanDistances.push_back(pMatJobLayer->getScanDistance(nIndex));
+		}
+
+		// Part bounds of this layer, as added to the parts by the data blocks
+		std::map<uint32_t, sMatJobCachedPartBounds> partBoundsByID;
+		for (auto& segment : layerData.getSegments()) {
+			if (segment.m_nElementCount == 0)
+				continue;
+
+			double dFirstX, dFirstY;
+			switch (segment.m_Type) {
+			case eToolpathSegmentType::Loop:
+			case eToolpathSegmentType::Polyline:
+				dFirstX = layerData.getSegmentPoints(segment)->m_Coordinates[0];
+				dFirstY = layerData.getSegmentPoints(segment)->m_Coordinates[1];
+				break;
+			case eToolpathSegmentType::Hatch:
+				dFirstX = layerData.getSegmentHatches(segment)->m_Point1Coordinates[0];
+				dFirstY = layerData.getSegmentHatches(segment)->m_Point1Coordinates[1];
+				break;
+			default:
+				continue;
+			}
+
+			uint32_t nPartID = m_PartsBySourceIndex[segment.m_nPartIndex]->getPartID();
+			auto iBoundsIter = partBoundsByID.find(nPartID);
+			if (iBoundsIter == partBoundsByID.end()) {
+				sMatJobCachedPartBounds newBounds;
+				newBounds.m_nPartID = nPartID;
+				newBounds.m_dMinX = dFirstX;
+				newBounds.m_dMinY = dFirstY;
+				newBounds.m_dMaxX = dFirstX;
+				newBounds.m_dMaxY = dFirstY;
+				iBoundsIter = partBoundsByID.insert(std::make_pair(nPartID, newBounds)).first;
+			}
+
+			auto& partBounds = iBoundsIter->second;
+			if (segment.m_Type == eToolpathSegmentType::Hatch) {
+				auto pHatches = layerData.getSegmentHatches(segment);
+				for (uint32_t nIndex = 0; nIndex < segment.m_nElementCount; nIndex++) {
+					addCachedPartBounds(partBounds, pHatches[nIndex].m_Point1Coordinates[0], pHatches[nIndex].m_Point1Coordinates[1]);
+					addCachedPartBounds(partBounds, pHatches[nIndex].m_Point2Coordinates[0], pHatches[nIndex].m_Point2Coordinates[1]);
+				}
+			}
+			else {
+				auto pPoints = layerData.getSegmentPoints(segment);
+				for (uint32_t nIndex = 0; nIndex < segment.m_nElementCount; nIndex++)
+					addCachedPartBounds(partBounds, pPoints[nIndex].m_Coordinates[0], pPoints[nIndex].m_Coordinates[1]);
+			}
+		}
+
+		m_CachedLayer.m_PartBounds.clear();
+		for (auto& boundsIter : partBoundsByID)
+			m_CachedLayer.m_PartBounds.push_back(boundsIter.second);
+
+		m_pCurrentFile->copyData(nLayerStartPosition, m_pCurrentFile->getCurrentFileSize(), m_CachedLayer.m_LayerData);
+
+		m_pLayerCache->store(sCacheKey, m_CachedLayer);
 	}
 
 	void CToolpathExporter_Matjob::finalize()
 	{
+		if ((m_pLaserAssignment.get() != nullptr) && (m_pStatistics.get() != nullptr))
+			m_pLaserAssignment->writeStatistics(*m_pStatistics);
+
+		// Data blocks of the encoded layers, layers taken from the cache are not planned again
+		if ((m_pStatistics.get() != nullptr) && ((m_BlockPlanner.getHatchTargetCount() > 0) || (m_BlockPlanner.getSplitSegmentCount() > 0))) {
+			m_pStatistics->setProcessingValue("matjobBlocks", "dataBlocks", (double)m_BlockPlanner.getBlockCount());
+			m_pStatistics->setProcessingValue("matjobBlocks", "splitSegments", (double)m_BlockPlanner.getSplitSegmentCount());
+			m_pStatistics->setProcessingValue("matjobBlocks", "joinedSegments", (double)m_BlockPlanner.getJoinedSegmentCount());
+		}
+
+		if (m_bIsSlice) {
+			sMatJobSliceRange sliceRange;
+			sliceRange.m_nLayerCount = m_nLayerCount;
+			sliceRange.m_nFirstLayerIndex = m_nFirstLayer;
+			sliceRange.m_nEndLayerIndex = m_nEndLayer;
+			m_pMatJobWriter->finalizeSlice(sliceRange);
+			return;
+		}
+
+		if (m_nMergedLayerEnd != m_nMergedLayerCount)
+			throw std::runtime_error("merged slices end at layer " + std::to_string(m_nMergedLayerEnd) + " of " + std::to_string(m_nMergedLayerCount));
+
 		m_pMatJobWriter->writeJobMetaData();
 		m_pMatJobWriter->writeContent();
 		m_pMatJobWriter->finalize();
+
+		if (m_pStatistics.get() != nullptr)
+			m_pStatistics->setOutputSize(m_pExportStream->getPosition());
+	}
+
+	void CToolpathExporter_Matjob::setLayerCache(PMatJobLayerCache pLayerCache)
+	{
+		m_pLayerCache = pLayerCache;
+	}
+
+	void CToolpathExporter_Matjob::setLaserAssignment(PMatJobLaserAssignment pLaserAssignment)
+	{
+		if (m_pSource.get() != nullptr)
+			throw std::runtime_error("laser assignment must be set before beginExport");
+
+		m_pLaserAssignment = pLaserAssignment;
+	}
+
+	void CToolpathExporter_Matjob::setScanTimeModel(PMatJobScanTimeModel pScanTimeModel)
+	{
+		if (m_pMatJobWriter.get() != nullptr)
+			throw std::runtime_error("scan time model must be set before initialize");
+		if (pScanTimeModel.get() == nullptr)
+			throw std::runtime_error("Invalid scan time model");
+
+		m_pScanTimeModel = pScanTimeModel;
+	}
+
+	void CToolpathExporter_Matjob::setHatchBlockTarget(uint32_t nHatchTargetCount)
+	{
+		if (m_pSource.get() != nullptr)
+			throw std::runtime_error("hatch block target must be set before beginExport");
+
+		m_BlockPlanner.setHatchTargetCount(nHatchTargetCount);
+	}
+
+	void CToolpathExporter_Matjob::setLayerRange(uint32_t nFirstLayer, uint32_t nEndLayer)
+	{
+		if (m_pMatJobWriter.get() != nullptr)
+			throw std::runtime_error("layer range must be set before initialize");
+		if (nFirstLayer >= nEndLayer)
+			throw std::runtime_error("layer range " + std::to_string(nFirstLayer) + ":" + std::to_string(nEndLayer) + " is empty");
+
+		m_bIsSlice = true;
+		m_nFirstLayer = nFirstLayer;
+		m_nEndLayer = nEndLayer;
+	}
+
+	void CToolpathExporter_Matjob::mergeSlice(const std::string& sSliceDirectory)
+	{
+		if (m_pMatJobWriter.get() == nullptr)
+			throw std::runtime_error("exporter has not been initialized");
+		if (m_bIsSlice || (m_pSource.get() != nullptr))
+			throw std::runtime_error("slices can only be merged into a new job");
+
+		sMatJobSliceRange sliceRange = m_pMatJobWriter->mergeSlice(sSliceDirectory);
+
+		if (m_nMergedLayerEnd == 0)
+			m_nMergedLayerCount = sliceRange.m_nLayerCount;
+
+		if (sliceRange.m_nLayerCount != m_nMergedLayerCount)
+			throw std::runtime_error("slice " + sSliceDirectory + " belongs to a job with a different layer count");
+		if (sliceRange.m_nFirstLayerIndex != m_nMergedLayerEnd)
+			throw std::runtime_error("slice " + sSliceDirectory + " starts at layer " + std::to_string(sliceRange.m_nFirstLayerIndex) + ", expected " + std::to_string(m_nMergedLayerEnd));
+
+		m_nMergedLayerEnd = sliceRange.m_nEndLayerIndex;
 	}
 
 	void CToolpathExporter_Matjob::setLayersPerBatch(uint32_t nLayersPerBatch)
@@ -252,5 +709,13 @@ namespace Toolpath {
 		m_dGlobalLaserDiameter = dDiameter;
 	}
 
+	void CToolpathExporter_Matjob::setThreadCount(uint32_t nThreadCount)
+	{
+		if (m_pMatJobWriter.get() != nullptr)
+			throw std::runtime_error("thread count must be set before initialize");
+
+		m_nThreadCount = nThreadCount;
+	}
+
 } // namespace Toolpath
 
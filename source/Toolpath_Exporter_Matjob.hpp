@@ -34,9 +34,14 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <sstream>
 #include <cmath>
 #include <stdexcept>
+#include <map>
 
 #include "Toolpath_MatjobWriter.hpp"
 #include "Toolpath_MatjobBinaryFile.hpp"
+#include "Toolpath_MatjobLayerCache.hpp"
+#include "Toolpath_MatjobLaserAssignment.hpp"
+#include "Toolpath_MatjobBlockPlanner.hpp"
+#include "Toolpath_ThreadPool.hpp"
 #include "Common/NMR_StringUtils.h"
 #include "Common/Platform/NMR_ExportStream_Native.h"
 
@@ -52,26 +57,120 @@ namespace Toolpath {
 		NMR::PExportStream m_pExportStream;
 
 		// Cached toolpath info
-		Lib3MF::PToolpath m_pToolpath;
-		double m_dUnits;
+		PToolpathSource m_pSource;
 		uint32_t m_nLayerCount;
 		uint32_t m_nLayersPerBatch;
 		PMatJobBinaryFile m_pCurrentFile;
 
+		// Layer range [m_nFirstLayer, m_nEndLayer) of a job slice
+		bool m_bIsSlice;
+		uint32_t m_nFirstLayer;
+		uint32_t m_nEndLayer;
+
+		// Layers of the merged slices, which must be contiguous
+		uint32_t m_nMergedLayerCount;
+		uint32_t m_nMergedLayerEnd;
+
 		double m_dGlobalLaserDiameter;
 
+		// MatJob parts and parameter sets by source part and profile index
+		std::vector<CMatJobPart*> m_PartsBySourceIndex;
+		std::vector<CMatJobParameterSet*> m_ParameterSetsBySourceIndex;
+		std::map<uint32_t, CMatJobPart*> m_PartsByID;
+		std::map<uint32_t, CMatJobParameterSet*> m_ParameterSetsByID;
+
+		// Parameter sets by source profile index * laser count + laser index, and the laser of every segment of a layer
+		PMatJobLaserAssignment m_pLaserAssignment;
+		std::vector<CMatJobParameterSet*> m_LaserParameterSets;
+		std::vector<uint32_t> m_SegmentLasers;
+		std::vector<double> m_LaserTimes;
+
+		// Cached layers are re-timed from their distances if every parameter set is timed by distance over speed
+		PMatJobScanTimeModel m_pScanTimeModel;
+		bool m_bRetimeCachedLayers;
+
+		// Data blocks of a layer and the parameter set of every segment, joined hatches are gathered in m_BlockHatches
+		CMatJobBlockPlanner m_BlockPlanner;
+		std::vector<sMatJobPlannedBlock> m_PlannedBlocks;
+		std::vector<CMatJobParameterSet*> m_SegmentParameterSets;
+		std::vector<uint32_t> m_SegmentParameterSetIDs;
+		std::vector<sToolpathHatch2D> m_BlockHatches;
+
+		uint32_t m_nThreadCount;
+		PToolpathThreadPool m_pThreadPool;
+
+		PToolpathStatistics m_pStatistics;
+
+		// Encoded layers of earlier conversions, reused when geometry and IDs are unchanged
+		PMatJobLayerCache m_pLayerCache;
+		sMatJobCachedLayer m_CachedLayer;
+
+		CMatJobPart* findPartByID(uint32_t nPartID);
+		CMatJobParameterSet* findParameterSetByID(uint32_t nParameterSetID);
+
+		std::string computeLayerCacheKey(const CToolpathLayerData& layerData);
+		void spliceCachedLayer(CMatJobLayer* pMatJobLayer, double dZValue);
+		void storeCachedLayer(const std::string& sCacheKey, const CToolpathLayerData& layerData, CMatJobLayer* pMatJobLayer, uint64_t nLayerStartPosition);
+		void recordLaserTimes(CMatJobLayer* pMatJobLayer);
+
 	public:
 		CToolpathExporter_Matjob();
 		virtual ~CToolpathExporter_Matjob() = default;
 
 		void initialize(const std::string& sOutputFileName) override;
-		void beginExport(Lib3MF::PToolpath pToolpath, Lib3MF::PModel pModel) override;
-		void processLayer(uint32_t nLayerIndex, Lib3MF::PToolpathLayerReader pLayerReader) override;
+		void setStatistics(PToolpathStatistics pStatistics) override;
+		void beginExport(PToolpathSource pSource) override;
+		void processLayer(const CToolpathLayerData& layerData) override;
 		void finalize() override;
 
 		// MatJob-specific configuration
 		void setLayersPerBatch(uint32_t nLayersPerBatch);
 		void setGlobalLaserDiameter(double dDiameter);
+		void setThreadCount(uint32_t nThreadCount);
+
+		/**
+		 * Export only the layers [nFirstLayer, nEndLayer) into a job slice directory.
+		 * The output of initialize is the slice directory. Must be called before initialize.
+		 * @param nEndLayer End of the range, clamped to the layer count of the source
+		 */
+		void setLayerRange(uint32_t nFirstLayer, uint32_t nEndLayer);
+
+		/**
+		 * Merge a job slice into the output instead of calling beginExport and processLayer.
+		 * Slices must be merged in layer order and cover the whole job.
+		 * @param sSliceDirectory Directory written by an exporter with a layer range
+		 */
+		void mergeSlice(const std::string& sSliceDirectory);
+
+		/**
+		 * Reuse encoded layers from an on-disk cache. Only profile parameters, job properties and
+		 * the layer summaries are computed for layers found in the cache.
+		 * @param pLayerCache Layer cache, may be nullptr to disable caching
+		 */
+		void setLayerCache(PMatJobLayerCache pLayerCache);
+
+		/**
+		 * Use the scan fields of a laser assignment instead of the default machine. Every profile gets
+		 * a parameter set per laser, the segments of a layer use the parameter set of their assigned laser.
+		 * Must be called before beginExport.
+		 * @param pLaserAssignment Laser assignment, may be nullptr for the default machine
+		 */
+		void setLaserAssignment(PMatJobLaserAssignment pLaserAssignment);
+
+		/**
+		 * Model for the layer scan times, the scanner model by default. Its delays, acceleration and skywriting
+		 * are read from the profile parameters jumpdelay, markdelay, polygondelay, skywritingtime (in microseconds),
+		 * acceleration (in mm/s^2) and skywriting (0 or 1) of the MatJob double namespace, all 0 by default.
+		 * Must be called before initialize.
+		 */
+		void setScanTimeModel(PMatJobScanTimeModel pScanTimeModel);
+
+		/**
+		 * Join consecutive hatch segments with the same part and parameter set into data blocks of up to
+		 * nHatchTargetCount hatches, 0 writes one data block per segment. Segments that exceed the
+		 * MatJob block limits are always split. Must be called before beginExport.
+		 */
+		void setHatchBlockTarget(uint32_t nHatchTargetCount);
 	};
 
 	typedef std::shared_ptr<CToolpathExporter_Matjob> PToolpathExporter_Matjob;
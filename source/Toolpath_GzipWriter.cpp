@@ -0,0 +1,220 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#include "Toolpath_GzipWriter.hpp"
+#include "zlib.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+// Uncompressed size of the blocks that are deflated independently
+#define GZIPWRITER_BLOCKSIZE (128 * 1024)
+
+// Deflate window, the end of the previous block that primes the next one
+#define GZIPWRITER_WINDOWSIZE 32768
+#define GZIPWRITER_WINDOWBITS 15
+
+// Empty stored block of a sync flush, which deflateBound does not account for
+#define GZIPWRITER_FLUSHMARGIN 64
+
+namespace Toolpath {
+
+	static PToolpathGzipBlock deflateGzipBlock(const std::vector<uint8_t>& block, const std::vector<uint8_t>* pDictionary, int nCompressionLevel, bool bIsLastBlock)
+	{
+		z_stream stream;
+		stream.zalloc = Z_NULL;
+		stream.zfree = Z_NULL;
+		stream.opaque = Z_NULL;
+
+		// Negative window bits write a raw deflate stream, the gzip header and trailer are written by the writer
+		if (deflateInit2(&stream, nCompressionLevel, Z_DEFLATED, -GZIPWRITER_WINDOWBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+			throw std::runtime_error("could not initialize gzip compression");
+
+		auto pBlock = std::make_shared<sToolpathGzipBlock>();
+		pBlock->m_nUncompressedSize = (uint32_t)block.size();
+		pBlock->m_nCRC32 = (uint32_t)crc32(0L, block.data(), (uInt)block.size());
+
+		int nResult = Z_OK;
+		if ((pDictionary != nullptr) && !pDictionary->empty()) {
+			size_t nDictionarySize = std::min(pDictionary->size(), (size_t)GZIPWRITER_WINDOWSIZE);
+			nResult = deflateSetDictionary(&stream, pDictionary->data() + pDictionary->size() - nDictionarySize, (uInt)nDictionarySize);
+		}
+
+		if (nResult == Z_OK) {
+			pBlock->m_CompressedData.resize(deflateBound(&stream, (uLong)block.size()) + GZIPWRITER_FLUSHMARGIN);
+			stream.next_in = const_cast<Bytef*>(block.data());
+			stream.avail_in = (uInt)block.size();
+			stream.next_out = pBlock->m_CompressedData.data();
+			stream.avail_out = (uInt)pBlock->m_CompressedData.size();
+
+			// A sync flush ends the block on a byte boundary, so that the next block can be appended
+			nResult = deflate(&stream, bIsLastBlock ? Z_FINISH : Z_SYNC_FLUSH);
+			if (bIsLastBlock ? (nResult != Z_STREAM_END) : ((nResult != Z_OK) || (stream.avail_in != 0) || (stream.avail_out == 0)))
+				nResult = Z_BUF_ERROR;
+			else
+				nResult = Z_OK;
+		}
+
+		size_t nCompressedSize = pBlock->m_CompressedData.size() - stream.avail_out;
+		deflateEnd(&stream);
+
+		if (nResult != Z_OK)
+			throw std::runtime_error("gzip compression failed");
+
+		pBlock->m_CompressedData.resize(nCompressedSize);
+		return pBlock;
+	}
+
+	CToolpathGzipWriter::CToolpathGzipWriter(const std::string& sFileName, int nCompressionLevel, PToolpathThreadPool pThreadPool, PToolpathStatistics pStatistics)
+		: m_sFileName(sFileName),
+		m_nCompressionLevel(nCompressionLevel),
+		m_pThreadPool(pThreadPool),
+		m_pStatistics(pStatistics),
+		m_nCRC32(0),
+		m_nUncompressedSize(0),
+		m_nCompressedSize(0),
+		m_bIsFinished(false)
+	{
+		if ((nCompressionLevel < Z_DEFAULT_COMPRESSION) || (nCompressionLevel > Z_BEST_COMPRESSION))
+			throw std::runtime_error("invalid gzip compression level: " + std::to_string(nCompressionLevel));
+
+		if (m_pThreadPool.get() == nullptr)
+			m_pThreadPool = std::make_shared<CToolpathThreadPool>(1);
+		m_nMaxPendingBlocks = 2 * (size_t)std::max(m_pThreadPool->getThreadCount(), (uint32_t)1);
+
+		m_OutputStream.open(sFileName, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!m_OutputStream.is_open())
+			throw std::runtime_error("Failed to open output file: " + sFileName);
+
+		// Member header without file name and modification time, the operating system is unknown
+		const uint8_t header[10] = { 0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff };
+		m_OutputStream.write(reinterpret_cast<const char*>(header), sizeof(header));
+		m_nCompressedSize = sizeof(header);
+
+		m_pBlock = std::make_shared<std::vector<uint8_t>>();
+		m_pBlock->reserve(GZIPWRITER_BLOCKSIZE);
+	}
+
+	CToolpathGzipWriter::~CToolpathGzipWriter()
+	{
+		// Blocks of an unfinished file are not written, but no task may outlive the writer
+		for (auto& pendingBlock : m_PendingBlocks) {
+			if (pendingBlock.valid())
+				pendingBlock.wait();
+		}
+	}
+
+	void CToolpathGzipWriter::write(const void* pData, size_t nSize)
+	{
+		if (m_bIsFinished)
+			throw std::runtime_error("gzip file is already finished: " + m_sFileName);
+
+		const uint8_t* pBytes = static_cast<const uint8_t*>(pData);
+		while (nSize > 0) {
+			size_t nChunkSize = std::min(nSize, (size_t)GZIPWRITER_BLOCKSIZE - m_pBlock->size());
+			m_pBlock->insert(m_pBlock->end(), pBytes, pBytes + nChunkSize);
+			pBytes += nChunkSize;
+			nSize -= nChunkSize;
+
+			if (m_pBlock->size() == GZIPWRITER_BLOCKSIZE)
+				submitBlock(false);
+		}
+	}
+
+	void CToolpathGzipWriter::submitBlock(bool bIsLastBlock)
+	{
+		if (m_PendingBlocks.size() >= m_nMaxPendingBlocks)
+			writeOldestBlock();
+
+		auto pBlock = m_pBlock;
+		auto pPreviousBlock = m_pPreviousBlock;
+		int nCompressionLevel = m_nCompressionLevel;
+		auto pStatistics = m_pStatistics;
+		m_PendingBlocks.push_back(m_pThreadPool->submit([pBlock, pPreviousBlock, nCompressionLevel, bIsLastBlock, pStatistics]() {
+			CToolpathScopedTimer deflateTimer(pStatistics.get(), eToolpathStatisticsPhase::Deflate);
+			return deflateGzipBlock(*pBlock, pPreviousBlock.get(), nCompressionLevel, bIsLastBlock);
+		}));
+
+		m_pPreviousBlock = m_pBlock;
+		m_pBlock = std::make_shared<std::vector<uint8_t>>();
+		m_pBlock->reserve(GZIPWRITER_BLOCKSIZE);
+	}
+
+	void CToolpathGzipWriter::writeOldestBlock()
+	{
+		auto pBlock = m_PendingBlocks.front().get();
+		m_PendingBlocks.pop_front();
+
+		m_OutputStream.write(reinterpret_cast<const char*>(pBlock->m_CompressedData.data()), pBlock->m_CompressedData.size());
+		if (!m_OutputStream.good())
+			throw std::runtime_error("Failed to write output file: " + m_sFileName);
+
+		m_nCRC32 = (uint32_t)crc32_combine(m_nCRC32, pBlock->m_nCRC32, (z_off_t)pBlock->m_nUncompressedSize);
+		m_nUncompressedSize += pBlock->m_nUncompressedSize;
+		m_nCompressedSize += pBlock->m_CompressedData.size();
+	}
+
+	void CToolpathGzipWriter::finish()
+	{
+		if (m_bIsFinished)
+			return;
+
+		// The last block is written even if it is empty, as it ends the deflate stream
+		submitBlock(true);
+		while (!m_PendingBlocks.empty())
+			writeOldestBlock();
+
+		uint8_t trailer[8];
+		for (uint32_t nByteIndex = 0; nByteIndex < 4; nByteIndex++) {
+			trailer[nByteIndex] = (uint8_t)(m_nCRC32 >> (8 * nByteIndex));
+			trailer[4 + nByteIndex] = (uint8_t)(m_nUncompressedSize >> (8 * nByteIndex));
+		}
+		m_OutputStream.write(reinterpret_cast<const char*>(trailer), sizeof(trailer));
+		m_nCompressedSize += sizeof(trailer);
+
+		m_OutputStream.close();
+		if (m_OutputStream.fail())
+			throw std::runtime_error("Failed to write output file: " + m_sFileName);
+
+		m_pBlock.reset();
+		m_pPreviousBlock.reset();
+		m_bIsFinished = true;
+	}
+
+	uint64_t CToolpathGzipWriter::getUncompressedSize()
+	{
+		return m_nUncompressedSize;
+	}
+
+	uint64_t CToolpathGzipWriter::getCompressedSize()
+	{
+		return m_nCompressedSize;
+	}
+
+} // namespace Toolpath
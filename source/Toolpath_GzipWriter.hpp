@@ -0,0 +1,95 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#ifndef __TOOLPATH_GZIPWRITER
+#define __TOOLPATH_GZIPWRITER
+
+#include "Toolpath_ThreadPool.hpp"
+#include "Toolpath_Statistics.hpp"
+
+#include <fstream>
+#include <string>
+
+namespace Toolpath {
+
+	// Deflated block of a gzip file
+	typedef struct _sToolpathGzipBlock {
+		std::vector<uint8_t> m_CompressedData;
+		uint32_t m_nCRC32;
+		uint32_t m_nUncompressedSize;
+	} sToolpathGzipBlock;
+
+	typedef std::shared_ptr<sToolpathGzipBlock> PToolpathGzipBlock;
+
+	/**
+	 * Streaming gzip file writer.
+	 * Data is split into fixed-size blocks, which are deflated on the thread pool. Every block is primed with the
+	 * end of the previous block as dictionary and ends on a byte boundary, so that the blocks concatenate into one
+	 * deflate stream. The checksums of the blocks are combined in order.
+	 */
+	class CToolpathGzipWriter {
+	private:
+		std::string m_sFileName;
+		std::ofstream m_OutputStream;
+		int m_nCompressionLevel;
+
+		PToolpathThreadPool m_pThreadPool;
+		PToolpathStatistics m_pStatistics;
+
+		std::shared_ptr<std::vector<uint8_t>> m_pBlock;
+		std::shared_ptr<std::vector<uint8_t>> m_pPreviousBlock;
+		std::deque<std::future<PToolpathGzipBlock>> m_PendingBlocks;
+		size_t m_nMaxPendingBlocks;
+
+		uint32_t m_nCRC32;
+		uint64_t m_nUncompressedSize;
+		uint64_t m_nCompressedSize;
+		bool m_bIsFinished;
+
+		void submitBlock(bool bIsLastBlock);
+		void writeOldestBlock();
+
+	public:
+		CToolpathGzipWriter(const std::string& sFileName, int nCompressionLevel, PToolpathThreadPool pThreadPool, PToolpathStatistics pStatistics);
+		virtual ~CToolpathGzipWriter();
+
+		void write(const void* pData, size_t nSize);
+
+		// Writes the remaining blocks and the gzip trailer, and closes the file
+		void finish();
+
+		uint64_t getUncompressedSize();
+		uint64_t getCompressedSize();
+	};
+
+	typedef std::shared_ptr<CToolpathGzipWriter> PToolpathGzipWriter;
+
+} // namespace Toolpath
+
+#endif // __TOOLPATH_GZIPWRITER
@@ -0,0 +1,438 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#include "Toolpath_JSONReader.hpp"
+
+#include <stdexcept>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+
+#define TOOLPATHJSON_MAXDEPTH 64
+
+namespace Toolpath {
+
+	CToolpathJSONValue::CToolpathJSONValue(eToolpathJSONType valueType)
+		: m_Type(valueType), m_bValue(false)
+	{
+	}
+
+	PToolpathJSONValue CToolpathJSONValue::makeBool(bool bValue)
+	{
+		auto pValue = std::make_shared<CToolpathJSONValue>(eToolpathJSONType::Bool);
+		pValue->m_bValue = bValue;
+		return pValue;
+	}
+
+	PToolpathJSONValue CToolpathJSONValue::makeNumber(const std::string& sNumber)
+	{
+		auto pValue = std::make_shared<CToolpathJSONValue>(eToolpathJSONType::Number);
+		pValue->m_sValue = sNumber;
+		return pValue;
+	}
+
+	PToolpathJSONValue CToolpathJSONValue::makeString(const std::string& sValue)
+	{
+		auto pValue = std::make_shared<CToolpathJSONValue>(eToolpathJSONType::String);
+		pValue->m_sValue = sValue;
+		return pValue;
+	}
+
+	void CToolpathJSONValue::checkType(eToolpathJSONType expectedType) const
+	{
+		if (m_Type != expectedType)
+			throw std::runtime_error("JSON value has unexpected type " + std::to_string((uint32_t)m_Type) + ", expected " + std::to_string((uint32_t)expectedType));
+	}
+
+	eToolpathJSONType CToolpathJSONValue::getType() const
+	{
+		return m_Type;
+	}
+
+	bool CToolpathJSONValue::isNull() const
+	{
+		return m_Type == eToolpathJSONType::Null;
+	}
+
+	bool CToolpathJSONValue::getBool() const
+	{
+		checkType(eToolpathJSONType::Bool);
+		return m_bValue;
+	}
+
+	double CToolpathJSONValue::getDouble() const
+	{
+		checkType(eToolpathJSONType::Number);
+		return strtod(m_sValue.c_str(), nullptr);
+	}
+
+	uint64_t CToolpathJSONValue::getUint64() const
+	{
+		checkType(eToolpathJSONType::Number);
+
+		char* pszEnd = nullptr;
+		unsigned long long nValue = strtoull(m_sValue.c_str(), &pszEnd, 10);
+		if ((m_sValue[0] == '-') || (pszEnd == nullptr) || (*pszEnd != 0))
+			throw std::runtime_error("JSON number is not an unsigned integer: " + m_sValue);
+
+		return (uint64_t)nValue;
+	}
+
+	int64_t CToolpathJSONValue::getInt64() const
+	{
+		checkType(eToolpathJSONType::Number);
+
+		char* pszEnd = nullptr;
+		long long nValue = strtoll(m_sValue.c_str(), &pszEnd, 10);
+		if ((pszEnd == nullptr) || (*pszEnd != 0))
+			throw std::runtime_error("JSON number is not an integer: " + m_sValue);
+
+		return (int64_t)nValue;
+	}
+
+	const std::string& CToolpathJSONValue::getString() const
+	{
+		checkType(eToolpathJSONType::String);
+		return m_sValue;
+	}
+
+	uint32_t CToolpathJSONValue::getElementCount() const
+	{
+		checkType(eToolpathJSONType::Array);
+		return (uint32_t)m_Elements.size();
+	}
+
+	const CToolpathJSONValue& CToolpathJSONValue::getElement(uint32_t nIndex) const
+	{
+		checkType(eToolpathJSONType::Array);
+		if (nIndex >= m_Elements.size())
+			throw std::runtime_error("invalid JSON array index: " + std::to_string(nIndex));
+
+		return *m_Elements[nIndex];
+	}
+
+	void CToolpathJSONValue::addElement(PToolpathJSONValue pValue)
+	{
+		checkType(eToolpathJSONType::Array);
+		if (pValue.get() == nullptr)
+			throw std::runtime_error("invalid JSON array element");
+
+		m_Elements.push_back(pValue);
+	}
+
+	bool CToolpathJSONValue::hasMember(const std::string& sKey) const
+	{
+		checkType(eToolpathJSONType::Object);
+		for (auto& member : m_Members) {
+			if (member.first == sKey)
+				return true;
+		}
+
+		return false;
+	}
+
+	const CToolpathJSONValue& CToolpathJSONValue::getMember(const std::string& sKey) const
+	{
+		checkType(eToolpathJSONType::Object);
+		for (auto& member : m_Members) {
+			if (member.first == sKey)
+				return *member.second;
+		}
+
+		throw std::runtime_error("missing JSON member: " + sKey);
+	}
+
+	void CToolpathJSONValue::addMember(const std::string& sKey, PToolpathJSONValue pValue)
+	{
+		checkType(eToolpathJSONType::Object);
+		if (pValue.get() == nullptr)
+			throw std::runtime_error("invalid JSON member: " + sKey);
+
+		m_Members.push_back(std::make_pair(sKey, pValue));
+	}
+
+	bool CToolpathJSONValue::getBool(const std::string& sKey) const
+	{
+		return getMember(sKey).getBool();
+	}
+
+	double CToolpathJSONValue::getDouble(const std::string& sKey) const
+	{
+		return getMember(sKey).getDouble();
+	}
+
+	uint64_t CToolpathJSONValue::getUint64(const std::string& sKey) const
+	{
+		return getMember(sKey).getUint64();
+	}
+
+	uint32_t CToolpathJSONValue::getUint32(const std::string& sKey) const
+	{
+		uint64_t nValue = getUint64(sKey);
+		if (nValue > 0xffffffffULL)
+			throw std::runtime_error("JSON member exceeds 32 bit: " + sKey);
+
+		return (uint32_t)nValue;
+	}
+
+	const std::string& CToolpathJSONValue::getString(const std::string& sKey) const
+	{
+		return getMember(sKey).getString();
+	}
+
+
+	CToolpathJSONReader::CToolpathJSONReader(const std::string& sText)
+		: m_sText(sText), m_nPosition(0)
+	{
+	}
+
+	void CToolpathJSONReader::throwParseError(const std::string& sMessage)
+	{
+		throw std::runtime_error("JSON parse error at offset " + std::to_string(m_nPosition) + ": " + sMessage);
+	}
+
+	void CToolpathJSONReader::skipWhiteSpace()
+	{
+		while (m_nPosition < m_sText.length()) {
+			char cChar = m_sText[m_nPosition];
+			if ((cChar != ' ') && (cChar != '\t') && (cChar != '\n') && (cChar != '\r'))
+				break;
+			m_nPosition++;
+		}
+	}
+
+	char CToolpathJSONReader::peekChar()
+	{
+		skipWhiteSpace();
+		if (m_nPosition >= m_sText.length())
+			throwParseError("unexpected end of input");
+
+		return m_sText[m_nPosition];
+	}
+
+	void CToolpathJSONReader::expectChar(char cExpected)
+	{
+		if (peekChar() != cExpected)
+			throwParseError(std::string("expected '") + cExpected + "'");
+		m_nPosition++;
+	}
+
+	void CToolpathJSONReader::expectLiteral(const std::string& sLiteral)
+	{
+		if (m_sText.compare(m_nPosition, sLiteral.length(), sLiteral) != 0)
+			throwParseError("expected " + sLiteral);
+		m_nPosition += sLiteral.length();
+	}
+
+	std::string CToolpathJSONReader::parseString()
+	{
+		expectChar('"');
+
+		std::string sResult;
+		while (true) {
+			if (m_nPosition >= m_sText.length())
+				throwParseError("unterminated string");
+
+			char cChar = m_sText[m_nPosition++];
+			if (cChar == '"')
+				break;
+
+			if (cChar != '\\') {
+				sResult += cChar;
+				continue;
+			}
+
+			if (m_nPosition >= m_sText.length())
+				throwParseError("unterminated escape sequence");
+
+			char cEscape = m_sText[m_nPosition++];
+			switch (cEscape) {
+			case '"': sResult += '"'; break;
+			case '\\': sResult += '\\'; break;
+			case '/': sResult += '/'; break;
+			case 'b': sResult += '\b'; break;
+			case 'f': sResult += '\f'; break;
+			case 'n': sResult += '\n'; break;
+			case 'r': sResult += '\r'; break;
+			case 't': sResult += '\t'; break;
+			case 'u':
+			{
+				if (m_nPosition + 4 > m_sText.length())
+					throwParseError("invalid unicode escape");
+
+				uint32_t nCodePoint = (uint32_t)strtoul(m_sText.substr(m_nPosition, 4).c_str(), nullptr, 16);
+				m_nPosition += 4;
+
+				// Surrogate pairs are not written by CToolpathJSONWriter and are not supported
+				if (nCodePoint < 0x80) {
+					sResult += (char)nCodePoint;
+				}
+				else if (nCodePoint < 0x800) {
+					sResult += (char)(0xC0 | (nCodePoint >> 6));
+					sResult += (char)(0x80 | (nCodePoint & 0x3F));
+				}
+				else {
+					sResult += (char)(0xE0 | (nCodePoint >> 12));
+					sResult += (char)(0x80 | ((nCodePoint >> 6) & 0x3F));
+					sResult += (char)(0x80 | (nCodePoint & 0x3F));
+				}
+				break;
+			}
+			default:
+				throwParseError("invalid escape sequence");
+			}
+		}
+
+		return sResult;
+	}
+
+	std::string CToolpathJSONReader::parseNumber()
+	{
+		skipWhiteSpace();
+		size_t nStart = m_nPosition;
+		while (m_nPosition < m_sText.length()) {
+			char cChar = m_sText[m_nPosition];
+			if (((cChar >= '0') && (cChar <= '9')) || (cChar == '-') || (cChar == '+') || (cChar == '.') || (cChar == 'e') || (cChar == 'E'))
+				m_nPosition++;
+			else
+				break;
+		}
+
+		if (m_nPosition == nStart)
+			throwParseError("invalid number");
+
+		return m_sText.substr(nStart, m_nPosition - nStart);
+	}
+
+	PToolpathJSONValue CToolpathJSONReader::parseValue(uint32_t nDepth)
+	{
+		if (nDepth > TOOLPATHJSON_MAXDEPTH)
+			throwParseError("nesting too deep");
+
+		char cChar = peekChar();
+
+		if (cChar == '{') {
+			m_nPosition++;
+			auto pObject = std::make_shared<CToolpathJSONValue>(eToolpathJSONType::Object);
+			if (peekChar() == '}') {
+				m_nPosition++;
+				return pObject;
+			}
+
+			while (true) {
+				std::string sKey = parseString();
+				expectChar(':');
+				pObject->addMember(sKey, parseValue(nDepth + 1));
+
+				char cNext = peekChar();
+				m_nPosition++;
+				if (cNext == '}')
+					break;
+				if (cNext != ',')
+					throwParseError("expected ',' or '}'");
+			}
+
+			return pObject;
+		}
+
+		if (cChar == '[') {
+			m_nPosition++;
+			auto pArray = std::make_shared<CToolpathJSONValue>(eToolpathJSONType::Array);
+			if (peekChar() == ']') {
+				m_nPosition++;
+				return pArray;
+			}
+
+			while (true) {
+				pArray->addElement(parseValue(nDepth + 1));
+
+				char cNext = peekChar();
+				m_nPosition++;
+				if (cNext == ']')
+					break;
+				if (cNext != ',')
+					throwParseError("expected ',' or ']'");
+			}
+
+			return pArray;
+		}
+
+		if (cChar == '"')
+			return CToolpathJSONValue::makeString(parseString());
+
+		if (cChar == 't') {
+			expectLiteral("true");
+			return CToolpathJSONValue::makeBool(true);
+		}
+
+		if (cChar == 'f') {
+			expectLiteral("false");
+			return CToolpathJSONValue::makeBool(false);
+		}
+
+		if (cChar == 'n') {
+			expectLiteral("null");
+			return std::make_shared<CToolpathJSONValue>(eToolpathJSONType::Null);
+		}
+
+		return CToolpathJSONValue::makeNumber(parseNumber());
+	}
+
+	PToolpathJSONValue CToolpathJSONReader::parse(const std::string& sText)
+	{
+		CToolpathJSONReader reader(sText);
+		auto pValue = reader.parseValue(0);
+
+		reader.skipWhiteSpace();
+		if (reader.m_nPosition != sText.length())
+			reader.throwParseError("unexpected content after value");
+
+		return pValue;
+	}
+
+	PToolpathJSONValue CToolpathJSONReader::parseFile(const std::string& sFileName)
+	{
+		std::ifstream stream(sFileName, std::ios::in | std::ios::binary);
+		if (!stream.is_open())
+			throw std::runtime_error("Failed to open JSON file: " + sFileName);
+
+		std::stringstream buffer;
+		buffer << stream.rdbuf();
+		if (stream.bad())
+			throw std::runtime_error("Failed to read JSON file: " + sFileName);
+
+		try {
+			return parse(buffer.str());
+		}
+		catch (std::exception& E) {
+			throw std::runtime_error(sFileName + ": " + E.what());
+		}
+	}
+
+} // namespace Toolpath
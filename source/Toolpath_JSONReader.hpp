@@ -0,0 +1,127 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#ifndef __TOOLPATH_JSONREADER
+#define __TOOLPATH_JSONREADER
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+namespace Toolpath {
+
+	enum class eToolpathJSONType : uint32_t {
+		Null = 0,
+		Bool = 1,
+		Number = 2,
+		String = 3,
+		Array = 4,
+		Object = 5
+	};
+
+	class CToolpathJSONValue;
+	typedef std::shared_ptr<CToolpathJSONValue> PToolpathJSONValue;
+
+	/**
+	 * Parsed JSON value. Numbers keep their source text, so that 64 bit integers are read without loss.
+	 * Accessors throw if the value has a different type or a member is missing.
+	 */
+	class CToolpathJSONValue {
+	private:
+		eToolpathJSONType m_Type;
+		bool m_bValue;
+		std::string m_sValue;
+
+		std::vector<PToolpathJSONValue> m_Elements;
+		std::vector<std::pair<std::string, PToolpathJSONValue>> m_Members;
+
+		void checkType(eToolpathJSONType expectedType) const;
+
+	public:
+		CToolpathJSONValue(eToolpathJSONType valueType);
+		virtual ~CToolpathJSONValue() = default;
+
+		static PToolpathJSONValue makeBool(bool bValue);
+		static PToolpathJSONValue makeNumber(const std::string& sNumber);
+		static PToolpathJSONValue makeString(const std::string& sValue);
+
+		eToolpathJSONType getType() const;
+		bool isNull() const;
+
+		bool getBool() const;
+		double getDouble() const;
+		uint64_t getUint64() const;
+		int64_t getInt64() const;
+		const std::string& getString() const;
+
+		uint32_t getElementCount() const;
+		const CToolpathJSONValue& getElement(uint32_t nIndex) const;
+		void addElement(PToolpathJSONValue pValue);
+
+		bool hasMember(const std::string& sKey) const;
+		const CToolpathJSONValue& getMember(const std::string& sKey) const;
+		void addMember(const std::string& sKey, PToolpathJSONValue pValue);
+
+		// Convenience accessors for object members
+		bool getBool(const std::string& sKey) const;
+		double getDouble(const std::string& sKey) const;
+		uint64_t getUint64(const std::string& sKey) const;
+		uint32_t getUint32(const std::string& sKey) const;
+		const std::string& getString(const std::string& sKey) const;
+	};
+
+	/**
+	 * Minimal JSON parser for the files written by CToolpathJSONWriter.
+	 */
+	class CToolpathJSONReader {
+	private:
+		const std::string& m_sText;
+		size_t m_nPosition;
+
+		void skipWhiteSpace();
+		char peekChar();
+		void expectChar(char cExpected);
+		void expectLiteral(const std::string& sLiteral);
+		[[noreturn]] void throwParseError(const std::string& sMessage);
+
+		PToolpathJSONValue parseValue(uint32_t nDepth);
+		std::string parseString();
+		std::string parseNumber();
+
+		CToolpathJSONReader(const std::string& sText);
+
+	public:
+		static PToolpathJSONValue parse(const std::string& sText);
+		static PToolpathJSONValue parseFile(const std::string& sFileName);
+	};
+
+} // namespace Toolpath
+
+#endif // __TOOLPATH_JSONREADER
@@ -0,0 +1,212 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#include "Toolpath_JSONWriter.hpp"
+
+#include <stdexcept>
+#include <sstream>
+#include <iomanip>
+#include <cmath>
+
+namespace Toolpath {
+
+	CToolpathJSONWriter::CToolpathJSONWriter(std::ostream& stream)
+		: m_Stream(stream), m_nDoublePrecision(10), m_bIsCompact(false)
+	{
+	}
+
+	void CToolpathJSONWriter::setCompact(bool bIsCompact)
+	{
+		m_bIsCompact = bIsCompact;
+	}
+
+	void CToolpathJSONWriter::setDoublePrecision(uint32_t nDoublePrecision)
+	{
+		if ((nDoublePrecision == 0) || (nDoublePrecision > 17))
+			throw std::runtime_error("JSON writer: invalid double precision");
+		m_nDoublePrecision = nDoublePrecision;
+	}
+
+	void CToolpathJSONWriter::writeSeparator()
+	{
+		if (m_ScopeHasElements.empty())
+			return;
+
+		if (m_ScopeHasElements.back())
+			m_Stream << ",";
+		m_ScopeHasElements.back() = true;
+
+		if (!m_bIsCompact)
+			m_Stream << "\n" << std::string(m_ScopeHasElements.size(), '\t');
+	}
+
+	void CToolpathJSONWriter::writeKey(const std::string& sKey)
+	{
+		writeSeparator();
+		m_Stream << "\"" << escapeString(sKey) << "\": ";
+	}
+
+	void CToolpathJSONWriter::beginObject()
+	{
+		writeSeparator();
+		m_Stream << "{";
+		m_ScopeHasElements.push_back(false);
+	}
+
+	void CToolpathJSONWriter::beginObject(const std::string& sKey)
+	{
+		writeKey(sKey);
+		m_Stream << "{";
+		m_ScopeHasElements.push_back(false);
+	}
+
+	void CToolpathJSONWriter::endObject()
+	{
+		if (m_ScopeHasElements.empty())
+			throw std::runtime_error("JSON writer: no open object");
+
+		bool bHasElements = m_ScopeHasElements.back();
+		m_ScopeHasElements.pop_back();
+		if (bHasElements && !m_bIsCompact)
+			m_Stream << "\n" << std::string(m_ScopeHasElements.size(), '\t');
+		m_Stream << "}";
+
+		if (m_ScopeHasElements.empty())
+			m_Stream << "\n";
+	}
+
+	void CToolpathJSONWriter::beginArray()
+	{
+		writeSeparator();
+		m_Stream << "[";
+		m_ScopeHasElements.push_back(false);
+	}
+
+	void CToolpathJSONWriter::beginArray(const std::string& sKey)
+	{
+		writeKey(sKey);
+		m_Stream << "[";
+		m_ScopeHasElements.push_back(false);
+	}
+
+	void CToolpathJSONWriter::endArray()
+	{
+		if (m_ScopeHasElements.empty())
+			throw std::runtime_error("JSON writer: no open array");
+
+		bool bHasElements = m_ScopeHasElements.back();
+		m_ScopeHasElements.pop_back();
+		if (bHasElements && !m_bIsCompact)
+			m_Stream << "\n" << std::string(m_ScopeHasElements.size(), '\t');
+		m_Stream << "]";
+	}
+
+	void CToolpathJSONWriter::writeString(const std::string& sKey, const std::string& sValue)
+	{
+		writeKey(sKey);
+		m_Stream << "\"" << escapeString(sValue) << "\"";
+	}
+
+	void CToolpathJSONWriter::writeDouble(const std::string& sKey, double dValue)
+	{
+		writeKey(sKey);
+		// JSON has no representation for NaN and infinity
+		if (std::isfinite(dValue))
+			m_Stream << std::setprecision(m_nDoublePrecision) << dValue;
+		else
+			m_Stream << "null";
+	}
+
+	void CToolpathJSONWriter::writeUint64(const std::string& sKey, uint64_t nValue)
+	{
+		writeKey(sKey);
+		m_Stream << nValue;
+	}
+
+	void CToolpathJSONWriter::writeInt64(const std::string& sKey, int64_t nValue)
+	{
+		writeKey(sKey);
+		m_Stream << nValue;
+	}
+
+	void CToolpathJSONWriter::writeBool(const std::string& sKey, bool bValue)
+	{
+		writeKey(sKey);
+		m_Stream << (bValue ? "true" : "false");
+	}
+
+	void CToolpathJSONWriter::writeStringValue(const std::string& sValue)
+	{
+		writeSeparator();
+		m_Stream << "\"" << escapeString(sValue) << "\"";
+	}
+
+	void CToolpathJSONWriter::writeDoubleValue(double dValue)
+	{
+		writeSeparator();
+		if (std::isfinite(dValue))
+			m_Stream << std::setprecision(m_nDoublePrecision) << dValue;
+		else
+			m_Stream << "null";
+	}
+
+	void CToolpathJSONWriter::writeUint64Value(uint64_t nValue)
+	{
+		writeSeparator();
+		m_Stream << nValue;
+	}
+
+	std::string CToolpathJSONWriter::escapeString(const std::string& sValue)
+	{
+		std::string sResult;
+		sResult.reserve(sValue.length());
+
+		for (char cChar : sValue) {
+			switch (cChar) {
+			case '"': sResult += "\\\""; break;
+			case '\\': sResult += "\\\\"; break;
+			case '\n': sResult += "\\n"; break;
+			case '\r': sResult += "\\r"; break;
+			case '\t': sResult += "\\t"; break;
+			default:
+				if ((unsigned char)cChar < 0x20) {
+					std::ostringstream oss;
+					oss << "\\u" << std::hex << std::setw(4) << std::setfill('0') << (int)(unsigned char)cChar;
+					sResult += oss.str();
+				}
+				else {
+					sResult += cChar;
+				}
+			}
+		}
+
+		return sResult;
+	}
+
+} // namespace Toolpath
@@ -0,0 +1,87 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#ifndef __TOOLPATH_JSONWRITER
+#define __TOOLPATH_JSONWRITER
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <ostream>
+
+namespace Toolpath {
+
+	/**
+	 * Minimal streaming JSON writer for reports.
+	 * Keys are passed to the write calls inside objects and omitted inside arrays.
+	 */
+	class CToolpathJSONWriter {
+	private:
+		std::ostream& m_Stream;
+		std::vector<bool> m_ScopeHasElements;
+		uint32_t m_nDoublePrecision;
+		bool m_bIsCompact;
+
+		void writeSeparator();
+		void writeKey(const std::string& sKey);
+
+	public:
+		CToolpathJSONWriter(std::ostream& stream);
+		virtual ~CToolpathJSONWriter() = default;
+
+		// Significant digits of doubles, 10 by default. Use 17 for values that are read back.
+		void setDoublePrecision(uint32_t nDoublePrecision);
+
+		// Writes each document on a single line that ends with a newline, e.g. for line based protocols
+		void setCompact(bool bIsCompact);
+
+		void beginObject();
+		void beginObject(const std::string& sKey);
+		void endObject();
+
+		void beginArray();
+		void beginArray(const std::string& sKey);
+		void endArray();
+
+		void writeString(const std::string& sKey, const std::string& sValue);
+		void writeDouble(const std::string& sKey, double dValue);
+		void writeUint64(const std::string& sKey, uint64_t nValue);
+		void writeInt64(const std::string& sKey, int64_t nValue);
+		void writeBool(const std::string& sKey, bool bValue);
+
+		void writeStringValue(const std::string& sValue);
+		void writeDoubleValue(double dValue);
+		void writeUint64Value(uint64_t nValue);
+
+		static std::string escapeString(const std::string& sValue);
+	};
+
+} // namespace Toolpath
+
+#endif // __TOOLPATH_JSONWRITER
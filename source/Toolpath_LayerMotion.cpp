@@ -0,0 +1,216 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#include "Toolpath_LayerMotion.hpp"
+
+#include <cmath>
+
+namespace Toolpath {
+
+	CToolpathLayerMotion::CToolpathLayerMotion()
+	{
+	}
+
+	void CToolpathLayerMotion::readSpeeds(IToolpathSource& source)
+	{
+		m_MarkSpeeds.clear();
+		m_JumpSpeeds.clear();
+
+		uint32_t nProfileCount = source.getProfileCount();
+		for (uint32_t nProfileIndex = 0; nProfileIndex < nProfileCount; nProfileIndex++) {
+			auto& profile = source.getProfile(nProfileIndex);
+
+			double dMarkSpeed = profile.getParameterDoubleValueDef("", "laserspeed", 0.0);
+			double dJumpSpeed = profile.getParameterDoubleValueDef("", "jumpspeed", dMarkSpeed);
+			m_MarkSpeeds.push_back(dMarkSpeed);
+			m_JumpSpeeds.push_back(dJumpSpeed);
+		}
+	}
+
+	double CToolpathLayerMotion::getMarkSpeed(uint32_t nProfileIndex) const
+	{
+		if (nProfileIndex >= m_MarkSpeeds.size())
+			return 0.0;
+		return m_MarkSpeeds[nProfileIndex];
+	}
+
+	double CToolpathLayerMotion::getJumpSpeed(uint32_t nProfileIndex) const
+	{
+		if (nProfileIndex >= m_JumpSpeeds.size())
+			return 0.0;
+		return m_JumpSpeeds[nProfileIndex];
+	}
+
+	double CToolpathLayerMotion::getDistance(double dX1, double dY1, double dX2, double dY2)
+	{
+		double dDeltaX = dX2 - dX1;
+		double dDeltaY = dY2 - dY1;
+		return sqrt(dDeltaX * dDeltaX + dDeltaY * dDeltaY);
+	}
+
+	void CToolpathLayerMotion::clearSummary(sToolpathMotionSummary& summary)
+	{
+		summary.m_dMarkDistance = 0.0;
+		summary.m_dJumpDistance = 0.0;
+		summary.m_dScanTime = 0.0;
+	}
+
+	void CToolpathLayerMotion::addSummary(sToolpathMotionSummary& total, const sToolpathMotionSummary& summary)
+	{
+		total.m_dMarkDistance += summary.m_dMarkDistance;
+		total.m_dJumpDistance += summary.m_dJumpDistance;
+		total.m_dScanTime += summary.m_dScanTime;
+	}
+
+	bool CToolpathLayerMotion::getSegmentStart(const CToolpathLayerData& layerData, const sToolpathSegment& segment, double& dX, double& dY)
+	{
+		if (segment.m_nElementCount == 0)
+			return false;
+
+		switch (segment.m_Type) {
+		case eToolpathSegmentType::Loop:
+		case eToolpathSegmentType::Polyline:
+		{
+			auto pPoints = layerData.getSegmentPoints(segment);
+			dX = pPoints[0].m_Coordinates[0];
+			dY = pPoints[0].m_Coordinates[1];
+			return true;
+		}
+
+		case eToolpathSegmentType::Hatch:
+		{
+			auto pHatches = layerData.getSegmentHatches(segment);
+			dX = pHatches[0].m_Point1Coordinates[0];
+			dY = pHatches[0].m_Point1Coordinates[1];
+			return true;
+		}
+
+		default:
+			return false;
+		}
+	}
+
+	bool CToolpathLayerMotion::getSegmentEnd(const CToolpathLayerData& layerData, const sToolpathSegment& segment, double& dX, double& dY)
+	{
+		if (segment.m_nElementCount == 0)
+			return false;
+
+		switch (segment.m_Type) {
+		case eToolpathSegmentType::Loop:
+		case eToolpathSegmentType::Polyline:
+		{
+			auto pPoints = layerData.getSegmentPoints(segment);
+			dX = pPoints[segment.m_nElementCount - 1].m_Coordinates[0];
+			dY = pPoints[segment.m_nElementCount - 1].m_Coordinates[1];
+			return true;
+		}
+
+		case eToolpathSegmentType::Hatch:
+		{
+			auto pHatches = layerData.getSegmentHatches(segment);
+			dX = pHatches[segment.m_nElementCount - 1].m_Point2Coordinates[0];
+			dY = pHatches[segment.m_nElementCount - 1].m_Point2Coordinates[1];
+			return true;
+		}
+
+		default:
+			return false;
+		}
+	}
+
+	sToolpathMotionSummary CToolpathLayerMotion::measureLayer(const CToolpathLayerData& layerData) const
+	{
+		sToolpathMotionSummary summary;
+		clearSummary(summary);
+
+		bool bHasPosition = false;
+		double dCurrentX = 0.0;
+		double dCurrentY = 0.0;
+
+		for (auto& segment : layerData.getSegments()) {
+			double dMarkDistance = 0.0;
+			double dJumpDistance = 0.0;
+
+			switch (segment.m_Type) {
+			case eToolpathSegmentType::Loop:
+			case eToolpathSegmentType::Polyline:
+			{
+				if (segment.m_nElementCount == 0)
+					continue;
+
+				auto pPoints = layerData.getSegmentPoints(segment);
+				if (bHasPosition)
+					dJumpDistance += getDistance(dCurrentX, dCurrentY, pPoints[0].m_Coordinates[0], pPoints[0].m_Coordinates[1]);
+
+				for (uint32_t nIndex = 1; nIndex < segment.m_nElementCount; nIndex++)
+					dMarkDistance += getDistance(pPoints[nIndex - 1].m_Coordinates[0], pPoints[nIndex - 1].m_Coordinates[1],
+						pPoints[nIndex].m_Coordinates[0], pPoints[nIndex].m_Coordinates[1]);
+
+				dCurrentX = pPoints[segment.m_nElementCount - 1].m_Coordinates[0];
+				dCurrentY = pPoints[segment.m_nElementCount - 1].m_Coordinates[1];
+				bHasPosition = true;
+				break;
+			}
+
+			case eToolpathSegmentType::Hatch:
+			{
+				auto pHatches = layerData.getSegmentHatches(segment);
+				for (uint32_t nIndex = 0; nIndex < segment.m_nElementCount; nIndex++) {
+					auto& hatch = pHatches[nIndex];
+					if (bHasPosition)
+						dJumpDistance += getDistance(dCurrentX, dCurrentY, hatch.m_Point1Coordinates[0], hatch.m_Point1Coordinates[1]);
+
+					dMarkDistance += getDistance(hatch.m_Point1Coordinates[0], hatch.m_Point1Coordinates[1], hatch.m_Point2Coordinates[0], hatch.m_Point2Coordinates[1]);
+
+					dCurrentX = hatch.m_Point2Coordinates[0];
+					dCurrentY = hatch.m_Point2Coordinates[1];
+					bHasPosition = true;
+				}
+				break;
+			}
+
+			default:
+				continue;
+			}
+
+			double dMarkSpeed = getMarkSpeed(segment.m_nProfileIndex);
+			double dJumpSpeed = getJumpSpeed(segment.m_nProfileIndex);
+
+			summary.m_dMarkDistance += dMarkDistance;
+			summary.m_dJumpDistance += dJumpDistance;
+			if (dMarkSpeed > 0.0)
+				summary.m_dScanTime += dMarkDistance / dMarkSpeed;
+			if (dJumpSpeed > 0.0)
+				summary.m_dScanTime += dJumpDistance / dJumpSpeed;
+		}
+
+		return summary;
+	}
+
+} // namespace Toolpath
@@ -0,0 +1,82 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#ifndef __TOOLPATH_LAYERMOTION
+#define __TOOLPATH_LAYERMOTION
+
+#include <vector>
+#include <cstdint>
+
+#include "Toolpath_Source.hpp"
+
+namespace Toolpath {
+
+	// Distances and estimated time of the scanner moves of a layer, in millimeters and seconds
+	typedef struct _sToolpathMotionSummary {
+		double m_dMarkDistance;
+		double m_dJumpDistance;
+		double m_dScanTime;
+	} sToolpathMotionSummary;
+
+	/**
+	 * Estimates the scanner motion of a layer in the order of its segments, with the same
+	 * distance over speed model as CMatJobLayer: the first move of a layer is free,
+	 * every segment starts with a jump from the end of the previous segment.
+	 */
+	class CToolpathLayerMotion {
+	private:
+		// Speeds in mm/s by source profile index, 0 if unknown
+		std::vector<double> m_MarkSpeeds;
+		std::vector<double> m_JumpSpeeds;
+
+	public:
+		CToolpathLayerMotion();
+		virtual ~CToolpathLayerMotion() = default;
+
+		// Reads laserspeed and jumpspeed of all profiles, jumpspeed defaults to laserspeed
+		void readSpeeds(IToolpathSource& source);
+
+		double getMarkSpeed(uint32_t nProfileIndex) const;
+		double getJumpSpeed(uint32_t nProfileIndex) const;
+
+		sToolpathMotionSummary measureLayer(const CToolpathLayerData& layerData) const;
+
+		// First and last position of the scanner in a segment; false for empty segments
+		static bool getSegmentStart(const CToolpathLayerData& layerData, const sToolpathSegment& segment, double& dX, double& dY);
+		static bool getSegmentEnd(const CToolpathLayerData& layerData, const sToolpathSegment& segment, double& dX, double& dY);
+
+		static double getDistance(double dX1, double dY1, double dX2, double dY2);
+
+		static void clearSummary(sToolpathMotionSummary& summary);
+		static void addSummary(sToolpathMotionSummary& total, const sToolpathMotionSummary& summary);
+	};
+
+} // namespace Toolpath
+
+#endif // __TOOLPATH_LAYERMOTION
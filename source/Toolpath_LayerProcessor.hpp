@@ -0,0 +1,78 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#ifndef __TOOLPATH_LAYERPROCESSOR
+#define __TOOLPATH_LAYERPROCESSOR
+
+#include <string>
+#include <memory>
+
+#include "Toolpath_Source.hpp"
+#include "Toolpath_Statistics.hpp"
+
+namespace Toolpath {
+
+	/**
+	 * Optional stage that changes the geometry of a layer between the source and the exporters,
+	 * e.g. to shorten jumps. Stages run in the order they were added to a conversion.
+	 */
+	class IToolpathLayerProcessor {
+	public:
+		virtual ~IToolpathLayerProcessor() = default;
+
+		// Name of the stage in logs and statistics
+		virtual std::string getName() = 0;
+
+		/**
+		 * Attach a statistics collector for the results of the stage.
+		 * @param pStatistics Statistics of the conversion job, may be nullptr
+		 */
+		virtual void setStatistics(PToolpathStatistics pStatistics) = 0;
+
+		// Called once before the first layer, e.g. to read profile parameters
+		virtual void beginProcessing(PToolpathSource pSource) = 0;
+
+		/**
+		 * Process one layer in place.
+		 * @param layerData Layer as read from the source or returned by the previous stage
+		 */
+		virtual void processLayer(CToolpathLayerData& layerData) = 0;
+
+		// One line report of the last processed layer, for the conversion log
+		virtual std::string getLayerSummary() = 0;
+
+		// Called after the last layer; writes the totals to the statistics
+		virtual void endProcessing() = 0;
+	};
+
+	typedef std::shared_ptr<IToolpathLayerProcessor> PToolpathLayerProcessor;
+
+} // namespace Toolpath
+
+#endif // __TOOLPATH_LAYERPROCESSOR
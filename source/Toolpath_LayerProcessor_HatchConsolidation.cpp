@@ -0,0 +1,368 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#include "Toolpath_LayerProcessor_HatchConsolidation.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+#include <cmath>
+
+// Number of direction bins over 180 degrees, about 1 mrad each and centered on multiples of 15 degrees.
+// Hatches that are split by a slicer share their direction up to rounding, the bins only group candidates,
+// the tolerance check decides whether two hatches are joined.
+#define HATCHCONSOLIDATION_ANGLEBINCOUNT 3144
+#define HATCHCONSOLIDATION_PI 3.14159265358979323846
+
+namespace Toolpath {
+
+	CToolpathLayerProcessor_HatchConsolidation::CToolpathLayerProcessor_HatchConsolidation()
+		: m_dMergeTolerance(0.001),
+		m_dMinimumLength(0.0),
+		m_nLayerHatchesBefore(0),
+		m_nLayerMergedHatches(0),
+		m_nLayerDroppedHatches(0),
+		m_nHatchesBefore(0),
+		m_nMergedHatches(0),
+		m_nDroppedHatches(0),
+		m_nLayerCount(0)
+	{
+		CToolpathLayerMotion::clearSummary(m_LayerBefore);
+		CToolpathLayerMotion::clearSummary(m_LayerAfter);
+		CToolpathLayerMotion::clearSummary(m_TotalBefore);
+		CToolpathLayerMotion::clearSummary(m_TotalAfter);
+	}
+
+	void CToolpathLayerProcessor_HatchConsolidation::setMergeTolerance(double dMergeTolerance)
+	{
+		if (!std::isfinite(dMergeTolerance) || (dMergeTolerance <= 0.0))
+			throw std::runtime_error("invalid hatch merge tolerance");
+
+		m_dMergeTolerance = dMergeTolerance;
+	}
+
+	void CToolpathLayerProcessor_HatchConsolidation::setMinimumLength(double dMinimumLength)
+	{
+		if (!std::isfinite(dMinimumLength) || (dMinimumLength < 0.0))
+			throw std::runtime_error("invalid minimum hatch length");
+
+		m_dMinimumLength = dMinimumLength;
+	}
+
+	std::string CToolpathLayerProcessor_HatchConsolidation::getName()
+	{
+		return "hatchConsolidation";
+	}
+
+	void CToolpathLayerProcessor_HatchConsolidation::setStatistics(PToolpathStatistics pStatistics)
+	{
+		m_pStatistics = pStatistics;
+	}
+
+	void CToolpathLayerProcessor_HatchConsolidation::beginProcessing(PToolpathSource pSource)
+	{
+		if (pSource.get() == nullptr)
+			throw std::runtime_error("Invalid toolpath source");
+
+		m_LayerMotion.readSpeeds(*pSource);
+	}
+
+	void CToolpathLayerProcessor_HatchConsolidation::closeChain(sToolpathHatch2D* pHatches, const sHatchChain& chain)
+	{
+		if (chain.m_nHatchCount < 2)
+			return;
+
+		m_RemoveHatch[chain.m_nFirstHatchIndex] = 0;
+
+		// The joined hatch keeps the scan direction of the hatch whose place it takes
+		auto& firstHatch = pHatches[chain.m_nFirstHatchIndex];
+		double dFirstDirection = (firstHatch.m_Point2Coordinates[0] - firstHatch.m_Point1Coordinates[0]) * chain.m_dDirectionX
+			+ (firstHatch.m_Point2Coordinates[1] - firstHatch.m_Point1Coordinates[1]) * chain.m_dDirectionY;
+		const double* pStartPoint = (dFirstDirection >= 0.0) ? chain.m_pMinPoint : chain.m_pMaxPoint;
+		const double* pEndPoint = (dFirstDirection >= 0.0) ? chain.m_pMaxPoint : chain.m_pMinPoint;
+
+		sToolpathHatch2D mergedHatch;
+		mergedHatch.m_Point1Coordinates[0] = pStartPoint[0];
+		mergedHatch.m_Point1Coordinates[1] = pStartPoint[1];
+		mergedHatch.m_Point2Coordinates[0] = pEndPoint[0];
+		mergedHatch.m_Point2Coordinates[1] = pEndPoint[1];
+		m_MergedHatches.push_back(std::make_pair(chain.m_nFirstHatchIndex, mergedHatch));
+
+		m_nLayerMergedHatches += (chain.m_nHatchCount - 1);
+	}
+
+	void CToolpathLayerProcessor_HatchConsolidation::chainLineCluster(sToolpathHatch2D* pHatches, size_t nClusterBegin, size_t nClusterEnd)
+	{
+		double dBinWidth = HATCHCONSOLIDATION_PI / HATCHCONSOLIDATION_ANGLEBINCOUNT;
+
+		// The cluster spans several offset bins, its hatches are visited in order along the bin direction
+		std::sort(m_LineKeys.begin() + nClusterBegin, m_LineKeys.begin() + nClusterEnd, [](const sHatchLineKey& key1, const sHatchLineKey& key2) {
+			if (key1.m_dStart != key2.m_dStart)
+				return key1.m_dStart < key2.m_dStart;
+			return key1.m_nHatchIndex < key2.m_nHatchIndex;
+		});
+
+		m_OpenChains.clear();
+
+		for (size_t nKeyIndex = nClusterBegin; nKeyIndex < nClusterEnd; nKeyIndex++) {
+			auto& candidateKey = m_LineKeys[nKeyIndex];
+			auto& candidateHatch = pHatches[candidateKey.m_nHatchIndex];
+			bool bJoined = false;
+
+			size_t nChainIndex = 0;
+			while (nChainIndex < m_OpenChains.size()) {
+				auto& chain = m_OpenChains[nChainIndex];
+
+				double dDelta1X = candidateHatch.m_Point1Coordinates[0] - chain.m_dOriginX;
+				double dDelta1Y = candidateHatch.m_Point1Coordinates[1] - chain.m_dOriginY;
+				double dDelta2X = candidateHatch.m_Point2Coordinates[0] - chain.m_dOriginX;
+				double dDelta2Y = candidateHatch.m_Point2Coordinates[1] - chain.m_dOriginY;
+				double dPosition1 = dDelta1X * chain.m_dDirectionX + dDelta1Y * chain.m_dDirectionY;
+				double dPosition2 = dDelta2X * chain.m_dDirectionX + dDelta2Y * chain.m_dDirectionY;
+				double dDistance1 = std::fabs(dDelta1Y * chain.m_dDirectionX - dDelta1X * chain.m_dDirectionY);
+				double dDistance2 = std::fabs(dDelta2Y * chain.m_dDirectionX - dDelta2X * chain.m_dDirectionY);
+				double dCandidateMin = std::min(dPosition1, dPosition2);
+				double dCandidateMax = std::max(dPosition1, dPosition2);
+
+				// All further candidates start beyond the gap as well
+				if (dCandidateMin > chain.m_dMaxPosition + m_dMergeTolerance) {
+					closeChain(pHatches, chain);
+					m_OpenChains.erase(m_OpenChains.begin() + nChainIndex);
+					continue;
+				}
+
+				// Only a hatch that starts where the chain ends is joined, overlapping and contained hatches are kept
+				if (!bJoined && (dDistance1 <= m_dMergeTolerance) && (dDistance2 <= m_dMergeTolerance)
+					&& (dCandidateMin >= chain.m_dMaxPosition - m_dMergeTolerance) && (dCandidateMax > chain.m_dMaxPosition)) {
+					chain.m_dMaxPosition = dCandidateMax;
+					chain.m_pMaxPoint = (dPosition1 > dPosition2) ? candidateHatch.m_Point1Coordinates : candidateHatch.m_Point2Coordinates;
+					chain.m_nFirstHatchIndex = std::min(chain.m_nFirstHatchIndex, candidateKey.m_nHatchIndex);
+					chain.m_nHatchCount++;
+
+					m_RemoveHatch[chain.m_nAnchorHatchIndex] = 1;
+					m_RemoveHatch[candidateKey.m_nHatchIndex] = 1;
+					bJoined = true;
+				}
+
+				nChainIndex++;
+			}
+
+			if (bJoined)
+				continue;
+
+			// The line is oriented along the direction of its bin, so that the candidates follow in increasing position
+			sHatchChain chain;
+			chain.m_pMinPoint = candidateHatch.m_Point1Coordinates;
+			chain.m_pMaxPoint = candidateHatch.m_Point2Coordinates;
+			double dDirectionX = chain.m_pMaxPoint[0] - chain.m_pMinPoint[0];
+			double dDirectionY = chain.m_pMaxPoint[1] - chain.m_pMinPoint[1];
+			if (dDirectionX * std::cos(candidateKey.m_nAngleBin * dBinWidth) + dDirectionY * std::sin(candidateKey.m_nAngleBin * dBinWidth) < 0.0) {
+				std::swap(chain.m_pMinPoint, chain.m_pMaxPoint);
+				dDirectionX = -dDirectionX;
+				dDirectionY = -dDirectionY;
+			}
+
+			double dLength = std::sqrt(dDirectionX * dDirectionX + dDirectionY * dDirectionY);
+			chain.m_dOriginX = chain.m_pMinPoint[0];
+			chain.m_dOriginY = chain.m_pMinPoint[1];
+			chain.m_dDirectionX = dDirectionX / dLength;
+			chain.m_dDirectionY = dDirectionY / dLength;
+			chain.m_dMaxPosition = dLength;
+			chain.m_nAnchorHatchIndex = candidateKey.m_nHatchIndex;
+			chain.m_nFirstHatchIndex = candidateKey.m_nHatchIndex;
+			chain.m_nHatchCount = 1;
+			m_OpenChains.push_back(chain);
+		}
+
+		for (auto& chain : m_OpenChains)
+			closeChain(pHatches, chain);
+		m_OpenChains.clear();
+	}
+
+	void CToolpathLayerProcessor_HatchConsolidation::mergeCollinearHatches(sToolpathHatch2D* pHatches, uint32_t nHatchCount)
+	{
+		m_LineKeys.clear();
+		m_MergedHatches.clear();
+
+		double dBinWidth = HATCHCONSOLIDATION_PI / HATCHCONSOLIDATION_ANGLEBINCOUNT;
+
+		for (uint32_t nHatchIndex = 0; nHatchIndex < nHatchCount; nHatchIndex++) {
+			auto& hatch = pHatches[nHatchIndex];
+			double dDeltaX = hatch.m_Point2Coordinates[0] - hatch.m_Point1Coordinates[0];
+			double dDeltaY = hatch.m_Point2Coordinates[1] - hatch.m_Point1Coordinates[1];
+			double dLength = std::sqrt(dDeltaX * dDeltaX + dDeltaY * dDeltaY);
+			if (dLength <= 0.0)
+				continue;
+
+			// Both directions of a line map to the same bin, the bins are centered on their angle so that
+			// axis aligned hatches with rounding noise do not end up in different bins
+			int64_t nAngleBin = (int64_t)std::floor(std::atan2(dDeltaY, dDeltaX) / dBinWidth + 0.5) % HATCHCONSOLIDATION_ANGLEBINCOUNT;
+			if (nAngleBin < 0)
+				nAngleBin += HATCHCONSOLIDATION_ANGLEBINCOUNT;
+			double dBinDirectionX = std::cos(nAngleBin * dBinWidth);
+			double dBinDirectionY = std::sin(nAngleBin * dBinWidth);
+
+			double dOffset = dBinDirectionX * hatch.m_Point1Coordinates[1] - dBinDirectionY * hatch.m_Point1Coordinates[0];
+			double dStart1 = dBinDirectionX * hatch.m_Point1Coordinates[0] + dBinDirectionY * hatch.m_Point1Coordinates[1];
+			double dStart2 = dBinDirectionX * hatch.m_Point2Coordinates[0] + dBinDirectionY * hatch.m_Point2Coordinates[1];
+
+			sHatchLineKey lineKey;
+			lineKey.m_nAngleBin = nAngleBin;
+			lineKey.m_nOffsetBin = (int64_t)std::floor(dOffset / m_dMergeTolerance + 0.5);
+			lineKey.m_dStart = std::min(dStart1, dStart2);
+			lineKey.m_nHatchIndex = nHatchIndex;
+			m_LineKeys.push_back(lineKey);
+		}
+
+		std::sort(m_LineKeys.begin(), m_LineKeys.end(), [](const sHatchLineKey& key1, const sHatchLineKey& key2) {
+			if (key1.m_nAngleBin != key2.m_nAngleBin)
+				return key1.m_nAngleBin < key2.m_nAngleBin;
+			if (key1.m_nOffsetBin != key2.m_nOffsetBin)
+				return key1.m_nOffsetBin < key2.m_nOffsetBin;
+			if (key1.m_dStart != key2.m_dStart)
+				return key1.m_dStart < key2.m_dStart;
+			return key1.m_nHatchIndex < key2.m_nHatchIndex;
+		});
+
+		// Collinear hatches may fall on either side of an offset bin boundary, so a line cluster spans all
+		// adjacent offset bins, the distance to the line of each chain decides whether hatches are collinear
+		size_t nClusterBegin = 0;
+		while (nClusterBegin < m_LineKeys.size()) {
+			size_t nClusterEnd = nClusterBegin + 1;
+			while ((nClusterEnd < m_LineKeys.size()) && (m_LineKeys[nClusterEnd].m_nAngleBin == m_LineKeys[nClusterBegin].m_nAngleBin)
+				&& (m_LineKeys[nClusterEnd].m_nOffsetBin <= m_LineKeys[nClusterEnd - 1].m_nOffsetBin + 1))
+				nClusterEnd++;
+
+			if (nClusterEnd - nClusterBegin > 1)
+				chainLineCluster(pHatches, nClusterBegin, nClusterEnd);
+
+			nClusterBegin = nClusterEnd;
+		}
+
+		// The end points are referenced by the chains, so the hatches are only overwritten once all chains are known
+		for (auto& mergedHatch : m_MergedHatches)
+			pHatches[mergedHatch.first] = mergedHatch.second;
+	}
+
+	uint32_t CToolpathLayerProcessor_HatchConsolidation::removeHatches(sToolpathHatch2D* pHatches, uint32_t nHatchCount)
+	{
+		double dMinimumLengthSquared = m_dMinimumLength * m_dMinimumLength;
+
+		uint32_t nWriteIndex = 0;
+		for (uint32_t nHatchIndex = 0; nHatchIndex < nHatchCount; nHatchIndex++) {
+			if (m_RemoveHatch[nHatchIndex])
+				continue;
+
+			auto& hatch = pHatches[nHatchIndex];
+			if (m_dMinimumLength > 0.0) {
+				double dDeltaX = hatch.m_Point2Coordinates[0] - hatch.m_Point1Coordinates[0];
+				double dDeltaY = hatch.m_Point2Coordinates[1] - hatch.m_Point1Coordinates[1];
+				if (dDeltaX * dDeltaX + dDeltaY * dDeltaY < dMinimumLengthSquared) {
+					m_nLayerDroppedHatches++;
+					continue;
+				}
+			}
+
+			pHatches[nWriteIndex] = hatch;
+			nWriteIndex++;
+		}
+
+		return nWriteIndex;
+	}
+
+	void CToolpathLayerProcessor_HatchConsolidation::processLayer(CToolpathLayerData& layerData)
+	{
+		m_LayerBefore = m_LayerMotion.measureLayer(layerData);
+		m_nLayerHatchesBefore = 0;
+		m_nLayerMergedHatches = 0;
+		m_nLayerDroppedHatches = 0;
+
+		bool bHasRemovedHatches = false;
+		uint32_t nSegmentCount = layerData.getSegmentCount();
+		for (uint32_t nSegmentIndex = 0; nSegmentIndex < nSegmentCount; nSegmentIndex++) {
+			auto& segment = layerData.getSegment(nSegmentIndex);
+			if ((segment.m_Type != eToolpathSegmentType::Hatch) || (segment.m_nElementCount == 0))
+				continue;
+
+			uint32_t nHatchCount = segment.m_nElementCount;
+			sToolpathHatch2D* pHatches = layerData.getSegmentHatches(segment);
+			m_nLayerHatchesBefore += nHatchCount;
+
+			m_RemoveHatch.assign(nHatchCount, 0);
+			if (nHatchCount > 1)
+				mergeCollinearHatches(pHatches, nHatchCount);
+
+			uint32_t nRemainingCount = removeHatches(pHatches, nHatchCount);
+			if (nRemainingCount < nHatchCount) {
+				layerData.setSegmentElementCount(nSegmentIndex, nRemainingCount);
+				bHasRemovedHatches = true;
+			}
+		}
+
+		if (bHasRemovedHatches)
+			layerData.compactElements();
+
+		m_LayerAfter = m_LayerMotion.measureLayer(layerData);
+		CToolpathLayerMotion::addSummary(m_TotalBefore, m_LayerBefore);
+		CToolpathLayerMotion::addSummary(m_TotalAfter, m_LayerAfter);
+		m_nHatchesBefore += m_nLayerHatchesBefore;
+		m_nMergedHatches += m_nLayerMergedHatches;
+		m_nDroppedHatches += m_nLayerDroppedHatches;
+		m_nLayerCount++;
+	}
+
+	std::string CToolpathLayerProcessor_HatchConsolidation::getLayerSummary()
+	{
+		std::stringstream summaryStream;
+		summaryStream << std::fixed << std::setprecision(3)
+			<< "hatch consolidation: " << m_nLayerHatchesBefore << " -> " << (m_nLayerHatchesBefore - m_nLayerMergedHatches - m_nLayerDroppedHatches) << " hatches"
+			<< " (" << m_nLayerMergedHatches << " joined, " << m_nLayerDroppedHatches << " dropped)"
+			<< ", scan time " << m_LayerBefore.m_dScanTime << " -> " << m_LayerAfter.m_dScanTime << " s";
+		return summaryStream.str();
+	}
+
+	void CToolpathLayerProcessor_HatchConsolidation::endProcessing()
+	{
+		if (m_pStatistics.get() == nullptr)
+			return;
+
+		std::string sStage = getName();
+		m_pStatistics->setProcessingValue(sStage, "layers", (double)m_nLayerCount);
+		m_pStatistics->setProcessingValue(sStage, "hatchesBefore", (double)m_nHatchesBefore);
+		m_pStatistics->setProcessingValue(sStage, "hatchesAfter", (double)(m_nHatchesBefore - m_nMergedHatches - m_nDroppedHatches));
+		m_pStatistics->setProcessingValue(sStage, "joinedHatches", (double)m_nMergedHatches);
+		m_pStatistics->setProcessingValue(sStage, "droppedHatches", (double)m_nDroppedHatches);
+		m_pStatistics->setProcessingValue(sStage, "jumpDistanceBefore", m_TotalBefore.m_dJumpDistance);
+		m_pStatistics->setProcessingValue(sStage, "jumpDistanceAfter", m_TotalAfter.m_dJumpDistance);
+		m_pStatistics->setProcessingValue(sStage, "scanTimeBefore", m_TotalBefore.m_dScanTime);
+		m_pStatistics->setProcessingValue(sStage, "scanTimeAfter", m_TotalAfter.m_dScanTime);
+	}
+
+} // namespace Toolpath
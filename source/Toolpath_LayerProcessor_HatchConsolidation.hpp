@@ -0,0 +1,121 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#ifndef __TOOLPATH_LAYERPROCESSOR_HATCHCONSOLIDATION
+#define __TOOLPATH_LAYERPROCESSOR_HATCHCONSOLIDATION
+
+#include <vector>
+#include <cstdint>
+
+#include "Toolpath_LayerProcessor.hpp"
+#include "Toolpath_LayerMotion.hpp"
+
+namespace Toolpath {
+
+	/**
+	 * Joins collinear hatches of a hatch segment where one hatch ends within a tolerance of the start of the
+	 * next, and removes hatches that are shorter than a minimum length afterwards. Hatches that overlap or
+	 * contain each other beyond the tolerance are kept as they are. A joined hatch takes the place and the
+	 * direction of its first member in the segment, the order of the remaining hatches is kept.
+	 */
+	class CToolpathLayerProcessor_HatchConsolidation : public IToolpathLayerProcessor {
+	private:
+		// Hatches are sorted by direction and line offset bins, so that collinear candidates are adjacent
+		typedef struct _sHatchLineKey {
+			int64_t m_nAngleBin;
+			int64_t m_nOffsetBin;
+			double m_dStart;
+			uint32_t m_nHatchIndex;
+		} sHatchLineKey;
+
+		// Hatches joined end to end, measured along the line of the hatch that started the chain
+		typedef struct _sHatchChain {
+			double m_dOriginX;
+			double m_dOriginY;
+			double m_dDirectionX;
+			double m_dDirectionY;
+			double m_dMaxPosition;
+			const double* m_pMinPoint;
+			const double* m_pMaxPoint;
+			uint32_t m_nAnchorHatchIndex;
+			uint32_t m_nFirstHatchIndex;
+			uint32_t m_nHatchCount;
+		} sHatchChain;
+
+		double m_dMergeTolerance;
+		double m_dMinimumLength;
+
+		PToolpathStatistics m_pStatistics;
+		CToolpathLayerMotion m_LayerMotion;
+
+		sToolpathMotionSummary m_LayerBefore;
+		sToolpathMotionSummary m_LayerAfter;
+		sToolpathMotionSummary m_TotalBefore;
+		sToolpathMotionSummary m_TotalAfter;
+		uint64_t m_nLayerHatchesBefore;
+		uint64_t m_nLayerMergedHatches;
+		uint64_t m_nLayerDroppedHatches;
+		uint64_t m_nHatchesBefore;
+		uint64_t m_nMergedHatches;
+		uint64_t m_nDroppedHatches;
+		uint64_t m_nLayerCount;
+
+		// Buffers reused across segments
+		std::vector<sHatchLineKey> m_LineKeys;
+		std::vector<sHatchChain> m_OpenChains;
+		std::vector<uint8_t> m_RemoveHatch;
+		std::vector<std::pair<uint32_t, sToolpathHatch2D>> m_MergedHatches;
+
+		void mergeCollinearHatches(sToolpathHatch2D* pHatches, uint32_t nHatchCount);
+		void chainLineCluster(sToolpathHatch2D* pHatches, size_t nClusterBegin, size_t nClusterEnd);
+		void closeChain(sToolpathHatch2D* pHatches, const sHatchChain& chain);
+		uint32_t removeHatches(sToolpathHatch2D* pHatches, uint32_t nHatchCount);
+
+	public:
+		CToolpathLayerProcessor_HatchConsolidation();
+		virtual ~CToolpathLayerProcessor_HatchConsolidation() = default;
+
+		// Maximum distance in mm of a hatch end point from the line of the hatch it is joined to, and maximum gap or overlap between their ends
+		void setMergeTolerance(double dMergeTolerance);
+		// Hatches shorter than this length in mm are removed after joining, 0 keeps all hatches
+		void setMinimumLength(double dMinimumLength);
+
+		std::string getName() override;
+		void setStatistics(PToolpathStatistics pStatistics) override;
+		void beginProcessing(PToolpathSource pSource) override;
+		void processLayer(CToolpathLayerData& layerData) override;
+		std::string getLayerSummary() override;
+		void endProcessing() override;
+	};
+
+	typedef std::shared_ptr<CToolpathLayerProcessor_HatchConsolidation> PToolpathLayerProcessor_HatchConsolidation;
+
+} // namespace Toolpath
+
+#endif // __TOOLPATH_LAYERPROCESSOR_HATCHCONSOLIDATION
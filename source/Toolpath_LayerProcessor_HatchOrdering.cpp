@@ -0,0 +1,430 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#include "Toolpath_LayerProcessor_HatchOrdering.hpp"
+
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+
+// Hatches whose centers are closer than this across the hatch direction are scanned as one row, in mm
+#define TOOLPATH_HATCHORDERING_ROWTOLERANCE 1.0e-3
+
+// Longest subsequence that is reversed by a 2-opt move
+#define TOOLPATH_HATCHORDERING_TWOOPTWINDOW 48
+
+// Upper limit of the nearest neighbor grid size
+#define TOOLPATH_HATCHORDERING_MAXGRIDCELLS (1 << 22)
+
+namespace Toolpath {
+
+	static void reverseHatch(sToolpathHatch2D& hatch)
+	{
+		std::swap(hatch.m_Point1Coordinates[0], hatch.m_Point2Coordinates[0]);
+		std::swap(hatch.m_Point1Coordinates[1], hatch.m_Point2Coordinates[1]);
+	}
+
+	CToolpathLayerProcessor_HatchOrdering::CToolpathLayerProcessor_HatchOrdering()
+		: m_dTimeBudgetInSeconds(0.05),
+		m_nReorderedSegmentCount(0),
+		m_nLayerCount(0)
+	{
+		CToolpathLayerMotion::clearSummary(m_LayerBefore);
+		CToolpathLayerMotion::clearSummary(m_LayerAfter);
+		CToolpathLayerMotion::clearSummary(m_TotalBefore);
+		CToolpathLayerMotion::clearSummary(m_TotalAfter);
+	}
+
+	void CToolpathLayerProcessor_HatchOrdering::setTimeBudget(double dTimeBudgetInMilliseconds)
+	{
+		if (dTimeBudgetInMilliseconds < 0.0)
+			throw std::runtime_error("hatch ordering time budget must not be negative");
+
+		m_dTimeBudgetInSeconds = dTimeBudgetInMilliseconds * 0.001;
+	}
+
+	std::string CToolpathLayerProcessor_HatchOrdering::getName()
+	{
+		return "hatchOrdering";
+	}
+
+	void CToolpathLayerProcessor_HatchOrdering::setStatistics(PToolpathStatistics pStatistics)
+	{
+		m_pStatistics = pStatistics;
+	}
+
+	void CToolpathLayerProcessor_HatchOrdering::beginProcessing(PToolpathSource pSource)
+	{
+		if (pSource.get() == nullptr)
+			throw std::runtime_error("Invalid toolpath source");
+
+		m_LayerMotion.readSpeeds(*pSource);
+	}
+
+	double CToolpathLayerProcessor_HatchOrdering::computeJumpDistance(const sToolpathHatch2D* pHatches, uint32_t nHatchCount, bool bHasEntry, double dEntryX, double dEntryY)
+	{
+		double dJumpDistance = 0.0;
+		if (bHasEntry && (nHatchCount > 0))
+			dJumpDistance += CToolpathLayerMotion::getDistance(dEntryX, dEntryY, pHatches[0].m_Point1Coordinates[0], pHatches[0].m_Point1Coordinates[1]);
+
+		for (uint32_t nIndex = 1; nIndex < nHatchCount; nIndex++)
+			dJumpDistance += CToolpathLayerMotion::getDistance(pHatches[nIndex - 1].m_Point2Coordinates[0], pHatches[nIndex - 1].m_Point2Coordinates[1],
+				pHatches[nIndex].m_Point1Coordinates[0], pHatches[nIndex].m_Point1Coordinates[1]);
+
+		return dJumpDistance;
+	}
+
+	void CToolpathLayerProcessor_HatchOrdering::orderSerpentine(const sToolpathHatch2D* pHatches, uint32_t nHatchCount, std::vector<sToolpathHatch2D>& orderedHatches)
+	{
+		// Dominant hatch direction from the doubled angles, so that opposite directions add up
+		double dSumCos = 0.0;
+		double dSumSin = 0.0;
+		for (uint32_t nIndex = 0; nIndex < nHatchCount; nIndex++) {
+			double dDeltaX = pHatches[nIndex].m_Point2Coordinates[0] - pHatches[nIndex].m_Point1Coordinates[0];
+			double dDeltaY = pHatches[nIndex].m_Point2Coordinates[1] - pHatches[nIndex].m_Point1Coordinates[1];
+			double dLength = sqrt(dDeltaX * dDeltaX + dDeltaY * dDeltaY);
+			if (dLength > 0.0) {
+				dSumCos += (dDeltaX * dDeltaX - dDeltaY * dDeltaY) / dLength;
+				dSumSin += 2.0 * dDeltaX * dDeltaY / dLength;
+			}
+		}
+
+		double dAngle = 0.5 * atan2(dSumSin, dSumCos);
+		double dDirectionX = cos(dAngle);
+		double dDirectionY = sin(dAngle);
+
+		// Row offset across and position along the hatch direction of every hatch center
+		m_SortKeys.resize((size_t)nHatchCount * 2);
+		m_SortIndices.resize(nHatchCount);
+		for (uint32_t nIndex = 0; nIndex < nHatchCount; nIndex++) {
+			double dCenterX = 0.5 * (pHatches[nIndex].m_Point1Coordinates[0] + pHatches[nIndex].m_Point2Coordinates[0]);
+			double dCenterY = 0.5 * (pHatches[nIndex].m_Point1Coordinates[1] + pHatches[nIndex].m_Point2Coordinates[1]);
+			m_SortKeys[(size_t)nIndex * 2] = dCenterY * dDirectionX - dCenterX * dDirectionY;
+			m_SortKeys[(size_t)nIndex * 2 + 1] = dCenterX * dDirectionX + dCenterY * dDirectionY;
+			m_SortIndices[nIndex] = nIndex;
+		}
+
+		std::sort(m_SortIndices.begin(), m_SortIndices.end(), [this](uint32_t nIndex1, uint32_t nIndex2) {
+			return m_SortKeys[(size_t)nIndex1 * 2] < m_SortKeys[(size_t)nIndex2 * 2];
+		});
+
+		orderedHatches.clear();
+		bool bIsForward = true;
+		uint32_t nRowStart = 0;
+		while (nRowStart < nHatchCount) {
+			double dRowOffset = m_SortKeys[(size_t)m_SortIndices[nRowStart] * 2];
+			uint32_t nRowEnd = nRowStart + 1;
+			while ((nRowEnd < nHatchCount) && (m_SortKeys[(size_t)m_SortIndices[nRowEnd] * 2] - dRowOffset <= TOOLPATH_HATCHORDERING_ROWTOLERANCE))
+				nRowEnd++;
+
+			// Rows are scanned alternately along and against the hatch direction
+			std::sort(m_SortIndices.begin() + nRowStart, m_SortIndices.begin() + nRowEnd, [this, bIsForward](uint32_t nIndex1, uint32_t nIndex2) {
+				double dPosition1 = m_SortKeys[(size_t)nIndex1 * 2 + 1];
+				double dPosition2 = m_SortKeys[(size_t)nIndex2 * 2 + 1];
+				return bIsForward ? (dPosition1 < dPosition2) : (dPosition1 > dPosition2);
+			});
+
+			for (uint32_t nRowIndex = nRowStart; nRowIndex < nRowEnd; nRowIndex++) {
+				sToolpathHatch2D hatch = pHatches[m_SortIndices[nRowIndex]];
+				double dPosition1 = hatch.m_Point1Coordinates[0] * dDirectionX + hatch.m_Point1Coordinates[1] * dDirectionY;
+				double dPosition2 = hatch.m_Point2Coordinates[0] * dDirectionX + hatch.m_Point2Coordinates[1] * dDirectionY;
+				if (bIsForward ? (dPosition1 > dPosition2) : (dPosition1 < dPosition2))
+					reverseHatch(hatch);
+				orderedHatches.push_back(hatch);
+			}
+
+			bIsForward = !bIsForward;
+			nRowStart = nRowEnd;
+		}
+	}
+
+	void CToolpathLayerProcessor_HatchOrdering::orderNearestNeighbor(const sToolpathHatch2D* pHatches, uint32_t nHatchCount, bool bHasEntry, double dEntryX, double dEntryY, std::vector<sToolpathHatch2D>& orderedHatches)
+	{
+		// Uniform grid over the hatch end points with about one hatch per cell.
+		// Entry 2 * n is the first, entry 2 * n + 1 the second point of hatch n.
+		double dMinX = pHatches[0].m_Point1Coordinates[0];
+		double dMinY = pHatches[0].m_Point1Coordinates[1];
+		double dMaxX = dMinX;
+		double dMaxY = dMinY;
+		for (uint32_t nIndex = 0; nIndex < nHatchCount; nIndex++) {
+			auto& hatch = pHatches[nIndex];
+			dMinX = std::min(dMinX, std::min(hatch.m_Point1Coordinates[0], hatch.m_Point2Coordinates[0]));
+			dMinY = std::min(dMinY, std::min(hatch.m_Point1Coordinates[1], hatch.m_Point2Coordinates[1]));
+			dMaxX = std::max(dMaxX, std::max(hatch.m_Point1Coordinates[0], hatch.m_Point2Coordinates[0]));
+			dMaxY = std::max(dMaxY, std::max(hatch.m_Point1Coordinates[1], hatch.m_Point2Coordinates[1]));
+		}
+
+		double dCellSize = sqrt(std::max((dMaxX - dMinX) * (dMaxY - dMinY), 1.0e-12) / nHatchCount);
+		dCellSize = std::max(dCellSize, std::max(dMaxX - dMinX, dMaxY - dMinY) / sqrt((double)TOOLPATH_HATCHORDERING_MAXGRIDCELLS));
+		dCellSize = std::max(dCellSize, 1.0e-6);
+
+		int64_t nCellCountX = (int64_t)((dMaxX - dMinX) / dCellSize) + 1;
+		int64_t nCellCountY = (int64_t)((dMaxY - dMinY) / dCellSize) + 1;
+
+		auto getCellX = [&](double dX) { return std::min(std::max((int64_t)((dX - dMinX) / dCellSize), (int64_t)0), nCellCountX - 1); };
+		auto getCellY = [&](double dY) { return std::min(std::max((int64_t)((dY - dMinY) / dCellSize), (int64_t)0), nCellCountY - 1); };
+		auto getEntryX = [pHatches](uint32_t nEntry) { return (nEntry & 1) ? pHatches[nEntry >> 1].m_Point2Coordinates[0] : pHatches[nEntry >> 1].m_Point1Coordinates[0]; };
+		auto getEntryY = [pHatches](uint32_t nEntry) { return (nEntry & 1) ? pHatches[nEntry >> 1].m_Point2Coordinates[1] : pHatches[nEntry >> 1].m_Point1Coordinates[1]; };
+		auto getEntryCell = [&](uint32_t nEntry) { return (uint32_t)(getCellY(getEntryY(nEntry)) * nCellCountX + getCellX(getEntryX(nEntry))); };
+
+		uint32_t nEntryCount = nHatchCount * 2;
+		size_t nCellCount = (size_t)(nCellCountX * nCellCountY);
+		m_GridCellStarts.assign(nCellCount + 1, 0);
+		m_GridCellCounts.assign(nCellCount, 0);
+		m_GridEntries.resize(nEntryCount);
+		m_GridEntryPositions.resize(nEntryCount);
+
+		for (uint32_t nEntry = 0; nEntry < nEntryCount; nEntry++)
+			m_GridCellCounts[getEntryCell(nEntry)]++;
+		for (size_t nCell = 0; nCell < nCellCount; nCell++)
+			m_GridCellStarts[nCell + 1] = m_GridCellStarts[nCell] + m_GridCellCounts[nCell];
+
+		std::fill(m_GridCellCounts.begin(), m_GridCellCounts.end(), 0);
+		for (uint32_t nEntry = 0; nEntry < nEntryCount; nEntry++) {
+			uint32_t nCell = getEntryCell(nEntry);
+			uint32_t nPosition = m_GridCellStarts[nCell] + m_GridCellCounts[nCell]++;
+			m_GridEntries[nPosition] = nEntry;
+			m_GridEntryPositions[nEntry] = nPosition;
+		}
+
+		// Visited entries are swapped behind the live entries of their cell
+		auto removeEntry = [&](uint32_t nEntry) {
+			uint32_t nCell = getEntryCell(nEntry);
+			uint32_t nPosition = m_GridEntryPositions[nEntry];
+			uint32_t nLastPosition = m_GridCellStarts[nCell] + m_GridCellCounts[nCell] - 1;
+			uint32_t nLastEntry = m_GridEntries[nLastPosition];
+			m_GridEntries[nPosition] = nLastEntry;
+			m_GridEntryPositions[nLastEntry] = nPosition;
+			m_GridEntries[nLastPosition] = nEntry;
+			m_GridEntryPositions[nEntry] = nLastPosition;
+			m_GridCellCounts[nCell]--;
+		};
+
+		double dCurrentX = bHasEntry ? dEntryX : pHatches[0].m_Point1Coordinates[0];
+		double dCurrentY = bHasEntry ? dEntryY : pHatches[0].m_Point1Coordinates[1];
+		int64_t nMaxRing = std::max(nCellCountX, nCellCountY);
+
+		orderedHatches.clear();
+		for (uint32_t nStep = 0; nStep < nHatchCount; nStep++) {
+			int64_t nCenterX = getCellX(dCurrentX);
+			int64_t nCenterY = getCellY(dCurrentY);
+
+			uint32_t nBestEntry = 0;
+			double dBestDistance = std::numeric_limits<double>::max();
+			bool bFound = false;
+
+			for (int64_t nRing = 0; nRing <= nMaxRing; nRing++) {
+				for (int64_t nCellY = nCenterY - nRing; nCellY <= nCenterY + nRing; nCellY++) {
+					if ((nCellY < 0) || (nCellY >= nCellCountY))
+						continue;
+
+					// Only the border cells of the ring
+					bool bIsBorderRow = (nCellY == nCenterY - nRing) || (nCellY == nCenterY + nRing);
+					int64_t nStepX = (bIsBorderRow || (nRing == 0)) ? 1 : 2 * nRing;
+					for (int64_t nCellX = nCenterX - nRing; nCellX <= nCenterX + nRing; nCellX += nStepX) {
+						if ((nCellX < 0) || (nCellX >= nCellCountX))
+							continue;
+
+						size_t nCell = (size_t)(nCellY * nCellCountX + nCellX);
+						uint32_t nStart = m_GridCellStarts[nCell];
+						uint32_t nEnd = nStart + m_GridCellCounts[nCell];
+						for (uint32_t nPosition = nStart; nPosition < nEnd; nPosition++) {
+							uint32_t nEntry = m_GridEntries[nPosition];
+							double dDistance = CToolpathLayerMotion::getDistance(dCurrentX, dCurrentY, getEntryX(nEntry), getEntryY(nEntry));
+							if (dDistance < dBestDistance) {
+								dBestDistance = dDistance;
+								nBestEntry = nEntry;
+								bFound = true;
+							}
+						}
+					}
+				}
+
+				// Entries outside of this ring are at least nRing cells away
+				if (bFound && (dBestDistance <= nRing * dCellSize))
+					break;
+			}
+
+			if (!bFound)
+				throw std::runtime_error("hatch ordering lost a hatch");
+
+			uint32_t nHatchIndex = nBestEntry >> 1;
+			sToolpathHatch2D hatch = pHatches[nHatchIndex];
+			if (nBestEntry & 1)
+				reverseHatch(hatch);
+			orderedHatches.push_back(hatch);
+
+			removeEntry(nHatchIndex * 2);
+			removeEntry(nHatchIndex * 2 + 1);
+
+			dCurrentX = hatch.m_Point2Coordinates[0];
+			dCurrentY = hatch.m_Point2Coordinates[1];
+		}
+	}
+
+	void CToolpathLayerProcessor_HatchOrdering::refineTwoOpt(std::vector<sToolpathHatch2D>& orderedHatches, bool bHasEntry, double dEntryX, double dEntryY, uint64_t nDeadlineInNanoseconds)
+	{
+		// Reversing hatches [i, j] only changes the jump into hatch i and the jump out of hatch j,
+		// the jumps inside the reversed range keep their lengths.
+		size_t nHatchCount = orderedHatches.size();
+		bool bImproved = true;
+		uint64_t nMoveCount = 0;
+
+		while (bImproved) {
+			bImproved = false;
+
+			for (size_t nFirst = 0; nFirst < nHatchCount; nFirst++) {
+				if (((++nMoveCount & 63) == 0) && (CToolpathStatistics::getWallTimeInNanoseconds() > nDeadlineInNanoseconds))
+					return;
+
+				bool bHasPrevious = (nFirst > 0) || bHasEntry;
+				double dPreviousX = (nFirst > 0) ? orderedHatches[nFirst - 1].m_Point2Coordinates[0] : dEntryX;
+				double dPreviousY = (nFirst > 0) ? orderedHatches[nFirst - 1].m_Point2Coordinates[1] : dEntryY;
+
+				size_t nLastLimit = std::min(nHatchCount, nFirst + TOOLPATH_HATCHORDERING_TWOOPTWINDOW);
+				for (size_t nLast = nFirst; nLast < nLastLimit; nLast++) {
+					auto& firstHatch = orderedHatches[nFirst];
+					auto& lastHatch = orderedHatches[nLast];
+
+					double dOldDistance = 0.0;
+					double dNewDistance = 0.0;
+					if (bHasPrevious) {
+						dOldDistance += CToolpathLayerMotion::getDistance(dPreviousX, dPreviousY, firstHatch.m_Point1Coordinates[0], firstHatch.m_Point1Coordinates[1]);
+						dNewDistance += CToolpathLayerMotion::getDistance(dPreviousX, dPreviousY, lastHatch.m_Point2Coordinates[0], lastHatch.m_Point2Coordinates[1]);
+					}
+					if (nLast + 1 < nHatchCount) {
+						auto& nextHatch = orderedHatches[nLast + 1];
+						dOldDistance += CToolpathLayerMotion::getDistance(lastHatch.m_Point2Coordinates[0], lastHatch.m_Point2Coordinates[1], nextHatch.m_Point1Coordinates[0], nextHatch.m_Point1Coordinates[1]);
+						dNewDistance += CToolpathLayerMotion::getDistance(firstHatch.m_Point1Coordinates[0], firstHatch.m_Point1Coordinates[1], nextHatch.m_Point1Coordinates[0], nextHatch.m_Point1Coordinates[1]);
+					}
+
+					if (dNewDistance < dOldDistance - 1.0e-9) {
+						std::reverse(orderedHatches.begin() + nFirst, orderedHatches.begin() + nLast + 1);
+						for (size_t nIndex = nFirst; nIndex <= nLast; nIndex++)
+							reverseHatch(orderedHatches[nIndex]);
+						bImproved = true;
+					}
+				}
+			}
+		}
+	}
+
+	void CToolpathLayerProcessor_HatchOrdering::processLayer(CToolpathLayerData& layerData)
+	{
+		m_LayerBefore = m_LayerMotion.measureLayer(layerData);
+
+		uint64_t nRemainingHatchCount = 0;
+		for (auto& segment : layerData.getSegments()) {
+			if (segment.m_Type == eToolpathSegmentType::Hatch)
+				nRemainingHatchCount += segment.m_nElementCount;
+		}
+
+		uint64_t nLayerDeadline = CToolpathStatistics::getWallTimeInNanoseconds() + (uint64_t)(m_dTimeBudgetInSeconds * 1.0e9);
+
+		bool bHasPosition = false;
+		double dPositionX = 0.0;
+		double dPositionY = 0.0;
+
+		uint32_t nSegmentCount = layerData.getSegmentCount();
+		for (uint32_t nSegmentIndex = 0; nSegmentIndex < nSegmentCount; nSegmentIndex++) {
+			auto& segment = layerData.getSegment(nSegmentIndex);
+			uint32_t nHatchCount = segment.m_nElementCount;
+
+			if ((segment.m_Type == eToolpathSegmentType::Hatch) && ((nHatchCount > 1) || (bHasPosition && (nHatchCount == 1)))) {
+				sToolpathHatch2D* pHatches = layerData.getSegmentHatches(segment);
+				double dOriginalDistance = computeJumpDistance(pHatches, nHatchCount, bHasPosition, dPositionX, dPositionY);
+
+				orderSerpentine(pHatches, nHatchCount, m_SerpentineHatches);
+				orderNearestNeighbor(pHatches, nHatchCount, bHasPosition, dPositionX, dPositionY, m_NearestNeighborHatches);
+
+				double dSerpentineDistance = computeJumpDistance(m_SerpentineHatches.data(), nHatchCount, bHasPosition, dPositionX, dPositionY);
+				double dNearestNeighborDistance = computeJumpDistance(m_NearestNeighborHatches.data(), nHatchCount, bHasPosition, dPositionX, dPositionY);
+				auto& orderedHatches = (dSerpentineDistance <= dNearestNeighborDistance) ? m_SerpentineHatches : m_NearestNeighborHatches;
+
+				// The remaining budget of the layer is shared by hatch count
+				if (m_dTimeBudgetInSeconds > 0.0) {
+					uint64_t nNow = CToolpathStatistics::getWallTimeInNanoseconds();
+					if (nNow < nLayerDeadline) {
+						uint64_t nSegmentDeadline = nNow + (nLayerDeadline - nNow) * nHatchCount / nRemainingHatchCount;
+						refineTwoOpt(orderedHatches, bHasPosition, dPositionX, dPositionY, nSegmentDeadline);
+					}
+				}
+
+				double dOrderedDistance = computeJumpDistance(orderedHatches.data(), nHatchCount, bHasPosition, dPositionX, dPositionY);
+				if (dOrderedDistance < dOriginalDistance) {
+					std::copy(orderedHatches.begin(), orderedHatches.end(), pHatches);
+					m_nReorderedSegmentCount++;
+				}
+			}
+
+			if (segment.m_Type == eToolpathSegmentType::Hatch)
+				nRemainingHatchCount -= nHatchCount;
+
+			double dEndX, dEndY;
+			if (CToolpathLayerMotion::getSegmentEnd(layerData, segment, dEndX, dEndY)) {
+				dPositionX = dEndX;
+				dPositionY = dEndY;
+				bHasPosition = true;
+			}
+		}
+
+		m_LayerAfter = m_LayerMotion.measureLayer(layerData);
+		CToolpathLayerMotion::addSummary(m_TotalBefore, m_LayerBefore);
+		CToolpathLayerMotion::addSummary(m_TotalAfter, m_LayerAfter);
+		m_nLayerCount++;
+	}
+
+	std::string CToolpathLayerProcessor_HatchOrdering::getLayerSummary()
+	{
+		std::stringstream summaryStream;
+		summaryStream << std::fixed << std::setprecision(3)
+			<< "hatch ordering: jump distance " << m_LayerBefore.m_dJumpDistance << " -> " << m_LayerAfter.m_dJumpDistance << " mm"
+			<< ", scan time " << m_LayerBefore.m_dScanTime << " -> " << m_LayerAfter.m_dScanTime << " s";
+		return summaryStream.str();
+	}
+
+	void CToolpathLayerProcessor_HatchOrdering::endProcessing()
+	{
+		if (m_pStatistics.get() == nullptr)
+			return;
+
+		std::string sStage = getName();
+		m_pStatistics->setProcessingValue(sStage, "layers", (double)m_nLayerCount);
+		m_pStatistics->setProcessingValue(sStage, "reorderedSegments", (double)m_nReorderedSegmentCount);
+		m_pStatistics->setProcessingValue(sStage, "markDistance", m_TotalAfter.m_dMarkDistance);
+		m_pStatistics->setProcessingValue(sStage, "jumpDistanceBefore", m_TotalBefore.m_dJumpDistance);
+		m_pStatistics->setProcessingValue(sStage, "jumpDistanceAfter", m_TotalAfter.m_dJumpDistance);
+		m_pStatistics->setProcessingValue(sStage, "scanTimeBefore", m_TotalBefore.m_dScanTime);
+		m_pStatistics->setProcessingValue(sStage, "scanTimeAfter", m_TotalAfter.m_dScanTime);
+	}
+
+} // namespace Toolpath
@@ -0,0 +1,97 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#ifndef __TOOLPATH_LAYERPROCESSOR_HATCHORDERING
+#define __TOOLPATH_LAYERPROCESSOR_HATCHORDERING
+
+#include <vector>
+#include <cstdint>
+
+#include "Toolpath_LayerProcessor.hpp"
+#include "Toolpath_LayerMotion.hpp"
+
+namespace Toolpath {
+
+	/**
+	 * Reorders and reverses the hatches of every hatch segment to shorten the jumps between them.
+	 * A bidirectional serpentine order and a nearest neighbor tour are built, the shorter one is refined
+	 * with 2-opt moves until the time budget of the layer is used up. The hatch set of a segment is kept,
+	 * and a segment keeps its original order if no shorter one was found.
+	 */
+	class CToolpathLayerProcessor_HatchOrdering : public IToolpathLayerProcessor {
+	private:
+		// Time for the 2-opt refinement of one layer, shared by its segments by hatch count
+		double m_dTimeBudgetInSeconds;
+
+		PToolpathStatistics m_pStatistics;
+		CToolpathLayerMotion m_LayerMotion;
+
+		sToolpathMotionSummary m_LayerBefore;
+		sToolpathMotionSummary m_LayerAfter;
+		sToolpathMotionSummary m_TotalBefore;
+		sToolpathMotionSummary m_TotalAfter;
+		uint64_t m_nReorderedSegmentCount;
+		uint64_t m_nLayerCount;
+
+		// Buffers reused across segments
+		std::vector<sToolpathHatch2D> m_SerpentineHatches;
+		std::vector<sToolpathHatch2D> m_NearestNeighborHatches;
+		std::vector<uint32_t> m_SortIndices;
+		std::vector<double> m_SortKeys;
+		std::vector<uint32_t> m_GridCellStarts;
+		std::vector<uint32_t> m_GridCellCounts;
+		std::vector<uint32_t> m_GridEntries;
+		std::vector<uint32_t> m_GridEntryPositions;
+
+		void orderSerpentine(const sToolpathHatch2D* pHatches, uint32_t nHatchCount, std::vector<sToolpathHatch2D>& orderedHatches);
+		void orderNearestNeighbor(const sToolpathHatch2D* pHatches, uint32_t nHatchCount, bool bHasEntry, double dEntryX, double dEntryY, std::vector<sToolpathHatch2D>& orderedHatches);
+		void refineTwoOpt(std::vector<sToolpathHatch2D>& orderedHatches, bool bHasEntry, double dEntryX, double dEntryY, uint64_t nDeadlineInNanoseconds);
+
+		static double computeJumpDistance(const sToolpathHatch2D* pHatches, uint32_t nHatchCount, bool bHasEntry, double dEntryX, double dEntryY);
+
+	public:
+		CToolpathLayerProcessor_HatchOrdering();
+		virtual ~CToolpathLayerProcessor_HatchOrdering() = default;
+
+		// Time budget of the 2-opt refinement per layer, 0 keeps the better construction order
+		void setTimeBudget(double dTimeBudgetInMilliseconds);
+
+		std::string getName() override;
+		void setStatistics(PToolpathStatistics pStatistics) override;
+		void beginProcessing(PToolpathSource pSource) override;
+		void processLayer(CToolpathLayerData& layerData) override;
+		std::string getLayerSummary() override;
+		void endProcessing() override;
+	};
+
+	typedef std::shared_ptr<CToolpathLayerProcessor_HatchOrdering> PToolpathLayerProcessor_HatchOrdering;
+
+} // namespace Toolpath
+
+#endif // __TOOLPATH_LAYERPROCESSOR_HATCHORDERING
@@ -0,0 +1,153 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#include "Toolpath_LayerProcessor_LoopSeam.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+
+namespace Toolpath {
+
+	CToolpathLayerProcessor_LoopSeam::CToolpathLayerProcessor_LoopSeam()
+		: m_nLayerMovedSeamCount(0),
+		m_nMovedSeamCount(0),
+		m_nLoopCount(0),
+		m_nLayerCount(0)
+	{
+		CToolpathLayerMotion::clearSummary(m_LayerBefore);
+		CToolpathLayerMotion::clearSummary(m_LayerAfter);
+		CToolpathLayerMotion::clearSummary(m_TotalBefore);
+		CToolpathLayerMotion::clearSummary(m_TotalAfter);
+	}
+
+	std::string CToolpathLayerProcessor_LoopSeam::getName()
+	{
+		return "loopSeam";
+	}
+
+	void CToolpathLayerProcessor_LoopSeam::setStatistics(PToolpathStatistics pStatistics)
+	{
+		m_pStatistics = pStatistics;
+	}
+
+	void CToolpathLayerProcessor_LoopSeam::beginProcessing(PToolpathSource pSource)
+	{
+		if (pSource.get() == nullptr)
+			throw std::runtime_error("Invalid toolpath source");
+
+		m_LayerMotion.readSpeeds(*pSource);
+	}
+
+	void CToolpathLayerProcessor_LoopSeam::processLayer(CToolpathLayerData& layerData)
+	{
+		m_LayerBefore = m_LayerMotion.measureLayer(layerData);
+		m_nLayerMovedSeamCount = 0;
+
+		bool bHasPosition = false;
+		double dPositionX = 0.0;
+		double dPositionY = 0.0;
+
+		// Every loop is visited once and its vertices are scanned once, so the pass is linear in the point count of the layer
+		uint32_t nSegmentCount = layerData.getSegmentCount();
+		for (uint32_t nSegmentIndex = 0; nSegmentIndex < nSegmentCount; nSegmentIndex++) {
+			auto& segment = layerData.getSegment(nSegmentIndex);
+
+			if ((segment.m_Type == eToolpathSegmentType::Loop) && (segment.m_nElementCount > 2)) {
+				m_nLoopCount++;
+
+				sToolpathPoint2D* pPoints = layerData.getSegmentPoints(segment);
+				uint32_t nVertexCount = segment.m_nElementCount - 1;
+				auto& firstPoint = pPoints[0];
+				auto& lastPoint = pPoints[nVertexCount];
+				bool bIsClosed = (firstPoint.m_Coordinates[0] == lastPoint.m_Coordinates[0]) && (firstPoint.m_Coordinates[1] == lastPoint.m_Coordinates[1]);
+
+				if (bHasPosition && bIsClosed) {
+					uint32_t nBestVertex = 0;
+					double dBestDistanceSquared = 0.0;
+					for (uint32_t nVertex = 0; nVertex < nVertexCount; nVertex++) {
+						double dDeltaX = pPoints[nVertex].m_Coordinates[0] - dPositionX;
+						double dDeltaY = pPoints[nVertex].m_Coordinates[1] - dPositionY;
+						double dDistanceSquared = dDeltaX * dDeltaX + dDeltaY * dDeltaY;
+						if ((nVertex == 0) || (dDistanceSquared < dBestDistanceSquared)) {
+							dBestDistanceSquared = dDistanceSquared;
+							nBestVertex = nVertex;
+						}
+					}
+
+					// The closing point is dropped, the vertices are rotated and the loop is closed again
+					if (nBestVertex > 0) {
+						std::rotate(pPoints, pPoints + nBestVertex, pPoints + nVertexCount);
+						pPoints[nVertexCount] = pPoints[0];
+						m_nLayerMovedSeamCount++;
+					}
+				}
+			}
+
+			double dEndX, dEndY;
+			if (CToolpathLayerMotion::getSegmentEnd(layerData, segment, dEndX, dEndY)) {
+				dPositionX = dEndX;
+				dPositionY = dEndY;
+				bHasPosition = true;
+			}
+		}
+
+		m_LayerAfter = m_LayerMotion.measureLayer(layerData);
+		CToolpathLayerMotion::addSummary(m_TotalBefore, m_LayerBefore);
+		CToolpathLayerMotion::addSummary(m_TotalAfter, m_LayerAfter);
+		m_nMovedSeamCount += m_nLayerMovedSeamCount;
+		m_nLayerCount++;
+	}
+
+	std::string CToolpathLayerProcessor_LoopSeam::getLayerSummary()
+	{
+		std::stringstream summaryStream;
+		summaryStream << std::fixed << std::setprecision(3)
+			<< "loop seams: " << m_nLayerMovedSeamCount << " moved, jump distance " << m_LayerBefore.m_dJumpDistance << " -> " << m_LayerAfter.m_dJumpDistance << " mm"
+			<< ", scan time " << m_LayerBefore.m_dScanTime << " -> " << m_LayerAfter.m_dScanTime << " s";
+		return summaryStream.str();
+	}
+
+	void CToolpathLayerProcessor_LoopSeam::endProcessing()
+	{
+		if (m_pStatistics.get() == nullptr)
+			return;
+
+		std::string sStage = getName();
+		m_pStatistics->setProcessingValue(sStage, "layers", (double)m_nLayerCount);
+		m_pStatistics->setProcessingValue(sStage, "loops", (double)m_nLoopCount);
+		m_pStatistics->setProcessingValue(sStage, "movedSeams", (double)m_nMovedSeamCount);
+		m_pStatistics->setProcessingValue(sStage, "jumpDistanceBefore", m_TotalBefore.m_dJumpDistance);
+		m_pStatistics->setProcessingValue(sStage, "jumpDistanceAfter", m_TotalAfter.m_dJumpDistance);
+		m_pStatistics->setProcessingValue(sStage, "scanTimeBefore", m_TotalBefore.m_dScanTime);
+		m_pStatistics->setProcessingValue(sStage, "scanTimeAfter", m_TotalAfter.m_dScanTime);
+	}
+
+} // namespace Toolpath
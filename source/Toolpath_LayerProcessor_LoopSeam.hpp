@@ -0,0 +1,74 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#ifndef __TOOLPATH_LAYERPROCESSOR_LOOPSEAM
+#define __TOOLPATH_LAYERPROCESSOR_LOOPSEAM
+
+#include <cstdint>
+
+#include "Toolpath_LayerProcessor.hpp"
+#include "Toolpath_LayerMotion.hpp"
+
+namespace Toolpath {
+
+	/**
+	 * Moves the start vertex of every closed loop to the vertex closest to the end of the previous segment,
+	 * so that the jump into the loop is as short as possible. The loop geometry is unchanged.
+	 */
+	class CToolpathLayerProcessor_LoopSeam : public IToolpathLayerProcessor {
+	private:
+		PToolpathStatistics m_pStatistics;
+		CToolpathLayerMotion m_LayerMotion;
+
+		sToolpathMotionSummary m_LayerBefore;
+		sToolpathMotionSummary m_LayerAfter;
+		sToolpathMotionSummary m_TotalBefore;
+		sToolpathMotionSummary m_TotalAfter;
+		uint64_t m_nLayerMovedSeamCount;
+		uint64_t m_nMovedSeamCount;
+		uint64_t m_nLoopCount;
+		uint64_t m_nLayerCount;
+
+	public:
+		CToolpathLayerProcessor_LoopSeam();
+		virtual ~CToolpathLayerProcessor_LoopSeam() = default;
+
+		std::string getName() override;
+		void setStatistics(PToolpathStatistics pStatistics) override;
+		void beginProcessing(PToolpathSource pSource) override;
+		void processLayer(CToolpathLayerData& layerData) override;
+		std::string getLayerSummary() override;
+		void endProcessing() override;
+	};
+
+	typedef std::shared_ptr<CToolpathLayerProcessor_LoopSeam> PToolpathLayerProcessor_LoopSeam;
+
+} // namespace Toolpath
+
+#endif // __TOOLPATH_LAYERPROCESSOR_LOOPSEAM
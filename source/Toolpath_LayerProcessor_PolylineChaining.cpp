@@ -0,0 +1,288 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#include "Toolpath_LayerProcessor_PolylineChaining.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+#include <cmath>
+
+namespace Toolpath {
+
+	CToolpathLayerProcessor_PolylineChaining::CToolpathLayerProcessor_PolylineChaining()
+		: m_dTolerance(0.001),
+		m_bKeepDirection(false),
+		m_nLayerPolylinesBefore(0),
+		m_nLayerPolylinesAfter(0),
+		m_nPolylinesBefore(0),
+		m_nPolylinesAfter(0),
+		m_nLayerCount(0)
+	{
+		CToolpathLayerMotion::clearSummary(m_LayerBefore);
+		CToolpathLayerMotion::clearSummary(m_LayerAfter);
+		CToolpathLayerMotion::clearSummary(m_TotalBefore);
+		CToolpathLayerMotion::clearSummary(m_TotalAfter);
+	}
+
+	void CToolpathLayerProcessor_PolylineChaining::setTolerance(double dTolerance)
+	{
+		if (!std::isfinite(dTolerance) || (dTolerance <= 0.0))
+			throw std::runtime_error("invalid polyline chaining tolerance");
+
+		m_dTolerance = dTolerance;
+	}
+
+	void CToolpathLayerProcessor_PolylineChaining::setKeepDirection(bool bKeepDirection)
+	{
+		m_bKeepDirection = bKeepDirection;
+	}
+
+	std::string CToolpathLayerProcessor_PolylineChaining::getName()
+	{
+		return "polylineChaining";
+	}
+
+	void CToolpathLayerProcessor_PolylineChaining::setStatistics(PToolpathStatistics pStatistics)
+	{
+		m_pStatistics = pStatistics;
+	}
+
+	void CToolpathLayerProcessor_PolylineChaining::beginProcessing(PToolpathSource pSource)
+	{
+		if (pSource.get() == nullptr)
+			throw std::runtime_error("Invalid toolpath source");
+
+		m_LayerMotion.readSpeeds(*pSource);
+	}
+
+	uint64_t CToolpathLayerProcessor_PolylineChaining::computeCellHash(const sToolpathSegment& segment, int64_t nCellX, int64_t nCellY)
+	{
+		// FNV-1a over the words of the key, parts and profiles share the index
+		uint64_t keyWords[4] = { segment.m_nPartIndex, segment.m_nProfileIndex, (uint64_t)nCellX, (uint64_t)nCellY };
+		uint64_t nHash = 14695981039346656037ULL;
+		for (uint64_t nKeyWord : keyWords) {
+			nHash ^= nKeyWord;
+			nHash *= 1099511628211ULL;
+		}
+		return nHash;
+	}
+
+	bool CToolpathLayerProcessor_PolylineChaining::findLink(const CToolpathLayerData& layerData, const sToolpathSegment& segment, const sToolpathPoint2D& point, bool bAtChainEnd, sChainLink& link)
+	{
+		double dPointX = point.m_Coordinates[0];
+		double dPointY = point.m_Coordinates[1];
+		int64_t nCellX = (int64_t)std::floor(dPointX / m_dTolerance);
+		int64_t nCellY = (int64_t)std::floor(dPointY / m_dTolerance);
+		double dToleranceSquared = m_dTolerance * m_dTolerance;
+
+		// The polyline with the lowest index wins, so that the chains do not depend on the hash order
+		bool bHasLink = false;
+		for (int64_t nDeltaY = -1; nDeltaY <= 1; nDeltaY++) {
+			for (int64_t nDeltaX = -1; nDeltaX <= 1; nDeltaX++) {
+				uint64_t nCellHash = computeCellHash(segment, nCellX + nDeltaX, nCellY + nDeltaY);
+				auto iEndpointIter = std::lower_bound(m_Endpoints.begin(), m_Endpoints.end(), nCellHash, [](const sChainEndpoint& endpoint, uint64_t nHash) {
+					return endpoint.m_nCellHash < nHash;
+				});
+
+				for (; (iEndpointIter != m_Endpoints.end()) && (iEndpointIter->m_nCellHash == nCellHash); iEndpointIter++) {
+					uint32_t nSegmentIndex = iEndpointIter->m_nSegmentIndex;
+					if (m_SegmentIsChained[nSegmentIndex])
+						continue;
+
+					// A chain end continues at the start of a polyline, a chain start at the end of a polyline
+					bool bIsReversed = (iEndpointIter->m_bIsEnd != 0) == bAtChainEnd;
+					if (bIsReversed && m_bKeepDirection)
+						continue;
+
+					auto& candidate = layerData.getSegment(nSegmentIndex);
+					if ((candidate.m_nPartIndex != segment.m_nPartIndex) || (candidate.m_nProfileIndex != segment.m_nProfileIndex))
+						continue;
+
+					auto pPoints = layerData.getSegmentPoints(candidate);
+					auto& endpoint = iEndpointIter->m_bIsEnd ? pPoints[candidate.m_nElementCount - 1] : pPoints[0];
+					double dDeltaX = endpoint.m_Coordinates[0] - dPointX;
+					double dDeltaY = endpoint.m_Coordinates[1] - dPointY;
+					if (dDeltaX * dDeltaX + dDeltaY * dDeltaY > dToleranceSquared)
+						continue;
+
+					if (!bHasLink || (nSegmentIndex < link.m_nSegmentIndex) || ((nSegmentIndex == link.m_nSegmentIndex) && link.m_bIsReversed && !bIsReversed)) {
+						link.m_nSegmentIndex = nSegmentIndex;
+						link.m_bIsReversed = bIsReversed;
+						bHasLink = true;
+					}
+				}
+			}
+		}
+
+		return bHasLink;
+	}
+
+	void CToolpathLayerProcessor_PolylineChaining::processLayer(CToolpathLayerData& layerData)
+	{
+		m_LayerBefore = m_LayerMotion.measureLayer(layerData);
+		m_nLayerPolylinesBefore = 0;
+
+		uint32_t nSegmentCount = layerData.getSegmentCount();
+		m_Endpoints.clear();
+		for (uint32_t nSegmentIndex = 0; nSegmentIndex < nSegmentCount; nSegmentIndex++) {
+			auto& segment = layerData.getSegment(nSegmentIndex);
+			if ((segment.m_Type != eToolpathSegmentType::Polyline) || (segment.m_nElementCount < 2))
+				continue;
+
+			m_nLayerPolylinesBefore++;
+			auto pPoints = layerData.getSegmentPoints(segment);
+			for (uint32_t nIsEnd = 0; nIsEnd < 2; nIsEnd++) {
+				auto& point = nIsEnd ? pPoints[segment.m_nElementCount - 1] : pPoints[0];
+				sChainEndpoint endpoint;
+				endpoint.m_nCellHash = computeCellHash(segment, (int64_t)std::floor(point.m_Coordinates[0] / m_dTolerance), (int64_t)std::floor(point.m_Coordinates[1] / m_dTolerance));
+				endpoint.m_nSegmentIndex = nSegmentIndex;
+				endpoint.m_bIsEnd = nIsEnd;
+				m_Endpoints.push_back(endpoint);
+			}
+		}
+
+		std::sort(m_Endpoints.begin(), m_Endpoints.end(), [](const sChainEndpoint& endpoint1, const sChainEndpoint& endpoint2) {
+			return endpoint1.m_nCellHash < endpoint2.m_nCellHash;
+		});
+
+		m_SegmentIsChained.assign(nSegmentCount, 0);
+		m_SegmentIsRemoved.assign(nSegmentCount, 0);
+		m_ChainPoints.clear();
+		m_ChainSegments.clear();
+		m_ChainPointStarts.clear();
+		m_nLayerPolylinesAfter = m_nLayerPolylinesBefore;
+
+		// Every chain grows from its first polyline in both directions, all polylines before it are chained already
+		for (uint32_t nSegmentIndex = 0; nSegmentIndex < nSegmentCount; nSegmentIndex++) {
+			auto& segment = layerData.getSegment(nSegmentIndex);
+			if ((segment.m_Type != eToolpathSegmentType::Polyline) || (segment.m_nElementCount < 2) || m_SegmentIsChained[nSegmentIndex])
+				continue;
+
+			m_SegmentIsChained[nSegmentIndex] = 1;
+			m_ForwardLinks.clear();
+			m_BackwardLinks.clear();
+
+			sChainLink link;
+			sToolpathPoint2D chainEnd = layerData.getSegmentPoints(segment)[segment.m_nElementCount - 1];
+			while (findLink(layerData, segment, chainEnd, true, link)) {
+				auto& linkSegment = layerData.getSegment(link.m_nSegmentIndex);
+				auto pLinkPoints = layerData.getSegmentPoints(linkSegment);
+				chainEnd = link.m_bIsReversed ? pLinkPoints[0] : pLinkPoints[linkSegment.m_nElementCount - 1];
+				m_SegmentIsChained[link.m_nSegmentIndex] = 1;
+				m_ForwardLinks.push_back(link);
+			}
+
+			sToolpathPoint2D chainStart = layerData.getSegmentPoints(segment)[0];
+			while (findLink(layerData, segment, chainStart, false, link)) {
+				auto& linkSegment = layerData.getSegment(link.m_nSegmentIndex);
+				auto pLinkPoints = layerData.getSegmentPoints(linkSegment);
+				chainStart = link.m_bIsReversed ? pLinkPoints[linkSegment.m_nElementCount - 1] : pLinkPoints[0];
+				m_SegmentIsChained[link.m_nSegmentIndex] = 1;
+				m_BackwardLinks.push_back(link);
+			}
+
+			if (m_ForwardLinks.empty() && m_BackwardLinks.empty())
+				continue;
+
+			// The chain is the backward links from the far end, the first polyline and the forward links.
+			// The first point of every following polyline is replaced by the last point before it.
+			size_t nChainStart = m_ChainPoints.size();
+			auto appendPolyline = [&](uint32_t nLinkSegmentIndex, bool bIsReversed) {
+				auto& linkSegment = layerData.getSegment(nLinkSegmentIndex);
+				auto pLinkPoints = layerData.getSegmentPoints(linkSegment);
+				uint32_t nFirstPoint = (m_ChainPoints.size() > nChainStart) ? 1 : 0;
+				for (uint32_t nPointIndex = nFirstPoint; nPointIndex < linkSegment.m_nElementCount; nPointIndex++)
+					m_ChainPoints.push_back(bIsReversed ? pLinkPoints[linkSegment.m_nElementCount - 1 - nPointIndex] : pLinkPoints[nPointIndex]);
+			};
+
+			for (auto iLinkIter = m_BackwardLinks.rbegin(); iLinkIter != m_BackwardLinks.rend(); iLinkIter++) {
+				appendPolyline(iLinkIter->m_nSegmentIndex, iLinkIter->m_bIsReversed);
+				m_SegmentIsRemoved[iLinkIter->m_nSegmentIndex] = 1;
+			}
+			appendPolyline(nSegmentIndex, false);
+			for (auto& forwardLink : m_ForwardLinks) {
+				appendPolyline(forwardLink.m_nSegmentIndex, forwardLink.m_bIsReversed);
+				m_SegmentIsRemoved[forwardLink.m_nSegmentIndex] = 1;
+			}
+
+			if (m_ChainPoints.size() - nChainStart > 0xffffffffULL)
+				throw std::runtime_error("polyline chain has too many points");
+
+			m_ChainSegments.push_back(nSegmentIndex);
+			m_ChainPointStarts.push_back((uint32_t)nChainStart);
+			m_nLayerPolylinesAfter -= (m_ForwardLinks.size() + m_BackwardLinks.size());
+		}
+
+		if (!m_ChainSegments.empty()) {
+			m_ChainPointStarts.push_back((uint32_t)m_ChainPoints.size());
+			for (size_t nChainIndex = 0; nChainIndex < m_ChainSegments.size(); nChainIndex++) {
+				uint32_t nChainStart = m_ChainPointStarts[nChainIndex];
+				layerData.setSegmentPoints(m_ChainSegments[nChainIndex], &m_ChainPoints[nChainStart], m_ChainPointStarts[nChainIndex + 1] - nChainStart);
+			}
+
+			layerData.removeSegments(m_SegmentIsRemoved);
+			layerData.compactElements();
+		}
+
+		m_LayerAfter = m_LayerMotion.measureLayer(layerData);
+		CToolpathLayerMotion::addSummary(m_TotalBefore, m_LayerBefore);
+		CToolpathLayerMotion::addSummary(m_TotalAfter, m_LayerAfter);
+		m_nPolylinesBefore += m_nLayerPolylinesBefore;
+		m_nPolylinesAfter += m_nLayerPolylinesAfter;
+		m_nLayerCount++;
+	}
+
+	std::string CToolpathLayerProcessor_PolylineChaining::getLayerSummary()
+	{
+		std::stringstream summaryStream;
+		summaryStream << std::fixed << std::setprecision(3)
+			<< "polyline chaining: " << m_nLayerPolylinesBefore << " -> " << m_nLayerPolylinesAfter << " polylines"
+			<< ", jump distance " << m_LayerBefore.m_dJumpDistance << " -> " << m_LayerAfter.m_dJumpDistance << " mm"
+			<< ", scan time " << m_LayerBefore.m_dScanTime << " -> " << m_LayerAfter.m_dScanTime << " s";
+		return summaryStream.str();
+	}
+
+	void CToolpathLayerProcessor_PolylineChaining::endProcessing()
+	{
+		if (m_pStatistics.get() == nullptr)
+			return;
+
+		std::string sStage = getName();
+		m_pStatistics->setProcessingValue(sStage, "layers", (double)m_nLayerCount);
+		m_pStatistics->setProcessingValue(sStage, "polylinesBefore", (double)m_nPolylinesBefore);
+		m_pStatistics->setProcessingValue(sStage, "polylinesAfter", (double)m_nPolylinesAfter);
+		m_pStatistics->setProcessingValue(sStage, "jumpDistanceBefore", m_TotalBefore.m_dJumpDistance);
+		m_pStatistics->setProcessingValue(sStage, "jumpDistanceAfter", m_TotalAfter.m_dJumpDistance);
+		m_pStatistics->setProcessingValue(sStage, "scanTimeBefore", m_TotalBefore.m_dScanTime);
+		m_pStatistics->setProcessingValue(sStage, "scanTimeAfter", m_TotalAfter.m_dScanTime);
+	}
+
+} // namespace Toolpath
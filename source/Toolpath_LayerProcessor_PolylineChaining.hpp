@@ -0,0 +1,112 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#ifndef __TOOLPATH_LAYERPROCESSOR_POLYLINECHAINING
+#define __TOOLPATH_LAYERPROCESSOR_POLYLINECHAINING
+
+#include <vector>
+#include <cstdint>
+
+#include "Toolpath_LayerProcessor.hpp"
+#include "Toolpath_LayerMotion.hpp"
+
+namespace Toolpath {
+
+	/**
+	 * Joins open polylines of the same part and profile whose end points coincide within a tolerance into chains,
+	 * so that they are exported as one data block without jumps in between. End points are found through a hashed
+	 * grid index with a cell size of the tolerance. Polylines are reversed to continue a chain unless their
+	 * direction is kept. A chain takes the place of its first polyline in the segment order.
+	 */
+	class CToolpathLayerProcessor_PolylineChaining : public IToolpathLayerProcessor {
+	private:
+		// End point of a polyline in the hashed grid, sorted by cell hash
+		typedef struct _sChainEndpoint {
+			uint64_t m_nCellHash;
+			uint32_t m_nSegmentIndex;
+			uint32_t m_bIsEnd;
+		} sChainEndpoint;
+
+		// Polyline of a chain in chain order
+		typedef struct _sChainLink {
+			uint32_t m_nSegmentIndex;
+			bool m_bIsReversed;
+		} sChainLink;
+
+		double m_dTolerance;
+		bool m_bKeepDirection;
+
+		PToolpathStatistics m_pStatistics;
+		CToolpathLayerMotion m_LayerMotion;
+
+		sToolpathMotionSummary m_LayerBefore;
+		sToolpathMotionSummary m_LayerAfter;
+		sToolpathMotionSummary m_TotalBefore;
+		sToolpathMotionSummary m_TotalAfter;
+		uint64_t m_nLayerPolylinesBefore;
+		uint64_t m_nLayerPolylinesAfter;
+		uint64_t m_nPolylinesBefore;
+		uint64_t m_nPolylinesAfter;
+		uint64_t m_nLayerCount;
+
+		// Buffers reused across layers
+		std::vector<sChainEndpoint> m_Endpoints;
+		std::vector<uint8_t> m_SegmentIsChained;
+		std::vector<uint8_t> m_SegmentIsRemoved;
+		std::vector<sChainLink> m_ForwardLinks;
+		std::vector<sChainLink> m_BackwardLinks;
+		std::vector<sToolpathPoint2D> m_ChainPoints;
+		std::vector<uint32_t> m_ChainSegments;
+		std::vector<uint32_t> m_ChainPointStarts;
+
+		uint64_t computeCellHash(const sToolpathSegment& segment, int64_t nCellX, int64_t nCellY);
+		bool findLink(const CToolpathLayerData& layerData, const sToolpathSegment& segment, const sToolpathPoint2D& point, bool bAtChainEnd, sChainLink& link);
+
+	public:
+		CToolpathLayerProcessor_PolylineChaining();
+		virtual ~CToolpathLayerProcessor_PolylineChaining() = default;
+
+		// Maximum distance in mm between end points that are joined
+		void setTolerance(double dTolerance);
+		// Polylines are only joined end to start, without reversing any of them
+		void setKeepDirection(bool bKeepDirection);
+
+		std::string getName() override;
+		void setStatistics(PToolpathStatistics pStatistics) override;
+		void beginProcessing(PToolpathSource pSource) override;
+		void processLayer(CToolpathLayerData& layerData) override;
+		std::string getLayerSummary() override;
+		void endProcessing() override;
+	};
+
+	typedef std::shared_ptr<CToolpathLayerProcessor_PolylineChaining> PToolpathLayerProcessor_PolylineChaining;
+
+} // namespace Toolpath
+
+#endif // __TOOLPATH_LAYERPROCESSOR_POLYLINECHAINING
@@ -0,0 +1,509 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#include "Toolpath_LayerProcessor_SegmentOrdering.hpp"
+
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+
+// Farthest distance in the sequence that an Or-opt move relocates a chunk of segments
+#define TOOLPATH_SEGMENTORDERING_OROPTWINDOW 32
+
+// Longest chunk of consecutive segments that is moved by an Or-opt move
+#define TOOLPATH_SEGMENTORDERING_MAXCHUNKLENGTH 3
+
+#define TOOLPATH_SEGMENTORDERING_MAXOROPTPASSES 8
+
+// Upper limit of the nearest neighbor grid size
+#define TOOLPATH_SEGMENTORDERING_MAXGRIDCELLS (1 << 20)
+
+namespace Toolpath {
+
+	CToolpathLayerProcessor_SegmentOrdering::CToolpathLayerProcessor_SegmentOrdering()
+		: m_bContoursBeforeHatches(false),
+		m_bGroupByProfile(false),
+		m_nReorderedLayerCount(0),
+		m_nLayerCount(0)
+	{
+		CToolpathLayerMotion::clearSummary(m_LayerBefore);
+		CToolpathLayerMotion::clearSummary(m_LayerAfter);
+		CToolpathLayerMotion::clearSummary(m_TotalBefore);
+		CToolpathLayerMotion::clearSummary(m_TotalAfter);
+	}
+
+	void CToolpathLayerProcessor_SegmentOrdering::setContoursBeforeHatches(bool bContoursBeforeHatches)
+	{
+		m_bContoursBeforeHatches = bContoursBeforeHatches;
+	}
+
+	void CToolpathLayerProcessor_SegmentOrdering::setGroupByProfile(bool bGroupByProfile)
+	{
+		m_bGroupByProfile = bGroupByProfile;
+	}
+
+	std::string CToolpathLayerProcessor_SegmentOrdering::getName()
+	{
+		return "segmentOrdering";
+	}
+
+	void CToolpathLayerProcessor_SegmentOrdering::setStatistics(PToolpathStatistics pStatistics)
+	{
+		m_pStatistics = pStatistics;
+	}
+
+	void CToolpathLayerProcessor_SegmentOrdering::beginProcessing(PToolpathSource pSource)
+	{
+		if (pSource.get() == nullptr)
+			throw std::runtime_error("Invalid toolpath source");
+
+		m_LayerMotion.readSpeeds(*pSource);
+	}
+
+	void CToolpathLayerProcessor_SegmentOrdering::buildNodes(const CToolpathLayerData& layerData, std::vector<uint32_t>& emptySegments)
+	{
+		m_Nodes.clear();
+
+		uint32_t nSegmentCount = layerData.getSegmentCount();
+		for (uint32_t nSegmentIndex = 0; nSegmentIndex < nSegmentCount; nSegmentIndex++) {
+			auto& segment = layerData.getSegment(nSegmentIndex);
+
+			sToolpathSegmentOrderingNode node;
+			node.m_nSegmentIndex = nSegmentIndex;
+			node.m_nPartIndex = segment.m_nPartIndex;
+			node.m_nStageIndex = 0;
+			node.m_bIsHatch = (segment.m_Type == eToolpathSegmentType::Hatch);
+
+			if (!CToolpathLayerMotion::getSegmentStart(layerData, segment, node.m_dStartX, node.m_dStartY) ||
+				!CToolpathLayerMotion::getSegmentEnd(layerData, segment, node.m_dEndX, node.m_dEndY)) {
+				emptySegments.push_back(nSegmentIndex);
+				continue;
+			}
+
+			m_Nodes.push_back(node);
+		}
+
+		if (!m_bGroupByProfile)
+			return;
+
+		// One stage per profile, in the order of the first segment of each profile
+		std::vector<uint32_t> profileOrder;
+		std::set<uint32_t> profilesWithContours;
+		for (auto& node : m_Nodes) {
+			uint32_t nProfileIndex = layerData.getSegment(node.m_nSegmentIndex).m_nProfileIndex;
+			if (std::find(profileOrder.begin(), profileOrder.end(), nProfileIndex) == profileOrder.end())
+				profileOrder.push_back(nProfileIndex);
+			if (!node.m_bIsHatch)
+				profilesWithContours.insert(nProfileIndex);
+		}
+
+		if (m_bContoursBeforeHatches)
+			std::stable_partition(profileOrder.begin(), profileOrder.end(), [&profilesWithContours](uint32_t nProfileIndex) {
+				return profilesWithContours.count(nProfileIndex) > 0;
+			});
+
+		std::map<uint32_t, uint32_t> stagesByProfile;
+		for (uint32_t nStageIndex = 0; nStageIndex < profileOrder.size(); nStageIndex++)
+			stagesByProfile.insert(std::make_pair(profileOrder[nStageIndex], nStageIndex));
+
+		for (auto& node : m_Nodes)
+			node.m_nStageIndex = stagesByProfile[layerData.getSegment(node.m_nSegmentIndex).m_nProfileIndex];
+	}
+
+	void CToolpathLayerProcessor_SegmentOrdering::orderNearestNeighbor(const std::vector<uint32_t>& stageNodes, bool& bHasPosition, double& dPositionX, double& dPositionY)
+	{
+		if (stageNodes.empty())
+			return;
+
+		// Uniform grid over the segment start points with about one segment per cell
+		double dMinX = m_Nodes[stageNodes[0]].m_dStartX;
+		double dMinY = m_Nodes[stageNodes[0]].m_dStartY;
+		double dMaxX = dMinX;
+		double dMaxY = dMinY;
+		for (uint32_t nNode : stageNodes) {
+			dMinX = std::min(dMinX, m_Nodes[nNode].m_dStartX);
+			dMinY = std::min(dMinY, m_Nodes[nNode].m_dStartY);
+			dMaxX = std::max(dMaxX, m_Nodes[nNode].m_dStartX);
+			dMaxY = std::max(dMaxY, m_Nodes[nNode].m_dStartY);
+		}
+
+		double dCellSize = sqrt(std::max((dMaxX - dMinX) * (dMaxY - dMinY), 1.0e-12) / stageNodes.size());
+		dCellSize = std::max(dCellSize, std::max(dMaxX - dMinX, dMaxY - dMinY) / sqrt((double)TOOLPATH_SEGMENTORDERING_MAXGRIDCELLS));
+		dCellSize = std::max(dCellSize, 1.0e-6);
+
+		int64_t nCellCountX = (int64_t)((dMaxX - dMinX) / dCellSize) + 1;
+		int64_t nCellCountY = (int64_t)((dMaxY - dMinY) / dCellSize) + 1;
+
+		auto getCellX = [&](double dX) { return std::min(std::max((int64_t)((dX - dMinX) / dCellSize), (int64_t)0), nCellCountX - 1); };
+		auto getCellY = [&](double dY) { return std::min(std::max((int64_t)((dY - dMinY) / dCellSize), (int64_t)0), nCellCountY - 1); };
+		auto getNodeCell = [&](uint32_t nNode) { return (size_t)(getCellY(m_Nodes[nNode].m_dStartY) * nCellCountX + getCellX(m_Nodes[nNode].m_dStartX)); };
+
+		m_GridCells.resize((size_t)(nCellCountX * nCellCountY));
+		for (auto& gridCell : m_GridCells)
+			gridCell.clear();
+		m_GridPositions.resize(m_Nodes.size());
+
+		auto insertNode = [&](uint32_t nNode) {
+			auto& gridCell = m_GridCells[getNodeCell(nNode)];
+			m_GridPositions[nNode] = (uint32_t)gridCell.size();
+			gridCell.push_back(nNode);
+		};
+
+		auto removeNode = [&](uint32_t nNode) {
+			auto& gridCell = m_GridCells[getNodeCell(nNode)];
+			uint32_t nLastNode = gridCell.back();
+			gridCell[m_GridPositions[nNode]] = nLastNode;
+			m_GridPositions[nLastNode] = m_GridPositions[nNode];
+			gridCell.pop_back();
+		};
+
+		// Hatches wait outside of the grid until all contours of their part are scanned
+		std::unordered_map<uint32_t, uint32_t> pendingContourCounts;
+		std::unordered_map<uint32_t, std::vector<uint32_t>> waitingHatches;
+		if (m_bContoursBeforeHatches) {
+			for (uint32_t nNode : stageNodes) {
+				if (!m_Nodes[nNode].m_bIsHatch)
+					pendingContourCounts[m_Nodes[nNode].m_nPartIndex]++;
+			}
+		}
+
+		for (uint32_t nNode : stageNodes) {
+			auto& node = m_Nodes[nNode];
+			if (node.m_bIsHatch && (pendingContourCounts.count(node.m_nPartIndex) > 0))
+				waitingHatches[node.m_nPartIndex].push_back(nNode);
+			else
+				insertNode(nNode);
+		}
+
+		int64_t nMaxRing = std::max(nCellCountX, nCellCountY);
+
+		for (size_t nStep = 0; nStep < stageNodes.size(); nStep++) {
+			uint32_t nBestNode = 0;
+			bool bFound = false;
+
+			if (!bHasPosition) {
+				// The first segment of the layer is the first one that may be scanned, in source order
+				for (uint32_t nNode : stageNodes) {
+					auto& node = m_Nodes[nNode];
+					if (!node.m_bIsHatch || (pendingContourCounts.count(node.m_nPartIndex) == 0)) {
+						nBestNode = nNode;
+						bFound = true;
+						break;
+					}
+				}
+			}
+			else {
+				int64_t nCenterX = getCellX(dPositionX);
+				int64_t nCenterY = getCellY(dPositionY);
+				double dBestDistance = std::numeric_limits<double>::max();
+
+				for (int64_t nRing = 0; nRing <= nMaxRing; nRing++) {
+					for (int64_t nCellY = nCenterY - nRing; nCellY <= nCenterY + nRing; nCellY++) {
+						if ((nCellY < 0) || (nCellY >= nCellCountY))
+							continue;
+
+						// Only the border cells of the ring
+						bool bIsBorderRow = (nCellY == nCenterY - nRing) || (nCellY == nCenterY + nRing);
+						int64_t nStepX = (bIsBorderRow || (nRing == 0)) ? 1 : 2 * nRing;
+						for (int64_t nCellX = nCenterX - nRing; nCellX <= nCenterX + nRing; nCellX += nStepX) {
+							if ((nCellX < 0) || (nCellX >= nCellCountX))
+								continue;
+
+							for (uint32_t nNode : m_GridCells[(size_t)(nCellY * nCellCountX + nCellX)]) {
+								double dDistance = CToolpathLayerMotion::getDistance(dPositionX, dPositionY, m_Nodes[nNode].m_dStartX, m_Nodes[nNode].m_dStartY);
+								// Ties are broken by source order, for stable results
+								if ((dDistance < dBestDistance) || ((dDistance == dBestDistance) && (nNode < nBestNode))) {
+									dBestDistance = dDistance;
+									nBestNode = nNode;
+									bFound = true;
+								}
+							}
+						}
+					}
+
+					// Start points outside of this ring are at least nRing cells away
+					if (bFound && (dBestDistance <= nRing * dCellSize))
+						break;
+				}
+			}
+
+			if (!bFound)
+				throw std::runtime_error("segment ordering found no segment to scan next");
+
+			auto& bestNode = m_Nodes[nBestNode];
+			removeNode(nBestNode);
+
+			m_Order.push_back(nBestNode);
+			dPositionX = bestNode.m_dEndX;
+			dPositionY = bestNode.m_dEndY;
+			bHasPosition = true;
+
+			if (!bestNode.m_bIsHatch && m_bContoursBeforeHatches) {
+				auto iCountIter = pendingContourCounts.find(bestNode.m_nPartIndex);
+				if (iCountIter != pendingContourCounts.end()) {
+					iCountIter->second--;
+					if (iCountIter->second == 0) {
+						pendingContourCounts.erase(iCountIter);
+						for (uint32_t nHatchNode : waitingHatches[bestNode.m_nPartIndex])
+							insertNode(nHatchNode);
+						waitingHatches.erase(bestNode.m_nPartIndex);
+					}
+				}
+			}
+		}
+	}
+
+	bool CToolpathLayerProcessor_SegmentOrdering::canMoveChunk(size_t nChunkStart, size_t nChunkLength, size_t nInsertBefore)
+	{
+		if (!m_bContoursBeforeHatches)
+			return true;
+
+		size_t nChunkEnd = nChunkStart + nChunkLength;
+
+		size_t nPassedStart, nPassedEnd;
+		bool bMovesEarlier = (nInsertBefore < nChunkStart);
+		if (bMovesEarlier) {
+			nPassedStart = nInsertBefore;
+			nPassedEnd = nChunkStart;
+		}
+		else {
+			nPassedStart = nChunkEnd;
+			nPassedEnd = nInsertBefore;
+		}
+
+		for (size_t nChunkIndex = nChunkStart; nChunkIndex < nChunkEnd; nChunkIndex++) {
+			auto& chunkNode = m_Nodes[m_Order[nChunkIndex]];
+
+			// A hatch may not move in front of a contour of its part, a contour may not move behind a hatch of its part
+			if (chunkNode.m_bIsHatch != bMovesEarlier)
+				continue;
+
+			for (size_t nPassedIndex = nPassedStart; nPassedIndex < nPassedEnd; nPassedIndex++) {
+				auto& passedNode = m_Nodes[m_Order[nPassedIndex]];
+				if ((passedNode.m_nPartIndex == chunkNode.m_nPartIndex) && (passedNode.m_bIsHatch != chunkNode.m_bIsHatch))
+					return false;
+			}
+		}
+
+		return true;
+	}
+
+	void CToolpathLayerProcessor_SegmentOrdering::refineOrOpt(size_t nStageStart, size_t nStageEnd)
+	{
+		size_t nOrderSize = m_Order.size();
+
+		// Jump from the end of segment nFromPosition - 1 to the start of segment nPosition,
+		// nothing in front of the first segment and behind the last segment of the layer
+		auto getJump = [&](size_t nPosition, size_t nFromPosition) -> double {
+			if ((nFromPosition == 0) || (nPosition >= nOrderSize))
+				return 0.0;
+			auto& fromNode = m_Nodes[m_Order[nFromPosition - 1]];
+			auto& toNode = m_Nodes[m_Order[nPosition]];
+			return CToolpathLayerMotion::getDistance(fromNode.m_dEndX, fromNode.m_dEndY, toNode.m_dStartX, toNode.m_dStartY);
+		};
+
+		for (uint32_t nPass = 0; nPass < TOOLPATH_SEGMENTORDERING_MAXOROPTPASSES; nPass++) {
+			bool bImproved = false;
+
+			for (size_t nChunkLength = 1; nChunkLength <= TOOLPATH_SEGMENTORDERING_MAXCHUNKLENGTH; nChunkLength++) {
+				for (size_t nChunkStart = nStageStart; nChunkStart + nChunkLength <= nStageEnd; nChunkStart++) {
+					size_t nChunkEnd = nChunkStart + nChunkLength;
+
+					double dRemoveGain = getJump(nChunkStart, nChunkStart) + getJump(nChunkEnd, nChunkEnd) - getJump(nChunkEnd, nChunkStart);
+					if (dRemoveGain <= 1.0e-9)
+						continue;
+
+					size_t nFirstInsert = std::max(nStageStart, (nChunkStart > TOOLPATH_SEGMENTORDERING_OROPTWINDOW) ? nChunkStart - TOOLPATH_SEGMENTORDERING_OROPTWINDOW : 0);
+					size_t nLastInsert = std::min(nStageEnd, nChunkEnd + TOOLPATH_SEGMENTORDERING_OROPTWINDOW);
+
+					double dBestGain = 1.0e-9;
+					size_t nBestInsert = 0;
+					bool bFound = false;
+
+					for (size_t nInsert = nFirstInsert; nInsert <= nLastInsert; nInsert++) {
+						// The chunk goes between the segments nInsert - 1 and nInsert
+						if ((nInsert >= nChunkStart) && (nInsert <= nChunkEnd))
+							continue;
+
+						double dInsertCost = 0.0;
+						if (nInsert > 0) {
+							auto& fromNode = m_Nodes[m_Order[nInsert - 1]];
+							auto& chunkStartNode = m_Nodes[m_Order[nChunkStart]];
+							dInsertCost += CToolpathLayerMotion::getDistance(fromNode.m_dEndX, fromNode.m_dEndY, chunkStartNode.m_dStartX, chunkStartNode.m_dStartY);
+						}
+						if (nInsert < nOrderSize) {
+							auto& chunkEndNode = m_Nodes[m_Order[nChunkEnd - 1]];
+							auto& toNode = m_Nodes[m_Order[nInsert]];
+							dInsertCost += CToolpathLayerMotion::getDistance(chunkEndNode.m_dEndX, chunkEndNode.m_dEndY, toNode.m_dStartX, toNode.m_dStartY);
+						}
+						dInsertCost -= getJump(nInsert, nInsert);
+
+						double dGain = dRemoveGain - dInsertCost;
+						if ((dGain > dBestGain) && canMoveChunk(nChunkStart, nChunkLength, nInsert)) {
+							dBestGain = dGain;
+							nBestInsert = nInsert;
+							bFound = true;
+						}
+					}
+
+					if (bFound) {
+						if (nBestInsert < nChunkStart)
+							std::rotate(m_Order.begin() + nBestInsert, m_Order.begin() + nChunkStart, m_Order.begin() + nChunkEnd);
+						else
+							std::rotate(m_Order.begin() + nChunkStart, m_Order.begin() + nChunkEnd, m_Order.begin() + nBestInsert);
+						bImproved = true;
+					}
+				}
+			}
+
+			if (!bImproved)
+				break;
+		}
+	}
+
+	bool CToolpathLayerProcessor_SegmentOrdering::meetsConstraints(const std::vector<uint32_t>& order)
+	{
+		std::set<uint32_t> partsWithHatches;
+		uint32_t nStageIndex = 0;
+
+		for (uint32_t nNode : order) {
+			auto& node = m_Nodes[nNode];
+			if (node.m_nStageIndex < nStageIndex)
+				return false;
+			if (node.m_nStageIndex > nStageIndex) {
+				nStageIndex = node.m_nStageIndex;
+				partsWithHatches.clear();
+			}
+
+			if (m_bContoursBeforeHatches) {
+				if (node.m_bIsHatch)
+					partsWithHatches.insert(node.m_nPartIndex);
+				else if (partsWithHatches.count(node.m_nPartIndex) > 0)
+					return false;
+			}
+		}
+
+		return true;
+	}
+
+	double CToolpathLayerProcessor_SegmentOrdering::computeJumpDistance(const std::vector<uint32_t>& order)
+	{
+		double dJumpDistance = 0.0;
+		for (size_t nIndex = 1; nIndex < order.size(); nIndex++) {
+			auto& fromNode = m_Nodes[order[nIndex - 1]];
+			auto& toNode = m_Nodes[order[nIndex]];
+			dJumpDistance += CToolpathLayerMotion::getDistance(fromNode.m_dEndX, fromNode.m_dEndY, toNode.m_dStartX, toNode.m_dStartY);
+		}
+		return dJumpDistance;
+	}
+
+	void CToolpathLayerProcessor_SegmentOrdering::processLayer(CToolpathLayerData& layerData)
+	{
+		m_LayerBefore = m_LayerMotion.measureLayer(layerData);
+		m_nLayerCount++;
+
+		std::vector<uint32_t> emptySegments;
+		buildNodes(layerData, emptySegments);
+
+		uint32_t nStageCount = 0;
+		for (auto& node : m_Nodes)
+			nStageCount = std::max(nStageCount, node.m_nStageIndex + 1);
+
+		std::vector<std::vector<uint32_t>> stageNodes(nStageCount);
+		for (uint32_t nNode = 0; nNode < m_Nodes.size(); nNode++)
+			stageNodes[m_Nodes[nNode].m_nStageIndex].push_back(nNode);
+
+		m_Order.clear();
+		m_StageStarts.clear();
+
+		bool bHasPosition = false;
+		double dPositionX = 0.0;
+		double dPositionY = 0.0;
+		for (uint32_t nStageIndex = 0; nStageIndex < nStageCount; nStageIndex++) {
+			m_StageStarts.push_back((uint32_t)m_Order.size());
+			orderNearestNeighbor(stageNodes[nStageIndex], bHasPosition, dPositionX, dPositionY);
+		}
+		m_StageStarts.push_back((uint32_t)m_Order.size());
+
+		for (uint32_t nStageIndex = 0; nStageIndex < nStageCount; nStageIndex++)
+			refineOrOpt(m_StageStarts[nStageIndex], m_StageStarts[nStageIndex + 1]);
+
+		std::vector<uint32_t> sourceOrder(m_Nodes.size());
+		for (uint32_t nNode = 0; nNode < m_Nodes.size(); nNode++)
+			sourceOrder[nNode] = nNode;
+
+		bool bKeepSourceOrder = meetsConstraints(sourceOrder) && (computeJumpDistance(sourceOrder) <= computeJumpDistance(m_Order));
+		if (!bKeepSourceOrder) {
+			// Segments without points keep their relative order at the end of the layer
+			std::vector<uint32_t> segmentOrder;
+			segmentOrder.reserve(m_Order.size() + emptySegments.size());
+			for (uint32_t nNode : m_Order)
+				segmentOrder.push_back(m_Nodes[nNode].m_nSegmentIndex);
+			for (uint32_t nSegmentIndex : emptySegments)
+				segmentOrder.push_back(nSegmentIndex);
+
+			layerData.reorderSegments(segmentOrder);
+			m_nReorderedLayerCount++;
+		}
+
+		m_LayerAfter = m_LayerMotion.measureLayer(layerData);
+		CToolpathLayerMotion::addSummary(m_TotalBefore, m_LayerBefore);
+		CToolpathLayerMotion::addSummary(m_TotalAfter, m_LayerAfter);
+	}
+
+	std::string CToolpathLayerProcessor_SegmentOrdering::getLayerSummary()
+	{
+		std::stringstream summaryStream;
+		summaryStream << std::fixed << std::setprecision(3)
+			<< "segment ordering: jump distance " << m_LayerBefore.m_dJumpDistance << " -> " << m_LayerAfter.m_dJumpDistance << " mm"
+			<< ", scan time " << m_LayerBefore.m_dScanTime << " -> " << m_LayerAfter.m_dScanTime << " s";
+		return summaryStream.str();
+	}
+
+	void CToolpathLayerProcessor_SegmentOrdering::endProcessing()
+	{
+		if (m_pStatistics.get() == nullptr)
+			return;
+
+		std::string sStage = getName();
+		m_pStatistics->setProcessingValue(sStage, "layers", (double)m_nLayerCount);
+		m_pStatistics->setProcessingValue(sStage, "reorderedLayers", (double)m_nReorderedLayerCount);
+		m_pStatistics->setProcessingValue(sStage, "jumpDistanceBefore", m_TotalBefore.m_dJumpDistance);
+		m_pStatistics->setProcessingValue(sStage, "jumpDistanceAfter", m_TotalAfter.m_dJumpDistance);
+		m_pStatistics->setProcessingValue(sStage, "scanTimeBefore", m_TotalBefore.m_dScanTime);
+		m_pStatistics->setProcessingValue(sStage, "scanTimeAfter", m_TotalAfter.m_dScanTime);
+	}
+
+} // namespace Toolpath
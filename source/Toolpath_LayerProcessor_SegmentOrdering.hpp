@@ -0,0 +1,110 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#ifndef __TOOLPATH_LAYERPROCESSOR_SEGMENTORDERING
+#define __TOOLPATH_LAYERPROCESSOR_SEGMENTORDERING
+
+#include <vector>
+#include <cstdint>
+
+#include "Toolpath_LayerProcessor.hpp"
+#include "Toolpath_LayerMotion.hpp"
+
+namespace Toolpath {
+
+	typedef struct _sToolpathSegmentOrderingNode {
+		uint32_t m_nSegmentIndex;
+		uint32_t m_nPartIndex;
+		uint32_t m_nStageIndex;
+		bool m_bIsHatch;
+		double m_dStartX;
+		double m_dStartY;
+		double m_dEndX;
+		double m_dEndY;
+	} sToolpathSegmentOrderingNode;
+
+	/**
+	 * Reorders the segments of a layer across parts to shorten the jumps between them.
+	 * A nearest neighbor tour on the segment start and end points is improved with Or-opt moves.
+	 * Segments are not reversed. Optional constraints:
+	 *   - contours before hatches: the hatches of a part follow all loops and polylines of the part
+	 *   - profile grouping: the segments of a profile are scanned together, profiles in the order
+	 *     of their first segment (profiles with contours first if contours go before hatches)
+	 * A layer keeps its order if it already meets the constraints and no shorter order was found.
+	 */
+	class CToolpathLayerProcessor_SegmentOrdering : public IToolpathLayerProcessor {
+	private:
+		bool m_bContoursBeforeHatches;
+		bool m_bGroupByProfile;
+
+		PToolpathStatistics m_pStatistics;
+		CToolpathLayerMotion m_LayerMotion;
+
+		sToolpathMotionSummary m_LayerBefore;
+		sToolpathMotionSummary m_LayerAfter;
+		sToolpathMotionSummary m_TotalBefore;
+		sToolpathMotionSummary m_TotalAfter;
+		uint64_t m_nReorderedLayerCount;
+		uint64_t m_nLayerCount;
+
+		// Buffers reused across layers
+		std::vector<sToolpathSegmentOrderingNode> m_Nodes;
+		std::vector<uint32_t> m_Order;
+		std::vector<uint32_t> m_StageStarts;
+		std::vector<std::vector<uint32_t>> m_GridCells;
+		std::vector<uint32_t> m_GridPositions;
+
+		void buildNodes(const CToolpathLayerData& layerData, std::vector<uint32_t>& emptySegments);
+		void orderNearestNeighbor(const std::vector<uint32_t>& stageNodes, bool& bHasPosition, double& dPositionX, double& dPositionY);
+		void refineOrOpt(size_t nStageStart, size_t nStageEnd);
+
+		bool canMoveChunk(size_t nChunkStart, size_t nChunkLength, size_t nInsertBefore);
+		bool meetsConstraints(const std::vector<uint32_t>& order);
+		double computeJumpDistance(const std::vector<uint32_t>& order);
+
+	public:
+		CToolpathLayerProcessor_SegmentOrdering();
+		virtual ~CToolpathLayerProcessor_SegmentOrdering() = default;
+
+		void setContoursBeforeHatches(bool bContoursBeforeHatches);
+		void setGroupByProfile(bool bGroupByProfile);
+
+		std::string getName() override;
+		void setStatistics(PToolpathStatistics pStatistics) override;
+		void beginProcessing(PToolpathSource pSource) override;
+		void processLayer(CToolpathLayerData& layerData) override;
+		std::string getLayerSummary() override;
+		void endProcessing() override;
+	};
+
+	typedef std::shared_ptr<CToolpathLayerProcessor_SegmentOrdering> PToolpathLayerProcessor_SegmentOrdering;
+
+} // namespace Toolpath
+
+#endif // __TOOLPATH_LAYERPROCESSOR_SEGMENTORDERING
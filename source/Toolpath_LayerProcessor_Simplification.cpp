@@ -0,0 +1,288 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#include "Toolpath_LayerProcessor_Simplification.hpp"
+
+#include <algorithm>
+#include <future>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+#include <cmath>
+
+// Segments are split into this many tasks per worker thread, so that threads finishing early can pick up more work
+#define SIMPLIFICATION_TASKSPERTHREAD 4
+
+namespace Toolpath {
+
+	CToolpathLayerProcessor_Simplification::CToolpathLayerProcessor_Simplification()
+		: m_nThreadCount(1),
+		m_dTolerance(0.0),
+		m_nLayerPointsBefore(0),
+		m_nLayerPointsAfter(0),
+		m_nPointsBefore(0),
+		m_nPointsAfter(0),
+		m_nSimplifiedSegmentCount(0),
+		m_nLayerCount(0)
+	{
+	}
+
+	void CToolpathLayerProcessor_Simplification::setTolerance(double dTolerance)
+	{
+		if (!std::isfinite(dTolerance) || (dTolerance < 0.0))
+			throw std::runtime_error("invalid simplification tolerance");
+
+		m_dTolerance = dTolerance;
+	}
+
+	void CToolpathLayerProcessor_Simplification::setThreadCount(uint32_t nThreadCount)
+	{
+		m_nThreadCount = nThreadCount;
+	}
+
+	std::string CToolpathLayerProcessor_Simplification::getName()
+	{
+		return "simplification";
+	}
+
+	void CToolpathLayerProcessor_Simplification::setStatistics(PToolpathStatistics pStatistics)
+	{
+		m_pStatistics = pStatistics;
+	}
+
+	void CToolpathLayerProcessor_Simplification::beginProcessing(PToolpathSource pSource)
+	{
+		if (pSource.get() == nullptr)
+			throw std::runtime_error("Invalid toolpath source");
+
+		m_pThreadPool = std::make_shared<CToolpathThreadPool>(m_nThreadCount);
+	}
+
+	void CToolpathLayerProcessor_Simplification::markKeptPoints(const sToolpathPoint2D* pPoints, uint32_t nFirst, uint32_t nLast, sSimplificationScratch& scratch)
+	{
+		double dToleranceSquared = m_dTolerance * m_dTolerance;
+
+		// Iterative subdivision, so that long polylines can not overflow the call stack
+		scratch.m_RangeStack.clear();
+		scratch.m_RangeStack.push_back({ nFirst, nLast });
+		while (!scratch.m_RangeStack.empty()) {
+			sSimplificationRange range = scratch.m_RangeStack.back();
+			scratch.m_RangeStack.pop_back();
+			if (range.m_nLast - range.m_nFirst < 2)
+				continue;
+
+			double dStartX = pPoints[range.m_nFirst].m_Coordinates[0];
+			double dStartY = pPoints[range.m_nFirst].m_Coordinates[1];
+			double dChordX = pPoints[range.m_nLast].m_Coordinates[0] - dStartX;
+			double dChordY = pPoints[range.m_nLast].m_Coordinates[1] - dStartY;
+			double dChordLengthSquared = dChordX * dChordX + dChordY * dChordY;
+
+			uint32_t nFarthestIndex = range.m_nFirst;
+			double dFarthestDistanceSquared = 0.0;
+			for (uint32_t nIndex = range.m_nFirst + 1; nIndex < range.m_nLast; nIndex++) {
+				double dDeltaX = pPoints[nIndex].m_Coordinates[0] - dStartX;
+				double dDeltaY = pPoints[nIndex].m_Coordinates[1] - dStartY;
+
+				// Distance to the chord segment, not to the infinite line, so that spikes beyond the chord ends are kept
+				if (dChordLengthSquared > 0.0) {
+					double dParameter = std::min(std::max((dDeltaX * dChordX + dDeltaY * dChordY) / dChordLengthSquared, 0.0), 1.0);
+					dDeltaX -= dParameter * dChordX;
+					dDeltaY -= dParameter * dChordY;
+				}
+
+				double dDistanceSquared = dDeltaX * dDeltaX + dDeltaY * dDeltaY;
+				if (dDistanceSquared > dFarthestDistanceSquared) {
+					dFarthestDistanceSquared = dDistanceSquared;
+					nFarthestIndex = nIndex;
+				}
+			}
+
+			if (dFarthestDistanceSquared > dToleranceSquared) {
+				scratch.m_KeepPoint[nFarthestIndex] = 1;
+				scratch.m_RangeStack.push_back({ range.m_nFirst, nFarthestIndex });
+				scratch.m_RangeStack.push_back({ nFarthestIndex, range.m_nLast });
+			}
+		}
+	}
+
+	uint32_t CToolpathLayerProcessor_Simplification::simplifySegment(sToolpathPoint2D* pPoints, uint32_t nPointCount, bool bIsLoop, sSimplificationScratch& scratch)
+	{
+		uint32_t nLastIndex = nPointCount - 1;
+		scratch.m_KeepPoint.assign(nPointCount, 0);
+		scratch.m_KeepPoint[0] = 1;
+		scratch.m_KeepPoint[nLastIndex] = 1;
+
+		bool bIsClosed = bIsLoop && (pPoints[0].m_Coordinates[0] == pPoints[nLastIndex].m_Coordinates[0]) && (pPoints[0].m_Coordinates[1] == pPoints[nLastIndex].m_Coordinates[1]);
+		if (bIsClosed) {
+			// The chord of a closed loop has zero length, so the loop is split at the vertex farthest from its start
+			uint32_t nSplitIndex = 1;
+			double dSplitDistanceSquared = -1.0;
+			for (uint32_t nIndex = 1; nIndex < nLastIndex; nIndex++) {
+				double dDeltaX = (double)pPoints[nIndex].m_Coordinates[0] - pPoints[0].m_Coordinates[0];
+				double dDeltaY = (double)pPoints[nIndex].m_Coordinates[1] - pPoints[0].m_Coordinates[1];
+				double dDistanceSquared = dDeltaX * dDeltaX + dDeltaY * dDeltaY;
+				if (dDistanceSquared > dSplitDistanceSquared) {
+					dSplitDistanceSquared = dDistanceSquared;
+					nSplitIndex = nIndex;
+				}
+			}
+
+			scratch.m_KeepPoint[nSplitIndex] = 1;
+			markKeptPoints(pPoints, 0, nSplitIndex, scratch);
+			markKeptPoints(pPoints, nSplitIndex, nLastIndex, scratch);
+		}
+		else {
+			markKeptPoints(pPoints, 0, nLastIndex, scratch);
+		}
+
+		uint32_t nKeptCount = 0;
+		for (uint32_t nIndex = 0; nIndex < nPointCount; nIndex++)
+			nKeptCount += scratch.m_KeepPoint[nIndex];
+
+		// A closed loop needs at least three distinct vertices, smaller loops are left unchanged
+		if (bIsClosed && (nKeptCount < 4))
+			return nPointCount;
+
+		uint32_t nWriteIndex = 0;
+		for (uint32_t nIndex = 0; nIndex < nPointCount; nIndex++) {
+			if (scratch.m_KeepPoint[nIndex]) {
+				pPoints[nWriteIndex] = pPoints[nIndex];
+				nWriteIndex++;
+			}
+		}
+
+		return nWriteIndex;
+	}
+
+	void CToolpathLayerProcessor_Simplification::processLayer(CToolpathLayerData& layerData)
+	{
+		if (m_pThreadPool.get() == nullptr)
+			throw std::runtime_error("simplification has not been started");
+
+		m_SegmentIndices.clear();
+		m_nLayerPointsBefore = 0;
+
+		uint64_t nSimplifiablePointCount = 0;
+		uint32_t nSegmentCount = layerData.getSegmentCount();
+		for (uint32_t nSegmentIndex = 0; nSegmentIndex < nSegmentCount; nSegmentIndex++) {
+			auto& segment = layerData.getSegment(nSegmentIndex);
+			if (segment.m_Type == eToolpathSegmentType::Hatch)
+				continue;
+
+			m_nLayerPointsBefore += segment.m_nElementCount;
+			if (segment.m_nElementCount > 2) {
+				m_SegmentIndices.push_back(nSegmentIndex);
+				nSimplifiablePointCount += segment.m_nElementCount;
+			}
+		}
+
+		m_SimplifiedCounts.resize(m_SegmentIndices.size());
+
+		// Consecutive segments are grouped into tasks of roughly equal point count
+		uint32_t nTaskCount = 1;
+		if (!m_pThreadPool->isSynchronous())
+			nTaskCount = m_pThreadPool->getThreadCount() * SIMPLIFICATION_TASKSPERTHREAD;
+		if (m_TaskScratch.size() < nTaskCount)
+			m_TaskScratch.resize(nTaskCount);
+		uint64_t nPointsPerTask = (nSimplifiablePointCount + nTaskCount - 1) / nTaskCount;
+
+		std::vector<std::future<void>> taskFutures;
+		size_t nTaskBegin = 0;
+		uint32_t nTaskIndex = 0;
+		while (nTaskBegin < m_SegmentIndices.size()) {
+			size_t nTaskEnd = nTaskBegin;
+			uint64_t nTaskPointCount = 0;
+			while ((nTaskEnd < m_SegmentIndices.size()) && ((nTaskPointCount < nPointsPerTask) || (nTaskIndex + 1 == nTaskCount))) {
+				nTaskPointCount += layerData.getSegment(m_SegmentIndices[nTaskEnd]).m_nElementCount;
+				nTaskEnd++;
+			}
+
+			sSimplificationScratch* pScratch = &m_TaskScratch[nTaskIndex];
+			taskFutures.push_back(m_pThreadPool->submit([this, &layerData, pScratch, nTaskBegin, nTaskEnd]() {
+				for (size_t nIndex = nTaskBegin; nIndex < nTaskEnd; nIndex++) {
+					auto& segment = layerData.getSegment(m_SegmentIndices[nIndex]);
+					m_SimplifiedCounts[nIndex] = simplifySegment(layerData.getSegmentPoints(segment), segment.m_nElementCount, segment.m_Type == eToolpathSegmentType::Loop, *pScratch);
+				}
+			}));
+
+			nTaskBegin = nTaskEnd;
+			nTaskIndex++;
+		}
+
+		// All tasks have to finish before an exception is rethrown, as they reference the layer
+		for (auto& taskFuture : taskFutures)
+			taskFuture.wait();
+		for (auto& taskFuture : taskFutures)
+			taskFuture.get();
+
+		m_nLayerPointsAfter = m_nLayerPointsBefore;
+		for (size_t nIndex = 0; nIndex < m_SegmentIndices.size(); nIndex++) {
+			uint32_t nSegmentIndex = m_SegmentIndices[nIndex];
+			uint32_t nPointCount = layerData.getSegment(nSegmentIndex).m_nElementCount;
+			if (m_SimplifiedCounts[nIndex] < nPointCount) {
+				layerData.setSegmentElementCount(nSegmentIndex, m_SimplifiedCounts[nIndex]);
+				m_nLayerPointsAfter -= (nPointCount - m_SimplifiedCounts[nIndex]);
+				m_nSimplifiedSegmentCount++;
+			}
+		}
+
+		if (m_nLayerPointsAfter < m_nLayerPointsBefore)
+			layerData.compactElements();
+
+		m_nPointsBefore += m_nLayerPointsBefore;
+		m_nPointsAfter += m_nLayerPointsAfter;
+		m_nLayerCount++;
+	}
+
+	std::string CToolpathLayerProcessor_Simplification::getLayerSummary()
+	{
+		std::stringstream summaryStream;
+		summaryStream << "simplification: " << m_nLayerPointsBefore << " -> " << m_nLayerPointsAfter << " points"
+			<< ", " << m_nLayerPointsBefore * sizeof(sToolpathPoint2D) << " -> " << m_nLayerPointsAfter * sizeof(sToolpathPoint2D) << " bytes";
+		return summaryStream.str();
+	}
+
+	void CToolpathLayerProcessor_Simplification::endProcessing()
+	{
+		m_pThreadPool = nullptr;
+
+		if (m_pStatistics.get() == nullptr)
+			return;
+
+		std::string sStage = getName();
+		m_pStatistics->setProcessingValue(sStage, "layers", (double)m_nLayerCount);
+		m_pStatistics->setProcessingValue(sStage, "tolerance", m_dTolerance);
+		m_pStatistics->setProcessingValue(sStage, "simplifiedSegments", (double)m_nSimplifiedSegmentCount);
+		m_pStatistics->setProcessingValue(sStage, "pointsBefore", (double)m_nPointsBefore);
+		m_pStatistics->setProcessingValue(sStage, "pointsAfter", (double)m_nPointsAfter);
+		m_pStatistics->setProcessingValue(sStage, "bytesBefore", (double)(m_nPointsBefore * sizeof(sToolpathPoint2D)));
+		m_pStatistics->setProcessingValue(sStage, "bytesAfter", (double)(m_nPointsAfter * sizeof(sToolpathPoint2D)));
+	}
+
+} // namespace Toolpath
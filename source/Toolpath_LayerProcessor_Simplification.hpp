@@ -0,0 +1,98 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#ifndef __TOOLPATH_LAYERPROCESSOR_SIMPLIFICATION
+#define __TOOLPATH_LAYERPROCESSOR_SIMPLIFICATION
+
+#include <cstdint>
+#include <vector>
+
+#include "Toolpath_LayerProcessor.hpp"
+#include "Toolpath_ThreadPool.hpp"
+
+namespace Toolpath {
+
+	/**
+	 * Removes polyline and loop vertices that deviate less than a chord tolerance from the simplified path (Douglas-Peucker).
+	 * The first and last point of every segment are kept, so closed loops stay closed. Hatches are not changed.
+	 * Segments are simplified in parallel, the layer is compacted afterwards.
+	 */
+	class CToolpathLayerProcessor_Simplification : public IToolpathLayerProcessor {
+	private:
+		typedef struct _sSimplificationRange {
+			uint32_t m_nFirst;
+			uint32_t m_nLast;
+		} sSimplificationRange;
+
+		// Scratch buffers of one task, reused across layers
+		typedef struct _sSimplificationScratch {
+			std::vector<uint8_t> m_KeepPoint;
+			std::vector<sSimplificationRange> m_RangeStack;
+		} sSimplificationScratch;
+
+		PToolpathStatistics m_pStatistics;
+		PToolpathThreadPool m_pThreadPool;
+		uint32_t m_nThreadCount;
+		double m_dTolerance;
+
+		std::vector<uint32_t> m_SegmentIndices;
+		std::vector<uint32_t> m_SimplifiedCounts;
+		std::vector<sSimplificationScratch> m_TaskScratch;
+
+		uint64_t m_nLayerPointsBefore;
+		uint64_t m_nLayerPointsAfter;
+		uint64_t m_nPointsBefore;
+		uint64_t m_nPointsAfter;
+		uint64_t m_nSimplifiedSegmentCount;
+		uint64_t m_nLayerCount;
+
+		void markKeptPoints(const sToolpathPoint2D* pPoints, uint32_t nFirst, uint32_t nLast, sSimplificationScratch& scratch);
+		uint32_t simplifySegment(sToolpathPoint2D* pPoints, uint32_t nPointCount, bool bIsLoop, sSimplificationScratch& scratch);
+
+	public:
+		CToolpathLayerProcessor_Simplification();
+		virtual ~CToolpathLayerProcessor_Simplification() = default;
+
+		// Maximum distance of a removed vertex from the simplified path in mm
+		void setTolerance(double dTolerance);
+		void setThreadCount(uint32_t nThreadCount);
+
+		std::string getName() override;
+		void setStatistics(PToolpathStatistics pStatistics) override;
+		void beginProcessing(PToolpathSource pSource) override;
+		void processLayer(CToolpathLayerData& layerData) override;
+		std::string getLayerSummary() override;
+		void endProcessing() override;
+	};
+
+	typedef std::shared_ptr<CToolpathLayerProcessor_Simplification> PToolpathLayerProcessor_Simplification;
+
+} // namespace Toolpath
+
+#endif // __TOOLPATH_LAYERPROCESSOR_SIMPLIFICATION
@@ -0,0 +1,293 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#include "Toolpath_LocalSocket.hpp"
+
+#include <stdexcept>
+#include <cstring>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <afunix.h>
+#include <io.h>
+#pragma comment(lib, "ws2_32.lib")
+#define TOOLPATHSOCKET_INVALID INVALID_SOCKET
+#define TOOLPATHSOCKET_NATIVE SOCKET
+#else
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#define TOOLPATHSOCKET_INVALID -1
+#define TOOLPATHSOCKET_NATIVE int
+#endif
+
+// Only the owner of the daemon may connect, as clients convert files with the rights of the daemon
+#define TOOLPATHSOCKET_FILEMODE 0600
+
+// Longest message line, a longer line drops the connection
+#define TOOLPATHSOCKET_MAXLINELENGTH (1024 * 1024)
+
+namespace Toolpath {
+
+	static sockaddr_un makeSocketAddress(const std::string& sSocketPath)
+	{
+		sockaddr_un socketAddress;
+		memset(&socketAddress, 0, sizeof(socketAddress));
+		socketAddress.sun_family = AF_UNIX;
+
+		if (sSocketPath.empty() || (sSocketPath.length() >= sizeof(socketAddress.sun_path)))
+			throw std::runtime_error("Invalid socket path: " + sSocketPath);
+
+		memcpy(socketAddress.sun_path, sSocketPath.c_str(), sSocketPath.length());
+		return socketAddress;
+	}
+
+	static ToolpathSocketHandle createSocket()
+	{
+#ifdef _WIN32
+		static bool s_bIsInitialized = false;
+		static std::mutex s_InitializationMutex;
+		{
+			std::lock_guard<std::mutex> lockGuard(s_InitializationMutex);
+			if (!s_bIsInitialized) {
+				WSADATA wsaData;
+				if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0)
+					throw std::runtime_error("Could not initialize Windows sockets");
+				s_bIsInitialized = true;
+			}
+		}
+#endif
+
+		ToolpathSocketHandle hSocket = (ToolpathSocketHandle)socket(AF_UNIX, SOCK_STREAM, 0);
+		if (hSocket == (ToolpathSocketHandle)TOOLPATHSOCKET_INVALID)
+			throw std::runtime_error("Could not create socket");
+
+		return hSocket;
+	}
+
+	enum class eToolpathSocketFileState {
+		Missing,
+		Socket,
+		Other
+	};
+
+	static eToolpathSocketFileState getSocketFileState(const std::string& sSocketPath)
+	{
+#ifdef _WIN32
+		// Unix domain sockets are reparse points on Windows
+		DWORD nAttributes = GetFileAttributesA(sSocketPath.c_str());
+		if (nAttributes == INVALID_FILE_ATTRIBUTES)
+			return eToolpathSocketFileState::Missing;
+		if ((nAttributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0)
+			return eToolpathSocketFileState::Socket;
+		return eToolpathSocketFileState::Other;
+#else
+		struct stat fileStatus;
+		if (lstat(sSocketPath.c_str(), &fileStatus) != 0)
+			return (errno == ENOENT) ? eToolpathSocketFileState::Missing : eToolpathSocketFileState::Other;
+		if (S_ISSOCK(fileStatus.st_mode))
+			return eToolpathSocketFileState::Socket;
+		return eToolpathSocketFileState::Other;
+#endif
+	}
+
+	static void closeSocket(ToolpathSocketHandle hSocket)
+	{
+#ifdef _WIN32
+		closesocket((TOOLPATHSOCKET_NATIVE)hSocket);
+#else
+		close(hSocket);
+#endif
+	}
+
+	CToolpathLocalSocket::CToolpathLocalSocket(ToolpathSocketHandle hSocket)
+		: m_hSocket(hSocket)
+	{
+	}
+
+	CToolpathLocalSocket::~CToolpathLocalSocket()
+	{
+		closeSocket(m_hSocket);
+	}
+
+	void CToolpathLocalSocket::removeSocketFile(const std::string& sSocketPath)
+	{
+		if (getSocketFileState(sSocketPath) != eToolpathSocketFileState::Socket)
+			return;
+
+#ifdef _WIN32
+		_unlink(sSocketPath.c_str());
+#else
+		unlink(sSocketPath.c_str());
+#endif
+	}
+
+	PToolpathLocalSocket CToolpathLocalSocket::listen(const std::string& sSocketPath)
+	{
+		sockaddr_un socketAddress = makeSocketAddress(sSocketPath);
+
+		// A daemon that is still running is detected before its socket file is replaced
+		bool bIsInUse = false;
+		try {
+			connect(sSocketPath);
+			bIsInUse = true;
+		}
+		catch (std::runtime_error&) {
+		}
+
+		if (bIsInUse)
+			throw std::runtime_error("Another process is listening on " + sSocketPath);
+
+		if (getSocketFileState(sSocketPath) == eToolpathSocketFileState::Other)
+			throw std::runtime_error("Socket path exists and is not a socket: " + sSocketPath);
+		removeSocketFile(sSocketPath);
+
+		ToolpathSocketHandle hSocket = createSocket();
+		PToolpathLocalSocket pSocket(new CToolpathLocalSocket(hSocket));
+
+		if (bind((TOOLPATHSOCKET_NATIVE)hSocket, (sockaddr*)&socketAddress, sizeof(socketAddress)) != 0)
+			throw std::runtime_error("Could not bind socket " + sSocketPath);
+
+#ifndef _WIN32
+		// Connections are refused until listen, so no client can connect before the mode is restricted
+		if (chmod(sSocketPath.c_str(), TOOLPATHSOCKET_FILEMODE) != 0) {
+			removeSocketFile(sSocketPath);
+			throw std::runtime_error("Could not restrict access to socket " + sSocketPath);
+		}
+#endif
+
+		if (::listen((TOOLPATHSOCKET_NATIVE)hSocket, SOMAXCONN) != 0)
+			throw std::runtime_error("Could not listen on socket " + sSocketPath);
+
+		return pSocket;
+	}
+
+	PToolpathLocalSocket CToolpathLocalSocket::connect(const std::string& sSocketPath)
+	{
+		sockaddr_un socketAddress = makeSocketAddress(sSocketPath);
+
+		ToolpathSocketHandle hSocket = createSocket();
+		PToolpathLocalSocket pSocket(new CToolpathLocalSocket(hSocket));
+
+		if (::connect((TOOLPATHSOCKET_NATIVE)hSocket, (sockaddr*)&socketAddress, sizeof(socketAddress)) != 0)
+			throw std::runtime_error("Could not connect to " + sSocketPath);
+
+		return pSocket;
+	}
+
+	PToolpathLocalSocket CToolpathLocalSocket::accept()
+	{
+		ToolpathSocketHandle hConnection = (ToolpathSocketHandle)::accept((TOOLPATHSOCKET_NATIVE)m_hSocket, nullptr, nullptr);
+#ifndef _WIN32
+		// A signal interrupts the wait, but does not end it
+		while ((hConnection == (ToolpathSocketHandle)TOOLPATHSOCKET_INVALID) && (errno == EINTR))
+			hConnection = (ToolpathSocketHandle)::accept((TOOLPATHSOCKET_NATIVE)m_hSocket, nullptr, nullptr);
+#endif
+		if (hConnection == (ToolpathSocketHandle)TOOLPATHSOCKET_INVALID)
+			return nullptr;
+
+		return PToolpathLocalSocket(new CToolpathLocalSocket(hConnection));
+	}
+
+	bool CToolpathLocalSocket::sendLine(const std::string& sLine)
+	{
+		std::string sMessage = sLine;
+		if (sMessage.empty() || (sMessage.back() != '\n'))
+			sMessage += "\n";
+
+		std::lock_guard<std::mutex> lockGuard(m_SendMutex);
+
+		size_t nPosition = 0;
+		while (nPosition < sMessage.length()) {
+			int nFlags = 0;
+#ifdef MSG_NOSIGNAL
+			// A client that has gone must not terminate the process
+			nFlags = MSG_NOSIGNAL;
+#endif
+			auto nSent = send((TOOLPATHSOCKET_NATIVE)m_hSocket, sMessage.c_str() + nPosition, (int)(sMessage.length() - nPosition), nFlags);
+#ifndef _WIN32
+			if ((nSent < 0) && (errno == EINTR))
+				continue;
+#endif
+			if (nSent <= 0)
+				return false;
+			nPosition += (size_t)nSent;
+		}
+
+		return true;
+	}
+
+	bool CToolpathLocalSocket::receiveLine(std::string& sLine)
+	{
+		while (true) {
+			size_t nNewLine = m_sReceiveBuffer.find('\n');
+			if (nNewLine != std::string::npos) {
+				sLine = m_sReceiveBuffer.substr(0, nNewLine);
+				m_sReceiveBuffer.erase(0, nNewLine + 1);
+				return true;
+			}
+
+			if (m_sReceiveBuffer.length() > TOOLPATHSOCKET_MAXLINELENGTH) {
+				m_sReceiveBuffer.clear();
+				shutdown();
+				return false;
+			}
+
+			char buffer[4096];
+			auto nReceived = recv((TOOLPATHSOCKET_NATIVE)m_hSocket, buffer, sizeof(buffer), 0);
+#ifndef _WIN32
+			if ((nReceived < 0) && (errno == EINTR))
+				continue;
+#endif
+			if (nReceived <= 0) {
+				// A last line without newline is still delivered
+				if (m_sReceiveBuffer.empty())
+					return false;
+
+				sLine = m_sReceiveBuffer;
+				m_sReceiveBuffer.clear();
+				return true;
+			}
+
+			m_sReceiveBuffer.append(buffer, (size_t)nReceived);
+		}
+	}
+
+	void CToolpathLocalSocket::shutdown()
+	{
+#ifdef _WIN32
+		::shutdown((TOOLPATHSOCKET_NATIVE)m_hSocket, SD_BOTH);
+#else
+		::shutdown(m_hSocket, SHUT_RDWR);
+#endif
+	}
+
+} // namespace Toolpath
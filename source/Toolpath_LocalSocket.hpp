@@ -0,0 +1,90 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#ifndef __TOOLPATH_LOCALSOCKET
+#define __TOOLPATH_LOCALSOCKET
+
+#include <string>
+#include <memory>
+#include <mutex>
+#include <cstdint>
+
+namespace Toolpath {
+
+#ifdef _WIN32
+	typedef uintptr_t ToolpathSocketHandle;
+#else
+	typedef int ToolpathSocketHandle;
+#endif
+
+	class CToolpathLocalSocket;
+	typedef std::shared_ptr<CToolpathLocalSocket> PToolpathLocalSocket;
+
+	/**
+	 * Stream socket on a Unix domain socket path, exchanging newline terminated messages.
+	 * Sending is thread safe; receiving is expected from one thread.
+	 */
+	class CToolpathLocalSocket {
+	private:
+		ToolpathSocketHandle m_hSocket;
+		std::mutex m_SendMutex;
+		std::string m_sReceiveBuffer;
+
+		CToolpathLocalSocket(ToolpathSocketHandle hSocket);
+
+	public:
+		virtual ~CToolpathLocalSocket();
+
+		// Creates a listening socket that only the owner may connect to, replacing a stale socket file of an earlier process.
+		// Fails if the path exists and is not a socket.
+		static PToolpathLocalSocket listen(const std::string& sSocketPath);
+		static PToolpathLocalSocket connect(const std::string& sSocketPath);
+
+		// Waits for the next connection of a listening socket, interrupted waits are resumed. Returns nullptr if accepting fails.
+		PToolpathLocalSocket accept();
+
+		// Returns false if the peer has gone, interrupted sends are resumed
+		bool sendLine(const std::string& sLine);
+
+		// Returns false at the end of the stream. A line longer than the maximum length shuts the connection down and returns false.
+		bool receiveLine(std::string& sLine);
+
+		// Wakes up threads blocked in receiveLine or accept
+		void shutdown();
+
+		// Removes the file at the path only if it is a socket
+		static void removeSocketFile(const std::string& sSocketPath);
+
+		CToolpathLocalSocket(const CToolpathLocalSocket&) = delete;
+		CToolpathLocalSocket& operator=(const CToolpathLocalSocket&) = delete;
+	};
+
+} // namespace Toolpath
+
+#endif // __TOOLPATH_LOCALSOCKET
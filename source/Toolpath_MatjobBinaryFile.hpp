@@ -35,11 +35,12 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <vector>
 #include <stack>
 
-#include "lib3mf_types.hpp"
-
+#include "Toolpath_Source.hpp"
 #include "Toolpath_MatjobConst.hpp"
+#include "Toolpath_MemoryTracker.hpp"
 
 #include "Common/Platform/NMR_ExportStream.h"
+#include "Common/Platform/NMR_PortableZIPDeflatedData.h"
 
 namespace Toolpath {
 	
@@ -53,10 +54,12 @@ namespace Toolpath {
 		std::vector<uint8_t> m_Buffer;
 		std::stack<uint64_t> m_GroupStartPositionStack;
 
+		CToolpathMemoryGauge m_BufferGauge;
+
 	public:
 
 		CMatJobBinaryFile (uint32_t nFileID, const std::string sFileName)
-			: m_nFileID (nFileID), m_nFileSize (0)
+			: m_nFileID (nFileID), m_nFileSize (0), m_BufferGauge (eToolpathMemorySubsystem::MatJobBinaryFile)
 		{
 			m_sFileName = sFileName;
 
@@ -67,17 +70,16 @@ namespace Toolpath {
 		{
 		}
 
-		void writeRaw (uint8_t * pBuffer, uint32_t nLength)
+		void writeRaw (const uint8_t * pBuffer, uint32_t nLength)
 		{
 			if (nLength > 0) {
 				if (pBuffer == nullptr)
 					throw std::runtime_error("CMatJobBinaryFile::writeRaw: Buffer is null");
 
-				for (uint32_t nIndex = 0; nIndex < nLength; nIndex++) {
-					m_Buffer.push_back(pBuffer[nIndex]);
-				}
+				m_Buffer.insert(m_Buffer.end(), pBuffer, pBuffer + nLength);
 
 				m_nFileSize += nLength;
+				m_BufferGauge.update(m_Buffer.capacity());
 			}
 
 		}
@@ -97,6 +99,15 @@ namespace Toolpath {
 			return m_nFileSize;
 		}
 
+		// Copies encoded bytes that have not been released yet, e.g. a layer group for the layer cache
+		void copyData(uint64_t nStartPosition, uint64_t nEndPosition, std::vector<uint8_t>& buffer)
+		{
+			if ((nStartPosition > nEndPosition) || (nEndPosition > m_Buffer.size()))
+				throw std::runtime_error("CMatJobBinaryFile::copyData: Invalid data range");
+
+			buffer.assign(m_Buffer.begin() + (size_t)nStartPosition, m_Buffer.begin() + (size_t)nEndPosition);
+		}
+
 		void beginGroup(uint32_t nID)
 		{
 			m_GroupStartPositionStack.push(m_nFileSize);
@@ -157,12 +168,11 @@ namespace Toolpath {
 			writeRaw((uint8_t*)&nValue, 4);
 		}
 
-		void writePointArray(uint32_t nID, const std::vector<Lib3MF::sPosition2D> & points)
+		void writePointArray(uint32_t nID, const sToolpathPoint2D * pPoints, uint32_t nNumberOfPoints)
 		{
-			if (points.size() == 0)
+			if ((pPoints == nullptr) || (nNumberOfPoints == 0))
 				throw std::runtime_error("CMatJobBinaryFile::writePointArray: Point array is empty");
 
-			uint32_t nNumberOfPoints = (uint32_t)points.size();
 			if (nNumberOfPoints > MATJOB_MAXPOINTCOUNTPERPOLYLINE)
 				throw std::runtime_error("CMatJobBinaryFile::writePointArray: Too many points in array (" + std::to_string(nNumberOfPoints) + ")");
 
@@ -170,21 +180,21 @@ namespace Toolpath {
 			uint32_t nLength = (uint32_t)(8 * nNumberOfPoints + 4);
 			writeRaw((uint8_t*)&nLength, 4);
 			writeRaw((uint8_t*)&nNumberOfPoints, 4);
-			writeRaw((uint8_t*)&points.at(0), (uint32_t) (8 * points.size ()));
+			writeRaw((const uint8_t*)pPoints, 8 * nNumberOfPoints);
 		}
 
-		void writeHatchArray(uint32_t nID, const std::vector<Lib3MF::sHatch2D>& hatches)
+		void writeHatchArray(uint32_t nID, const sToolpathHatch2D * pHatches, uint32_t nHatchCount)
 		{
-			if (hatches.size() == 0)
+			if ((pHatches == nullptr) || (nHatchCount == 0))
 				throw std::runtime_error("CMatJobBinaryFile::writeHatchArray: Hatch array is empty");
 
-			uint32_t nHatchCount = (uint32_t)hatches.size();
 			if (nHatchCount > MATJOB_MAXHATCHCOUNTPERBLOCK)
 				throw std::runtime_error("CMatJobBinaryFile::writeHatchArray: Too many hatches in array (" + std::to_string (nHatchCount) + ")");
 
 			std::vector<float> coordinates;
 			coordinates.reserve(nHatchCount * 4);
-			for (auto & hatch : hatches) {
+			for (uint32_t nHatchIndex = 0; nHatchIndex < nHatchCount; nHatchIndex++) {
+				auto & hatch = pHatches[nHatchIndex];
 				coordinates.push_back((float)hatch.m_Point1Coordinates[0]);
 				coordinates.push_back((float)hatch.m_Point1Coordinates[1]);
 				coordinates.push_back((float)hatch.m_Point2Coordinates[0]);
@@ -279,6 +289,24 @@ namespace Toolpath {
 			pStream->writeBuffer(m_Buffer.data(), m_Buffer.size());
 		}
 
+		NMR::PPortableZIPDeflatedData deflateBuffer()
+		{
+			if (m_Buffer.empty())
+				throw std::runtime_error("MatJob Strean Buffer is empty");
+
+			auto pDeflatedData = std::make_shared<NMR::CPortableZIPDeflatedData>();
+			pDeflatedData->deflateBuffer(m_Buffer.data(), m_Buffer.size());
+			return pDeflatedData;
+		}
+
+		// Frees the encoded data once it has been stored. The file size is retained for the metadata.
+		void releaseBuffer()
+		{
+			std::vector<uint8_t> emptyBuffer;
+			m_Buffer.swap(emptyBuffer);
+			m_BufferGauge.update(0);
+		}
+
 
 	};
 
@@ -0,0 +1,207 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#ifndef __TOOLPATH_MATJOBBLOCKPLANNER
+#define __TOOLPATH_MATJOBBLOCKPLANNER
+
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+
+#include "Toolpath_Source.hpp"
+#include "Toolpath_MatjobConst.hpp"
+
+namespace Toolpath {
+
+	// A data block of a layer. It is either a range of the elements of one segment,
+	// or all elements of consecutive hatch segments of the same part and parameter set.
+	typedef struct _sMatJobPlannedBlock {
+		eToolpathSegmentType m_Type;
+		uint32_t m_nFirstSegmentIndex;
+		uint32_t m_nSegmentCount;
+		uint32_t m_nFirstElementOffset;
+		uint32_t m_nElementCount;
+	} sMatJobPlannedBlock;
+
+	/**
+	 * Plans the data blocks of a layer. Segments with more points or hatches than a data block
+	 * can hold are split into several blocks. Consecutive polyline pieces share their end point,
+	 * so the path is unchanged. Optionally, consecutive hatch segments with the same part and
+	 * parameter set are joined into one block up to a target hatch count.
+	 */
+	class CMatJobBlockPlanner {
+	private:
+		uint32_t m_nMaxPointCount;
+		uint32_t m_nMaxHatchCount;
+		uint32_t m_nHatchTargetCount;
+
+		uint64_t m_nBlockCount;
+		uint64_t m_nSplitSegmentCount;
+		uint64_t m_nJoinedSegmentCount;
+
+		void addBlock(std::vector<sMatJobPlannedBlock>& blocks, eToolpathSegmentType segmentType, uint32_t nFirstSegmentIndex, uint32_t nSegmentCount, uint32_t nFirstElementOffset, uint32_t nElementCount)
+		{
+			sMatJobPlannedBlock block;
+			block.m_Type = segmentType;
+			block.m_nFirstSegmentIndex = nFirstSegmentIndex;
+			block.m_nSegmentCount = nSegmentCount;
+			block.m_nFirstElementOffset = nFirstElementOffset;
+			block.m_nElementCount = nElementCount;
+			blocks.push_back(block);
+			m_nBlockCount++;
+		}
+
+	public:
+
+		CMatJobBlockPlanner(uint32_t nMaxPointCount = MATJOB_MAXPOINTCOUNTPERPOLYLINE, uint32_t nMaxHatchCount = MATJOB_MAXHATCHCOUNTPERBLOCK)
+			: m_nMaxPointCount(nMaxPointCount),
+			m_nMaxHatchCount(nMaxHatchCount),
+			m_nHatchTargetCount(0),
+			m_nBlockCount(0),
+			m_nSplitSegmentCount(0),
+			m_nJoinedSegmentCount(0)
+		{
+			if ((nMaxPointCount < 2) || (nMaxHatchCount < 1))
+				throw std::runtime_error("invalid MatJob block limits");
+		}
+
+		virtual ~CMatJobBlockPlanner() = default;
+
+		// Hatch segments are joined into blocks of up to this many hatches, 0 keeps one block per segment
+		void setHatchTargetCount(uint32_t nHatchTargetCount)
+		{
+			m_nHatchTargetCount = (nHatchTargetCount < m_nMaxHatchCount) ? nHatchTargetCount : m_nMaxHatchCount;
+		}
+
+		uint32_t getHatchTargetCount()
+		{
+			return m_nHatchTargetCount;
+		}
+
+		/**
+		 * Plans the data blocks of a layer in segment order. Hatch segments without hatches get no block.
+		 * @param segmentParameterSetIDs Parameter set ID of every segment of the layer
+		 */
+		void planLayer(const CToolpathLayerData& layerData, const std::vector<uint32_t>& segmentParameterSetIDs, std::vector<sMatJobPlannedBlock>& blocks)
+		{
+			uint32_t nSegmentCount = layerData.getSegmentCount();
+			if (segmentParameterSetIDs.size() != nSegmentCount)
+				throw std::runtime_error("MatJob block planner has no parameter set for every segment");
+
+			blocks.clear();
+
+			uint32_t nSegmentIndex = 0;
+			while (nSegmentIndex < nSegmentCount) {
+				auto& segment = layerData.getSegment(nSegmentIndex);
+
+				switch (segment.m_Type) {
+				case eToolpathSegmentType::Loop:
+				case eToolpathSegmentType::Polyline:
+				{
+					if (segment.m_nElementCount <= m_nMaxPointCount) {
+						addBlock(blocks, segment.m_Type, nSegmentIndex, 1, 0, segment.m_nElementCount);
+						break;
+					}
+
+					// Every piece starts at the last point of the previous piece
+					for (uint32_t nOffset = 0; nOffset + 1 < segment.m_nElementCount; nOffset += m_nMaxPointCount - 1) {
+						uint32_t nPieceCount = segment.m_nElementCount - nOffset;
+						if (nPieceCount > m_nMaxPointCount)
+							nPieceCount = m_nMaxPointCount;
+						addBlock(blocks, segment.m_Type, nSegmentIndex, 1, nOffset, nPieceCount);
+					}
+					m_nSplitSegmentCount++;
+					break;
+				}
+
+				case eToolpathSegmentType::Hatch:
+				{
+					if (segment.m_nElementCount == 0)
+						break;
+
+					if (segment.m_nElementCount > m_nMaxHatchCount) {
+						for (uint32_t nOffset = 0; nOffset < segment.m_nElementCount; nOffset += m_nMaxHatchCount) {
+							uint32_t nPieceCount = segment.m_nElementCount - nOffset;
+							if (nPieceCount > m_nMaxHatchCount)
+								nPieceCount = m_nMaxHatchCount;
+							addBlock(blocks, segment.m_Type, nSegmentIndex, 1, nOffset, nPieceCount);
+						}
+						m_nSplitSegmentCount++;
+						break;
+					}
+
+					// Following hatch segments are joined while the block stays within the target, empty segments are passed over
+					uint32_t nBlockSegmentCount = 1;
+					uint32_t nBlockHatchCount = segment.m_nElementCount;
+					while ((nBlockHatchCount < m_nHatchTargetCount) && (nSegmentIndex + nBlockSegmentCount < nSegmentCount)) {
+						auto& nextSegment = layerData.getSegment(nSegmentIndex + nBlockSegmentCount);
+						if ((nextSegment.m_Type != eToolpathSegmentType::Hatch) || (nextSegment.m_nPartIndex != segment.m_nPartIndex)
+							|| (segmentParameterSetIDs[nSegmentIndex + nBlockSegmentCount] != segmentParameterSetIDs[nSegmentIndex]))
+							break;
+						if ((uint64_t)nBlockHatchCount + nextSegment.m_nElementCount > m_nHatchTargetCount)
+							break;
+
+						nBlockHatchCount += nextSegment.m_nElementCount;
+						nBlockSegmentCount++;
+					}
+
+					addBlock(blocks, segment.m_Type, nSegmentIndex, nBlockSegmentCount, 0, nBlockHatchCount);
+					m_nJoinedSegmentCount += nBlockSegmentCount - 1;
+					nSegmentIndex += nBlockSegmentCount;
+					continue;
+				}
+
+				default:
+					// Other segment types are not exported
+					break;
+				}
+
+				nSegmentIndex++;
+			}
+		}
+
+		uint64_t getBlockCount()
+		{
+			return m_nBlockCount;
+		}
+
+		uint64_t getSplitSegmentCount()
+		{
+			return m_nSplitSegmentCount;
+		}
+
+		uint64_t getJoinedSegmentCount()
+		{
+			return m_nJoinedSegmentCount;
+		}
+	};
+
+} // namespace Toolpath
+
+#endif // __TOOLPATH_MATJOBBLOCKPLANNER
@@ -58,4 +58,16 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define MATJOB_MAXHATCHCOUNTPERBLOCK (1UL << 27)
 #define MATJOB_MAXPOINTCOUNTPERPOLYLINE (1UL << 28)
 
+// Scan fields of the default machine, one per laser, all covering the build plate
+#define MATJOB_DEFAULTSCANFIELDCOUNT 4
+#define MATJOB_DEFAULTSCANFIELDSIZEX 450.0
+#define MATJOB_DEFAULTSCANFIELDSIZEY 300.0
+
+// Job slices written with a layer range, see CMatJobWriter::finalizeSlice
+#define MATJOB_SLICEMANIFESTNAME "SliceManifest.json"
+#define MATJOB_SLICEDATABLOCKSNAME "SliceDataBlocks.bin"
+#define MATJOB_SLICEENTRYEXTENSION ".deflate"
+#define MATJOB_SLICEMANIFESTFORMAT "matjob-slice"
+#define MATJOB_SLICEMANIFESTVERSION 1
+
 #endif // __TOOLPATH_MATJOBCONST
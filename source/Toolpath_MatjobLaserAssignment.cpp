@@ -0,0 +1,341 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#include "Toolpath_MatjobLaserAssignment.hpp"
+#include "Toolpath_MatjobLayerCache.hpp"
+#include "Toolpath_MatjobConst.hpp"
+
+#include <cmath>
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+#define MATJOB_LASERASSIGNMENTSTAGENAME "laserAssignment"
+
+namespace Toolpath {
+
+	static void addTaskBounds(sMatJobLaserTask& task, double dX, double dY)
+	{
+		task.m_dMinX = std::min(task.m_dMinX, dX);
+		task.m_dMinY = std::min(task.m_dMinY, dY);
+		task.m_dMaxX = std::max(task.m_dMaxX, dX);
+		task.m_dMaxY = std::max(task.m_dMaxY, dY);
+	}
+
+	static double getTaskDistance(double dX1, double dY1, double dX2, double dY2)
+	{
+		double dDeltaX = dX2 - dX1;
+		double dDeltaY = dY2 - dY1;
+		return sqrt(dDeltaX * dDeltaX + dDeltaY * dDeltaY);
+	}
+
+	CMatJobLaserAssignment::CMatJobLaserAssignment()
+		: m_dOverlapWidth(0.0),
+		m_bBalancing(false),
+		m_nLayerCount(0),
+		m_nReassignedSegmentCount(0),
+		m_nUnreachableSegmentCount(0),
+		m_dTotalLayerTime(0.0)
+	{
+	}
+
+	void CMatJobLaserAssignment::addLaserField(double dMinX, double dMinY, double dMaxX, double dMaxY)
+	{
+		if ((dMinX >= dMaxX) || (dMinY >= dMaxY))
+			throw std::runtime_error("scan field of laser " + std::to_string(m_LaserFields.size()) + " is empty");
+
+		sMatJobLaserField laserField;
+		laserField.m_dMinX = dMinX;
+		laserField.m_dMinY = dMinY;
+		laserField.m_dMaxX = dMaxX;
+		laserField.m_dMaxY = dMaxY;
+		m_LaserFields.push_back(laserField);
+		m_LaserTimes.push_back(0.0);
+	}
+
+	void CMatJobLaserAssignment::addDefaultLaserFields()
+	{
+		for (uint32_t nLaserIndex = 0; nLaserIndex < MATJOB_DEFAULTSCANFIELDCOUNT; nLaserIndex++)
+			addLaserField(0.0, 0.0, MATJOB_DEFAULTSCANFIELDSIZEX, MATJOB_DEFAULTSCANFIELDSIZEY);
+	}
+
+	uint32_t CMatJobLaserAssignment::getLaserCount()
+	{
+		return (uint32_t)m_LaserFields.size();
+	}
+
+	const sMatJobLaserField& CMatJobLaserAssignment::getLaserField(uint32_t nLaserIndex)
+	{
+		if (nLaserIndex >= m_LaserFields.size())
+			throw std::runtime_error("invalid laser index: " + std::to_string(nLaserIndex));
+
+		return m_LaserFields[nLaserIndex];
+	}
+
+	void CMatJobLaserAssignment::setOverlapWidth(double dOverlapWidth)
+	{
+		if (dOverlapWidth < 0.0)
+			throw std::runtime_error("overlap width must not be negative");
+
+		m_dOverlapWidth = dOverlapWidth;
+	}
+
+	void CMatJobLaserAssignment::setBalancing(bool bBalancing)
+	{
+		m_bBalancing = bBalancing;
+	}
+
+	void CMatJobLaserAssignment::readProfiles(IToolpathSource& source)
+	{
+		if (m_LaserFields.empty())
+			throw std::runtime_error("laser assignment has no scan fields");
+
+		m_Profiles.clear();
+
+		uint32_t nProfileCount = source.getProfileCount();
+		for (uint32_t nProfileIndex = 0; nProfileIndex < nProfileCount; nProfileIndex++) {
+			auto& profile = source.getProfile(nProfileIndex);
+
+			int64_t nLaserIndex = profile.getParameterIntegerValueDef("", "laserindex", 0);
+			if ((nLaserIndex < 0) || (nLaserIndex >= (int64_t)m_LaserFields.size()))
+				throw std::runtime_error("profile " + profile.getName() + " uses laser " + std::to_string(nLaserIndex) + ", but " + std::to_string(m_LaserFields.size()) + " scan fields are configured");
+
+			sMatJobLaserProfile laserProfile;
+			laserProfile.m_nHomeLaserIndex = (uint32_t)nLaserIndex;
+			laserProfile.m_dMarkSpeed = profile.getParameterDoubleValue("", "laserspeed");
+			laserProfile.m_dJumpSpeed = profile.getParameterDoubleValueDef("", "jumpspeed", laserProfile.m_dMarkSpeed);
+			m_Profiles.push_back(laserProfile);
+		}
+	}
+
+	uint64_t CMatJobLaserAssignment::getFingerprint()
+	{
+		uint64_t nHash = CMatJobLayerCache::getInitialHash();
+		nHash = CMatJobLayerCache::hashData(nHash, m_LaserFields.data(), m_LaserFields.size() * sizeof(sMatJobLaserField));
+		nHash = CMatJobLayerCache::hashData(nHash, &m_dOverlapWidth, sizeof(m_dOverlapWidth));
+		nHash = CMatJobLayerCache::hashData(nHash, &m_bBalancing, sizeof(m_bBalancing));
+
+		for (auto& laserProfile : m_Profiles) {
+			nHash = CMatJobLayerCache::hashData(nHash, &laserProfile.m_nHomeLaserIndex, sizeof(laserProfile.m_nHomeLaserIndex));
+			nHash = CMatJobLayerCache::hashData(nHash, &laserProfile.m_dMarkSpeed, sizeof(laserProfile.m_dMarkSpeed));
+			nHash = CMatJobLayerCache::hashData(nHash, &laserProfile.m_dJumpSpeed, sizeof(laserProfile.m_dJumpSpeed));
+		}
+
+		return nHash;
+	}
+
+	bool CMatJobLaserAssignment::isReachable(uint32_t nLaserIndex, const sMatJobLaserTask& task)
+	{
+		auto& laserField = m_LaserFields[nLaserIndex];
+		double dMargin = m_dOverlapWidth * 0.5;
+
+		return (task.m_dMinX >= laserField.m_dMinX - dMargin) && (task.m_dMaxX <= laserField.m_dMaxX + dMargin) &&
+			(task.m_dMinY >= laserField.m_dMinY - dMargin) && (task.m_dMaxY <= laserField.m_dMaxY + dMargin);
+	}
+
+	void CMatJobLaserAssignment::assignLayer(const CToolpathLayerData& layerData, std::vector<uint32_t>& segmentLasers)
+	{
+		uint32_t nLaserCount = (uint32_t)m_LaserFields.size();
+		uint32_t nSegmentCount = layerData.getSegmentCount();
+
+		segmentLasers.resize(nSegmentCount);
+		m_Tasks.clear();
+
+		for (uint32_t nSegmentIndex = 0; nSegmentIndex < nSegmentCount; nSegmentIndex++) {
+			auto& segment = layerData.getSegment(nSegmentIndex);
+			if (segment.m_nProfileIndex >= m_Profiles.size())
+				throw std::runtime_error("toolpath segment has no valid profile reference");
+
+			auto& laserProfile = m_Profiles[segment.m_nProfileIndex];
+			segmentLasers[nSegmentIndex] = laserProfile.m_nHomeLaserIndex;
+
+			if (segment.m_nElementCount == 0)
+				continue;
+
+			sMatJobLaserTask task;
+			task.m_nSegmentIndex = nSegmentIndex;
+			task.m_nHomeLaserIndex = laserProfile.m_nHomeLaserIndex;
+			task.m_nLaserIndex = laserProfile.m_nHomeLaserIndex;
+
+			// Distances within the segment, as moved by CMatJobLayer
+			double dMarkDistance = 0.0;
+			double dJumpDistance = 0.0;
+			switch (segment.m_Type) {
+			case eToolpathSegmentType::Loop:
+			case eToolpathSegmentType::Polyline:
+			{
+				auto pPoints = layerData.getSegmentPoints(segment);
+				task.m_dMinX = task.m_dMaxX = pPoints[0].m_Coordinates[0];
+				task.m_dMinY = task.m_dMaxY = pPoints[0].m_Coordinates[1];
+				for (uint32_t nIndex = 1; nIndex < segment.m_nElementCount; nIndex++) {
+					addTaskBounds(task, pPoints[nIndex].m_Coordinates[0], pPoints[nIndex].m_Coordinates[1]);
+					dMarkDistance += getTaskDistance(pPoints[nIndex - 1].m_Coordinates[0], pPoints[nIndex - 1].m_Coordinates[1],
+						pPoints[nIndex].m_Coordinates[0], pPoints[nIndex].m_Coordinates[1]);
+				}
+				break;
+			}
+
+			case eToolpathSegmentType::Hatch:
+			{
+				auto pHatches = layerData.getSegmentHatches(segment);
+				task.m_dMinX = task.m_dMaxX = pHatches[0].m_Point1Coordinates[0];
+				task.m_dMinY = task.m_dMaxY = pHatches[0].m_Point1Coordinates[1];
+				for (uint32_t nIndex = 0; nIndex < segment.m_nElementCount; nIndex++) {
+					auto& hatch = pHatches[nIndex];
+					addTaskBounds(task, hatch.m_Point1Coordinates[0], hatch.m_Point1Coordinates[1]);
+					addTaskBounds(task, hatch.m_Point2Coordinates[0], hatch.m_Point2Coordinates[1]);
+					dMarkDistance += getTaskDistance(hatch.m_Point1Coordinates[0], hatch.m_Point1Coordinates[1], hatch.m_Point2Coordinates[0], hatch.m_Point2Coordinates[1]);
+					if (nIndex > 0)
+						dJumpDistance += getTaskDistance(pHatches[nIndex - 1].m_Point2Coordinates[0], pHatches[nIndex - 1].m_Point2Coordinates[1],
+							hatch.m_Point1Coordinates[0], hatch.m_Point1Coordinates[1]);
+				}
+				break;
+			}
+
+			default:
+				continue;
+			}
+
+			task.m_dScanTime = 0.0;
+			if (laserProfile.m_dMarkSpeed > 0.0)
+				task.m_dScanTime += dMarkDistance / laserProfile.m_dMarkSpeed;
+			if (laserProfile.m_dJumpSpeed > 0.0)
+				task.m_dScanTime += dJumpDistance / laserProfile.m_dJumpSpeed;
+
+			bool bIsReachable = false;
+			for (uint32_t nLaserIndex = 0; nLaserIndex < nLaserCount; nLaserIndex++)
+				bIsReachable |= isReachable(nLaserIndex, task);
+			if (!bIsReachable)
+				m_nUnreachableSegmentCount++;
+
+			m_Tasks.push_back(task);
+		}
+
+		if (!m_bBalancing || (nLaserCount < 2))
+			return;
+
+		m_LaserLoads.assign(nLaserCount, 0.0);
+		for (auto& task : m_Tasks)
+			m_LaserLoads[task.m_nHomeLaserIndex] += task.m_dScanTime;
+		double dHomeMaxLoad = *std::max_element(m_LaserLoads.begin(), m_LaserLoads.end());
+
+		// Longest processing time first, ties in segment order
+		m_TaskOrder.resize(m_Tasks.size());
+		for (uint32_t nTaskIndex = 0; nTaskIndex < m_Tasks.size(); nTaskIndex++)
+			m_TaskOrder[nTaskIndex] = nTaskIndex;
+		std::stable_sort(m_TaskOrder.begin(), m_TaskOrder.end(), [this](uint32_t nTask1, uint32_t nTask2) {
+			return m_Tasks[nTask1].m_dScanTime > m_Tasks[nTask2].m_dScanTime;
+		});
+
+		m_LaserLoads.assign(nLaserCount, 0.0);
+		for (uint32_t nTaskIndex : m_TaskOrder) {
+			auto& task = m_Tasks[nTaskIndex];
+
+			// Segments that no laser reaches stay with the laser of their profile
+			uint32_t nBestLaserIndex = task.m_nHomeLaserIndex;
+			bool bFound = false;
+			for (uint32_t nLaserIndex = 0; nLaserIndex < nLaserCount; nLaserIndex++) {
+				if (!isReachable(nLaserIndex, task))
+					continue;
+
+				if (!bFound || (m_LaserLoads[nLaserIndex] < m_LaserLoads[nBestLaserIndex]) ||
+					((m_LaserLoads[nLaserIndex] == m_LaserLoads[nBestLaserIndex]) && (nLaserIndex == task.m_nHomeLaserIndex))) {
+					nBestLaserIndex = nLaserIndex;
+					bFound = true;
+				}
+			}
+
+			task.m_nLaserIndex = nBestLaserIndex;
+			m_LaserLoads[nBestLaserIndex] += task.m_dScanTime;
+		}
+
+		double dBalancedMaxLoad = *std::max_element(m_LaserLoads.begin(), m_LaserLoads.end());
+		if (dBalancedMaxLoad >= dHomeMaxLoad)
+			return;
+
+		for (auto& task : m_Tasks) {
+			segmentLasers[task.m_nSegmentIndex] = task.m_nLaserIndex;
+			if (task.m_nLaserIndex != task.m_nHomeLaserIndex)
+				m_nReassignedSegmentCount++;
+		}
+	}
+
+	void CMatJobLaserAssignment::recordLayer(const std::vector<double>& laserTimes)
+	{
+		if (laserTimes.size() != m_LaserTimes.size())
+			throw std::runtime_error("laser times do not match the laser count");
+
+		double dLayerTime = 0.0;
+		for (size_t nLaserIndex = 0; nLaserIndex < laserTimes.size(); nLaserIndex++) {
+			m_LaserTimes[nLaserIndex] += laserTimes[nLaserIndex];
+			dLayerTime = std::max(dLayerTime, laserTimes[nLaserIndex]);
+		}
+
+		m_dTotalLayerTime += dLayerTime;
+		m_nLayerCount++;
+	}
+
+	void CMatJobLaserAssignment::writeStatistics(CToolpathStatistics& statistics)
+	{
+		std::string sStage = MATJOB_LASERASSIGNMENTSTAGENAME;
+		statistics.setProcessingValue(sStage, "layers", (double)m_nLayerCount);
+		statistics.setProcessingValue(sStage, "reassignedSegments", (double)m_nReassignedSegmentCount);
+		statistics.setProcessingValue(sStage, "unreachableSegments", (double)m_nUnreachableSegmentCount);
+		statistics.setProcessingValue(sStage, "layerTime", m_dTotalLayerTime);
+
+		// Utilization is the share of the layer times during which a laser is scanning
+		for (size_t nLaserIndex = 0; nLaserIndex < m_LaserTimes.size(); nLaserIndex++) {
+			std::string sLaser = "laser" + std::to_string(nLaserIndex);
+			statistics.setProcessingValue(sStage, sLaser + "Time", m_LaserTimes[nLaserIndex]);
+			statistics.setProcessingValue(sStage, sLaser + "Utilization", (m_dTotalLayerTime > 0.0) ? m_LaserTimes[nLaserIndex] / m_dTotalLayerTime : 0.0);
+		}
+	}
+
+	std::string CMatJobLaserAssignment::makeLaserParameterSetUUID(const std::string& sUUID, uint32_t nLaserIndex)
+	{
+		uint64_t nHash1 = CMatJobLayerCache::hashData(CMatJobLayerCache::getInitialHash(), sUUID.data(), sUUID.size());
+		nHash1 = CMatJobLayerCache::hashData(nHash1, &nLaserIndex, sizeof(nLaserIndex));
+		uint64_t nHash2 = CMatJobLayerCache::hashData(nHash1, sUUID.data(), sUUID.size());
+
+		// Name based UUID layout (version 5) with the RFC 4122 variant
+		nHash1 = (nHash1 & 0xFFFFFFFFFFFF0FFFULL) | 0x0000000000005000ULL;
+		nHash2 = (nHash2 & 0x3FFFFFFFFFFFFFFFULL) | 0x8000000000000000ULL;
+
+		std::stringstream uuidStream;
+		uuidStream << std::hex << std::setfill('0')
+			<< std::setw(8) << (nHash1 >> 32) << "-"
+			<< std::setw(4) << ((nHash1 >> 16) & 0xFFFF) << "-"
+			<< std::setw(4) << (nHash1 & 0xFFFF) << "-"
+			<< std::setw(4) << (nHash2 >> 48) << "-"
+			<< std::setw(12) << (nHash2 & 0xFFFFFFFFFFFFULL);
+		return uuidStream.str();
+	}
+
+} // namespace Toolpath
@@ -0,0 +1,138 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#ifndef __TOOLPATH_MATJOBLASERASSIGNMENT
+#define __TOOLPATH_MATJOBLASERASSIGNMENT
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+#include "Toolpath_Source.hpp"
+#include "Toolpath_Statistics.hpp"
+
+namespace Toolpath {
+
+	// Nominal scan field of a laser, in millimeters
+	typedef struct _sMatJobLaserField {
+		double m_dMinX;
+		double m_dMinY;
+		double m_dMaxX;
+		double m_dMaxY;
+	} sMatJobLaserField;
+
+	// Laser of a source profile and its speeds in mm/s
+	typedef struct _sMatJobLaserProfile {
+		uint32_t m_nHomeLaserIndex;
+		double m_dMarkSpeed;
+		double m_dJumpSpeed;
+	} sMatJobLaserProfile;
+
+	// A segment of a layer with its estimated scan time and bounds
+	typedef struct _sMatJobLaserTask {
+		uint32_t m_nSegmentIndex;
+		uint32_t m_nHomeLaserIndex;
+		uint32_t m_nLaserIndex;
+		double m_dScanTime;
+		double m_dMinX;
+		double m_dMinY;
+		double m_dMaxX;
+		double m_dMaxY;
+	} sMatJobLaserTask;
+
+	/**
+	 * Assigns the segments of each layer to the lasers of a multi-laser machine.
+	 * Laser i scans field i. Neighboring fields share an overlap zone, every laser reaches
+	 * half of the overlap width beyond its field. Without balancing, every segment is scanned by
+	 * the laserindex of its profile. With balancing, segments are distributed longest first to
+	 * the least loaded laser that reaches them, and a layer keeps the profile lasers unless
+	 * that shortens its longest laser time.
+	 * The scan time of a segment is its mark and jump distance over the profile speeds.
+	 */
+	class CMatJobLaserAssignment {
+	private:
+		std::vector<sMatJobLaserField> m_LaserFields;
+		double m_dOverlapWidth;
+		bool m_bBalancing;
+
+		// By source profile index
+		std::vector<sMatJobLaserProfile> m_Profiles;
+
+		// Buffers reused across layers
+		std::vector<sMatJobLaserTask> m_Tasks;
+		std::vector<uint32_t> m_TaskOrder;
+		std::vector<double> m_LaserLoads;
+
+		// Summed over all recorded layers
+		uint64_t m_nLayerCount;
+		uint64_t m_nReassignedSegmentCount;
+		uint64_t m_nUnreachableSegmentCount;
+		std::vector<double> m_LaserTimes;
+		double m_dTotalLayerTime;
+
+		bool isReachable(uint32_t nLaserIndex, const sMatJobLaserTask& task);
+
+	public:
+		CMatJobLaserAssignment();
+		virtual ~CMatJobLaserAssignment() = default;
+
+		// Adds the scan field of the next laser
+		void addLaserField(double dMinX, double dMinY, double dMaxX, double dMaxY);
+		void addDefaultLaserFields();
+
+		uint32_t getLaserCount();
+		const sMatJobLaserField& getLaserField(uint32_t nLaserIndex);
+
+		void setOverlapWidth(double dOverlapWidth);
+		void setBalancing(bool bBalancing);
+
+		// Reads laserindex, laserspeed and jumpspeed of all profiles
+		void readProfiles(IToolpathSource& source);
+
+		// Hash of the fields, options and profiles, which determine the assignment of a layer
+		uint64_t getFingerprint();
+
+		// Laser index of every segment of the layer
+		void assignLayer(const CToolpathLayerData& layerData, std::vector<uint32_t>& segmentLasers);
+
+		// Scan time of every laser in a layer, the layer takes as long as its slowest laser
+		void recordLayer(const std::vector<double>& laserTimes);
+
+		void writeStatistics(CToolpathStatistics& statistics);
+
+		// Stable UUID of the copy of a parameter set for another laser
+		static std::string makeLaserParameterSetUUID(const std::string& sUUID, uint32_t nLaserIndex);
+	};
+
+	typedef std::shared_ptr<CMatJobLaserAssignment> PMatJobLaserAssignment;
+
+} // namespace Toolpath
+
+#endif // __TOOLPATH_MATJOBLASERASSIGNMENT
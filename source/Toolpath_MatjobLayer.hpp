@@ -37,8 +37,9 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <iomanip>
 
 #include "Toolpath_MatjobBinaryFile.hpp"
-
-#include "lib3mf_dynamic.hpp"
+#include "Toolpath_MatjobPart.hpp"
+#include "Toolpath_MatjobScanTimeModel.hpp"
+#include "Common/Platform/NMR_XmlWriter_Native.h"
 
 namespace Toolpath
 {
@@ -62,6 +63,13 @@ namespace Toolpath
 		uint64_t m_nDataPosition;
 	} sMatJobDataBlock;
 
+	// Distances moved at the mark and jump speed of a data block and its estimated scan time, including the jump to its start
+	typedef struct _sMatJobScanDistance {
+		double m_dMarkDistance;
+		double m_dJumpDistance;
+		double m_dScanTime;
+	} sMatJobScanDistance;
+
 
 	class CMatJobLayer {
 	private:
@@ -78,13 +86,27 @@ namespace Toolpath
 		double m_dCurrentY;
 		bool m_bIsFirstMoveInLayer;
 		bool m_bIsFirstMoveInBlock;
+		bool m_bLastMoveWasMark;
+
+		PMatJobScanTimeModel m_pScanTimeModel;
+		sMatJobScanTimeParameters m_CurrentScanTimeParameters;
 
 		uint32_t m_nCurrentNumMarkSegments;
 		uint32_t m_nCurrentNumJumpSegments;
 		double m_dCurrentMarkDistance;
 		double m_dCurrentJumpDistance;
+		sMatJobScanDistance m_CurrentScanDistance;
 
 		std::vector <sMatJobDataBlock> m_DataBlocks;
+		std::vector <sMatJobScanDistance> m_ScanDistances;
+		CToolpathMemoryGauge m_DataBlockGauge;
+
+		void pushDataBlock(const sMatJobDataBlock& dataBlock, const sMatJobScanDistance& scanDistance)
+		{
+			m_DataBlocks.push_back(dataBlock);
+			m_ScanDistances.push_back(scanDistance);
+			m_DataBlockGauge.update(m_DataBlocks.capacity() * sizeof(sMatJobDataBlock) + m_ScanDistances.capacity() * sizeof(sMatJobScanDistance));
+		}
 
 		void moveTo(double dX, double dY, double dSpeedInMMperS, bool bDoMark)
 		{
@@ -100,10 +122,21 @@ namespace Toolpath
 				double dDeltaX = dX - m_dCurrentX;
 				double dDeltaY = dY - m_dCurrentY;
 				double dDistance = sqrt((dDeltaX * dDeltaX) + (dDeltaY * dDeltaY));
-				if (dSpeedInMMperS > 0.0) {
-					double dTime = dDistance / dSpeedInMMperS;
-					m_dLayerScanTime += dTime;
-				}
+
+				eMatJobMoveType moveType;
+				if (bDoMark)
+					moveType = m_bLastMoveWasMark ? eMatJobMoveType::PolygonMark : eMatJobMoveType::Mark;
+				else
+					moveType = m_bLastMoveWasMark ? eMatJobMoveType::JumpAfterMark : eMatJobMoveType::Jump;
+
+				double dTime = m_pScanTimeModel->getMoveTime(m_CurrentScanTimeParameters, moveType, dDistance, dSpeedInMMperS);
+				m_dLayerScanTime += dTime;
+				m_CurrentScanDistance.m_dScanTime += dTime;
+
+				if (bDoMark)
+					m_CurrentScanDistance.m_dMarkDistance += dDistance;
+				else
+					m_CurrentScanDistance.m_dJumpDistance += dDistance;
 
 				if (bDoMark) {
 					m_dTotalMarkDistance += dDistance;
@@ -135,12 +168,14 @@ namespace Toolpath
 			m_dCurrentY = dY;
 			m_bIsFirstMoveInBlock = false;
 			m_bIsFirstMoveInLayer = false;
+			m_bLastMoveWasMark = bDoMark;
 		}
 
 
 	public:
 
-		CMatJobLayer(double dZValue)
+		// The scan time model defaults to distance over speed
+		CMatJobLayer(double dZValue, PMatJobScanTimeModel pScanTimeModel = nullptr)
 			: m_dZValue(dZValue),
 			m_dLayerScanTime(0.0),
 			m_dTotalMarkDistance(0.0),
@@ -156,11 +191,20 @@ namespace Toolpath
 			m_nCurrentNumJumpSegments(0),
 			m_nCurrentNumMarkSegments(0),
 			m_bIsFirstMoveInBlock(true),
-			m_bIsFirstMoveInLayer(true)
+			m_bIsFirstMoveInLayer(true),
+			m_bLastMoveWasMark(false),
+			m_pScanTimeModel(pScanTimeModel),
+			m_DataBlockGauge(eToolpathMemorySubsystem::MatJobLayerData)
 
 
 		{
+			if (m_pScanTimeModel.get() == nullptr)
+				m_pScanTimeModel = std::make_shared<CMatJobScanTimeModel_Distance>();
 
+			memset(&m_CurrentScanTimeParameters, 0, sizeof(sMatJobScanTimeParameters));
+			m_CurrentScanDistance.m_dMarkDistance = 0.0;
+			m_CurrentScanDistance.m_dJumpDistance = 0.0;
+			m_CurrentScanDistance.m_dScanTime = 0.0;
 		}
 
 		virtual ~CMatJobLayer()
@@ -207,19 +251,63 @@ namespace Toolpath
 			return m_dMaxY;
 		}
 
+		uint32_t getDataBlockCount()
+		{
+			return (uint32_t)m_DataBlocks.size();
+		}
+
+		const sMatJobDataBlock& getDataBlock(uint32_t nIndex)
+		{
+			if (nIndex >= m_DataBlocks.size())
+				throw std::runtime_error("MatJob Layer has no data block " + std::to_string(nIndex));
+
+			return m_DataBlocks[nIndex];
+		}
+
+		const sMatJobScanDistance& getScanDistance(uint32_t nIndex)
+		{
+			if (nIndex >= m_ScanDistances.size())
+				throw std::runtime_error("MatJob Layer has no data block " + std::to_string(nIndex));
+
+			return m_ScanDistances[nIndex];
+		}
+
+		// Sets the statistics of a layer that has been encoded elsewhere, e.g. in a slice of the job
+		void restoreSummary(double dLayerScanTime, double dTotalMarkDistance, double dTotalJumpDistance, double dMinX, double dMinY, double dMaxX, double dMaxY)
+		{
+			m_dLayerScanTime = dLayerScanTime;
+			m_dTotalMarkDistance = dTotalMarkDistance;
+			m_dTotalJumpDistance = dTotalJumpDistance;
+			m_dMinX = dMinX;
+			m_dMinY = dMinY;
+			m_dMaxX = dMaxX;
+			m_dMaxY = dMaxY;
+			m_bIsFirstMoveInLayer = false;
+		}
+
 		void addDataBlock(const sMatJobDataBlock& dataBlock)
 		{
-			m_DataBlocks.push_back(dataBlock);
+			sMatJobScanDistance scanDistance;
+			scanDistance.m_dMarkDistance = 0.0;
+			scanDistance.m_dJumpDistance = 0.0;
+			scanDistance.m_dScanTime = 0.0;
+			pushDataBlock(dataBlock, scanDistance);
+		}
+
+		void addDataBlock(const sMatJobDataBlock& dataBlock, const sMatJobScanDistance& scanDistance)
+		{
+			pushDataBlock(dataBlock, scanDistance);
 		}
 
-		void addPolylineDataBlock(CMatJobPart* pPart, CMatJobBinaryFile* pBinaryFile, uint32_t nPartID, uint32_t nParameterSetID, const std::vector<Lib3MF::sPosition2D>& points, double dMarkSpeedInMMPerS, double dJumpSpeedInMMPerS)
+		void addPolylineDataBlock(CMatJobPart* pPart, CMatJobBinaryFile* pBinaryFile, uint32_t nPartID, uint32_t nParameterSetID, const sToolpathPoint2D* pPoints, uint32_t nPointCount, double dMarkSpeedInMMPerS, double dJumpSpeedInMMPerS,
+			const sMatJobScanTimeParameters& scanTimeParameters = sMatJobScanTimeParameters())
 		{
 			
 			if (pBinaryFile == nullptr)
 				throw std::runtime_error("MatJob Polyline DataBlock has invalid binary file");
 			if (pPart == nullptr)
 				throw std::runtime_error("MatJob Polyline DataBlock has invalid part");
-			if (points.size() == 0)
+			if ((pPoints == nullptr) || (nPointCount == 0))
 				throw std::runtime_error("MatJob Polyline DataBlock has no points");
 
 			sMatJobDataBlock dataBlock;
@@ -235,7 +323,7 @@ namespace Toolpath
 			pBinaryFile->writeInt32(MATJOB_GROUP_DATABLOCKUNKNOWN2121, 0);
 			pBinaryFile->writeInt32(MATJOB_GROUP_DATABLOCKUNKNOWN2122, -1);
 			pBinaryFile->writeInt32(MATJOB_GROUP_DATABLOCKUNKNOWN2123, 0);
-			pBinaryFile->writePointArray(MATJOB_GROUP_DATABLOCKPOINTS, points);
+			pBinaryFile->writePointArray(MATJOB_GROUP_DATABLOCKPOINTS, pPoints, nPointCount);
 			pBinaryFile->endGroup();
 
 			m_bIsFirstMoveInBlock = true;
@@ -243,16 +331,20 @@ namespace Toolpath
 			m_dCurrentMarkDistance = 0.0;
 			m_nCurrentNumJumpSegments = 0;
 			m_nCurrentNumMarkSegments = 0;
+			m_CurrentScanDistance.m_dMarkDistance = 0.0;
+			m_CurrentScanDistance.m_dJumpDistance = 0.0;
+			m_CurrentScanDistance.m_dScanTime = 0.0;
+			m_CurrentScanTimeParameters = scanTimeParameters;
 
-			auto& startPoint = points.at(0);
+			auto& startPoint = pPoints[0];
 			double dStartX = startPoint.m_Coordinates[0];
 			double dStartY = startPoint.m_Coordinates[1];
 			pPart->addCoordinatesXY(dStartX, dStartY);
 
 			moveTo(dStartX, dStartY, dJumpSpeedInMMPerS, false);
-			for (auto i = 1; i < points.size(); i++) {
+			for (uint32_t i = 1; i < nPointCount; i++) {
 
-				auto& movePoint = points.at(i);
+				auto& movePoint = pPoints[i];
 				double dMoveX = movePoint.m_Coordinates[0];
 				double dMoveY = movePoint.m_Coordinates[1];
 
@@ -266,11 +358,12 @@ namespace Toolpath
 			dataBlock.m_dMarkDistance = m_dCurrentMarkDistance;
 			dataBlock.m_dJumpDistance = m_dCurrentJumpDistance;
 
-			m_DataBlocks.push_back(dataBlock);
+			pushDataBlock(dataBlock, m_CurrentScanDistance);
 
 		}
 
-		void addHatchDataBlock(CMatJobPart* pPart, CMatJobBinaryFile* pBinaryFile, uint32_t nPartID, uint32_t nParameterSetID, const std::vector<Lib3MF::sHatch2D>& hatches, double dMarkSpeedInMMPerS, double dJumpSpeedInMMPerS)
+		void addHatchDataBlock(CMatJobPart* pPart, CMatJobBinaryFile* pBinaryFile, uint32_t nPartID, uint32_t nParameterSetID, const sToolpathHatch2D* pHatches, uint32_t nHatchCount, double dMarkSpeedInMMPerS, double dJumpSpeedInMMPerS,
+			const sMatJobScanTimeParameters& scanTimeParameters = sMatJobScanTimeParameters())
 		{
 			if (pBinaryFile == nullptr)
 				throw std::runtime_error("MatJob Polyline DataBlock has invalid binary file");
@@ -288,7 +381,7 @@ namespace Toolpath
 			pBinaryFile->writeInt32(MATJOB_GROUP_DATABLOCKUNKNOWN2121, 0);
 			pBinaryFile->writeInt32(MATJOB_GROUP_DATABLOCKUNKNOWN2122, -1);
 			pBinaryFile->writeInt32(MATJOB_GROUP_DATABLOCKUNKNOWN2123, 0);
-			pBinaryFile->writeHatchArray(MATJOB_GROUP_DATABLOCKPOINTS, hatches);
+			pBinaryFile->writeHatchArray(MATJOB_GROUP_DATABLOCKPOINTS, pHatches, nHatchCount);
 			pBinaryFile->endGroup();
 
 			m_bIsFirstMoveInBlock = true;
@@ -296,9 +389,13 @@ namespace Toolpath
 			m_dCurrentMarkDistance = 0.0;
 			m_nCurrentNumJumpSegments = 0;
 			m_nCurrentNumMarkSegments = 0;
+			m_CurrentScanDistance.m_dMarkDistance = 0.0;
+			m_CurrentScanDistance.m_dJumpDistance = 0.0;
+			m_CurrentScanDistance.m_dScanTime = 0.0;
+			m_CurrentScanTimeParameters = scanTimeParameters;
 
-			for (auto& hatch : hatches) {
-
+			for (uint32_t nHatchIndex = 0; nHatchIndex < nHatchCount; nHatchIndex++) {
+				auto& hatch = pHatches[nHatchIndex];
 
 				pPart->addCoordinatesXY(hatch.m_Point1Coordinates[0], hatch.m_Point1Coordinates[1]);
 				pPart->addCoordinatesXY(hatch.m_Point2Coordinates[0], hatch.m_Point2Coordinates[1]);
@@ -313,7 +410,7 @@ namespace Toolpath
 			dataBlock.m_dMarkDistance = m_dCurrentMarkDistance;
 			dataBlock.m_dJumpDistance = m_dCurrentJumpDistance;
 
-			m_DataBlocks.push_back(dataBlock);
+			pushDataBlock(dataBlock, m_CurrentScanDistance);
 		}
 
 		void writeToXML(NMR::PXmlWriter_Native xmlWriter)
@@ -0,0 +1,430 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#include "Toolpath_MatjobLayerCache.hpp"
+#include "Toolpath_JSONReader.hpp"
+#include "Toolpath_JSONWriter.hpp"
+#include "Common/NMR_StringUtils.h"
+
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+namespace Toolpath {
+
+	template <typename T> static void appendValue(std::vector<uint8_t>& buffer, const T& value)
+	{
+		const uint8_t* pValue = (const uint8_t*)&value;
+		buffer.insert(buffer.end(), pValue, pValue + sizeof(T));
+	}
+
+	// Reads values of an entry file that has been loaded into memory
+	class CMatJobLayerCacheEntryReader {
+	private:
+		const std::vector<uint8_t>& m_Buffer;
+		size_t m_nPosition;
+
+	public:
+		CMatJobLayerCacheEntryReader(const std::vector<uint8_t>& buffer)
+			: m_Buffer(buffer), m_nPosition(0)
+		{
+		}
+
+		void read(void* pData, size_t nSize)
+		{
+			if (nSize > m_Buffer.size() - m_nPosition)
+				throw std::runtime_error("layer cache entry is truncated");
+
+			if (nSize > 0)
+				memcpy(pData, m_Buffer.data() + m_nPosition, nSize);
+			m_nPosition += nSize;
+		}
+
+		template <typename T> T readValue()
+		{
+			T value;
+			read(&value, sizeof(T));
+			return value;
+		}
+
+		// Element counts are checked against the remaining size before allocating
+		uint64_t readCount(size_t nElementSize)
+		{
+			uint64_t nCount = readValue<uint64_t>();
+			if (nCount > (m_Buffer.size() - m_nPosition) / nElementSize)
+				throw std::runtime_error("layer cache entry is truncated");
+			return nCount;
+		}
+
+		bool isAtEnd()
+		{
+			return m_nPosition == m_Buffer.size();
+		}
+	};
+
+	CMatJobLayerCache::CMatJobLayerCache(const std::string& sDirectory, uint64_t nSizeLimitInBytes)
+		: m_sDirectory(sDirectory),
+		m_nSizeLimit(nSizeLimitInBytes),
+		m_nTotalSize(0),
+		m_nUseCounter(0),
+		m_bIndexIsModified(false),
+		m_nHitCount(0),
+		m_nMissCount(0),
+		m_nEvictionCount(0)
+	{
+		if (sDirectory.empty())
+			throw std::runtime_error("Invalid layer cache directory");
+
+#ifdef _WIN32
+		std::wstring sDirectoryW = NMR::fnUTF8toUTF16(sDirectory);
+		if ((_wmkdir(sDirectoryW.c_str()) != 0) && (errno != EEXIST))
+#else
+		if ((mkdir(sDirectory.c_str(), 0755) != 0) && (errno != EEXIST))
+#endif
+			throw std::runtime_error("Could not create layer cache directory: " + sDirectory);
+
+		loadIndex();
+	}
+
+	CMatJobLayerCache::~CMatJobLayerCache()
+	{
+		try {
+			flush();
+		}
+		catch (...) {
+			// A lost index only loses the cached entries
+		}
+	}
+
+	std::string CMatJobLayerCache::getPath(const std::string& sFileName)
+	{
+		return m_sDirectory + "/" + sFileName;
+	}
+
+	void CMatJobLayerCache::loadIndex()
+	{
+		std::string sIndexFileName = getPath(MATJOBLAYERCACHE_INDEXNAME);
+		std::ifstream stream(sIndexFileName);
+		if (!stream.is_open())
+			return;
+		stream.close();
+
+		// An unreadable index or one of another version starts an empty cache
+		PToolpathJSONValue pIndex;
+		try {
+			pIndex = CToolpathJSONReader::parseFile(sIndexFileName);
+			if (pIndex->getUint64("version") != MATJOBLAYERCACHE_VERSION)
+				pIndex = nullptr;
+		}
+		catch (std::exception&) {
+			pIndex = nullptr;
+		}
+
+		if (pIndex.get() == nullptr) {
+			m_bIndexIsModified = true;
+			return;
+		}
+
+		m_nUseCounter = pIndex->getUint64("useCounter");
+
+		auto& entries = pIndex->getMember("entries");
+		for (uint32_t nIndex = 0; nIndex < entries.getElementCount(); nIndex++) {
+			auto& entry = entries.getElement(nIndex);
+
+			sMatJobLayerCacheEntry cacheEntry;
+			cacheEntry.m_sFileName = entry.getString("file");
+			cacheEntry.m_nSize = entry.getUint64("size");
+			cacheEntry.m_nLastUse = entry.getUint64("lastUse");
+
+			m_Entries.insert(std::make_pair(entry.getString("key"), cacheEntry));
+			m_nTotalSize += cacheEntry.m_nSize;
+		}
+
+		// The size limit may have been lowered since the last run
+		evict(0);
+	}
+
+	void CMatJobLayerCache::flush()
+	{
+		if (!m_bIndexIsModified)
+			return;
+
+		std::string sIndexFileName = getPath(MATJOBLAYERCACHE_INDEXNAME);
+		std::ofstream stream(sIndexFileName, std::ios::out | std::ios::trunc);
+		if (!stream.is_open())
+			throw std::runtime_error("Failed to write layer cache index: " + sIndexFileName);
+
+		CToolpathJSONWriter jsonWriter(stream);
+		jsonWriter.beginObject();
+		jsonWriter.writeUint64("version", MATJOBLAYERCACHE_VERSION);
+		jsonWriter.writeUint64("useCounter", m_nUseCounter);
+		jsonWriter.beginArray("entries");
+		for (auto& entryIter : m_Entries) {
+			jsonWriter.beginObject();
+			jsonWriter.writeString("key", entryIter.first);
+			jsonWriter.writeString("file", entryIter.second.m_sFileName);
+			jsonWriter.writeUint64("size", entryIter.second.m_nSize);
+			jsonWriter.writeUint64("lastUse", entryIter.second.m_nLastUse);
+			jsonWriter.endObject();
+		}
+		jsonWriter.endArray();
+		jsonWriter.endObject();
+
+		if (!stream.good())
+			throw std::runtime_error("Failed to write layer cache index: " + sIndexFileName);
+
+		m_bIndexIsModified = false;
+	}
+
+	void CMatJobLayerCache::removeEntry(std::map<std::string, sMatJobLayerCacheEntry>::iterator iEntryIter)
+	{
+		std::remove(getPath(iEntryIter->second.m_sFileName).c_str());
+
+		m_nTotalSize -= iEntryIter->second.m_nSize;
+		m_Entries.erase(iEntryIter);
+		m_bIndexIsModified = true;
+	}
+
+	void CMatJobLayerCache::evict(uint64_t nRequiredSize)
+	{
+		while ((!m_Entries.empty()) && (m_nTotalSize + nRequiredSize > m_nSizeLimit)) {
+			auto iOldestIter = m_Entries.begin();
+			for (auto iEntryIter = m_Entries.begin(); iEntryIter != m_Entries.end(); iEntryIter++) {
+				if (iEntryIter->second.m_nLastUse < iOldestIter->second.m_nLastUse)
+					iOldestIter = iEntryIter;
+			}
+
+			removeEntry(iOldestIter);
+			m_nEvictionCount++;
+		}
+	}
+
+	bool CMatJobLayerCache::lookup(const std::string& sKey, sMatJobCachedLayer& cachedLayer)
+	{
+		auto iEntryIter = m_Entries.find(sKey);
+		if (iEntryIter == m_Entries.end()) {
+			m_nMissCount++;
+			return false;
+		}
+
+		std::vector<uint8_t> buffer;
+		{
+			std::ifstream stream(getPath(iEntryIter->second.m_sFileName), std::ios::in | std::ios::binary);
+			if (stream.is_open()) {
+				buffer.resize((size_t)iEntryIter->second.m_nSize);
+				stream.read((char*)buffer.data(), (std::streamsize)buffer.size());
+				if ((uint64_t)stream.gcount() != iEntryIter->second.m_nSize)
+					buffer.clear();
+			}
+		}
+
+		// Entries that have been deleted or damaged outside of the cache are dropped
+		try {
+			CMatJobLayerCacheEntryReader reader(buffer);
+			if ((reader.readValue<uint32_t>() != MATJOBLAYERCACHE_SIGNATURE) || (reader.readValue<uint32_t>() != MATJOBLAYERCACHE_VERSION))
+				throw std::runtime_error("invalid layer cache entry");
+
+			std::string sEntryKey((size_t)reader.readCount(1), ' ');
+			reader.read(&sEntryKey[0], sEntryKey.length());
+			if (sEntryKey != sKey)
+				throw std::runtime_error("layer cache entry has a different key");
+
+			cachedLayer.m_dTotalMarkDistance = reader.readValue<double>();
+			cachedLayer.m_dTotalJumpDistance = reader.readValue<double>();
+			cachedLayer.m_dMinX = reader.readValue<double>();
+			cachedLayer.m_dMinY = reader.readValue<double>();
+			cachedLayer.m_dMaxX = reader.readValue<double>();
+			cachedLayer.m_dMaxY = reader.readValue<double>();
+
+			cachedLayer.m_DataBlocks.resize((size_t)reader.readCount(sizeof(sMatJobDataBlock)));
+			reader.read(cachedLayer.m_DataBlocks.data(), cachedLayer.m_DataBlocks.size() * sizeof(sMatJobDataBlock));
+
+			cachedLayer.m_ScanDistances.resize((size_t)reader.readCount(sizeof(sMatJobScanDistance)));
+			reader.read(cachedLayer.m_ScanDistances.data(), cachedLayer.m_ScanDistances.size() * sizeof(sMatJobScanDistance));
+
+			cachedLayer.m_PartBounds.resize((size_t)reader.readCount(sizeof(sMatJobCachedPartBounds)));
+			reader.read(cachedLayer.m_PartBounds.data(), cachedLayer.m_PartBounds.size() * sizeof(sMatJobCachedPartBounds));
+
+			cachedLayer.m_LayerData.resize((size_t)reader.readCount(1));
+			reader.read(cachedLayer.m_LayerData.data(), cachedLayer.m_LayerData.size());
+
+			if ((!reader.isAtEnd()) || (cachedLayer.m_DataBlocks.size() != cachedLayer.m_ScanDistances.size()))
+				throw std::runtime_error("invalid layer cache entry");
+		}
+		catch (std::exception&) {
+			removeEntry(iEntryIter);
+			m_nMissCount++;
+			return false;
+		}
+
+		m_nUseCounter++;
+		iEntryIter->second.m_nLastUse = m_nUseCounter;
+		m_bIndexIsModified = true;
+		m_nHitCount++;
+
+		return true;
+	}
+
+	void CMatJobLayerCache::store(const std::string& sKey, const sMatJobCachedLayer& cachedLayer)
+	{
+		if (cachedLayer.m_DataBlocks.size() != cachedLayer.m_ScanDistances.size())
+			throw std::runtime_error("layer cache data block count mismatch");
+
+		// Data blocks are stored in memory layout, the cache is not meant to be shared between platforms
+		std::vector<uint8_t> buffer;
+		buffer.reserve(cachedLayer.m_LayerData.size() + cachedLayer.m_DataBlocks.size() * (sizeof(sMatJobDataBlock) + sizeof(sMatJobScanDistance)) + 1024);
+
+		appendValue<uint32_t>(buffer, MATJOBLAYERCACHE_SIGNATURE);
+		appendValue<uint32_t>(buffer, MATJOBLAYERCACHE_VERSION);
+		appendValue<uint64_t>(buffer, sKey.length());
+		buffer.insert(buffer.end(), sKey.begin(), sKey.end());
+
+		appendValue(buffer, cachedLayer.m_dTotalMarkDistance);
+		appendValue(buffer, cachedLayer.m_dTotalJumpDistance);
+		appendValue(buffer, cachedLayer.m_dMinX);
+		appendValue(buffer, cachedLayer.m_dMinY);
+		appendValue(buffer, cachedLayer.m_dMaxX);
+		appendValue(buffer, cachedLayer.m_dMaxY);
+
+		appendValue<uint64_t>(buffer, cachedLayer.m_DataBlocks.size());
+		for (auto& dataBlock : cachedLayer.m_DataBlocks)
+			appendValue(buffer, dataBlock);
+		appendValue<uint64_t>(buffer, cachedLayer.m_ScanDistances.size());
+		for (auto& scanDistance : cachedLayer.m_ScanDistances)
+			appendValue(buffer, scanDistance);
+		appendValue<uint64_t>(buffer, cachedLayer.m_PartBounds.size());
+		for (auto& partBounds : cachedLayer.m_PartBounds)
+			appendValue(buffer, partBounds);
+		appendValue<uint64_t>(buffer, cachedLayer.m_LayerData.size());
+		buffer.insert(buffer.end(), cachedLayer.m_LayerData.begin(), cachedLayer.m_LayerData.end());
+
+		// Layers larger than the whole cache are not stored
+		uint64_t nSize = buffer.size();
+		if (nSize > m_nSizeLimit)
+			return;
+
+		auto iEntryIter = m_Entries.find(sKey);
+		if (iEntryIter != m_Entries.end())
+			removeEntry(iEntryIter);
+
+		evict(nSize);
+
+		sMatJobLayerCacheEntry cacheEntry;
+		cacheEntry.m_sFileName = std::to_string(hashData(getInitialHash(), sKey.c_str(), sKey.length())) + MATJOBLAYERCACHE_ENTRYEXTENSION;
+		cacheEntry.m_nSize = nSize;
+		m_nUseCounter++;
+		cacheEntry.m_nLastUse = m_nUseCounter;
+
+		std::string sEntryPath = getPath(cacheEntry.m_sFileName);
+		std::ofstream stream(sEntryPath, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!stream.is_open())
+			throw std::runtime_error("Failed to create layer cache entry: " + sEntryPath);
+		stream.write((const char*)buffer.data(), (std::streamsize)buffer.size());
+		if (!stream.good())
+			throw std::runtime_error("Failed to write layer cache entry: " + sEntryPath);
+
+		// Keys with the same file name replace each other
+		for (auto iOtherIter = m_Entries.begin(); iOtherIter != m_Entries.end(); iOtherIter++) {
+			if (iOtherIter->second.m_sFileName == cacheEntry.m_sFileName) {
+				m_nTotalSize -= iOtherIter->second.m_nSize;
+				m_Entries.erase(iOtherIter);
+				break;
+			}
+		}
+
+		m_Entries.insert(std::make_pair(sKey, cacheEntry));
+		m_nTotalSize += nSize;
+		m_bIndexIsModified = true;
+	}
+
+	uint64_t CMatJobLayerCache::getHitCount()
+	{
+		return m_nHitCount;
+	}
+
+	uint64_t CMatJobLayerCache::getMissCount()
+	{
+		return m_nMissCount;
+	}
+
+	uint64_t CMatJobLayerCache::getEvictionCount()
+	{
+		return m_nEvictionCount;
+	}
+
+	uint64_t CMatJobLayerCache::getTotalSize()
+	{
+		return m_nTotalSize;
+	}
+
+	std::string CMatJobLayerCache::makeKey(const std::string& sLayerDataUUID, uint64_t nContentHash)
+	{
+		const char* pHexDigits = "0123456789abcdef";
+
+		std::string sHash(16, '0');
+		for (uint32_t nDigit = 0; nDigit < 16; nDigit++)
+			sHash[15 - nDigit] = pHexDigits[(nContentHash >> (4 * nDigit)) & 0xf];
+
+		return sLayerDataUUID + ":" + sHash;
+	}
+
+	uint64_t CMatJobLayerCache::getInitialHash()
+	{
+		return 0xcbf29ce484222325ULL;
+	}
+
+	uint64_t CMatJobLayerCache::hashData(uint64_t nHash, const void* pData, size_t nSize)
+	{
+		// FNV-1a over 64 bit words, followed by the remaining bytes
+		const uint64_t nPrime = 0x100000001b3ULL;
+		const uint8_t* pBytes = (const uint8_t*)pData;
+
+		size_t nWordCount = nSize / 8;
+		for (size_t nIndex = 0; nIndex < nWordCount; nIndex++) {
+			uint64_t nWord;
+			memcpy(&nWord, pBytes + nIndex * 8, 8);
+			nHash = (nHash ^ nWord) * nPrime;
+			nHash ^= (nHash >> 29);
+		}
+
+		for (size_t nIndex = nWordCount * 8; nIndex < nSize; nIndex++)
+			nHash = (nHash ^ pBytes[nIndex]) * nPrime;
+
+		return nHash;
+	}
+
+}
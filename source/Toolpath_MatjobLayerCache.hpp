@@ -0,0 +1,131 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#ifndef __TOOLPATH_MATJOBLAYERCACHE
+#define __TOOLPATH_MATJOBLAYERCACHE
+
+#include <string>
+#include <cstdint>
+#include <vector>
+#include <map>
+#include <memory>
+
+#include "Toolpath_MatjobLayer.hpp"
+
+namespace Toolpath {
+
+	#define MATJOBLAYERCACHE_INDEXNAME "LayerCacheIndex.json"
+	#define MATJOBLAYERCACHE_ENTRYEXTENSION ".layer"
+	#define MATJOBLAYERCACHE_SIGNATURE 0x434c4a4d
+	// Increase whenever the encoding of layers or the entry format changes
+	#define MATJOBLAYERCACHE_VERSION 2
+
+	// Bounding box of the geometry of one part in a layer
+	typedef struct _sMatJobCachedPartBounds {
+		uint32_t m_nPartID;
+		double m_dMinX;
+		double m_dMinY;
+		double m_dMaxX;
+		double m_dMaxY;
+	} sMatJobCachedPartBounds;
+
+	/**
+	 * An encoded layer group of a MatJob binary file together with the statistics of its data blocks.
+	 * Data positions are relative to the start of the layer group; file IDs are assigned when splicing.
+	 */
+	typedef struct _sMatJobCachedLayer {
+		double m_dTotalMarkDistance;
+		double m_dTotalJumpDistance;
+		double m_dMinX;
+		double m_dMinY;
+		double m_dMaxX;
+		double m_dMaxY;
+		std::vector<sMatJobDataBlock> m_DataBlocks;
+		std::vector<sMatJobScanDistance> m_ScanDistances;
+		std::vector<sMatJobCachedPartBounds> m_PartBounds;
+		std::vector<uint8_t> m_LayerData;
+	} sMatJobCachedLayer;
+
+	typedef struct _sMatJobLayerCacheEntry {
+		std::string m_sFileName;
+		uint64_t m_nSize;
+		uint64_t m_nLastUse;
+	} sMatJobLayerCacheEntry;
+
+	/**
+	 * On-disk cache of encoded MatJob layers, keyed by layer data UUID and a content hash of the
+	 * layer geometry and its part and parameter set IDs. Entries are evicted least recently used
+	 * first once the size limit is exceeded. The index is written by flush.
+	 */
+	class CMatJobLayerCache {
+	private:
+		std::string m_sDirectory;
+		uint64_t m_nSizeLimit;
+		uint64_t m_nTotalSize;
+		uint64_t m_nUseCounter;
+		bool m_bIndexIsModified;
+
+		std::map<std::string, sMatJobLayerCacheEntry> m_Entries;
+
+		uint64_t m_nHitCount;
+		uint64_t m_nMissCount;
+		uint64_t m_nEvictionCount;
+
+		std::string getPath(const std::string& sFileName);
+		void loadIndex();
+		void removeEntry(std::map<std::string, sMatJobLayerCacheEntry>::iterator iEntryIter);
+		void evict(uint64_t nRequiredSize);
+
+	public:
+		CMatJobLayerCache(const std::string& sDirectory, uint64_t nSizeLimitInBytes);
+		virtual ~CMatJobLayerCache();
+
+		// Returns false if the key is not cached or its entry cannot be read
+		bool lookup(const std::string& sKey, sMatJobCachedLayer& cachedLayer);
+		void store(const std::string& sKey, const sMatJobCachedLayer& cachedLayer);
+
+		void flush();
+
+		uint64_t getHitCount();
+		uint64_t getMissCount();
+		uint64_t getEvictionCount();
+		uint64_t getTotalSize();
+
+		static std::string makeKey(const std::string& sLayerDataUUID, uint64_t nContentHash);
+
+		// Order dependent 64 bit hash, chained over several buffers starting with getInitialHash
+		static uint64_t getInitialHash();
+		static uint64_t hashData(uint64_t nHash, const void* pData, size_t nSize);
+	};
+
+	typedef std::shared_ptr<CMatJobLayerCache> PMatJobLayerCache;
+
+} // namespace Toolpath
+
+#endif // __TOOLPATH_MATJOBLAYERCACHE
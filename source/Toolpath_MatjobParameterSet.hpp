@@ -31,6 +31,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 
 #include "Toolpath_MatjobProperty.hpp"
+#include "Toolpath_MatjobScanTimeModel.hpp"
 #include "Common/Platform/NMR_XmlWriter_Native.h"
 
 namespace Toolpath {
@@ -46,6 +47,7 @@ namespace Toolpath {
 		uint32_t m_nLaserSetID;
 		double m_dLaserDiameter;
 		double m_dLaserPower;
+		sMatJobScanTimeParameters m_ScanTimeParameters;
 
 		std::map<std::string, PMatJobProperty> m_Properties;
 
@@ -54,12 +56,18 @@ namespace Toolpath {
 		CMatJobParameterSet(std::string sUUID, uint32_t nID, uint32_t nScanFieldID, const std::string& sName, double dLaserSpeed, uint32_t nLaserSetID, double dLaserDiameter, double dLaserPower, double dJumpSpeed)
 			: m_sUUID(sUUID), m_nID(nID), m_nScanFieldID(nScanFieldID), m_sName(sName), m_dLaserSpeed(dLaserSpeed), m_nLaserSetID(nLaserSetID), m_dLaserDiameter(dLaserDiameter), m_dLaserPower(dLaserPower), m_dJumpSpeed(dJumpSpeed)
 		{
+			memset(&m_ScanTimeParameters, 0, sizeof(sMatJobScanTimeParameters));
 		}
 
 		virtual ~CMatJobParameterSet()
 		{
 		}
 
+		std::string getUUID()
+		{
+			return m_sUUID;
+		}
+
 		uint32_t getID()
 		{
 			return m_nID;
@@ -100,6 +108,16 @@ namespace Toolpath {
 			return m_dLaserPower;
 		}
 
+		const sMatJobScanTimeParameters& getScanTimeParameters()
+		{
+			return m_ScanTimeParameters;
+		}
+
+		void setScanTimeParameters(const sMatJobScanTimeParameters& scanTimeParameters)
+		{
+			m_ScanTimeParameters = scanTimeParameters;
+		}
+
 		void addProperty(const std::string& sName, const std::string& sValue, eMatJobPropertyType propertyType)
 		{
 			if (sName.empty())
@@ -113,6 +131,11 @@ namespace Toolpath {
 			m_Properties.insert(std::make_pair(sName, pProperty));
 		}
 
+		const std::map<std::string, PMatJobProperty>& getProperties()
+		{
+			return m_Properties;
+		}
+
 		void writePropertiesToXML(NMR::PXmlWriter_Native xmlWriter)
 		{
 			for (auto propertyIter : m_Properties)
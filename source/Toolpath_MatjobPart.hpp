@@ -78,6 +78,11 @@ namespace Toolpath
 			return m_nPartID;
 		}
 
+		std::string getBuildItemUUID()
+		{
+			return m_sBuildItemUUID;
+		}
+
 		bool hasPartBoundsXY()
 		{
 			return m_bHasPartBoundsXY;
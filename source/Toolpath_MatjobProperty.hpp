@@ -91,6 +91,18 @@ namespace Toolpath {
 			}
 		}
 
+		static eMatJobPropertyType parseTypeString(const std::string& sTypeString)
+		{
+			if (sTypeString == "Json") return eMatJobPropertyType::mjpJson;
+			if (sTypeString == "String") return eMatJobPropertyType::mjpString;
+			if (sTypeString == "Integer") return eMatJobPropertyType::mjpInteger;
+			if (sTypeString == "Float") return eMatJobPropertyType::mjpFloat;
+			if (sTypeString == "Double") return eMatJobPropertyType::mjpDouble;
+			if (sTypeString == "Boolean") return eMatJobPropertyType::mjpBool;
+
+			throw std::runtime_error("Unknown MatJob Property Type: " + sTypeString);
+		}
+
 		void writeToXML(NMR::PXmlWriter_Native xmlWriter)
 		{
 			if (m_sName.empty())
@@ -0,0 +1,162 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#ifndef __TOOLPATH_MATJOBSCANTIMEMODEL
+#define __TOOLPATH_MATJOBSCANTIMEMODEL
+
+#include <string>
+#include <memory>
+#include <cmath>
+
+namespace Toolpath {
+
+	// Delays in seconds and acceleration in mm/s^2 of a parameter set, all zero for a distance over speed estimate
+	typedef struct _sMatJobScanTimeParameters {
+		double m_dJumpDelay;
+		double m_dMarkDelay;
+		double m_dPolygonDelay;
+		double m_dAcceleration;
+		double m_dSkywritingTime;
+		bool m_bSkywriting;
+	} sMatJobScanTimeParameters;
+
+	enum class eMatJobMoveType : int {
+		Jump = 0,
+		JumpAfterMark = 1,		// Jump that switches the laser off after a mark
+		Mark = 2,				// Mark that starts after a jump
+		PolygonMark = 3			// Mark that continues a mark at a polygon corner
+	};
+
+	/**
+	 * Estimates the time of a scanner move for CMatJobLayer.
+	 */
+	class IMatJobScanTimeModel {
+	public:
+		virtual ~IMatJobScanTimeModel() = default;
+
+		virtual std::string getName() = 0;
+
+		// Time of a move in seconds, including the delays before it
+		virtual double getMoveTime(const sMatJobScanTimeParameters& parameters, eMatJobMoveType moveType, double dDistance, double dSpeed) = 0;
+
+		// True if every move takes its distance over its speed with these parameters,
+		// so that a data block can be timed from its mark and jump distance alone
+		virtual bool isDistanceOverSpeed(const sMatJobScanTimeParameters& parameters) = 0;
+	};
+
+	typedef std::shared_ptr<IMatJobScanTimeModel> PMatJobScanTimeModel;
+
+	/**
+	 * Distance over speed of every move, ignoring delays and acceleration.
+	 */
+	class CMatJobScanTimeModel_Distance : public IMatJobScanTimeModel {
+	public:
+		std::string getName() override
+		{
+			return "distance";
+		}
+
+		double getMoveTime(const sMatJobScanTimeParameters& /*parameters*/, eMatJobMoveType /*moveType*/, double dDistance, double dSpeed) override
+		{
+			if (dSpeed > 0.0)
+				return dDistance / dSpeed;
+			return 0.0;
+		}
+
+		bool isDistanceOverSpeed(const sMatJobScanTimeParameters& /*parameters*/) override
+		{
+			return true;
+		}
+	};
+
+	/**
+	 * Galvo scanner with a trapezoidal velocity profile and the delays of the scan controller:
+	 *   - every jump waits for the jump delay, a jump after a mark also for the mark delay
+	 *   - a mark that continues a mark at a corner waits for the polygon delay
+	 *   - moves accelerate from and decelerate to standstill
+	 * With skywriting, marks are scanned at constant speed with run-in and run-out moves that take
+	 * the skywriting time per mark, and the mark and polygon delays are not needed.
+	 */
+	class CMatJobScanTimeModel_Scanner : public IMatJobScanTimeModel {
+	private:
+
+		static double getAcceleratedTime(double dDistance, double dSpeed, double dAcceleration)
+		{
+			if (dSpeed <= 0.0)
+				return 0.0;
+			if (dAcceleration <= 0.0)
+				return dDistance / dSpeed;
+
+			// Short moves do not reach the speed and end in a triangular velocity profile
+			double dRampDistance = dSpeed * dSpeed / dAcceleration;
+			if (dDistance >= dRampDistance)
+				return dDistance / dSpeed + dSpeed / dAcceleration;
+			return 2.0 * sqrt(dDistance / dAcceleration);
+		}
+
+	public:
+		std::string getName() override
+		{
+			return "scanner";
+		}
+
+		double getMoveTime(const sMatJobScanTimeParameters& parameters, eMatJobMoveType moveType, double dDistance, double dSpeed) override
+		{
+			switch (moveType) {
+			case eMatJobMoveType::Jump:
+				return getAcceleratedTime(dDistance, dSpeed, parameters.m_dAcceleration) + parameters.m_dJumpDelay;
+
+			case eMatJobMoveType::JumpAfterMark:
+				if (parameters.m_bSkywriting)
+					return getAcceleratedTime(dDistance, dSpeed, parameters.m_dAcceleration) + parameters.m_dJumpDelay;
+				return getAcceleratedTime(dDistance, dSpeed, parameters.m_dAcceleration) + parameters.m_dJumpDelay + parameters.m_dMarkDelay;
+
+			case eMatJobMoveType::Mark:
+			case eMatJobMoveType::PolygonMark:
+				if (parameters.m_bSkywriting)
+					return ((dSpeed > 0.0) ? dDistance / dSpeed : 0.0) + parameters.m_dSkywritingTime;
+				if (moveType == eMatJobMoveType::PolygonMark)
+					return getAcceleratedTime(dDistance, dSpeed, parameters.m_dAcceleration) + parameters.m_dPolygonDelay;
+				return getAcceleratedTime(dDistance, dSpeed, parameters.m_dAcceleration);
+
+			default:
+				return 0.0;
+			}
+		}
+
+		bool isDistanceOverSpeed(const sMatJobScanTimeParameters& parameters) override
+		{
+			return (parameters.m_dJumpDelay == 0.0) && (parameters.m_dMarkDelay == 0.0) && (parameters.m_dPolygonDelay == 0.0) &&
+				(parameters.m_dAcceleration <= 0.0) && (!parameters.m_bSkywriting || (parameters.m_dSkywritingTime == 0.0));
+		}
+	};
+
+}
+
+#endif // __TOOLPATH_MATJOBSCANTIMEMODEL
@@ -32,7 +32,18 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <exception>
 #include <sstream>
 #include <iomanip>
+#include <fstream>
+#include <cerrno>
 #include "Toolpath_MatjobWriter.hpp"
+#include "Toolpath_JSONWriter.hpp"
+#include "Toolpath_JSONReader.hpp"
+#include "Common/NMR_StringUtils.h"
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
 
 namespace Toolpath {
 
@@ -43,11 +54,58 @@ namespace Toolpath {
 		return oss.str();
 	}
 
-	CMatJobWriter::CMatJobWriter(NMR::PExportStream pExportStream)
+	static NMR::PPortableZIPDeflatedData deflateMemoryStream(NMR::PExportStream_Memory pMemoryStream, CToolpathStatistics* pStatistics)
+	{
+		CToolpathTraceSpan traceSpan("compressEntry");
+		CToolpathScopedTimer deflateTimer(pStatistics, eToolpathStatisticsPhase::Deflate);
+
+		uint64_t nUncompressedSize = pMemoryStream->getDataSize();
+
+		auto pDeflatedData = std::make_shared<NMR::CPortableZIPDeflatedData>();
+		pDeflatedData->deflateBuffer(pMemoryStream->getData(), pMemoryStream->getDataSize());
+		pMemoryStream->releaseData();
+
+		CToolpathMemoryTracker::addBytes(eToolpathMemorySubsystem::PendingCompression, (int64_t)pDeflatedData->getCompressedSize() - (int64_t)nUncompressedSize);
+		return pDeflatedData;
+	}
+
+	CMatJobWriter::CMatJobWriter(NMR::PExportStream pExportStream, PToolpathThreadPool pThreadPool)
+		: m_bIsFinalized(false), m_nMergedSliceCount(0)
 	{
 		if (pExportStream.get() == nullptr)
 			throw std::runtime_error("Invalid export stream parameter");
 
+		initializeJob(pThreadPool);
+
+		m_pZIPWriter = std::make_shared<NMR::CPortableZIPWriter>(pExportStream, true);
+	}
+
+	CMatJobWriter::CMatJobWriter(const std::string& sSliceDirectory, PToolpathThreadPool pThreadPool)
+		: m_bIsFinalized(false), m_sSliceDirectory(sSliceDirectory), m_nMergedSliceCount(0)
+	{
+		if (sSliceDirectory.empty())
+			throw std::runtime_error("Invalid slice directory parameter");
+
+		initializeJob(pThreadPool);
+
+#ifdef _WIN32
+		std::wstring sSliceDirectoryW = NMR::fnUTF8toUTF16(sSliceDirectory);
+		if ((_wmkdir(sSliceDirectoryW.c_str()) != 0) && (errno != EEXIST))
+#else
+		if ((mkdir(sSliceDirectory.c_str(), 0755) != 0) && (errno != EEXIST))
+#endif
+			throw std::runtime_error("Could not create slice directory: " + sSliceDirectory);
+	}
+
+	void CMatJobWriter::initializeJob(PToolpathThreadPool pThreadPool)
+	{
+		m_pThreadPool = pThreadPool;
+		if (m_pThreadPool.get() == nullptr)
+			m_pThreadPool = std::make_shared<CToolpathThreadPool>(1);
+
+		// Bounds the memory held by compressed entries that wait for their predecessors
+		m_nMaxPendingEntries = 2 * m_pThreadPool->getThreadCount();
+
 		// Meta information
 		m_sMetaDataFileName = "JobMetaData.job";
 		m_sConverterVersion = "0.1";
@@ -62,8 +120,17 @@ namespace Toolpath {
 
 		addVectorType("Hatching", VECTORTYPEID_HATCH, true, false);
 		addVectorType("Border", VECTORTYPEID_BORDER, false, true);
+	}
 
-		m_pZIPWriter = std::make_shared<NMR::CPortableZIPWriter>(pExportStream, true);
+	void CMatJobWriter::checkNotFinalized()
+	{
+		if (m_bIsFinalized)
+			throw std::runtime_error("MatJob writer has already been finalized");
+	}
+
+	bool CMatJobWriter::isSlice()
+	{
+		return !m_sSliceDirectory.empty();
 	}
 
 	CMatJobWriter::~CMatJobWriter()
@@ -71,15 +138,30 @@ namespace Toolpath {
 		m_pZIPWriter = nullptr;
 	}
 
+	void CMatJobWriter::setStatistics(PToolpathStatistics pStatistics)
+	{
+		m_pStatistics = pStatistics;
+	}
+
+	void CMatJobWriter::setScanTimeModel(PMatJobScanTimeModel pScanTimeModel)
+	{
+		m_pScanTimeModel = pScanTimeModel;
+	}
+
 
 	void CMatJobWriter::writeContent()
 	{
-		if (m_pZIPWriter == nullptr)
-			throw std::runtime_error("ZIP writer has already been finalized");
+		CToolpathTraceSpan traceSpan("writeContent");
 
-		auto pEntry = m_pZIPWriter->createEntry("Content.xml", 0);
+		checkNotFinalized();
+		if (isSlice())
+			throw std::runtime_error("job slices are finalized with finalizeSlice");
 
-		auto contentWriter = std::make_shared<NMR::CXmlWriter_Native>(pEntry);
+		CToolpathScopedTimer xmlTimer(m_pStatistics.get(), eToolpathStatisticsPhase::XMLMetaData);
+
+		auto pContentStream = std::make_shared<NMR::CExportStream_Memory>();
+
+		auto contentWriter = std::make_shared<NMR::CXmlWriter_Native>(pContentStream);
 		contentWriter->WriteStartDocument();
 		contentWriter->WriteStartElement(nullptr, "ContainerContent", nullptr);
 		contentWriter->WriteAttributeString(nullptr, "xmlns", nullptr, "http://schemas.materialise.com/AM/MatJob/Content");
@@ -106,9 +188,9 @@ namespace Toolpath {
 		contentWriter->WriteAttributeString(nullptr, "EncryptionStrategyRef", nullptr, "none");
 		contentWriter->WriteEndElement();
 
-		for (auto binaryFile : m_BinaryFiles) {
+		for (auto& binaryFile : m_BinaryFiles) {
 			contentWriter->WriteStartElement(nullptr, "BinaryFile", nullptr);
-			contentWriter->WriteAttributeString(nullptr, "FileName", nullptr, binaryFile->getFileName().c_str());
+			contentWriter->WriteAttributeString(nullptr, "FileName", nullptr, binaryFile.m_sFileName.c_str());
 			contentWriter->WriteAttributeString(nullptr, "EncryptionStrategyRef", nullptr, "none");
 			contentWriter->WriteAttributeString(nullptr, "IsOutsideContainer", nullptr, "false");
 
@@ -119,13 +201,74 @@ namespace Toolpath {
 		contentWriter->WriteFullEndElement();
 		contentWriter->WriteEndDocument();
 
+		xmlTimer.stop();
+
+		CToolpathMemoryTracker::addBytes(eToolpathMemorySubsystem::PendingCompression, (int64_t)pContentStream->getDataSize());
+
+		PToolpathStatistics pStatistics = m_pStatistics;
+		queueDeflatedEntry("Content.xml", m_pThreadPool->submit([pContentStream, pStatistics]() {
+			return deflateMemoryStream(pContentStream, pStatistics.get());
+		}));
+
 	}
 
 	void CMatJobWriter::finalize()
 	{
+		CToolpathTraceSpan traceSpan("finalizeMatJob");
+
+		checkNotFinalized();
+		if (isSlice())
+			throw std::runtime_error("job slices are finalized with finalizeSlice");
+
+		writePendingEntries(true);
+
+		CToolpathTraceSpan directorySpan("writeCentralDirectory");
+		CToolpathScopedTimer diskTimer(m_pStatistics.get(), eToolpathStatisticsPhase::DiskIO);
+
 		// Finalize the ZIP file by releasing the ZIP writer
 		// This triggers the destructor which writes the central directory
 		m_pZIPWriter = nullptr;
+		m_bIsFinalized = true;
+	}
+
+	void CMatJobWriter::queueDeflatedEntry(const std::string& sName, std::future<NMR::PPortableZIPDeflatedData> deflatedDataFuture)
+	{
+		m_PendingEntries.push_back(std::make_pair(sName, std::move(deflatedDataFuture)));
+		writePendingEntries(false);
+	}
+
+	void CMatJobWriter::writePendingEntries(bool bWaitForAll)
+	{
+		checkNotFinalized();
+
+		while (!m_PendingEntries.empty()) {
+			auto& pendingEntry = m_PendingEntries.front();
+
+			bool bMustWait = bWaitForAll || (m_PendingEntries.size() > m_nMaxPendingEntries);
+			if (!bMustWait && (pendingEntry.second.wait_for(std::chrono::seconds(0)) != std::future_status::ready))
+				break;
+
+			// Rethrows any exception of the compression task
+			NMR::PPortableZIPDeflatedData pDeflatedData;
+			{
+				CToolpathTraceSpan waitSpan("waitForEntry");
+				pDeflatedData = pendingEntry.second.get();
+			}
+			std::string sName = pendingEntry.first;
+			m_PendingEntries.pop_front();
+
+			CToolpathTraceSpan writeSpan("writeEntry");
+			CToolpathScopedTimer diskTimer(m_pStatistics.get(), eToolpathStatisticsPhase::DiskIO);
+			if (isSlice())
+				writeSliceEntry(sName, pDeflatedData.get());
+			else
+				m_pZIPWriter->writeDeflatedEntry(sName, pDeflatedData.get());
+
+			if (m_pStatistics.get() != nullptr)
+				m_pStatistics->addZIPEntry(sName, pDeflatedData->getUncompressedSize(), pDeflatedData->getCompressedSize());
+
+			CToolpathMemoryTracker::addBytes(eToolpathMemorySubsystem::PendingCompression, -(int64_t)pDeflatedData->getCompressedSize());
+		}
 	}
 
 	PMatJobBinaryFile CMatJobWriter::beginBinaryFile(const std::string& sFileName)
@@ -139,8 +282,6 @@ namespace Toolpath {
 
 		m_pOpenBinaryFile = std::make_shared<CMatJobBinaryFile>(nFileID, sFileName);
 
-		m_BinaryFiles.push_back(m_pOpenBinaryFile);
-
 		return m_pOpenBinaryFile;
 
 	}
@@ -148,11 +289,26 @@ namespace Toolpath {
 	void CMatJobWriter::closeCurrentBinaryFile()
 	{
 		if (m_pOpenBinaryFile != nullptr) {
-			if (m_pZIPWriter == nullptr)
-				throw std::runtime_error("ZIP writer has already been finalized");
+			checkNotFinalized();
 
-			auto pEntry = m_pZIPWriter->createEntry(m_pOpenBinaryFile->getFileName(), 0);
-			m_pOpenBinaryFile->storeToStream(pEntry);
+			PMatJobBinaryFile pBinaryFile = m_pOpenBinaryFile;
+
+			sMatJobBinaryFileInfo fileInfo;
+			fileInfo.m_nFileID = pBinaryFile->getFileID();
+			fileInfo.m_sFileName = pBinaryFile->getFileName();
+			fileInfo.m_nFileSize = pBinaryFile->getCurrentFileSize();
+			m_BinaryFiles.push_back(fileInfo);
+
+			PToolpathStatistics pStatistics = m_pStatistics;
+			queueDeflatedEntry(pBinaryFile->getFileName(), m_pThreadPool->submit([pBinaryFile, pStatistics]() {
+				CToolpathTraceSpan traceSpan("compressEntry", "fileID", pBinaryFile->getFileID());
+				CToolpathScopedTimer deflateTimer(pStatistics.get(), eToolpathStatisticsPhase::Deflate);
+				auto pDeflatedData = pBinaryFile->deflateBuffer();
+				pBinaryFile->releaseBuffer();
+
+				CToolpathMemoryTracker::addBytes(eToolpathMemorySubsystem::PendingCompression, (int64_t)pDeflatedData->getCompressedSize());
+				return pDeflatedData;
+			}));
 
 		}
 
@@ -162,14 +318,19 @@ namespace Toolpath {
 
 	void CMatJobWriter::writeJobMetaData()
 	{
+		CToolpathTraceSpan traceSpan("writeJobMetaData");
+
 		closeCurrentBinaryFile();
 
-		if (m_pZIPWriter == nullptr)
-			throw std::runtime_error("ZIP writer has already been finalized");
+		checkNotFinalized();
+		if (isSlice())
+			throw std::runtime_error("job slices are finalized with finalizeSlice");
 
-		auto pEntry = m_pZIPWriter->createEntry(m_sMetaDataFileName, 0);
+		CToolpathScopedTimer xmlTimer(m_pStatistics.get(), eToolpathStatisticsPhase::XMLMetaData);
 
-		auto metaDataWriter = std::make_shared<NMR::CXmlWriter_Native>(pEntry);
+		auto pMetaDataStream = std::make_shared<NMR::CExportStream_Memory>();
+
+		auto metaDataWriter = std::make_shared<NMR::CXmlWriter_Native>(pMetaDataStream);
 		metaDataWriter->WriteStartDocument();
 		metaDataWriter->WriteStartElement(nullptr, "BuildJob", "");
 		metaDataWriter->WriteAttributeString(nullptr, "xmlns", nullptr, "http://schemas.materialise.com/AM/MatJob/MetaData");
@@ -461,10 +622,10 @@ namespace Toolpath {
 
 		metaDataWriter->WriteStartElement(nullptr, "BinaryFiles", "");
 
-		for (auto binaryFileIter : m_BinaryFiles) {
-			std::string sIDString = std::to_string(binaryFileIter->getFileID());
-			std::string sFileSizeString = std::to_string(binaryFileIter->getCurrentFileSize());
-			std::string sFileName = binaryFileIter->getFileName();
+		for (auto& binaryFileInfo : m_BinaryFiles) {
+			std::string sIDString = std::to_string(binaryFileInfo.m_nFileID);
+			std::string sFileSizeString = std::to_string(binaryFileInfo.m_nFileSize);
+			std::string sFileName = binaryFileInfo.m_sFileName;
 
 			if (sFileName.empty())
 				throw std::runtime_error("Binary File name is empty!");
@@ -501,6 +662,15 @@ namespace Toolpath {
 		metaDataWriter->WriteEndElement();
 		metaDataWriter->WriteEndDocument();
 
+		xmlTimer.stop();
+
+		CToolpathMemoryTracker::addBytes(eToolpathMemorySubsystem::PendingCompression, (int64_t)pMetaDataStream->getDataSize());
+
+		PToolpathStatistics pStatistics = m_pStatistics;
+		queueDeflatedEntry(m_sMetaDataFileName, m_pThreadPool->submit([pMetaDataStream, pStatistics]() {
+			return deflateMemoryStream(pMetaDataStream, pStatistics.get());
+		}));
+
 	}
 
 	void CMatJobWriter::addProperty(const std::string& sName, const std::string& sValue, eMatJobPropertyType propertyType)
@@ -615,7 +785,7 @@ namespace Toolpath {
 				throw std::runtime_error("New layer Z value must be greater than previous layer Z value");
 		}
 
-		m_pOpenLayer = std::make_shared<CMatJobLayer>(dZValue);
+		m_pOpenLayer = std::make_shared<CMatJobLayer>(dZValue, m_pScanTimeModel);
 		m_Layers.push_back(m_pOpenLayer);
 
 		return m_pOpenLayer;
@@ -680,4 +850,408 @@ namespace Toolpath {
 	}
 
 
-}
\ No newline at end of file
+	template <typename T> static void writeSliceValue(std::ofstream& stream, const T& value)
+	{
+		stream.write((const char*)&value, sizeof(T));
+	}
+
+	template <typename T> static T readSliceValue(std::ifstream& stream)
+	{
+		T value;
+		stream.read((char*)&value, sizeof(T));
+		if (stream.gcount() != sizeof(T))
+			throw std::runtime_error("slice data blocks are truncated");
+		return value;
+	}
+
+	std::string CMatJobWriter::getSlicePath(const std::string& sSliceDirectory, const std::string& sName)
+	{
+		return sSliceDirectory + "/" + sName;
+	}
+
+	void CMatJobWriter::writeSliceEntry(const std::string& sName, NMR::CPortableZIPDeflatedData* pDeflatedData)
+	{
+		if (pDeflatedData == nullptr)
+			throw std::runtime_error("Invalid slice entry: " + sName);
+
+		std::string sEntryPath = getSlicePath(m_sSliceDirectory, sName + MATJOB_SLICEENTRYEXTENSION);
+		std::ofstream stream(sEntryPath, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!stream.is_open())
+			throw std::runtime_error("Failed to create slice entry: " + sEntryPath);
+
+		stream.write((const char*)pDeflatedData->getCompressedData(), (std::streamsize)pDeflatedData->getCompressedSize());
+		if (!stream.good())
+			throw std::runtime_error("Failed to write slice entry: " + sEntryPath);
+
+		sMatJobSliceEntry sliceEntry;
+		sliceEntry.m_sName = sName;
+		sliceEntry.m_nCompressedSize = pDeflatedData->getCompressedSize();
+		sliceEntry.m_nUncompressedSize = pDeflatedData->getUncompressedSize();
+		sliceEntry.m_nCRC32 = pDeflatedData->getCRC32();
+		m_SliceEntries.push_back(sliceEntry);
+	}
+
+	void CMatJobWriter::writeSliceDataBlocks()
+	{
+		// Fixed size records in native byte order, like the MatJob binary files
+		std::string sFileName = getSlicePath(m_sSliceDirectory, MATJOB_SLICEDATABLOCKSNAME);
+		std::ofstream stream(sFileName, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!stream.is_open())
+			throw std::runtime_error("Failed to create slice data blocks: " + sFileName);
+
+		for (auto& pLayer : m_Layers) {
+			uint32_t nDataBlockCount = pLayer->getDataBlockCount();
+			for (uint32_t nIndex = 0; nIndex < nDataBlockCount; nIndex++) {
+				auto& dataBlock = pLayer->getDataBlock(nIndex);
+				writeSliceValue(stream, dataBlock.m_nPartID);
+				writeSliceValue(stream, dataBlock.m_nParameterSetID);
+				writeSliceValue(stream, dataBlock.m_nVectorTypeID);
+				writeSliceValue(stream, dataBlock.m_dMarkDistance);
+				writeSliceValue(stream, dataBlock.m_dJumpDistance);
+				writeSliceValue(stream, dataBlock.m_nNumMarkSegments);
+				writeSliceValue(stream, dataBlock.m_nNumJumpSegments);
+				writeSliceValue(stream, dataBlock.m_nFileID);
+				writeSliceValue(stream, dataBlock.m_nDataPosition);
+			}
+		}
+
+		if (!stream.good())
+			throw std::runtime_error("Failed to write slice data blocks: " + sFileName);
+	}
+
+	void CMatJobWriter::writeSliceManifest(const sMatJobSliceRange& sliceRange)
+	{
+		std::string sFileName = getSlicePath(m_sSliceDirectory, MATJOB_SLICEMANIFESTNAME);
+		std::ofstream stream(sFileName, std::ios::out | std::ios::trunc);
+		if (!stream.is_open())
+			throw std::runtime_error("Failed to create slice manifest: " + sFileName);
+
+		// Values are read back by mergeSlice and must round trip
+		CToolpathJSONWriter jsonWriter(stream);
+		jsonWriter.setDoublePrecision(17);
+
+		jsonWriter.beginObject();
+		jsonWriter.writeString("format", MATJOB_SLICEMANIFESTFORMAT);
+		jsonWriter.writeUint64("version", MATJOB_SLICEMANIFESTVERSION);
+		jsonWriter.writeUint64("layerCount", sliceRange.m_nLayerCount);
+		jsonWriter.writeUint64("firstLayer", sliceRange.m_nFirstLayerIndex);
+		jsonWriter.writeUint64("endLayer", sliceRange.m_nEndLayerIndex);
+
+		jsonWriter.beginArray("properties");
+		for (auto propertyIter : m_Properties) {
+			jsonWriter.beginObject();
+			jsonWriter.writeString("name", propertyIter.second->getName());
+			jsonWriter.writeString("type", propertyIter.second->getTypeString());
+			jsonWriter.writeString("value", propertyIter.second->getValue());
+			jsonWriter.endObject();
+		}
+		jsonWriter.endArray();
+
+		jsonWriter.beginArray("scanFields");
+		for (auto scanFieldIter : m_ScanFields) {
+			jsonWriter.beginObject();
+			jsonWriter.writeString("reference", scanFieldIter.second->getReference());
+			jsonWriter.writeUint64("laserID", scanFieldIter.second->getLaserID());
+			jsonWriter.writeUint64("scanFieldID", scanFieldIter.second->getScanFieldID());
+			jsonWriter.writeDouble("xMin", scanFieldIter.second->getXMin());
+			jsonWriter.writeDouble("yMin", scanFieldIter.second->getYMin());
+			jsonWriter.writeDouble("xMax", scanFieldIter.second->getXMax());
+			jsonWriter.writeDouble("yMax", scanFieldIter.second->getYMax());
+			jsonWriter.endObject();
+		}
+		jsonWriter.endArray();
+
+		jsonWriter.beginArray("parts");
+		for (auto partIter : m_Parts) {
+			auto pPart = partIter.second;
+			jsonWriter.beginObject();
+			jsonWriter.writeUint64("id", pPart->getPartID());
+			jsonWriter.writeString("name", pPart->getName());
+			jsonWriter.writeString("buildItemUUID", pPart->getBuildItemUUID());
+			jsonWriter.writeBool("hasBoundsXY", pPart->hasPartBoundsXY());
+			jsonWriter.writeBool("hasBoundsZ", pPart->hasPartBoundsZ());
+			jsonWriter.writeDouble("minX", pPart->getMinX());
+			jsonWriter.writeDouble("minY", pPart->getMinY());
+			jsonWriter.writeDouble("minZ", pPart->getMinZ());
+			jsonWriter.writeDouble("maxX", pPart->getMaxX());
+			jsonWriter.writeDouble("maxY", pPart->getMaxY());
+			jsonWriter.writeDouble("maxZ", pPart->getMaxZ());
+			jsonWriter.endObject();
+		}
+		jsonWriter.endArray();
+
+		jsonWriter.beginArray("parameterSets");
+		for (auto parameterSetIter : m_ParameterSets) {
+			auto pParameterSet = parameterSetIter.second;
+			jsonWriter.beginObject();
+			jsonWriter.writeUint64("id", pParameterSet->getID());
+			jsonWriter.writeString("uuid", pParameterSet->getUUID());
+			jsonWriter.writeString("name", pParameterSet->getName());
+			jsonWriter.writeUint64("scanFieldID", pParameterSet->getScanFieldID());
+			jsonWriter.writeDouble("laserSpeed", pParameterSet->getLaserSpeed());
+			jsonWriter.writeDouble("jumpSpeed", pParameterSet->getJumpSpeed());
+			jsonWriter.writeUint64("laserSetID", pParameterSet->getLaserSetID());
+			jsonWriter.writeDouble("laserDiameter", pParameterSet->getLaserDiameter());
+			jsonWriter.writeDouble("laserPower", pParameterSet->getLaserPower());
+
+			jsonWriter.beginArray("properties");
+			for (auto propertyIter : pParameterSet->getProperties()) {
+				jsonWriter.beginObject();
+				jsonWriter.writeString("name", propertyIter.second->getName());
+				jsonWriter.writeString("type", propertyIter.second->getTypeString());
+				jsonWriter.writeString("value", propertyIter.second->getValue());
+				jsonWriter.endObject();
+			}
+			jsonWriter.endArray();
+
+			jsonWriter.endObject();
+		}
+		jsonWriter.endArray();
+
+		std::map<std::string, sMatJobSliceEntry> sliceEntries;
+		for (auto& sliceEntry : m_SliceEntries)
+			sliceEntries.insert(std::make_pair(sliceEntry.m_sName, sliceEntry));
+
+		jsonWriter.beginArray("binaryFiles");
+		for (auto& binaryFileInfo : m_BinaryFiles) {
+			auto iEntryIter = sliceEntries.find(binaryFileInfo.m_sFileName);
+			if (iEntryIter == sliceEntries.end())
+				throw std::runtime_error("binary file has not been written to the slice: " + binaryFileInfo.m_sFileName);
+
+			jsonWriter.beginObject();
+			jsonWriter.writeUint64("id", binaryFileInfo.m_nFileID);
+			jsonWriter.writeString("name", binaryFileInfo.m_sFileName);
+			jsonWriter.writeUint64("fileSize", binaryFileInfo.m_nFileSize);
+			jsonWriter.writeUint64("compressedSize", iEntryIter->second.m_nCompressedSize);
+			jsonWriter.writeUint64("uncompressedSize", iEntryIter->second.m_nUncompressedSize);
+			jsonWriter.writeUint64("crc32", iEntryIter->second.m_nCRC32);
+			jsonWriter.endObject();
+		}
+		jsonWriter.endArray();
+
+		// Data blocks of the layers are stored in MATJOB_SLICEDATABLOCKSNAME in the same order
+		jsonWriter.beginArray("layers");
+		for (auto& pLayer : m_Layers) {
+			jsonWriter.beginObject();
+			jsonWriter.writeDouble("z", pLayer->getZValue());
+			jsonWriter.writeDouble("scanTime", pLayer->getLayerScanTime());
+			jsonWriter.writeDouble("markDistance", pLayer->getTotalMarkDistance());
+			jsonWriter.writeDouble("jumpDistance", pLayer->getTotalJumpDistance());
+			jsonWriter.writeDouble("minX", pLayer->getMinX());
+			jsonWriter.writeDouble("minY", pLayer->getMinY());
+			jsonWriter.writeDouble("maxX", pLayer->getMaxX());
+			jsonWriter.writeDouble("maxY", pLayer->getMaxY());
+			jsonWriter.writeUint64("dataBlocks", pLayer->getDataBlockCount());
+			jsonWriter.endObject();
+		}
+		jsonWriter.endArray();
+
+		jsonWriter.endObject();
+
+		if (!stream.good())
+			throw std::runtime_error("Failed to write slice manifest: " + sFileName);
+	}
+
+	void CMatJobWriter::finalizeSlice(const sMatJobSliceRange& sliceRange)
+	{
+		CToolpathTraceSpan traceSpan("finalizeSlice");
+
+		checkNotFinalized();
+		if (!isSlice())
+			throw std::runtime_error("MatJob writer is not writing a job slice");
+
+		closeCurrentBinaryFile();
+		writePendingEntries(true);
+
+		CToolpathScopedTimer diskTimer(m_pStatistics.get(), eToolpathStatisticsPhase::DiskIO);
+		writeSliceDataBlocks();
+		writeSliceManifest(sliceRange);
+
+		m_bIsFinalized = true;
+	}
+
+	sMatJobSliceRange CMatJobWriter::mergeSlice(const std::string& sSliceDirectory)
+	{
+		CToolpathTraceSpan traceSpan("mergeSlice");
+
+		checkNotFinalized();
+		if (isSlice())
+			throw std::runtime_error("job slices cannot be merged into a job slice");
+
+		closeCurrentBinaryFile();
+
+		auto pManifest = CToolpathJSONReader::parseFile(getSlicePath(sSliceDirectory, MATJOB_SLICEMANIFESTNAME));
+		auto& manifest = *pManifest;
+
+		if ((manifest.getString("format") != MATJOB_SLICEMANIFESTFORMAT) || (manifest.getUint64("version") != MATJOB_SLICEMANIFESTVERSION))
+			throw std::runtime_error("unsupported slice manifest in " + sSliceDirectory);
+
+		sMatJobSliceRange sliceRange;
+		sliceRange.m_nLayerCount = manifest.getUint32("layerCount");
+		sliceRange.m_nFirstLayerIndex = manifest.getUint32("firstLayer");
+		sliceRange.m_nEndLayerIndex = manifest.getUint32("endLayer");
+		if ((sliceRange.m_nFirstLayerIndex >= sliceRange.m_nEndLayerIndex) || (sliceRange.m_nEndLayerIndex > sliceRange.m_nLayerCount))
+			throw std::runtime_error("invalid layer range in slice " + sSliceDirectory);
+
+		// Job properties, scan fields and parameter sets are the same in every slice and are taken from the first
+		bool bIsFirstSlice = (m_nMergedSliceCount == 0);
+
+		if (bIsFirstSlice) {
+			auto& properties = manifest.getMember("properties");
+			for (uint32_t nIndex = 0; nIndex < properties.getElementCount(); nIndex++) {
+				auto& property = properties.getElement(nIndex);
+				std::string sName = property.getString("name");
+				if (m_Properties.find(sName) == m_Properties.end())
+					addProperty(sName, property.getString("value"), CMatJobProperty::parseTypeString(property.getString("type")));
+			}
+
+			auto& scanFields = manifest.getMember("scanFields");
+			for (uint32_t nIndex = 0; nIndex < scanFields.getElementCount(); nIndex++) {
+				auto& scanField = scanFields.getElement(nIndex);
+				addScanField(scanField.getString("reference"), scanField.getUint32("laserID"), scanField.getUint32("scanFieldID"),
+					scanField.getDouble("xMin"), scanField.getDouble("yMin"), scanField.getDouble("xMax"), scanField.getDouble("yMax"));
+			}
+		}
+
+		auto& parameterSets = manifest.getMember("parameterSets");
+		if (!bIsFirstSlice && (parameterSets.getElementCount() != m_ParameterSets.size()))
+			throw std::runtime_error("slice " + sSliceDirectory + " has different parameter sets");
+
+		for (uint32_t nIndex = 0; nIndex < parameterSets.getElementCount(); nIndex++) {
+			auto& parameterSet = parameterSets.getElement(nIndex);
+			std::string sUUID = parameterSet.getString("uuid");
+
+			if (bIsFirstSlice) {
+				auto pParameterSet = addParameterSet(sUUID, parameterSet.getString("name"), parameterSet.getUint32("scanFieldID"), parameterSet.getDouble("laserSpeed"),
+					parameterSet.getUint32("laserSetID"), parameterSet.getDouble("laserDiameter"), parameterSet.getDouble("laserPower"), parameterSet.getDouble("jumpSpeed"));
+
+				auto& properties = parameterSet.getMember("properties");
+				for (uint32_t nPropertyIndex = 0; nPropertyIndex < properties.getElementCount(); nPropertyIndex++) {
+					auto& property = properties.getElement(nPropertyIndex);
+					pParameterSet->addProperty(property.getString("name"), property.getString("value"), CMatJobProperty::parseTypeString(property.getString("type")));
+				}
+			}
+
+			if (findParameterSetByUUID(sUUID)->getID() != parameterSet.getUint32("id"))
+				throw std::runtime_error("slice " + sSliceDirectory + " has a different parameter set ID for " + sUUID);
+		}
+
+		// Part bounds are combined over all slices
+		auto& parts = manifest.getMember("parts");
+		if (!bIsFirstSlice && (parts.getElementCount() != m_Parts.size()))
+			throw std::runtime_error("slice " + sSliceDirectory + " has different parts");
+
+		for (uint32_t nIndex = 0; nIndex < parts.getElementCount(); nIndex++) {
+			auto& part = parts.getElement(nIndex);
+			std::string sUUID = part.getString("buildItemUUID");
+
+			if (bIsFirstSlice)
+				addPart(part.getString("name"), sUUID);
+
+			auto pPart = findPartByBuildItemUUID(sUUID);
+			if (pPart->getPartID() != part.getUint32("id"))
+				throw std::runtime_error("slice " + sSliceDirectory + " has a different part ID for " + sUUID);
+
+			if (part.getBool("hasBoundsXY")) {
+				pPart->addCoordinatesXY(part.getDouble("minX"), part.getDouble("minY"));
+				pPart->addCoordinatesXY(part.getDouble("maxX"), part.getDouble("maxY"));
+			}
+
+			if (part.getBool("hasBoundsZ")) {
+				pPart->addCoordinatesZ(part.getDouble("minZ"));
+				pPart->addCoordinatesZ(part.getDouble("maxZ"));
+			}
+		}
+
+		// Binary files are appended with new IDs, their compressed data is copied as is
+		uint32_t nFileIDOffset = (uint32_t)m_BinaryFiles.size();
+
+		auto& binaryFiles = manifest.getMember("binaryFiles");
+		for (uint32_t nIndex = 0; nIndex < binaryFiles.getElementCount(); nIndex++) {
+			auto& binaryFile = binaryFiles.getElement(nIndex);
+			if (binaryFile.getUint32("id") != nIndex)
+				throw std::runtime_error("slice " + sSliceDirectory + " has non-consecutive binary file IDs");
+
+			sMatJobBinaryFileInfo fileInfo;
+			fileInfo.m_nFileID = nFileIDOffset + nIndex;
+			fileInfo.m_sFileName = binaryFile.getString("name");
+			fileInfo.m_nFileSize = binaryFile.getUint64("fileSize");
+
+			for (auto& existingFileInfo : m_BinaryFiles) {
+				if (existingFileInfo.m_sFileName == fileInfo.m_sFileName)
+					throw std::runtime_error("duplicate binary file in slice " + sSliceDirectory + ": " + fileInfo.m_sFileName);
+			}
+			m_BinaryFiles.push_back(fileInfo);
+
+			std::string sEntryPath = getSlicePath(sSliceDirectory, fileInfo.m_sFileName + MATJOB_SLICEENTRYEXTENSION);
+			uint64_t nCompressedSize = binaryFile.getUint64("compressedSize");
+			uint64_t nUncompressedSize = binaryFile.getUint64("uncompressedSize");
+			uint32_t nCRC32 = binaryFile.getUint32("crc32");
+
+			queueDeflatedEntry(fileInfo.m_sFileName, m_pThreadPool->submit([sEntryPath, nCompressedSize, nUncompressedSize, nCRC32]() {
+				CToolpathTraceSpan traceSpan("readSliceEntry");
+
+				std::ifstream stream(sEntryPath, std::ios::in | std::ios::binary);
+				if (!stream.is_open())
+					throw std::runtime_error("Failed to open slice entry: " + sEntryPath);
+
+				std::vector<char> buffer((size_t)nCompressedSize);
+				stream.read(buffer.data(), (std::streamsize)nCompressedSize);
+				if ((uint64_t)stream.gcount() != nCompressedSize)
+					throw std::runtime_error("slice entry is truncated: " + sEntryPath);
+
+				auto pDeflatedData = std::make_shared<NMR::CPortableZIPDeflatedData>();
+				pDeflatedData->setDeflatedData(buffer.data(), nCompressedSize, nUncompressedSize, nCRC32);
+
+				CToolpathMemoryTracker::addBytes(eToolpathMemorySubsystem::PendingCompression, (int64_t)pDeflatedData->getCompressedSize());
+				return pDeflatedData;
+			}));
+		}
+
+		// Layers and their data blocks, with the file references moved to the new IDs
+		std::string sDataBlocksFileName = getSlicePath(sSliceDirectory, MATJOB_SLICEDATABLOCKSNAME);
+		std::ifstream dataBlockStream(sDataBlocksFileName, std::ios::in | std::ios::binary);
+		if (!dataBlockStream.is_open())
+			throw std::runtime_error("Failed to open slice data blocks: " + sDataBlocksFileName);
+
+		auto& layers = manifest.getMember("layers");
+		if (layers.getElementCount() != sliceRange.m_nEndLayerIndex - sliceRange.m_nFirstLayerIndex)
+			throw std::runtime_error("slice " + sSliceDirectory + " has an invalid layer count");
+
+		for (uint32_t nIndex = 0; nIndex < layers.getElementCount(); nIndex++) {
+			auto& layer = layers.getElement(nIndex);
+
+			auto pLayer = beginNewLayer(layer.getDouble("z"));
+			pLayer->restoreSummary(layer.getDouble("scanTime"), layer.getDouble("markDistance"), layer.getDouble("jumpDistance"),
+				layer.getDouble("minX"), layer.getDouble("minY"), layer.getDouble("maxX"), layer.getDouble("maxY"));
+
+			uint32_t nDataBlockCount = layer.getUint32("dataBlocks");
+			for (uint32_t nDataBlockIndex = 0; nDataBlockIndex < nDataBlockCount; nDataBlockIndex++) {
+				sMatJobDataBlock dataBlock;
+				dataBlock.m_nPartID = readSliceValue<uint32_t>(dataBlockStream);
+				dataBlock.m_nParameterSetID = readSliceValue<uint32_t>(dataBlockStream);
+				dataBlock.m_nVectorTypeID = readSliceValue<uint32_t>(dataBlockStream);
+				dataBlock.m_dMarkDistance = readSliceValue<double>(dataBlockStream);
+				dataBlock.m_dJumpDistance = readSliceValue<double>(dataBlockStream);
+				dataBlock.m_nNumMarkSegments = readSliceValue<uint32_t>(dataBlockStream);
+				dataBlock.m_nNumJumpSegments = readSliceValue<uint32_t>(dataBlockStream);
+				dataBlock.m_nFileID = readSliceValue<uint32_t>(dataBlockStream);
+				dataBlock.m_nDataPosition = readSliceValue<uint64_t>(dataBlockStream);
+
+				if (dataBlock.m_nFileID >= binaryFiles.getElementCount())
+					throw std::runtime_error("slice " + sSliceDirectory + " references an unknown binary file");
+				dataBlock.m_nFileID += nFileIDOffset;
+
+				pLayer->addDataBlock(dataBlock);
+			}
+		}
+
+		if (dataBlockStream.peek() != std::ifstream::traits_type::eof())
+			throw std::runtime_error("slice " + sSliceDirectory + " has unreferenced data blocks");
+
+		m_nMergedSliceCount++;
+
+		return sliceRange;
+	}
+
+}
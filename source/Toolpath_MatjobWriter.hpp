@@ -36,15 +36,63 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "Toolpath_MatjobLayer.hpp"
 #include "Toolpath_MatjobScanField.hpp"
 #include "Toolpath_MatjobParameterSet.hpp"
+#include "Toolpath_ThreadPool.hpp"
+#include "Toolpath_Statistics.hpp"
+#include "Toolpath_Trace.hpp"
+#include "Toolpath_MemoryTracker.hpp"
 
 #include "Common/Platform/NMR_PortableZIPWriter.h"
+#include "Common/Platform/NMR_ExportStream_Memory.h"
+
+#include <deque>
+#include <future>
 
 namespace Toolpath {
 
+	typedef struct _sMatJobBinaryFileInfo {
+		uint32_t m_nFileID;
+		std::string m_sFileName;
+		uint64_t m_nFileSize;
+	} sMatJobBinaryFileInfo;
+
+	// Compressed entry of a job slice, stored as raw deflate stream next to the slice manifest
+	typedef struct _sMatJobSliceEntry {
+		std::string m_sName;
+		uint64_t m_nCompressedSize;
+		uint64_t m_nUncompressedSize;
+		uint32_t m_nCRC32;
+	} sMatJobSliceEntry;
+
+	// Layers [m_nFirstLayerIndex, m_nEndLayerIndex) of a job with m_nLayerCount layers
+	typedef struct _sMatJobSliceRange {
+		uint32_t m_nLayerCount;
+		uint32_t m_nFirstLayerIndex;
+		uint32_t m_nEndLayerIndex;
+	} sMatJobSliceRange;
+
+	/**
+	 * Writes a MatJob container. In slice mode, the binary files are stored as compressed entries in a
+	 * directory together with a manifest of the metadata, and several slices are merged into one container
+	 * later without encoding the geometry again.
+	 */
 	class CMatJobWriter {
 	private:
 		NMR::PPortableZIPWriter m_pZIPWriter;
-		std::vector<PMatJobBinaryFile> m_BinaryFiles;
+		std::vector<sMatJobBinaryFileInfo> m_BinaryFiles;
+		bool m_bIsFinalized;
+
+		// Slice mode
+		std::string m_sSliceDirectory;
+		std::vector<sMatJobSliceEntry> m_SliceEntries;
+		uint32_t m_nMergedSliceCount;
+
+		// Entries are compressed on the thread pool and appended to the ZIP in submission order
+		PToolpathThreadPool m_pThreadPool;
+		std::deque<std::pair<std::string, std::future<NMR::PPortableZIPDeflatedData>>> m_PendingEntries;
+		uint32_t m_nMaxPendingEntries;
+
+		PToolpathStatistics m_pStatistics;
+		PMatJobScanTimeModel m_pScanTimeModel;
 
 		PMatJobBinaryFile m_pOpenBinaryFile;
 		PMatJobLayer m_pOpenLayer;
@@ -73,12 +121,32 @@ namespace Toolpath {
 
 		void calculateGlobalBounds(double & dMinX, double & dMinY, double & dMinZ, double & dMaxX, double & dMaxY, double & dMaxZ);
 
+		void queueDeflatedEntry(const std::string& sName, std::future<NMR::PPortableZIPDeflatedData> deflatedDataFuture);
+
+		void writePendingEntries(bool bWaitForAll);
+
+		void initializeJob(PToolpathThreadPool pThreadPool);
+		void checkNotFinalized();
+
+		std::string getSlicePath(const std::string& sSliceDirectory, const std::string& sName);
+		void writeSliceEntry(const std::string& sName, NMR::CPortableZIPDeflatedData* pDeflatedData);
+		void writeSliceManifest(const sMatJobSliceRange& sliceRange);
+		void writeSliceDataBlocks();
+
 	public:
 
-		CMatJobWriter(NMR::PExportStream pExportStream);
+		CMatJobWriter(NMR::PExportStream pExportStream, PToolpathThreadPool pThreadPool = nullptr);
+
+		// Slice mode, the directory is created if it does not exist
+		CMatJobWriter(const std::string& sSliceDirectory, PToolpathThreadPool pThreadPool = nullptr);
 
 		virtual ~CMatJobWriter();
 
+		void setStatistics(PToolpathStatistics pStatistics);
+
+		// Scan time model of the layers begun afterwards, nullptr for distance over speed
+		void setScanTimeModel(PMatJobScanTimeModel pScanTimeModel);
+
 		void writeContent();
 
 		PMatJobBinaryFile beginBinaryFile(const std::string& sFileName);
@@ -89,6 +157,14 @@ namespace Toolpath {
 
 		void finalize();
 
+		bool isSlice();
+
+		// Writes the remaining entries and the manifest of a slice
+		void finalizeSlice(const sMatJobSliceRange& sliceRange);
+
+		// Appends a slice written by finalizeSlice. Slices must be merged in layer order.
+		sMatJobSliceRange mergeSlice(const std::string& sSliceDirectory);
+
 		void addProperty(const std::string& sName, const std::string& sValue, eMatJobPropertyType propertyType);
 
 		void addScanField(const std::string& sReference, uint32_t nLaserID, uint32_t nScanFieldID, double dXMin, double dYMin, double dXMax, double dYMax);
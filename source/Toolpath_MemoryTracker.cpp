@@ -0,0 +1,238 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#include "Toolpath_MemoryTracker.hpp"
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <fstream>
+#include <stdexcept>
+
+#ifdef _WIN32
+#define PSAPI_VERSION 2
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <unistd.h>
+#include <sys/resource.h>
+#endif
+
+namespace Toolpath {
+
+	typedef struct _sToolpathMemorySample {
+		uint32_t m_nLayerIndex;
+		uint64_t m_nResidentBytes;
+		uint64_t m_nTrackedBytes;
+	} sToolpathMemorySample;
+
+	static std::array<std::atomic<int64_t>, TOOLPATHMEMORY_SUBSYSTEMCOUNT> s_CurrentBytes = {};
+	static std::array<std::atomic<int64_t>, TOOLPATHMEMORY_SUBSYSTEMCOUNT> s_PeakBytes = {};
+
+	static std::mutex s_SampleMutex;
+	static std::vector<sToolpathMemorySample> s_Samples;
+	static uint64_t s_nBudgetInBytes = 0;
+	static uint64_t s_nPeakSampledResidentBytes = 0;
+	static bool s_bBudgetWarningIssued = false;
+
+	// Budget fraction at which the warning is printed
+	#define TOOLPATHMEMORY_BUDGETWARNINGRATIO 0.9
+
+	void CToolpathMemoryTracker::addBytes(eToolpathMemorySubsystem subsystem, int64_t nDeltaBytes)
+	{
+		uint32_t nIndex = (uint32_t)subsystem;
+		if (nIndex >= TOOLPATHMEMORY_SUBSYSTEMCOUNT)
+			throw std::runtime_error("invalid memory subsystem: " + std::to_string(nIndex));
+
+		int64_t nNewBytes = s_CurrentBytes[nIndex].fetch_add(nDeltaBytes, std::memory_order_relaxed) + nDeltaBytes;
+
+		int64_t nPeakBytes = s_PeakBytes[nIndex].load(std::memory_order_relaxed);
+		while ((nNewBytes > nPeakBytes) && !s_PeakBytes[nIndex].compare_exchange_weak(nPeakBytes, nNewBytes, std::memory_order_relaxed)) {
+		}
+	}
+
+	uint64_t CToolpathMemoryTracker::getCurrentBytes(eToolpathMemorySubsystem subsystem)
+	{
+		uint32_t nIndex = (uint32_t)subsystem;
+		if (nIndex >= TOOLPATHMEMORY_SUBSYSTEMCOUNT)
+			throw std::runtime_error("invalid memory subsystem: " + std::to_string(nIndex));
+
+		int64_t nBytes = s_CurrentBytes[nIndex].load();
+		return (nBytes > 0) ? (uint64_t)nBytes : 0;
+	}
+
+	uint64_t CToolpathMemoryTracker::getPeakBytes(eToolpathMemorySubsystem subsystem)
+	{
+		uint32_t nIndex = (uint32_t)subsystem;
+		if (nIndex >= TOOLPATHMEMORY_SUBSYSTEMCOUNT)
+			throw std::runtime_error("invalid memory subsystem: " + std::to_string(nIndex));
+
+		int64_t nBytes = s_PeakBytes[nIndex].load();
+		return (nBytes > 0) ? (uint64_t)nBytes : 0;
+	}
+
+	void CToolpathMemoryTracker::setBudget(uint64_t nBudgetInBytes)
+	{
+		std::lock_guard<std::mutex> lock(s_SampleMutex);
+		s_nBudgetInBytes = nBudgetInBytes;
+		s_bBudgetWarningIssued = false;
+	}
+
+	void CToolpathMemoryTracker::sampleLayer(uint32_t nLayerIndex, std::ostream* pLog)
+	{
+		sToolpathMemorySample sample;
+		sample.m_nLayerIndex = nLayerIndex;
+		sample.m_nResidentBytes = getProcessResidentBytes();
+		sample.m_nTrackedBytes = 0;
+		for (uint32_t nIndex = 0; nIndex < TOOLPATHMEMORY_SUBSYSTEMCOUNT; nIndex++)
+			sample.m_nTrackedBytes += getCurrentBytes((eToolpathMemorySubsystem)nIndex);
+
+		std::lock_guard<std::mutex> lock(s_SampleMutex);
+		s_Samples.push_back(sample);
+		if (sample.m_nResidentBytes > s_nPeakSampledResidentBytes)
+			s_nPeakSampledResidentBytes = sample.m_nResidentBytes;
+
+		if ((s_nBudgetInBytes > 0) && !s_bBudgetWarningIssued) {
+			if ((double)sample.m_nResidentBytes >= (double)s_nBudgetInBytes * TOOLPATHMEMORY_BUDGETWARNINGRATIO) {
+				if (pLog != nullptr)
+					*pLog << "warning: resident memory of " << (sample.m_nResidentBytes >> 20) << " MB at layer " << nLayerIndex
+						<< " is approaching the memory budget of " << (s_nBudgetInBytes >> 20) << " MB"
+						<< " (binary files: " << (getCurrentBytes(eToolpathMemorySubsystem::MatJobBinaryFile) >> 20) << " MB"
+						<< ", layer data: " << (getCurrentBytes(eToolpathMemorySubsystem::MatJobLayerData) >> 20) << " MB"
+						<< ", pending compression: " << (getCurrentBytes(eToolpathMemorySubsystem::PendingCompression) >> 20) << " MB"
+						<< ", CLI geometry: " << (getCurrentBytes(eToolpathMemorySubsystem::CLIGeometryBuffer) >> 20) << " MB)\n";
+				s_bBudgetWarningIssued = true;
+			}
+		}
+	}
+
+	uint64_t CToolpathMemoryTracker::getProcessResidentBytes()
+	{
+#ifdef _WIN32
+		PROCESS_MEMORY_COUNTERS counters;
+		if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+			return 0;
+		return (uint64_t)counters.WorkingSetSize;
+#else
+		std::ifstream statmStream("/proc/self/statm");
+		uint64_t nTotalPages = 0;
+		uint64_t nResidentPages = 0;
+		if (!(statmStream >> nTotalPages >> nResidentPages))
+			return 0;
+		return nResidentPages * (uint64_t)sysconf(_SC_PAGESIZE);
+#endif
+	}
+
+	uint64_t CToolpathMemoryTracker::getProcessPeakResidentBytes()
+	{
+#ifdef _WIN32
+		PROCESS_MEMORY_COUNTERS counters;
+		if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+			return 0;
+		return (uint64_t)counters.PeakWorkingSetSize;
+#else
+		struct rusage usage;
+		if (getrusage(RUSAGE_SELF, &usage) != 0)
+			return 0;
+#ifdef __APPLE__
+		return (uint64_t)usage.ru_maxrss;
+#else
+		// Linux reports kilobytes
+		return (uint64_t)usage.ru_maxrss * 1024;
+#endif
+#endif
+	}
+
+	void CToolpathMemoryTracker::writeToJSON(CToolpathJSONWriter& jsonWriter)
+	{
+		uint64_t nPeakResidentBytes = getProcessPeakResidentBytes();
+
+		std::lock_guard<std::mutex> lock(s_SampleMutex);
+
+		jsonWriter.beginObject();
+
+		jsonWriter.beginObject("process");
+		jsonWriter.writeUint64("residentBytes", getProcessResidentBytes());
+		jsonWriter.writeUint64("peakResidentBytes", nPeakResidentBytes);
+		jsonWriter.writeUint64("peakSampledResidentBytes", s_nPeakSampledResidentBytes);
+		jsonWriter.writeUint64("budgetBytes", s_nBudgetInBytes);
+		jsonWriter.writeBool("budgetWarningIssued", s_bBudgetWarningIssued);
+		jsonWriter.endObject();
+
+		jsonWriter.beginObject("subsystems");
+		for (uint32_t nIndex = 0; nIndex < TOOLPATHMEMORY_SUBSYSTEMCOUNT; nIndex++) {
+			auto subsystem = (eToolpathMemorySubsystem)nIndex;
+			jsonWriter.beginObject(getSubsystemName(subsystem));
+			jsonWriter.writeUint64("currentBytes", getCurrentBytes(subsystem));
+			jsonWriter.writeUint64("peakBytes", getPeakBytes(subsystem));
+			jsonWriter.endObject();
+		}
+		jsonWriter.endObject();
+
+		// Resident memory not covered by the gauges is mostly lib3mf and the C runtime
+		jsonWriter.beginArray("layers");
+		for (auto& sample : s_Samples) {
+			jsonWriter.beginObject();
+			jsonWriter.writeUint64("layer", sample.m_nLayerIndex);
+			jsonWriter.writeUint64("residentBytes", sample.m_nResidentBytes);
+			jsonWriter.writeUint64("trackedBytes", sample.m_nTrackedBytes);
+			jsonWriter.writeUint64("untrackedBytes", (sample.m_nResidentBytes > sample.m_nTrackedBytes) ? (sample.m_nResidentBytes - sample.m_nTrackedBytes) : 0);
+			jsonWriter.endObject();
+		}
+		jsonWriter.endArray();
+
+		jsonWriter.endObject();
+	}
+
+	void CToolpathMemoryTracker::writeToFile(const std::string& sFileName)
+	{
+		std::ofstream stream(sFileName, std::ios::out | std::ios::trunc);
+		if (!stream.is_open())
+			throw std::runtime_error("Failed to open memory statistics file: " + sFileName);
+
+		CToolpathJSONWriter jsonWriter(stream);
+		writeToJSON(jsonWriter);
+
+		if (!stream.good())
+			throw std::runtime_error("Failed to write memory statistics file: " + sFileName);
+	}
+
+	std::string CToolpathMemoryTracker::getSubsystemName(eToolpathMemorySubsystem subsystem)
+	{
+		switch (subsystem) {
+		case eToolpathMemorySubsystem::MatJobBinaryFile: return "matjobBinaryFile";
+		case eToolpathMemorySubsystem::MatJobLayerData: return "matjobLayerData";
+		case eToolpathMemorySubsystem::PendingCompression: return "pendingCompression";
+		case eToolpathMemorySubsystem::CLIGeometryBuffer: return "cliGeometryBuffer";
+		default:
+			throw std::runtime_error("invalid memory subsystem: " + std::to_string((uint32_t)subsystem));
+		}
+	}
+
+} // namespace Toolpath
@@ -0,0 +1,115 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#ifndef __TOOLPATH_MEMORYTRACKER
+#define __TOOLPATH_MEMORYTRACKER
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <ostream>
+
+#include "Toolpath_JSONWriter.hpp"
+
+namespace Toolpath {
+
+	/**
+	 * Owners of large converter allocations that are accounted separately.
+	 */
+	enum class eToolpathMemorySubsystem : uint32_t {
+		MatJobBinaryFile = 0,    // Encoded layer batches of CMatJobBinaryFile
+		MatJobLayerData = 1,     // Data block records of CMatJobLayer
+		PendingCompression = 2,  // ZIP entries waiting for compression or to be written
+		CLIGeometryBuffer = 3    // Geometry section of the CLI+ exporter
+	};
+
+	#define TOOLPATHMEMORY_SUBSYSTEMCOUNT 4
+
+	/**
+	 * Process-wide accounting of current and peak bytes per subsystem, together with
+	 * resident set size samples taken at layer boundaries.
+	 * Gauges are thread safe. Sampling and reporting are expected from the converting thread.
+	 */
+	class CToolpathMemoryTracker {
+	public:
+		static void addBytes(eToolpathMemorySubsystem subsystem, int64_t nDeltaBytes);
+
+		static uint64_t getCurrentBytes(eToolpathMemorySubsystem subsystem);
+		static uint64_t getPeakBytes(eToolpathMemorySubsystem subsystem);
+
+		// Budget in bytes, 0 disables the warning
+		static void setBudget(uint64_t nBudgetInBytes);
+
+		// Records the resident set size after a layer and warns on the log when the budget is approached, the log may be null
+		static void sampleLayer(uint32_t nLayerIndex, std::ostream* pLog);
+
+		static uint64_t getProcessResidentBytes();
+		static uint64_t getProcessPeakResidentBytes();
+
+		static void writeToJSON(CToolpathJSONWriter& jsonWriter);
+		static void writeToFile(const std::string& sFileName);
+
+		static std::string getSubsystemName(eToolpathMemorySubsystem subsystem);
+	};
+
+	/**
+	 * Reports the size of one allocation to a subsystem gauge. Owners call update with
+	 * their current capacity; the reported bytes are released on destruction.
+	 */
+	class CToolpathMemoryGauge {
+	private:
+		eToolpathMemorySubsystem m_Subsystem;
+		uint64_t m_nReportedBytes;
+
+	public:
+		CToolpathMemoryGauge(eToolpathMemorySubsystem subsystem)
+			: m_Subsystem(subsystem), m_nReportedBytes(0)
+		{
+		}
+
+		~CToolpathMemoryGauge()
+		{
+			update(0);
+		}
+
+		void update(uint64_t nBytes)
+		{
+			if (nBytes != m_nReportedBytes) {
+				CToolpathMemoryTracker::addBytes(m_Subsystem, (int64_t)nBytes - (int64_t)m_nReportedBytes);
+				m_nReportedBytes = nBytes;
+			}
+		}
+
+		CToolpathMemoryGauge(const CToolpathMemoryGauge&) = delete;
+		CToolpathMemoryGauge& operator=(const CToolpathMemoryGauge&) = delete;
+	};
+
+} // namespace Toolpath
+
+#endif // __TOOLPATH_MEMORYTRACKER
@@ -0,0 +1,466 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#include "Toolpath_Source.hpp"
+
+#include <stdexcept>
+#include <algorithm>
+#include <cstdlib>
+#include <cerrno>
+
+namespace Toolpath {
+
+	CToolpathLayerData::CToolpathLayerData()
+		: m_nLayerIndex(0), m_dZMin(0.0), m_dZMax(0.0)
+	{
+	}
+
+	void CToolpathLayerData::reset(uint32_t nLayerIndex, double dZMin, double dZMax)
+	{
+		m_nLayerIndex = nLayerIndex;
+		m_dZMin = dZMin;
+		m_dZMax = dZMax;
+		m_sLayerDataUUID.clear();
+
+		m_Segments.clear();
+		m_Points.clear();
+		m_Hatches.clear();
+	}
+
+	void CToolpathLayerData::addPolyline(eToolpathSegmentType segmentType, uint32_t nPartIndex, uint32_t nProfileIndex, const sToolpathPoint2D* pPoints, uint32_t nPointCount)
+	{
+		if ((segmentType != eToolpathSegmentType::Loop) && (segmentType != eToolpathSegmentType::Polyline))
+			throw std::runtime_error("invalid polyline segment type");
+		if ((pPoints == nullptr) && (nPointCount > 0))
+			throw std::runtime_error("invalid polyline point buffer");
+		if (m_Points.size() + nPointCount + 1 > 0xffffffffULL)
+			throw std::runtime_error("too many points in layer " + std::to_string(m_nLayerIndex));
+
+		sToolpathSegment segment;
+		segment.m_Type = segmentType;
+		segment.m_nPartIndex = nPartIndex;
+		segment.m_nProfileIndex = nProfileIndex;
+		segment.m_nFirstElementIndex = (uint32_t)m_Points.size();
+		segment.m_nElementCount = nPointCount;
+
+		m_Points.insert(m_Points.end(), pPoints, pPoints + nPointCount);
+
+		// Close loops if not already closed
+		if ((segmentType == eToolpathSegmentType::Loop) && (nPointCount > 0)) {
+			const sToolpathPoint2D& firstPoint = pPoints[0];
+			const sToolpathPoint2D& lastPoint = pPoints[nPointCount - 1];
+			if ((firstPoint.m_Coordinates[0] != lastPoint.m_Coordinates[0]) ||
+				(firstPoint.m_Coordinates[1] != lastPoint.m_Coordinates[1])) {
+				m_Points.push_back(firstPoint);
+				segment.m_nElementCount++;
+			}
+		}
+
+		m_Segments.push_back(segment);
+	}
+
+	void CToolpathLayerData::addHatches(uint32_t nPartIndex, uint32_t nProfileIndex, const sToolpathHatch2D* pHatches, uint32_t nHatchCount)
+	{
+		if ((pHatches == nullptr) && (nHatchCount > 0))
+			throw std::runtime_error("invalid hatch buffer");
+		if (m_Hatches.size() + nHatchCount > 0xffffffffULL)
+			throw std::runtime_error("too many hatches in layer " + std::to_string(m_nLayerIndex));
+
+		sToolpathSegment segment;
+		segment.m_Type = eToolpathSegmentType::Hatch;
+		segment.m_nPartIndex = nPartIndex;
+		segment.m_nProfileIndex = nProfileIndex;
+		segment.m_nFirstElementIndex = (uint32_t)m_Hatches.size();
+		segment.m_nElementCount = nHatchCount;
+
+		m_Hatches.insert(m_Hatches.end(), pHatches, pHatches + nHatchCount);
+		m_Segments.push_back(segment);
+	}
+
+	uint32_t CToolpathLayerData::getLayerIndex() const
+	{
+		return m_nLayerIndex;
+	}
+
+	double CToolpathLayerData::getZMin() const
+	{
+		return m_dZMin;
+	}
+
+	double CToolpathLayerData::getZMax() const
+	{
+		return m_dZMax;
+	}
+
+	void CToolpathLayerData::setLayerDataUUID(const std::string& sLayerDataUUID)
+	{
+		m_sLayerDataUUID = sLayerDataUUID;
+	}
+
+	const std::string& CToolpathLayerData::getLayerDataUUID() const
+	{
+		return m_sLayerDataUUID;
+	}
+
+	uint32_t CToolpathLayerData::getSegmentCount() const
+	{
+		return (uint32_t)m_Segments.size();
+	}
+
+	const sToolpathSegment& CToolpathLayerData::getSegment(uint32_t nSegmentIndex) const
+	{
+		if (nSegmentIndex >= m_Segments.size())
+			throw std::runtime_error("invalid segment index: " + std::to_string(nSegmentIndex));
+
+		return m_Segments[nSegmentIndex];
+	}
+
+	const sToolpathPoint2D* CToolpathLayerData::getSegmentPoints(const sToolpathSegment& segment) const
+	{
+		if (segment.m_Type == eToolpathSegmentType::Hatch)
+			throw std::runtime_error("hatch segment has no points");
+		if ((uint64_t)segment.m_nFirstElementIndex + segment.m_nElementCount > m_Points.size())
+			throw std::runtime_error("invalid segment point range");
+
+		if (segment.m_nElementCount == 0)
+			return nullptr;
+
+		return &m_Points[segment.m_nFirstElementIndex];
+	}
+
+	const sToolpathHatch2D* CToolpathLayerData::getSegmentHatches(const sToolpathSegment& segment) const
+	{
+		if (segment.m_Type != eToolpathSegmentType::Hatch)
+			throw std::runtime_error("segment has no hatches");
+		if ((uint64_t)segment.m_nFirstElementIndex + segment.m_nElementCount > m_Hatches.size())
+			throw std::runtime_error("invalid segment hatch range");
+
+		if (segment.m_nElementCount == 0)
+			return nullptr;
+
+		return &m_Hatches[segment.m_nFirstElementIndex];
+	}
+
+	sToolpathPoint2D* CToolpathLayerData::getSegmentPoints(const sToolpathSegment& segment)
+	{
+		return const_cast<sToolpathPoint2D*>(static_cast<const CToolpathLayerData*>(this)->getSegmentPoints(segment));
+	}
+
+	sToolpathHatch2D* CToolpathLayerData::getSegmentHatches(const sToolpathSegment& segment)
+	{
+		return const_cast<sToolpathHatch2D*>(static_cast<const CToolpathLayerData*>(this)->getSegmentHatches(segment));
+	}
+
+	void CToolpathLayerData::reorderSegments(const std::vector<uint32_t>& segmentOrder)
+	{
+		if (segmentOrder.size() != m_Segments.size())
+			throw std::runtime_error("segment order does not match the segment count");
+
+		std::vector<bool> segmentIsUsed(m_Segments.size(), false);
+		std::vector<sToolpathSegment> orderedSegments;
+		orderedSegments.reserve(m_Segments.size());
+		for (uint32_t nSegmentIndex : segmentOrder) {
+			if ((nSegmentIndex >= m_Segments.size()) || segmentIsUsed[nSegmentIndex])
+				throw std::runtime_error("segment order is not a permutation");
+
+			segmentIsUsed[nSegmentIndex] = true;
+			orderedSegments.push_back(m_Segments[nSegmentIndex]);
+		}
+
+		m_Segments.swap(orderedSegments);
+	}
+
+	void CToolpathLayerData::setSegmentElementCount(uint32_t nSegmentIndex, uint32_t nElementCount)
+	{
+		if (nSegmentIndex >= m_Segments.size())
+			throw std::runtime_error("invalid segment index");
+
+		sToolpathSegment& segment = m_Segments[nSegmentIndex];
+		if (nElementCount > segment.m_nElementCount)
+			throw std::runtime_error("segment element count can not be increased");
+
+		segment.m_nElementCount = nElementCount;
+	}
+
+	void CToolpathLayerData::setSegmentPoints(uint32_t nSegmentIndex, const sToolpathPoint2D* pPoints, uint32_t nPointCount)
+	{
+		if (nSegmentIndex >= m_Segments.size())
+			throw std::runtime_error("invalid segment index");
+		if ((pPoints == nullptr) && (nPointCount > 0))
+			throw std::runtime_error("invalid polyline point buffer");
+		if (m_Points.size() + nPointCount > 0xffffffffULL)
+			throw std::runtime_error("too many points in layer " + std::to_string(m_nLayerIndex));
+
+		sToolpathSegment& segment = m_Segments[nSegmentIndex];
+		if (segment.m_Type == eToolpathSegmentType::Hatch)
+			throw std::runtime_error("segment has no points");
+
+		segment.m_nFirstElementIndex = (uint32_t)m_Points.size();
+		segment.m_nElementCount = nPointCount;
+		m_Points.insert(m_Points.end(), pPoints, pPoints + nPointCount);
+	}
+
+	void CToolpathLayerData::removeSegments(const std::vector<uint8_t>& segmentIsRemoved)
+	{
+		if (segmentIsRemoved.size() != m_Segments.size())
+			throw std::runtime_error("segment flags do not match the segment count");
+
+		size_t nWriteIndex = 0;
+		for (size_t nSegmentIndex = 0; nSegmentIndex < m_Segments.size(); nSegmentIndex++) {
+			if (!segmentIsRemoved[nSegmentIndex]) {
+				m_Segments[nWriteIndex] = m_Segments[nSegmentIndex];
+				nWriteIndex++;
+			}
+		}
+		m_Segments.resize(nWriteIndex);
+	}
+
+	void CToolpathLayerData::compactElements()
+	{
+		// Segments own disjoint element ranges, so moving the ranges down in the order of their
+		// first element never overwrites data that has not been moved yet.
+		std::vector<uint32_t> pointSegments;
+		std::vector<uint32_t> hatchSegments;
+		for (uint32_t nSegmentIndex = 0; nSegmentIndex < (uint32_t)m_Segments.size(); nSegmentIndex++) {
+			if (m_Segments[nSegmentIndex].m_Type == eToolpathSegmentType::Hatch)
+				hatchSegments.push_back(nSegmentIndex);
+			else
+				pointSegments.push_back(nSegmentIndex);
+		}
+
+		auto compareFirstElement = [this](uint32_t nIndex1, uint32_t nIndex2) {
+			return m_Segments[nIndex1].m_nFirstElementIndex < m_Segments[nIndex2].m_nFirstElementIndex;
+		};
+		std::sort(pointSegments.begin(), pointSegments.end(), compareFirstElement);
+		std::sort(hatchSegments.begin(), hatchSegments.end(), compareFirstElement);
+
+		uint32_t nPointCount = 0;
+		for (uint32_t nSegmentIndex : pointSegments) {
+			sToolpathSegment& segment = m_Segments[nSegmentIndex];
+			if (segment.m_nFirstElementIndex != nPointCount)
+				std::copy(m_Points.begin() + segment.m_nFirstElementIndex, m_Points.begin() + segment.m_nFirstElementIndex + segment.m_nElementCount, m_Points.begin() + nPointCount);
+			segment.m_nFirstElementIndex = nPointCount;
+			nPointCount += segment.m_nElementCount;
+		}
+		m_Points.resize(nPointCount);
+
+		uint32_t nHatchCount = 0;
+		for (uint32_t nSegmentIndex : hatchSegments) {
+			sToolpathSegment& segment = m_Segments[nSegmentIndex];
+			if (segment.m_nFirstElementIndex != nHatchCount)
+				std::copy(m_Hatches.begin() + segment.m_nFirstElementIndex, m_Hatches.begin() + segment.m_nFirstElementIndex + segment.m_nElementCount, m_Hatches.begin() + nHatchCount);
+			segment.m_nFirstElementIndex = nHatchCount;
+			nHatchCount += segment.m_nElementCount;
+		}
+		m_Hatches.resize(nHatchCount);
+	}
+
+	const std::vector<sToolpathSegment>& CToolpathLayerData::getSegments() const
+	{
+		return m_Segments;
+	}
+
+	const std::vector<sToolpathPoint2D>& CToolpathLayerData::getPoints() const
+	{
+		return m_Points;
+	}
+
+	const std::vector<sToolpathHatch2D>& CToolpathLayerData::getHatches() const
+	{
+		return m_Hatches;
+	}
+
+
+	CToolpathSourcePart::CToolpathSourcePart(const std::string& sName, const std::string& sBuildItemUUID)
+		: m_sName(sName), m_sBuildItemUUID(sBuildItemUUID), m_bHasOutbox(false)
+	{
+		for (uint32_t nAxis = 0; nAxis < 3; nAxis++) {
+			m_dOutboxMin[nAxis] = 0.0;
+			m_dOutboxMax[nAxis] = 0.0;
+		}
+	}
+
+	std::string CToolpathSourcePart::getName() const
+	{
+		return m_sName;
+	}
+
+	std::string CToolpathSourcePart::getBuildItemUUID() const
+	{
+		return m_sBuildItemUUID;
+	}
+
+	void CToolpathSourcePart::setOutbox(double dMinX, double dMinY, double dMinZ, double dMaxX, double dMaxY, double dMaxZ)
+	{
+		m_dOutboxMin[0] = dMinX;
+		m_dOutboxMin[1] = dMinY;
+		m_dOutboxMin[2] = dMinZ;
+		m_dOutboxMax[0] = dMaxX;
+		m_dOutboxMax[1] = dMaxY;
+		m_dOutboxMax[2] = dMaxZ;
+		m_bHasOutbox = true;
+	}
+
+	bool CToolpathSourcePart::hasOutbox() const
+	{
+		return m_bHasOutbox;
+	}
+
+	double CToolpathSourcePart::getOutboxMin(uint32_t nAxis) const
+	{
+		if (nAxis >= 3)
+			throw std::runtime_error("invalid outbox axis: " + std::to_string(nAxis));
+		return m_dOutboxMin[nAxis];
+	}
+
+	double CToolpathSourcePart::getOutboxMax(uint32_t nAxis) const
+	{
+		if (nAxis >= 3)
+			throw std::runtime_error("invalid outbox axis: " + std::to_string(nAxis));
+		return m_dOutboxMax[nAxis];
+	}
+
+
+	CToolpathSourceProfile::CToolpathSourceProfile(const std::string& sUUID, const std::string& sName)
+		: m_sUUID(sUUID), m_sName(sName)
+	{
+	}
+
+	std::string CToolpathSourceProfile::getUUID() const
+	{
+		return m_sUUID;
+	}
+
+	std::string CToolpathSourceProfile::getName() const
+	{
+		return m_sName;
+	}
+
+	const sToolpathProfileParameter* CToolpathSourceProfile::findParameter(const std::string& sNameSpace, const std::string& sName) const
+	{
+		// Profiles carry few parameters, so a linear search is sufficient
+		for (auto& parameter : m_Parameters) {
+			if ((parameter.m_sName == sName) && (parameter.m_sNameSpace == sNameSpace))
+				return &parameter;
+		}
+
+		return nullptr;
+	}
+
+	void CToolpathSourceProfile::setParameterValue(const std::string& sNameSpace, const std::string& sName, const std::string& sValue)
+	{
+		if (sName.empty())
+			throw std::runtime_error("invalid profile parameter name");
+
+		for (auto& parameter : m_Parameters) {
+			if ((parameter.m_sName == sName) && (parameter.m_sNameSpace == sNameSpace)) {
+				parameter.m_sValue = sValue;
+				return;
+			}
+		}
+
+		sToolpathProfileParameter parameter;
+		parameter.m_sNameSpace = sNameSpace;
+		parameter.m_sName = sName;
+		parameter.m_sValue = sValue;
+		m_Parameters.push_back(parameter);
+	}
+
+	uint32_t CToolpathSourceProfile::getParameterCount() const
+	{
+		return (uint32_t)m_Parameters.size();
+	}
+
+	const sToolpathProfileParameter& CToolpathSourceProfile::getParameter(uint32_t nIndex) const
+	{
+		if (nIndex >= m_Parameters.size())
+			throw std::runtime_error("invalid profile parameter index: " + std::to_string(nIndex));
+
+		return m_Parameters[nIndex];
+	}
+
+	bool CToolpathSourceProfile::hasParameter(const std::string& sNameSpace, const std::string& sName) const
+	{
+		return findParameter(sNameSpace, sName) != nullptr;
+	}
+
+	std::string CToolpathSourceProfile::getParameterValue(const std::string& sNameSpace, const std::string& sName) const
+	{
+		auto pParameter = findParameter(sNameSpace, sName);
+		if (pParameter == nullptr)
+			throw std::runtime_error("profile parameter not found: " + sNameSpace + ":" + sName + " (profile " + m_sName + ")");
+
+		return pParameter->m_sValue;
+	}
+
+	double CToolpathSourceProfile::getParameterDoubleValue(const std::string& sNameSpace, const std::string& sName) const
+	{
+		std::string sValue = getParameterValue(sNameSpace, sName);
+
+		const char* pszValue = sValue.c_str();
+		char* pszEnd = nullptr;
+		errno = 0;
+		double dValue = strtod(pszValue, &pszEnd);
+		if ((pszEnd == pszValue) || (errno != 0))
+			throw std::runtime_error("invalid double value of profile parameter " + sName + ": " + sValue);
+
+		return dValue;
+	}
+
+	double CToolpathSourceProfile::getParameterDoubleValueDef(const std::string& sNameSpace, const std::string& sName, double dDefaultValue) const
+	{
+		if (!hasParameter(sNameSpace, sName))
+			return dDefaultValue;
+
+		return getParameterDoubleValue(sNameSpace, sName);
+	}
+
+	int64_t CToolpathSourceProfile::getParameterIntegerValue(const std::string& sNameSpace, const std::string& sName) const
+	{
+		std::string sValue = getParameterValue(sNameSpace, sName);
+
+		const char* pszValue = sValue.c_str();
+		char* pszEnd = nullptr;
+		errno = 0;
+		long long nValue = strtoll(pszValue, &pszEnd, 10);
+		if ((pszEnd == pszValue) || (errno != 0))
+			throw std::runtime_error("invalid integer value of profile parameter " + sName + ": " + sValue);
+
+		return (int64_t)nValue;
+	}
+
+	int64_t CToolpathSourceProfile::getParameterIntegerValueDef(const std::string& sNameSpace, const std::string& sName, int64_t nDefaultValue) const
+	{
+		if (!hasParameter(sNameSpace, sName))
+			return nDefaultValue;
+
+		return getParameterIntegerValue(sNameSpace, sName);
+	}
+
+} // namespace Toolpath
@@ -0,0 +1,238 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#ifndef __TOOLPATH_SOURCE
+#define __TOOLPATH_SOURCE
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+#include "Toolpath_Statistics.hpp"
+
+namespace Toolpath {
+
+	#define TOOLPATH_INDEX_NONE 0xffffffff
+
+	enum class eToolpathSegmentType : uint32_t {
+		Hatch = 1,
+		Loop = 2,
+		Polyline = 3
+	};
+
+	// Same memory layout as the float point pairs of the MatJob binary format
+	typedef struct _sToolpathPoint2D {
+		float m_Coordinates[2];
+	} sToolpathPoint2D;
+
+	typedef struct _sToolpathHatch2D {
+		double m_Point1Coordinates[2];
+		double m_Point2Coordinates[2];
+	} sToolpathHatch2D;
+
+	/**
+	 * A segment references a range of the flat point or hatch array of its layer.
+	 * Part and profile are indices into the tables of the source, or TOOLPATH_INDEX_NONE.
+	 */
+	typedef struct _sToolpathSegment {
+		eToolpathSegmentType m_Type;
+		uint32_t m_nPartIndex;
+		uint32_t m_nProfileIndex;
+		uint32_t m_nFirstElementIndex;
+		uint32_t m_nElementCount;
+	} sToolpathSegment;
+
+	/**
+	 * Geometry of one layer. Coordinates are given in model units, Z values in millimeters.
+	 * Loops are stored closed, i.e. their last point equals their first point.
+	 * Instances are meant to be reused across layers to avoid reallocation.
+	 */
+	class CToolpathLayerData {
+	private:
+		uint32_t m_nLayerIndex;
+		double m_dZMin;
+		double m_dZMax;
+		std::string m_sLayerDataUUID;
+
+		std::vector<sToolpathSegment> m_Segments;
+		std::vector<sToolpathPoint2D> m_Points;
+		std::vector<sToolpathHatch2D> m_Hatches;
+
+	public:
+		CToolpathLayerData();
+		virtual ~CToolpathLayerData() = default;
+
+		// Resets the layer while keeping the allocated capacity
+		void reset(uint32_t nLayerIndex, double dZMin, double dZMax);
+
+		void addPolyline(eToolpathSegmentType segmentType, uint32_t nPartIndex, uint32_t nProfileIndex, const sToolpathPoint2D* pPoints, uint32_t nPointCount);
+		void addHatches(uint32_t nPartIndex, uint32_t nProfileIndex, const sToolpathHatch2D* pHatches, uint32_t nHatchCount);
+
+		uint32_t getLayerIndex() const;
+		double getZMin() const;
+		double getZMax() const;
+
+		// UUID of the layer data in the source file, empty if the source has none
+		void setLayerDataUUID(const std::string& sLayerDataUUID);
+		const std::string& getLayerDataUUID() const;
+
+		uint32_t getSegmentCount() const;
+		const sToolpathSegment& getSegment(uint32_t nSegmentIndex) const;
+
+		// Returns the first point of a loop or polyline segment
+		const sToolpathPoint2D* getSegmentPoints(const sToolpathSegment& segment) const;
+		// Returns the first hatch of a hatch segment
+		const sToolpathHatch2D* getSegmentHatches(const sToolpathSegment& segment) const;
+
+		// Writable access for layer processors that change the geometry of a segment in place
+		sToolpathPoint2D* getSegmentPoints(const sToolpathSegment& segment);
+		sToolpathHatch2D* getSegmentHatches(const sToolpathSegment& segment);
+
+		// Changes the order in which segments are exported, segmentOrder is a permutation of the segment indices
+		void reorderSegments(const std::vector<uint32_t>& segmentOrder);
+
+		// Shortens a segment to its first nElementCount points or hatches, the dropped elements stay unused until compactElements is called
+		void setSegmentElementCount(uint32_t nSegmentIndex, uint32_t nElementCount);
+		// Replaces the points of a loop or polyline segment, the old points stay unused until compactElements is called
+		void setSegmentPoints(uint32_t nSegmentIndex, const sToolpathPoint2D* pPoints, uint32_t nPointCount);
+		// Removes the segments whose flag is set, their elements stay unused until compactElements is called
+		void removeSegments(const std::vector<uint8_t>& segmentIsRemoved);
+		// Removes points and hatches that are no longer referenced by any segment
+		void compactElements();
+
+		const std::vector<sToolpathSegment>& getSegments() const;
+		const std::vector<sToolpathPoint2D>& getPoints() const;
+		const std::vector<sToolpathHatch2D>& getHatches() const;
+	};
+
+	typedef std::shared_ptr<CToolpathLayerData> PToolpathLayerData;
+
+	/**
+	 * A part, corresponding to a build item of the 3MF model.
+	 */
+	class CToolpathSourcePart {
+	private:
+		std::string m_sName;
+		std::string m_sBuildItemUUID;
+
+		bool m_bHasOutbox;
+		double m_dOutboxMin[3];
+		double m_dOutboxMax[3];
+
+	public:
+		CToolpathSourcePart(const std::string& sName, const std::string& sBuildItemUUID);
+		virtual ~CToolpathSourcePart() = default;
+
+		std::string getName() const;
+		std::string getBuildItemUUID() const;
+
+		void setOutbox(double dMinX, double dMinY, double dMinZ, double dMaxX, double dMaxY, double dMaxZ);
+		bool hasOutbox() const;
+		double getOutboxMin(uint32_t nAxis) const;
+		double getOutboxMax(uint32_t nAxis) const;
+	};
+
+	typedef struct _sToolpathProfileParameter {
+		std::string m_sNameSpace;
+		std::string m_sName;
+		std::string m_sValue;
+	} sToolpathProfileParameter;
+
+	/**
+	 * A laser profile with its parameters. Values are stored as strings, as in the 3MF file.
+	 */
+	class CToolpathSourceProfile {
+	private:
+		std::string m_sUUID;
+		std::string m_sName;
+		std::vector<sToolpathProfileParameter> m_Parameters;
+
+		const sToolpathProfileParameter* findParameter(const std::string& sNameSpace, const std::string& sName) const;
+
+	public:
+		CToolpathSourceProfile(const std::string& sUUID, const std::string& sName);
+		virtual ~CToolpathSourceProfile() = default;
+
+		std::string getUUID() const;
+		std::string getName() const;
+
+		void setParameterValue(const std::string& sNameSpace, const std::string& sName, const std::string& sValue);
+
+		uint32_t getParameterCount() const;
+		const sToolpathProfileParameter& getParameter(uint32_t nIndex) const;
+
+		bool hasParameter(const std::string& sNameSpace, const std::string& sName) const;
+		std::string getParameterValue(const std::string& sNameSpace, const std::string& sName) const;
+		double getParameterDoubleValue(const std::string& sNameSpace, const std::string& sName) const;
+		double getParameterDoubleValueDef(const std::string& sNameSpace, const std::string& sName, double dDefaultValue) const;
+		int64_t getParameterIntegerValue(const std::string& sNameSpace, const std::string& sName) const;
+		int64_t getParameterIntegerValueDef(const std::string& sNameSpace, const std::string& sName, int64_t nDefaultValue) const;
+	};
+
+	/**
+	 * Abstract source of toolpath data consumed by the exporters.
+	 */
+	class IToolpathSource {
+	public:
+		virtual ~IToolpathSource() = default;
+
+		/**
+		 * Attach a statistics collector for decoding and extraction timings.
+		 * @param pStatistics Statistics of the conversion job, may be nullptr
+		 */
+		virtual void setStatistics(PToolpathStatistics pStatistics) = 0;
+
+		// Size of a model unit in millimeters
+		virtual double getUnits() = 0;
+
+		virtual uint32_t getLayerCount() = 0;
+		// Layer heights in millimeters
+		virtual double getLayerZMin(uint32_t nLayerIndex) = 0;
+		virtual double getLayerZMax(uint32_t nLayerIndex) = 0;
+
+		virtual uint32_t getPartCount() = 0;
+		virtual const CToolpathSourcePart& getPart(uint32_t nPartIndex) = 0;
+
+		virtual uint32_t getProfileCount() = 0;
+		virtual const CToolpathSourceProfile& getProfile(uint32_t nProfileIndex) = 0;
+
+		/**
+		 * Read the geometry of a layer.
+		 * @param nLayerIndex Index of the layer
+		 * @param layerData Layer container that is reset and filled
+		 */
+		virtual void readLayer(uint32_t nLayerIndex, CToolpathLayerData& layerData) = 0;
+	};
+
+	typedef std::shared_ptr<IToolpathSource> PToolpathSource;
+
+} // namespace Toolpath
+
+#endif // __TOOLPATH_SOURCE
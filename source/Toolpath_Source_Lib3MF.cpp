@@ -0,0 +1,251 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#include "Toolpath_Source_Lib3MF.hpp"
+
+#include <stdexcept>
+
+namespace Toolpath {
+
+	static_assert(sizeof(Lib3MF::sPosition2D) == sizeof(sToolpathPoint2D), "point layouts must match");
+
+	CToolpathSource_Lib3MF::CToolpathSource_Lib3MF(Lib3MF::PModel pModel, Lib3MF::PToolpath pToolpath)
+		: m_pModel(pModel), m_pToolpath(pToolpath), m_nSkippedArcSegmentCount(0)
+	{
+		if (pModel.get() == nullptr)
+			throw std::runtime_error("Invalid lib3mf model");
+		if (pToolpath.get() == nullptr)
+			throw std::runtime_error("Invalid lib3mf toolpath");
+
+		m_dUnits = pToolpath->GetUnits();
+		m_nLayerCount = pToolpath->GetLayerCount();
+
+		auto pBuildItems = pModel->GetBuildItems();
+		while (pBuildItems->MoveNext()) {
+			auto pBuildItem = pBuildItems->GetCurrent();
+			auto pObject = pBuildItem->GetObjectResource();
+
+			bool bHasUUID = false;
+			std::string sUUID = pBuildItem->GetUUID(bHasUUID);
+			if (!bHasUUID)
+				sUUID = "";
+
+			CToolpathSourcePart part(pObject->GetName(), sUUID);
+			auto outbox = pObject->GetOutbox();
+			part.setOutbox(outbox.m_MinCoordinate[0], outbox.m_MinCoordinate[1], outbox.m_MinCoordinate[2],
+				outbox.m_MaxCoordinate[0], outbox.m_MaxCoordinate[1], outbox.m_MaxCoordinate[2]);
+
+			if (!sUUID.empty())
+				m_PartIndicesByUUID.insert(std::make_pair(sUUID, (uint32_t)m_Parts.size()));
+			m_Parts.push_back(part);
+		}
+
+		uint32_t nProfileCount = pToolpath->GetProfileCount();
+		for (uint32_t nProfileIndex = 0; nProfileIndex < nProfileCount; nProfileIndex++) {
+			auto pProfile = pToolpath->GetProfile(nProfileIndex);
+
+			CToolpathSourceProfile profile(pProfile->GetUUID(), pProfile->GetName());
+
+			uint32_t nParameterCount = pProfile->GetParameterCount();
+			for (uint32_t nParameterIndex = 0; nParameterIndex < nParameterCount; nParameterIndex++) {
+				std::string sParameterName = pProfile->GetParameterName(nParameterIndex);
+				std::string sParameterNameSpace = pProfile->GetParameterNameSpace(nParameterIndex);
+				profile.setParameterValue(sParameterNameSpace, sParameterName, pProfile->GetParameterValue(sParameterNameSpace, sParameterName));
+			}
+
+			// Standard laser parameters are looked up explicitly, in case they are not enumerated
+			for (auto pszStandardName : { "laserpower", "laserspeed", "jumpspeed", "laserindex", "laserfocus" }) {
+				if (!profile.hasParameter("", pszStandardName) && pProfile->HasParameterValue("", pszStandardName))
+					profile.setParameterValue("", pszStandardName, pProfile->GetParameterValue("", pszStandardName));
+			}
+
+			m_ProfileIndicesByUUID.insert(std::make_pair(profile.getUUID(), (uint32_t)m_Profiles.size()));
+			m_Profiles.push_back(profile);
+		}
+	}
+
+	void CToolpathSource_Lib3MF::setStatistics(PToolpathStatistics pStatistics)
+	{
+		m_pStatistics = pStatistics;
+	}
+
+	uint64_t CToolpathSource_Lib3MF::getSkippedArcSegmentCount()
+	{
+		return m_nSkippedArcSegmentCount;
+	}
+
+	double CToolpathSource_Lib3MF::getUnits()
+	{
+		return m_dUnits;
+	}
+
+	uint32_t CToolpathSource_Lib3MF::getLayerCount()
+	{
+		return m_nLayerCount;
+	}
+
+	double CToolpathSource_Lib3MF::getLayerZMin(uint32_t nLayerIndex)
+	{
+		return m_pToolpath->GetLayerZMin(nLayerIndex) * m_dUnits;
+	}
+
+	double CToolpathSource_Lib3MF::getLayerZMax(uint32_t nLayerIndex)
+	{
+		return m_pToolpath->GetLayerZMax(nLayerIndex) * m_dUnits;
+	}
+
+	uint32_t CToolpathSource_Lib3MF::getPartCount()
+	{
+		return (uint32_t)m_Parts.size();
+	}
+
+	const CToolpathSourcePart& CToolpathSource_Lib3MF::getPart(uint32_t nPartIndex)
+	{
+		if (nPartIndex >= m_Parts.size())
+			throw std::runtime_error("invalid part index: " + std::to_string(nPartIndex));
+
+		return m_Parts[nPartIndex];
+	}
+
+	uint32_t CToolpathSource_Lib3MF::getProfileCount()
+	{
+		return (uint32_t)m_Profiles.size();
+	}
+
+	const CToolpathSourceProfile& CToolpathSource_Lib3MF::getProfile(uint32_t nProfileIndex)
+	{
+		if (nProfileIndex >= m_Profiles.size())
+			throw std::runtime_error("invalid profile index: " + std::to_string(nProfileIndex));
+
+		return m_Profiles[nProfileIndex];
+	}
+
+	uint32_t CToolpathSource_Lib3MF::findPartIndex(const std::string& sBuildItemUUID)
+	{
+		if (sBuildItemUUID.empty())
+			return TOOLPATH_INDEX_NONE;
+
+		auto iIter = m_PartIndicesByUUID.find(sBuildItemUUID);
+		if (iIter == m_PartIndicesByUUID.end())
+			throw std::runtime_error("toolpath segment references unknown build item: " + sBuildItemUUID);
+
+		return iIter->second;
+	}
+
+	uint32_t CToolpathSource_Lib3MF::findProfileIndex(const std::string& sProfileUUID)
+	{
+		if (sProfileUUID.empty())
+			return TOOLPATH_INDEX_NONE;
+
+		auto iIter = m_ProfileIndicesByUUID.find(sProfileUUID);
+		if (iIter == m_ProfileIndicesByUUID.end())
+			throw std::runtime_error("toolpath segment references unknown profile: " + sProfileUUID);
+
+		return iIter->second;
+	}
+
+	void CToolpathSource_Lib3MF::readLayer(uint32_t nLayerIndex, CToolpathLayerData& layerData)
+	{
+		CToolpathStatistics* pStatistics = m_pStatistics.get();
+
+		layerData.reset(nLayerIndex, getLayerZMin(nLayerIndex), getLayerZMax(nLayerIndex));
+
+		Lib3MF::PToolpathLayerReader pLayerReader;
+		{
+			CToolpathScopedTimer decodeTimer(pStatistics, eToolpathStatisticsPhase::Decode);
+			pLayerReader = m_pToolpath->ReadLayerData(nLayerIndex);
+		}
+
+		layerData.setLayerDataUUID(pLayerReader->GetLayerDataUUID());
+
+		CToolpathScopedTimer extractTimer(pStatistics, eToolpathStatisticsPhase::Extract);
+
+		uint32_t nSegmentCount = pLayerReader->GetSegmentCount();
+		uint32_t nSkippedArcSegmentCount = 0;
+		for (uint32_t nSegmentIndex = 0; nSegmentIndex < nSegmentCount; nSegmentIndex++) {
+			Lib3MF::eToolpathSegmentType segmentType;
+			uint32_t nPointCount = 0;
+			pLayerReader->GetSegmentInfo(nSegmentIndex, segmentType, nPointCount);
+
+			uint32_t nPartIndex = findPartIndex(pLayerReader->GetSegmentBuildItemUUID(nSegmentIndex));
+			uint32_t nProfileIndex = findProfileIndex(pLayerReader->GetSegmentDefaultProfileUUID(nSegmentIndex));
+
+			switch (segmentType) {
+			case Lib3MF::eToolpathSegmentType::Loop:
+			case Lib3MF::eToolpathSegmentType::Polyline:
+			{
+				pLayerReader->GetSegmentPointDataInModelUnits(nSegmentIndex, m_PointBuffer);
+				if (m_PointBuffer.size() != nPointCount)
+					throw std::runtime_error("Point count mismatch reading polyline segment");
+
+				eToolpathSegmentType internalType = (segmentType == Lib3MF::eToolpathSegmentType::Loop) ? eToolpathSegmentType::Loop : eToolpathSegmentType::Polyline;
+				layerData.addPolyline(internalType, nPartIndex, nProfileIndex,
+					reinterpret_cast<const sToolpathPoint2D*>(m_PointBuffer.data()), (uint32_t)m_PointBuffer.size());
+				break;
+			}
+
+			case Lib3MF::eToolpathSegmentType::Hatch:
+			{
+				pLayerReader->GetSegmentHatchDataInModelUnits(nSegmentIndex, m_HatchBuffer);
+				if (m_HatchBuffer.size() * 2 != nPointCount)
+					throw std::runtime_error("Point count mismatch reading hatch segment");
+
+				m_ConvertedHatchBuffer.resize(m_HatchBuffer.size());
+				for (size_t nHatchIndex = 0; nHatchIndex < m_HatchBuffer.size(); nHatchIndex++) {
+					auto& sourceHatch = m_HatchBuffer[nHatchIndex];
+					auto& targetHatch = m_ConvertedHatchBuffer[nHatchIndex];
+					targetHatch.m_Point1Coordinates[0] = sourceHatch.m_Point1Coordinates[0];
+					targetHatch.m_Point1Coordinates[1] = sourceHatch.m_Point1Coordinates[1];
+					targetHatch.m_Point2Coordinates[0] = sourceHatch.m_Point2Coordinates[0];
+					targetHatch.m_Point2Coordinates[1] = sourceHatch.m_Point2Coordinates[1];
+				}
+
+				layerData.addHatches(nPartIndex, nProfileIndex, m_ConvertedHatchBuffer.data(), (uint32_t)m_ConvertedHatchBuffer.size());
+				break;
+			}
+
+			case Lib3MF::eToolpathSegmentType::Arc:
+				// GetSegmentPointDataInModelUnits is only specified for loops and polylines
+				nSkippedArcSegmentCount++;
+				break;
+
+			default:
+				// Ignore other segment types
+				break;
+			}
+		}
+
+		if (nSkippedArcSegmentCount > 0) {
+			m_nSkippedArcSegmentCount += nSkippedArcSegmentCount;
+			if (pStatistics != nullptr)
+				pStatistics->setProcessingValue("arcSegments", "skipped", (double)m_nSkippedArcSegmentCount);
+		}
+	}
+
+} // namespace Toolpath
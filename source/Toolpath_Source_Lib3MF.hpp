@@ -0,0 +1,96 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#ifndef __TOOLPATH_SOURCE_LIB3MF
+#define __TOOLPATH_SOURCE_LIB3MF
+
+#include "Toolpath_Source.hpp"
+
+#include <map>
+#include "lib3mf_dynamic.hpp"
+
+namespace Toolpath {
+
+	/**
+	 * Toolpath source reading from a lib3mf toolpath.
+	 * Parts are taken from the build items and profiles from the toolpath profiles.
+	 */
+	class CToolpathSource_Lib3MF : public IToolpathSource {
+	private:
+		Lib3MF::PModel m_pModel;
+		Lib3MF::PToolpath m_pToolpath;
+		double m_dUnits;
+		uint32_t m_nLayerCount;
+
+		std::vector<CToolpathSourcePart> m_Parts;
+		std::vector<CToolpathSourceProfile> m_Profiles;
+		std::map<std::string, uint32_t> m_PartIndicesByUUID;
+		std::map<std::string, uint32_t> m_ProfileIndicesByUUID;
+
+		PToolpathStatistics m_pStatistics;
+
+		// Buffers reused across segments and layers
+		std::vector<Lib3MF::sPosition2D> m_PointBuffer;
+		std::vector<Lib3MF::sHatch2D> m_HatchBuffer;
+		std::vector<sToolpathHatch2D> m_ConvertedHatchBuffer;
+
+		// lib3mf specifies no point data for arc segments, so they are skipped and counted
+		uint64_t m_nSkippedArcSegmentCount;
+
+		uint32_t findPartIndex(const std::string& sBuildItemUUID);
+		uint32_t findProfileIndex(const std::string& sProfileUUID);
+
+	public:
+		CToolpathSource_Lib3MF(Lib3MF::PModel pModel, Lib3MF::PToolpath pToolpath);
+		virtual ~CToolpathSource_Lib3MF() = default;
+
+		void setStatistics(PToolpathStatistics pStatistics) override;
+
+		uint64_t getSkippedArcSegmentCount();
+
+		double getUnits() override;
+
+		uint32_t getLayerCount() override;
+		double getLayerZMin(uint32_t nLayerIndex) override;
+		double getLayerZMax(uint32_t nLayerIndex) override;
+
+		uint32_t getPartCount() override;
+		const CToolpathSourcePart& getPart(uint32_t nPartIndex) override;
+
+		uint32_t getProfileCount() override;
+		const CToolpathSourceProfile& getProfile(uint32_t nProfileIndex) override;
+
+		void readLayer(uint32_t nLayerIndex, CToolpathLayerData& layerData) override;
+	};
+
+	typedef std::shared_ptr<CToolpathSource_Lib3MF> PToolpathSource_Lib3MF;
+
+} // namespace Toolpath
+
+#endif // __TOOLPATH_SOURCE_LIB3MF
@@ -0,0 +1,137 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#include "Toolpath_Source_Memory.hpp"
+
+#include <stdexcept>
+
+namespace Toolpath {
+
+	CToolpathSource_Memory::CToolpathSource_Memory(double dUnits)
+		: m_dUnits(dUnits)
+	{
+		if (dUnits <= 0.0)
+			throw std::runtime_error("invalid toolpath units");
+	}
+
+	uint32_t CToolpathSource_Memory::addPart(const CToolpathSourcePart& part)
+	{
+		m_Parts.push_back(part);
+		return (uint32_t)(m_Parts.size() - 1);
+	}
+
+	uint32_t CToolpathSource_Memory::addProfile(const CToolpathSourceProfile& profile)
+	{
+		m_Profiles.push_back(profile);
+		return (uint32_t)(m_Profiles.size() - 1);
+	}
+
+	CToolpathLayerData& CToolpathSource_Memory::addLayer(double dZMin, double dZMax)
+	{
+		if (dZMax < dZMin)
+			throw std::runtime_error("invalid layer height range");
+		if ((m_Layers.size() > 0) && (dZMin < m_Layers.back()->getZMin()))
+			throw std::runtime_error("layers must be added in ascending order");
+
+		auto pLayerData = std::make_shared<CToolpathLayerData>();
+		pLayerData->reset((uint32_t)m_Layers.size(), dZMin, dZMax);
+		m_Layers.push_back(pLayerData);
+
+		return *pLayerData;
+	}
+
+	void CToolpathSource_Memory::setStatistics(PToolpathStatistics pStatistics)
+	{
+		m_pStatistics = pStatistics;
+	}
+
+	double CToolpathSource_Memory::getUnits()
+	{
+		return m_dUnits;
+	}
+
+	uint32_t CToolpathSource_Memory::getLayerCount()
+	{
+		return (uint32_t)m_Layers.size();
+	}
+
+	double CToolpathSource_Memory::getLayerZMin(uint32_t nLayerIndex)
+	{
+		if (nLayerIndex >= m_Layers.size())
+			throw std::runtime_error("invalid layer index: " + std::to_string(nLayerIndex));
+
+		return m_Layers[nLayerIndex]->getZMin();
+	}
+
+	double CToolpathSource_Memory::getLayerZMax(uint32_t nLayerIndex)
+	{
+		if (nLayerIndex >= m_Layers.size())
+			throw std::runtime_error("invalid layer index: " + std::to_string(nLayerIndex));
+
+		return m_Layers[nLayerIndex]->getZMax();
+	}
+
+	uint32_t CToolpathSource_Memory::getPartCount()
+	{
+		return (uint32_t)m_Parts.size();
+	}
+
+	const CToolpathSourcePart& CToolpathSource_Memory::getPart(uint32_t nPartIndex)
+	{
+		if (nPartIndex >= m_Parts.size())
+			throw std::runtime_error("invalid part index: " + std::to_string(nPartIndex));
+
+		return m_Parts[nPartIndex];
+	}
+
+	uint32_t CToolpathSource_Memory::getProfileCount()
+	{
+		return (uint32_t)m_Profiles.size();
+	}
+
+	const CToolpathSourceProfile& CToolpathSource_Memory::getProfile(uint32_t nProfileIndex)
+	{
+		if (nProfileIndex >= m_Profiles.size())
+			throw std::runtime_error("invalid profile index: " + std::to_string(nProfileIndex));
+
+		return m_Profiles[nProfileIndex];
+	}
+
+	void CToolpathSource_Memory::readLayer(uint32_t nLayerIndex, CToolpathLayerData& layerData)
+	{
+		if (nLayerIndex >= m_Layers.size())
+			throw std::runtime_error("invalid layer index: " + std::to_string(nLayerIndex));
+
+		CToolpathScopedTimer extractTimer(m_pStatistics.get(), eToolpathStatisticsPhase::Extract);
+
+		// Assignment reuses the capacity of the target container
+		layerData = *m_Layers[nLayerIndex];
+	}
+
+} // namespace Toolpath
@@ -0,0 +1,82 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#ifndef __TOOLPATH_SOURCE_MEMORY
+#define __TOOLPATH_SOURCE_MEMORY
+
+#include "Toolpath_Source.hpp"
+
+namespace Toolpath {
+
+	/**
+	 * Toolpath source holding all data in memory.
+	 * Used for synthetic jobs and for running the exporters without lib3mf.
+	 */
+	class CToolpathSource_Memory : public IToolpathSource {
+	private:
+		double m_dUnits;
+
+		std::vector<PToolpathLayerData> m_Layers;
+		std::vector<CToolpathSourcePart> m_Parts;
+		std::vector<CToolpathSourceProfile> m_Profiles;
+
+		PToolpathStatistics m_pStatistics;
+
+	public:
+		CToolpathSource_Memory(double dUnits = 1.0);
+		virtual ~CToolpathSource_Memory() = default;
+
+		uint32_t addPart(const CToolpathSourcePart& part);
+		uint32_t addProfile(const CToolpathSourceProfile& profile);
+
+		// Returns the new layer for filling. Layers must be added bottom up.
+		CToolpathLayerData& addLayer(double dZMin, double dZMax);
+
+		void setStatistics(PToolpathStatistics pStatistics) override;
+
+		double getUnits() override;
+
+		uint32_t getLayerCount() override;
+		double getLayerZMin(uint32_t nLayerIndex) override;
+		double getLayerZMax(uint32_t nLayerIndex) override;
+
+		uint32_t getPartCount() override;
+		const CToolpathSourcePart& getPart(uint32_t nPartIndex) override;
+
+		uint32_t getProfileCount() override;
+		const CToolpathSourceProfile& getProfile(uint32_t nProfileIndex) override;
+
+		void readLayer(uint32_t nLayerIndex, CToolpathLayerData& layerData) override;
+	};
+
+	typedef std::shared_ptr<CToolpathSource_Memory> PToolpathSource_Memory;
+
+} // namespace Toolpath
+
+#endif // __TOOLPATH_SOURCE_MEMORY
@@ -0,0 +1,268 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#include "Toolpath_Source_Synthetic.hpp"
+
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+#define TOOLPATHSYNTHETIC_PI 3.14159265358979323846
+#define TOOLPATHSYNTHETIC_HATCHANGLEINCREMENT 67.0
+#define TOOLPATHSYNTHETIC_LOOPDISTANCE 0.1
+
+namespace Toolpath {
+
+	// SplitMix64, used instead of the standard distributions so that the sequence does not depend on the standard library
+	static uint64_t nextSyntheticRandom(uint64_t& nState)
+	{
+		nState += 0x9E3779B97F4A7C15ULL;
+		uint64_t nValue = nState;
+		nValue = (nValue ^ (nValue >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		nValue = (nValue ^ (nValue >> 27)) * 0x94D049BB133111EBULL;
+		return nValue ^ (nValue >> 31);
+	}
+
+	// Uniform value in [dMin, dMax)
+	static double nextSyntheticDouble(uint64_t& nState, double dMin, double dMax)
+	{
+		double dUnit = (double)(nextSyntheticRandom(nState) >> 11) * (1.0 / 9007199254740992.0);
+		return dMin + (dMax - dMin) * dUnit;
+	}
+
+	static std::string createSyntheticUUID(uint32_t nKind, uint32_t nIndex)
+	{
+		char szBuffer[64];
+		snprintf(szBuffer, sizeof(szBuffer), "%08x-0000-4000-8000-%012x", nKind, nIndex);
+		return szBuffer;
+	}
+
+	CToolpathSource_Synthetic::CToolpathSource_Synthetic(const sToolpathSyntheticConfiguration& configuration)
+		: m_Configuration(configuration)
+	{
+		if (configuration.m_nLayerCount == 0)
+			throw std::runtime_error("synthetic job needs at least one layer");
+		if (configuration.m_dLayerThickness <= 0.0)
+			throw std::runtime_error("invalid synthetic layer thickness");
+		if ((configuration.m_nPartCount == 0) || (configuration.m_nProfileCount == 0))
+			throw std::runtime_error("synthetic job needs at least one part and one profile");
+		if ((configuration.m_nLoopsPerLayer > 0) && (configuration.m_nPointsPerLoop < 3))
+			throw std::runtime_error("synthetic loops need at least three points");
+		if (configuration.m_dPlateSize <= 0.0)
+			throw std::runtime_error("invalid synthetic plate size");
+
+		double dRadius = getPartMaxRadius();
+		double dHeight = configuration.m_nLayerCount * configuration.m_dLayerThickness;
+
+		for (uint32_t nPartIndex = 0; nPartIndex < configuration.m_nPartCount; nPartIndex++) {
+			CToolpathSourcePart part("Part " + std::to_string(nPartIndex + 1), createSyntheticUUID(1, nPartIndex));
+			double dCenterX = getPartCenter(nPartIndex, 0);
+			double dCenterY = getPartCenter(nPartIndex, 1);
+			part.setOutbox(dCenterX - dRadius, dCenterY - dRadius, 0.0, dCenterX + dRadius, dCenterY + dRadius, dHeight);
+			m_Parts.push_back(part);
+		}
+
+		uint64_t nProfileState = configuration.m_nSeed;
+		for (uint32_t nProfileIndex = 0; nProfileIndex < configuration.m_nProfileCount; nProfileIndex++) {
+			CToolpathSourceProfile profile(createSyntheticUUID(2, nProfileIndex), "Profile " + std::to_string(nProfileIndex + 1));
+			profile.setParameterValue("", "laserpower", std::to_string((int)nextSyntheticDouble(nProfileState, 150.0, 350.0)));
+			profile.setParameterValue("", "laserspeed", std::to_string((int)nextSyntheticDouble(nProfileState, 600.0, 1400.0)));
+			profile.setParameterValue("", "jumpspeed", "5000");
+			m_Profiles.push_back(profile);
+		}
+	}
+
+	sToolpathSyntheticConfiguration CToolpathSource_Synthetic::getDefaultConfiguration()
+	{
+		sToolpathSyntheticConfiguration configuration;
+		configuration.m_nSeed = 1;
+		configuration.m_nLayerCount = 10000;
+		configuration.m_dLayerThickness = 0.03;
+		configuration.m_nPartCount = 200;
+		configuration.m_nProfileCount = 100;
+		configuration.m_nLoopsPerLayer = 2000;
+		configuration.m_nPointsPerLoop = 64;
+		configuration.m_nHatchesPerLayer = 100000;
+		configuration.m_dPlateSize = 400.0;
+		return configuration;
+	}
+
+	const sToolpathSyntheticConfiguration& CToolpathSource_Synthetic::getConfiguration()
+	{
+		return m_Configuration;
+	}
+
+	double CToolpathSource_Synthetic::getPartCenter(uint32_t nPartIndex, uint32_t nAxis)
+	{
+		uint32_t nGridSize = (uint32_t)ceil(sqrt((double)m_Configuration.m_nPartCount));
+		double dCellSize = m_Configuration.m_dPlateSize / nGridSize;
+		uint32_t nCell = (nAxis == 0) ? (nPartIndex % nGridSize) : (nPartIndex / nGridSize);
+
+		return -0.5 * m_Configuration.m_dPlateSize + (nCell + 0.5) * dCellSize;
+	}
+
+	double CToolpathSource_Synthetic::getPartMaxRadius()
+	{
+		uint32_t nGridSize = (uint32_t)ceil(sqrt((double)m_Configuration.m_nPartCount));
+		return 0.4 * m_Configuration.m_dPlateSize / nGridSize;
+	}
+
+	void CToolpathSource_Synthetic::setStatistics(PToolpathStatistics pStatistics)
+	{
+		m_pStatistics = pStatistics;
+	}
+
+	double CToolpathSource_Synthetic::getUnits()
+	{
+		return 0.001;
+	}
+
+	uint32_t CToolpathSource_Synthetic::getLayerCount()
+	{
+		return m_Configuration.m_nLayerCount;
+	}
+
+	double CToolpathSource_Synthetic::getLayerZMin(uint32_t nLayerIndex)
+	{
+		if (nLayerIndex >= m_Configuration.m_nLayerCount)
+			throw std::runtime_error("invalid layer index: " + std::to_string(nLayerIndex));
+
+		return nLayerIndex * m_Configuration.m_dLayerThickness;
+	}
+
+	double CToolpathSource_Synthetic::getLayerZMax(uint32_t nLayerIndex)
+	{
+		if (nLayerIndex >= m_Configuration.m_nLayerCount)
+			throw std::runtime_error("invalid layer index: " + std::to_string(nLayerIndex));
+
+		return (nLayerIndex + 1) * m_Configuration.m_dLayerThickness;
+	}
+
+	uint32_t CToolpathSource_Synthetic::getPartCount()
+	{
+		return (uint32_t)m_Parts.size();
+	}
+
+	const CToolpathSourcePart& CToolpathSource_Synthetic::getPart(uint32_t nPartIndex)
+	{
+		if (nPartIndex >= m_Parts.size())
+			throw std::runtime_error("invalid part index: " + std::to_string(nPartIndex));
+
+		return m_Parts[nPartIndex];
+	}
+
+	uint32_t CToolpathSource_Synthetic::getProfileCount()
+	{
+		return (uint32_t)m_Profiles.size();
+	}
+
+	const CToolpathSourceProfile& CToolpathSource_Synthetic::getProfile(uint32_t nProfileIndex)
+	{
+		if (nProfileIndex >= m_Profiles.size())
+			throw std::runtime_error("invalid profile index: " + std::to_string(nProfileIndex));
+
+		return m_Profiles[nProfileIndex];
+	}
+
+	void CToolpathSource_Synthetic::readLayer(uint32_t nLayerIndex, CToolpathLayerData& layerData)
+	{
+		if (nLayerIndex >= m_Configuration.m_nLayerCount)
+			throw std::runtime_error("invalid layer index: " + std::to_string(nLayerIndex));
+
+		CToolpathScopedTimer extractTimer(m_pStatistics.get(), eToolpathStatisticsPhase::Extract);
+
+		layerData.reset(nLayerIndex, getLayerZMin(nLayerIndex), getLayerZMax(nLayerIndex));
+
+		// Every layer has its own random sequence, independent of the read order
+		uint64_t nState = m_Configuration.m_nSeed ^ ((uint64_t)(nLayerIndex + 1) * 0xD1B54A32D192ED03ULL);
+
+		uint32_t nPartCount = m_Configuration.m_nPartCount;
+		double dZ = getLayerZMax(nLayerIndex);
+		double dHatchAngle = fmod(nLayerIndex * TOOLPATHSYNTHETIC_HATCHANGLEINCREMENT, 180.0) * TOOLPATHSYNTHETIC_PI / 180.0;
+		double dDirectionX = cos(dHatchAngle);
+		double dDirectionY = sin(dHatchAngle);
+
+		for (uint32_t nPartIndex = 0; nPartIndex < nPartCount; nPartIndex++) {
+			double dCenterX = getPartCenter(nPartIndex, 0);
+			double dCenterY = getPartCenter(nPartIndex, 1);
+			// Cross section varies slowly with the height and differs between parts
+			double dRadius = getPartMaxRadius() * (0.8 + 0.2 * sin(dZ * 0.5 + nPartIndex));
+
+			uint32_t nLoopProfileIndex = (2 * nPartIndex) % m_Configuration.m_nProfileCount;
+			uint32_t nHatchProfileIndex = (2 * nPartIndex + 1) % m_Configuration.m_nProfileCount;
+
+			uint32_t nLoopCount = m_Configuration.m_nLoopsPerLayer / nPartCount + ((nPartIndex < m_Configuration.m_nLoopsPerLayer % nPartCount) ? 1 : 0);
+			uint32_t nHatchCount = m_Configuration.m_nHatchesPerLayer / nPartCount + ((nPartIndex < m_Configuration.m_nHatchesPerLayer % nPartCount) ? 1 : 0);
+
+			// Concentric contours from the outside in
+			m_PointBuffer.resize(m_Configuration.m_nPointsPerLoop);
+			for (uint32_t nLoopIndex = 0; nLoopIndex < nLoopCount; nLoopIndex++) {
+				double dLoopRadius = std::max(dRadius - nLoopIndex * TOOLPATHSYNTHETIC_LOOPDISTANCE, 0.1 * dRadius);
+				double dStartAngle = nextSyntheticDouble(nState, 0.0, 2.0 * TOOLPATHSYNTHETIC_PI);
+
+				for (uint32_t nPointIndex = 0; nPointIndex < m_Configuration.m_nPointsPerLoop; nPointIndex++) {
+					double dAngle = dStartAngle + 2.0 * TOOLPATHSYNTHETIC_PI * nPointIndex / m_Configuration.m_nPointsPerLoop;
+					double dPointRadius = dLoopRadius + nextSyntheticDouble(nState, -0.01, 0.01);
+					m_PointBuffer[nPointIndex].m_Coordinates[0] = (float)(dCenterX + dPointRadius * cos(dAngle));
+					m_PointBuffer[nPointIndex].m_Coordinates[1] = (float)(dCenterY + dPointRadius * sin(dAngle));
+				}
+
+				layerData.addPolyline(eToolpathSegmentType::Loop, nPartIndex, nLoopProfileIndex, m_PointBuffer.data(), (uint32_t)m_PointBuffer.size());
+			}
+
+			if (nHatchCount == 0)
+				continue;
+
+			// Parallel infill lines inside the innermost contour, in alternating direction
+			double dHatchRadius = std::max(dRadius - nLoopCount * TOOLPATHSYNTHETIC_LOOPDISTANCE, 0.1 * dRadius);
+			double dHatchDistance = 2.0 * dHatchRadius / nHatchCount;
+
+			m_HatchBuffer.resize(nHatchCount);
+			for (uint32_t nHatchIndex = 0; nHatchIndex < nHatchCount; nHatchIndex++) {
+				double dOffset = -dHatchRadius + (nHatchIndex + 0.5) * dHatchDistance;
+				double dHalfLength = sqrt(std::max(dHatchRadius * dHatchRadius - dOffset * dOffset, 0.0)) * nextSyntheticDouble(nState, 0.98, 1.0);
+				if (nHatchIndex % 2 == 1)
+					dHalfLength = -dHalfLength;
+
+				double dMidX = dCenterX - dDirectionY * dOffset;
+				double dMidY = dCenterY + dDirectionX * dOffset;
+
+				auto& hatch = m_HatchBuffer[nHatchIndex];
+				hatch.m_Point1Coordinates[0] = dMidX - dDirectionX * dHalfLength;
+				hatch.m_Point1Coordinates[1] = dMidY - dDirectionY * dHalfLength;
+				hatch.m_Point2Coordinates[0] = dMidX + dDirectionX * dHalfLength;
+				hatch.m_Point2Coordinates[1] = dMidY + dDirectionY * dHalfLength;
+			}
+
+			layerData.addHatches(nPartIndex, nHatchProfileIndex, m_HatchBuffer.data(), nHatchCount);
+		}
+	}
+
+} // namespace Toolpath
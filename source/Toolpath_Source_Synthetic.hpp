@@ -0,0 +1,102 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#ifndef __TOOLPATH_SOURCE_SYNTHETIC
+#define __TOOLPATH_SOURCE_SYNTHETIC
+
+#include "Toolpath_Source.hpp"
+
+namespace Toolpath {
+
+	/**
+	 * Size of a generated job. The defaults resemble a large production build.
+	 */
+	typedef struct _sToolpathSyntheticConfiguration {
+		uint64_t m_nSeed;
+		uint32_t m_nLayerCount;
+		double m_dLayerThickness;
+		uint32_t m_nPartCount;
+		uint32_t m_nProfileCount;
+		uint32_t m_nLoopsPerLayer;
+		uint32_t m_nPointsPerLoop;
+		uint32_t m_nHatchesPerLayer;
+		double m_dPlateSize;
+	} sToolpathSyntheticConfiguration;
+
+	/**
+	 * Deterministic toolpath source for load tests. Parts are cylinders with a varying
+	 * radius on a square plate, every layer has contour loops and a rotating hatch infill.
+	 * Layers are generated on demand from the seed and the layer index, so any layer can be
+	 * read in any order and the output is identical across runs.
+	 */
+	class CToolpathSource_Synthetic : public IToolpathSource {
+	private:
+		sToolpathSyntheticConfiguration m_Configuration;
+
+		std::vector<CToolpathSourcePart> m_Parts;
+		std::vector<CToolpathSourceProfile> m_Profiles;
+
+		std::vector<sToolpathPoint2D> m_PointBuffer;
+		std::vector<sToolpathHatch2D> m_HatchBuffer;
+
+		PToolpathStatistics m_pStatistics;
+
+		double getPartCenter(uint32_t nPartIndex, uint32_t nAxis);
+		double getPartMaxRadius();
+
+	public:
+		CToolpathSource_Synthetic(const sToolpathSyntheticConfiguration& configuration);
+		virtual ~CToolpathSource_Synthetic() = default;
+
+		static sToolpathSyntheticConfiguration getDefaultConfiguration();
+
+		const sToolpathSyntheticConfiguration& getConfiguration();
+
+		void setStatistics(PToolpathStatistics pStatistics) override;
+
+		double getUnits() override;
+
+		uint32_t getLayerCount() override;
+		double getLayerZMin(uint32_t nLayerIndex) override;
+		double getLayerZMax(uint32_t nLayerIndex) override;
+
+		uint32_t getPartCount() override;
+		const CToolpathSourcePart& getPart(uint32_t nPartIndex) override;
+
+		uint32_t getProfileCount() override;
+		const CToolpathSourceProfile& getProfile(uint32_t nProfileIndex) override;
+
+		void readLayer(uint32_t nLayerIndex, CToolpathLayerData& layerData) override;
+	};
+
+	typedef std::shared_ptr<CToolpathSource_Synthetic> PToolpathSource_Synthetic;
+
+} // namespace Toolpath
+
+#endif // __TOOLPATH_SOURCE_SYNTHETIC
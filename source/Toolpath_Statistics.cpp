@@ -0,0 +1,286 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#include "Toolpath_Statistics.hpp"
+
+#include <fstream>
+#include <stdexcept>
+#include <algorithm>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+namespace Toolpath {
+
+	CToolpathStatistics::CToolpathStatistics()
+		: m_nLayerCount(0)
+		, m_nSegmentCount(0)
+		, m_nPointCount(0)
+		, m_nHatchCount(0)
+		, m_nOutputSize(0)
+		, m_nStopTimeInNanoseconds(0)
+	{
+		for (auto& phase : m_Phases) {
+			phase.m_nWallTimeInNanoseconds.store(0);
+			phase.m_nCPUTimeInNanoseconds.store(0);
+			phase.m_nCallCount.store(0);
+		}
+
+		m_nStartTimeInNanoseconds = getWallTimeInNanoseconds();
+	}
+
+	void CToolpathStatistics::addPhaseTime(eToolpathStatisticsPhase phase, uint64_t nWallTimeInNanoseconds, uint64_t nCPUTimeInNanoseconds)
+	{
+		uint32_t nPhaseIndex = (uint32_t)phase;
+		if (nPhaseIndex >= TOOLPATHSTATISTICS_PHASECOUNT)
+			throw std::runtime_error("invalid statistics phase: " + std::to_string(nPhaseIndex));
+
+		auto& accumulator = m_Phases[nPhaseIndex];
+		accumulator.m_nWallTimeInNanoseconds.fetch_add(nWallTimeInNanoseconds, std::memory_order_relaxed);
+		accumulator.m_nCPUTimeInNanoseconds.fetch_add(nCPUTimeInNanoseconds, std::memory_order_relaxed);
+		accumulator.m_nCallCount.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void CToolpathStatistics::addLayers(uint64_t nCount)
+	{
+		m_nLayerCount.fetch_add(nCount, std::memory_order_relaxed);
+	}
+
+	void CToolpathStatistics::addSegments(uint64_t nCount)
+	{
+		m_nSegmentCount.fetch_add(nCount, std::memory_order_relaxed);
+	}
+
+	void CToolpathStatistics::addPoints(uint64_t nCount)
+	{
+		m_nPointCount.fetch_add(nCount, std::memory_order_relaxed);
+	}
+
+	void CToolpathStatistics::addHatches(uint64_t nCount)
+	{
+		m_nHatchCount.fetch_add(nCount, std::memory_order_relaxed);
+	}
+
+	void CToolpathStatistics::addZIPEntry(const std::string& sName, uint64_t nUncompressedSize, uint64_t nCompressedSize)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		sToolpathStatisticsZIPEntry entry;
+		entry.m_sName = sName;
+		entry.m_nUncompressedSize = nUncompressedSize;
+		entry.m_nCompressedSize = nCompressedSize;
+		m_ZIPEntries.push_back(entry);
+	}
+
+	void CToolpathStatistics::setOutputSize(uint64_t nOutputSize)
+	{
+		m_nOutputSize.store(nOutputSize);
+	}
+
+	void CToolpathStatistics::setInformation(const std::string& sKey, const std::string& sValue)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		for (auto& information : m_Information) {
+			if (information.first == sKey) {
+				information.second = sValue;
+				return;
+			}
+		}
+
+		m_Information.push_back(std::make_pair(sKey, sValue));
+	}
+
+	void CToolpathStatistics::setProcessingValue(const std::string& sStage, const std::string& sName, double dValue)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		auto iStageIter = std::find_if(m_ProcessingValues.begin(), m_ProcessingValues.end(),
+			[&sStage](const std::pair<std::string, std::vector<std::pair<std::string, double>>>& stage) { return stage.first == sStage; });
+		if (iStageIter == m_ProcessingValues.end())
+			iStageIter = m_ProcessingValues.insert(m_ProcessingValues.end(), std::make_pair(sStage, std::vector<std::pair<std::string, double>>()));
+
+		for (auto& value : iStageIter->second) {
+			if (value.first == sName) {
+				value.second = dValue;
+				return;
+			}
+		}
+
+		iStageIter->second.push_back(std::make_pair(sName, dValue));
+	}
+
+	void CToolpathStatistics::stop()
+	{
+		if (m_nStopTimeInNanoseconds == 0)
+			m_nStopTimeInNanoseconds = getWallTimeInNanoseconds();
+	}
+
+	void CToolpathStatistics::writeToJSON(CToolpathJSONWriter& jsonWriter)
+	{
+		stop();
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		double dTotalWallTime = (double)(m_nStopTimeInNanoseconds - m_nStartTimeInNanoseconds) * 1.0e-9;
+		uint64_t nLayerCount = m_nLayerCount.load();
+		uint64_t nSegmentCount = m_nSegmentCount.load();
+		uint64_t nPointCount = m_nPointCount.load();
+		uint64_t nHatchCount = m_nHatchCount.load();
+
+		jsonWriter.beginObject();
+
+		jsonWriter.beginObject("information");
+		for (auto& information : m_Information)
+			jsonWriter.writeString(information.first, information.second);
+		jsonWriter.endObject();
+
+		jsonWriter.writeDouble("wallTime", dTotalWallTime);
+
+		jsonWriter.beginObject("phases");
+		for (uint32_t nPhaseIndex = 0; nPhaseIndex < TOOLPATHSTATISTICS_PHASECOUNT; nPhaseIndex++) {
+			auto& accumulator = m_Phases[nPhaseIndex];
+			jsonWriter.beginObject(getPhaseName((eToolpathStatisticsPhase)nPhaseIndex));
+			jsonWriter.writeDouble("wallTime", (double)accumulator.m_nWallTimeInNanoseconds.load() * 1.0e-9);
+			jsonWriter.writeDouble("cpuTime", (double)accumulator.m_nCPUTimeInNanoseconds.load() * 1.0e-9);
+			jsonWriter.writeUint64("calls", accumulator.m_nCallCount.load());
+			jsonWriter.endObject();
+		}
+		jsonWriter.endObject();
+
+		jsonWriter.beginObject("counters");
+		jsonWriter.writeUint64("layers", nLayerCount);
+		jsonWriter.writeUint64("segments", nSegmentCount);
+		jsonWriter.writeUint64("points", nPointCount);
+		jsonWriter.writeUint64("hatches", nHatchCount);
+		jsonWriter.endObject();
+
+		if (!m_ProcessingValues.empty()) {
+			jsonWriter.beginObject("processing");
+			for (auto& stage : m_ProcessingValues) {
+				jsonWriter.beginObject(stage.first);
+				for (auto& value : stage.second)
+					jsonWriter.writeDouble(value.first, value.second);
+				jsonWriter.endObject();
+			}
+			jsonWriter.endObject();
+		}
+
+		jsonWriter.beginObject("throughput");
+		if (dTotalWallTime > 0.0) {
+			jsonWriter.writeDouble("layersPerSecond", (double)nLayerCount / dTotalWallTime);
+			jsonWriter.writeDouble("segmentsPerSecond", (double)nSegmentCount / dTotalWallTime);
+			jsonWriter.writeDouble("pointsPerSecond", (double)nPointCount / dTotalWallTime);
+		}
+		jsonWriter.endObject();
+
+		uint64_t nTotalUncompressedSize = 0;
+		uint64_t nTotalCompressedSize = 0;
+
+		jsonWriter.beginObject("output");
+		jsonWriter.writeUint64("fileSize", m_nOutputSize.load());
+		jsonWriter.beginArray("zipEntries");
+		for (auto& entry : m_ZIPEntries) {
+			jsonWriter.beginObject();
+			jsonWriter.writeString("name", entry.m_sName);
+			jsonWriter.writeUint64("uncompressedSize", entry.m_nUncompressedSize);
+			jsonWriter.writeUint64("compressedSize", entry.m_nCompressedSize);
+			if (entry.m_nCompressedSize > 0)
+				jsonWriter.writeDouble("compressionRatio", (double)entry.m_nUncompressedSize / (double)entry.m_nCompressedSize);
+			jsonWriter.endObject();
+
+			nTotalUncompressedSize += entry.m_nUncompressedSize;
+			nTotalCompressedSize += entry.m_nCompressedSize;
+		}
+		jsonWriter.endArray();
+		jsonWriter.writeUint64("uncompressedSize", nTotalUncompressedSize);
+		jsonWriter.writeUint64("compressedSize", nTotalCompressedSize);
+		jsonWriter.endObject();
+
+		jsonWriter.endObject();
+	}
+
+	void CToolpathStatistics::writeToFile(const std::string& sFileName)
+	{
+		std::ofstream stream(sFileName, std::ios::out | std::ios::trunc);
+		if (!stream.is_open())
+			throw std::runtime_error("Failed to open statistics file: " + sFileName);
+
+		CToolpathJSONWriter jsonWriter(stream);
+		writeToJSON(jsonWriter);
+
+		if (!stream.good())
+			throw std::runtime_error("Failed to write statistics file: " + sFileName);
+	}
+
+	std::string CToolpathStatistics::getPhaseName(eToolpathStatisticsPhase phase)
+	{
+		switch (phase) {
+		case eToolpathStatisticsPhase::Decode: return "decode";
+		case eToolpathStatisticsPhase::Extract: return "extract";
+		case eToolpathStatisticsPhase::Encode: return "encode";
+		case eToolpathStatisticsPhase::XMLMetaData: return "xmlMetaData";
+		case eToolpathStatisticsPhase::Deflate: return "deflate";
+		case eToolpathStatisticsPhase::DiskIO: return "diskIO";
+		default:
+			throw std::runtime_error("invalid statistics phase: " + std::to_string((uint32_t)phase));
+		}
+	}
+
+	uint64_t CToolpathStatistics::getWallTimeInNanoseconds()
+	{
+		return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	uint64_t CToolpathStatistics::getThreadCPUTimeInNanoseconds()
+	{
+#ifdef _WIN32
+		FILETIME creationTime, exitTime, kernelTime, userTime;
+		if (!GetThreadTimes(GetCurrentThread(), &creationTime, &exitTime, &kernelTime, &userTime))
+			return 0;
+
+		uint64_t nKernelTime = ((uint64_t)kernelTime.dwHighDateTime << 32) | kernelTime.dwLowDateTime;
+		uint64_t nUserTime = ((uint64_t)userTime.dwHighDateTime << 32) | userTime.dwLowDateTime;
+
+		// FILETIME is given in 100 nanosecond intervals
+		return (nKernelTime + nUserTime) * 100;
+#else
+		struct timespec cpuTime;
+		if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpuTime) != 0)
+			return 0;
+
+		return (uint64_t)cpuTime.tv_sec * 1000000000ULL + (uint64_t)cpuTime.tv_nsec;
+#endif
+	}
+
+} // namespace Toolpath
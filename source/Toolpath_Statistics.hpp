@@ -0,0 +1,172 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#ifndef __TOOLPATH_STATISTICS
+#define __TOOLPATH_STATISTICS
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <array>
+#include <map>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <chrono>
+
+#include "Toolpath_JSONWriter.hpp"
+
+namespace Toolpath {
+
+	/**
+	 * Phases of a conversion that are timed separately.
+	 */
+	enum class eToolpathStatisticsPhase : uint32_t {
+		Decode = 0,       // Reading the 3MF package and layer data with lib3mf
+		Extract = 1,      // Fetching segment, point and hatch data from the layer readers
+		Encode = 2,       // Encoding geometry into the output format
+		XMLMetaData = 3,  // Generating XML metadata documents
+		Deflate = 4,      // Compressing ZIP entries
+		DiskIO = 5        // Writing to the output file
+	};
+
+	#define TOOLPATHSTATISTICS_PHASECOUNT 6
+
+	typedef struct _sToolpathStatisticsZIPEntry {
+		std::string m_sName;
+		uint64_t m_nUncompressedSize;
+		uint64_t m_nCompressedSize;
+	} sToolpathStatisticsZIPEntry;
+
+	/**
+	 * Collects phase timings and counters of one conversion job.
+	 * All recording methods are thread safe. Phase times are summed over all threads,
+	 * so the time of a parallel phase may exceed the total wall time of the job.
+	 */
+	class CToolpathStatistics {
+	private:
+		typedef struct _sPhaseAccumulator {
+			std::atomic<uint64_t> m_nWallTimeInNanoseconds;
+			std::atomic<uint64_t> m_nCPUTimeInNanoseconds;
+			std::atomic<uint64_t> m_nCallCount;
+		} sPhaseAccumulator;
+
+		std::array<sPhaseAccumulator, TOOLPATHSTATISTICS_PHASECOUNT> m_Phases;
+
+		std::atomic<uint64_t> m_nLayerCount;
+		std::atomic<uint64_t> m_nSegmentCount;
+		std::atomic<uint64_t> m_nPointCount;
+		std::atomic<uint64_t> m_nHatchCount;
+		std::atomic<uint64_t> m_nOutputSize;
+
+		std::mutex m_Mutex;
+		std::vector<sToolpathStatisticsZIPEntry> m_ZIPEntries;
+		std::vector<std::pair<std::string, std::string>> m_Information;
+		std::vector<std::pair<std::string, std::vector<std::pair<std::string, double>>>> m_ProcessingValues;
+
+		uint64_t m_nStartTimeInNanoseconds;
+		uint64_t m_nStopTimeInNanoseconds;
+
+	public:
+		CToolpathStatistics();
+		virtual ~CToolpathStatistics() = default;
+
+		void addPhaseTime(eToolpathStatisticsPhase phase, uint64_t nWallTimeInNanoseconds, uint64_t nCPUTimeInNanoseconds);
+
+		void addLayers(uint64_t nCount);
+		void addSegments(uint64_t nCount);
+		void addPoints(uint64_t nCount);
+		void addHatches(uint64_t nCount);
+
+		void addZIPEntry(const std::string& sName, uint64_t nUncompressedSize, uint64_t nCompressedSize);
+		void setOutputSize(uint64_t nOutputSize);
+
+		// Free-form job information, written in insertion order
+		void setInformation(const std::string& sKey, const std::string& sValue);
+
+		// Results of a layer processing stage, grouped by stage and written in insertion order
+		void setProcessingValue(const std::string& sStage, const std::string& sName, double dValue);
+
+		// Stops the total job clock; called implicitly by writeToJSON if omitted
+		void stop();
+
+		void writeToJSON(CToolpathJSONWriter& jsonWriter);
+		void writeToFile(const std::string& sFileName);
+
+		static std::string getPhaseName(eToolpathStatisticsPhase phase);
+		static uint64_t getWallTimeInNanoseconds();
+		static uint64_t getThreadCPUTimeInNanoseconds();
+	};
+
+	typedef std::shared_ptr<CToolpathStatistics> PToolpathStatistics;
+
+	/**
+	 * Adds the wall and CPU time of its lifetime to a phase.
+	 * Does nothing if no statistics object is given.
+	 */
+	class CToolpathScopedTimer {
+	private:
+		CToolpathStatistics* m_pStatistics;
+		eToolpathStatisticsPhase m_Phase;
+		uint64_t m_nStartWallTime;
+		uint64_t m_nStartCPUTime;
+
+	public:
+		CToolpathScopedTimer(CToolpathStatistics* pStatistics, eToolpathStatisticsPhase phase)
+			: m_pStatistics(pStatistics), m_Phase(phase), m_nStartWallTime(0), m_nStartCPUTime(0)
+		{
+			if (m_pStatistics != nullptr) {
+				m_nStartWallTime = CToolpathStatistics::getWallTimeInNanoseconds();
+				m_nStartCPUTime = CToolpathStatistics::getThreadCPUTimeInNanoseconds();
+			}
+		}
+
+		~CToolpathScopedTimer()
+		{
+			stop();
+		}
+
+		// Records the elapsed time before the end of the scope; later calls have no effect
+		void stop()
+		{
+			if (m_pStatistics != nullptr) {
+				uint64_t nWallTime = CToolpathStatistics::getWallTimeInNanoseconds() - m_nStartWallTime;
+				uint64_t nCPUTime = CToolpathStatistics::getThreadCPUTimeInNanoseconds() - m_nStartCPUTime;
+				m_pStatistics->addPhaseTime(m_Phase, nWallTime, nCPUTime);
+				m_pStatistics = nullptr;
+			}
+		}
+
+		CToolpathScopedTimer(const CToolpathScopedTimer&) = delete;
+		CToolpathScopedTimer& operator=(const CToolpathScopedTimer&) = delete;
+	};
+
+} // namespace Toolpath
+
+#endif // __TOOLPATH_STATISTICS
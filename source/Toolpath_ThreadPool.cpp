@@ -0,0 +1,104 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#include "Toolpath_ThreadPool.hpp"
+
+#include <stdexcept>
+
+namespace Toolpath {
+
+	CToolpathThreadPool::CToolpathThreadPool(uint32_t nThreadCount)
+		: m_bIsShuttingDown(false)
+	{
+		if (nThreadCount > 1) {
+			for (uint32_t nThreadIndex = 0; nThreadIndex < nThreadCount; nThreadIndex++)
+				m_Workers.push_back(std::thread(&CToolpathThreadPool::workerLoop, this));
+		}
+	}
+
+	CToolpathThreadPool::~CToolpathThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_bIsShuttingDown = true;
+		}
+		m_TaskAvailable.notify_all();
+
+		for (auto& worker : m_Workers)
+			worker.join();
+	}
+
+	uint32_t CToolpathThreadPool::getThreadCount()
+	{
+		if (m_Workers.empty())
+			return 1;
+
+		return (uint32_t)m_Workers.size();
+	}
+
+	bool CToolpathThreadPool::isSynchronous()
+	{
+		return m_Workers.empty();
+	}
+
+	void CToolpathThreadPool::workerLoop()
+	{
+		while (true) {
+			std::function<void()> task;
+
+			{
+				std::unique_lock<std::mutex> lock(m_Mutex);
+				m_TaskAvailable.wait(lock, [this]() { return m_bIsShuttingDown || !m_Tasks.empty(); });
+
+				// Remaining tasks are still executed on shutdown, so that no future is left without a value
+				if (m_Tasks.empty())
+					return;
+
+				task = std::move(m_Tasks.front());
+				m_Tasks.pop_front();
+			}
+
+			// Exceptions are transported to the caller by the packaged task
+			task();
+		}
+	}
+
+	uint32_t CToolpathThreadPool::resolveThreadCount(uint32_t nRequestedThreadCount)
+	{
+		if (nRequestedThreadCount == 0) {
+			uint32_t nHardwareThreads = std::thread::hardware_concurrency();
+			if (nHardwareThreads == 0)
+				nHardwareThreads = 1;
+			return nHardwareThreads;
+		}
+
+		return nRequestedThreadCount;
+	}
+
+} // namespace Toolpath
@@ -0,0 +1,101 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#ifndef __TOOLPATH_THREADPOOL
+#define __TOOLPATH_THREADPOOL
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <stdexcept>
+
+namespace Toolpath {
+
+	/**
+	 * Fixed-size worker pool.
+	 * With a thread count of 0 or 1, tasks are executed synchronously on the calling thread,
+	 * so that single-threaded conversions behave exactly as before.
+	 */
+	class CToolpathThreadPool {
+	private:
+		std::vector<std::thread> m_Workers;
+		std::deque<std::function<void()>> m_Tasks;
+		std::mutex m_Mutex;
+		std::condition_variable m_TaskAvailable;
+		bool m_bIsShuttingDown;
+
+		void workerLoop();
+
+	public:
+		CToolpathThreadPool(uint32_t nThreadCount);
+		virtual ~CToolpathThreadPool();
+
+		uint32_t getThreadCount();
+
+		bool isSynchronous();
+
+		template <typename FunctionType>
+		std::future<typename std::result_of<FunctionType()>::type> submit(FunctionType function)
+		{
+			typedef typename std::result_of<FunctionType()>::type ResultType;
+
+			auto pTask = std::make_shared<std::packaged_task<ResultType()>>(std::move(function));
+			std::future<ResultType> taskFuture = pTask->get_future();
+
+			if (m_Workers.empty()) {
+				(*pTask)();
+				return taskFuture;
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(m_Mutex);
+				if (m_bIsShuttingDown)
+					throw std::runtime_error("thread pool is shutting down");
+				m_Tasks.push_back([pTask]() { (*pTask)(); });
+			}
+			m_TaskAvailable.notify_one();
+
+			return taskFuture;
+		}
+
+		// Resolves a user supplied thread count. 0 means one thread per hardware core.
+		static uint32_t resolveThreadCount(uint32_t nRequestedThreadCount);
+	};
+
+	typedef std::shared_ptr<CToolpathThreadPool> PToolpathThreadPool;
+
+} // namespace Toolpath
+
+#endif // __TOOLPATH_THREADPOOL
@@ -0,0 +1,159 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#include "Toolpath_Trace.hpp"
+#include "Toolpath_JSONWriter.hpp"
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <chrono>
+#include <fstream>
+#include <stdexcept>
+
+namespace Toolpath {
+
+	typedef struct _sToolpathTraceEvent {
+		const char* m_pszName;
+		const char* m_pszArgumentName;
+		int64_t m_nArgumentValue;
+		uint64_t m_nTimeStampInNanoseconds;
+		bool m_bIsBegin;
+	} sToolpathTraceEvent;
+
+	// Events of one thread. Only the owning thread appends to it.
+	typedef struct _sToolpathTraceBuffer {
+		uint32_t m_nThreadID;
+		std::deque<sToolpathTraceEvent> m_Events;
+	} sToolpathTraceBuffer;
+
+	static std::mutex s_TraceBufferMutex;
+	static std::vector<std::shared_ptr<sToolpathTraceBuffer>> s_TraceBuffers;
+	static std::chrono::steady_clock::time_point s_TraceStartTime;
+
+	std::atomic<bool> CToolpathTrace::s_bIsEnabled(false);
+
+	static sToolpathTraceBuffer* getThreadTraceBuffer()
+	{
+		thread_local sToolpathTraceBuffer* pThreadBuffer = nullptr;
+
+		if (pThreadBuffer == nullptr) {
+			auto pNewBuffer = std::make_shared<sToolpathTraceBuffer>();
+
+			std::lock_guard<std::mutex> lock(s_TraceBufferMutex);
+			pNewBuffer->m_nThreadID = (uint32_t)s_TraceBuffers.size() + 1;
+			s_TraceBuffers.push_back(pNewBuffer);
+			pThreadBuffer = pNewBuffer.get();
+		}
+
+		return pThreadBuffer;
+	}
+
+	static void recordTraceEvent(const char* pszName, const char* pszArgumentName, int64_t nArgumentValue, bool bIsBegin)
+	{
+		sToolpathTraceEvent event;
+		event.m_pszName = pszName;
+		event.m_pszArgumentName = pszArgumentName;
+		event.m_nArgumentValue = nArgumentValue;
+		event.m_nTimeStampInNanoseconds = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now() - s_TraceStartTime).count();
+		event.m_bIsBegin = bIsBegin;
+
+		getThreadTraceBuffer()->m_Events.push_back(event);
+	}
+
+	void CToolpathTrace::enable()
+	{
+		s_TraceStartTime = std::chrono::steady_clock::now();
+		s_bIsEnabled.store(true);
+
+		// Registers the enabling thread first, so that it is listed as main thread
+		getThreadTraceBuffer();
+	}
+
+	void CToolpathTrace::beginSpan(const char* pszName, const char* pszArgumentName, int64_t nArgumentValue)
+	{
+		recordTraceEvent(pszName, pszArgumentName, nArgumentValue, true);
+	}
+
+	void CToolpathTrace::endSpan(const char* pszName)
+	{
+		recordTraceEvent(pszName, nullptr, 0, false);
+	}
+
+	void CToolpathTrace::writeToFile(const std::string& sFileName)
+	{
+		std::ofstream stream(sFileName, std::ios::out | std::ios::trunc);
+		if (!stream.is_open())
+			throw std::runtime_error("Failed to open trace file: " + sFileName);
+
+		std::lock_guard<std::mutex> lock(s_TraceBufferMutex);
+
+		CToolpathJSONWriter jsonWriter(stream);
+		jsonWriter.beginObject();
+		jsonWriter.writeString("displayTimeUnit", "ms");
+		jsonWriter.beginArray("traceEvents");
+
+		for (auto pBuffer : s_TraceBuffers) {
+			jsonWriter.beginObject();
+			jsonWriter.writeString("name", "thread_name");
+			jsonWriter.writeString("ph", "M");
+			jsonWriter.writeUint64("pid", 1);
+			jsonWriter.writeUint64("tid", pBuffer->m_nThreadID);
+			jsonWriter.beginObject("args");
+			jsonWriter.writeString("name", (pBuffer->m_nThreadID == 1) ? "main" : ("thread " + std::to_string(pBuffer->m_nThreadID)));
+			jsonWriter.endObject();
+			jsonWriter.endObject();
+
+			for (auto& event : pBuffer->m_Events) {
+				jsonWriter.beginObject();
+				jsonWriter.writeString("name", event.m_pszName);
+				jsonWriter.writeString("ph", event.m_bIsBegin ? "B" : "E");
+				// Chrome expects microseconds
+				jsonWriter.writeDouble("ts", (double)event.m_nTimeStampInNanoseconds * 1.0e-3);
+				jsonWriter.writeUint64("pid", 1);
+				jsonWriter.writeUint64("tid", pBuffer->m_nThreadID);
+				if (event.m_pszArgumentName != nullptr) {
+					jsonWriter.beginObject("args");
+					jsonWriter.writeInt64(event.m_pszArgumentName, event.m_nArgumentValue);
+					jsonWriter.endObject();
+				}
+				jsonWriter.endObject();
+			}
+		}
+
+		jsonWriter.endArray();
+		jsonWriter.endObject();
+
+		if (!stream.good())
+			throw std::runtime_error("Failed to write trace file: " + sFileName);
+	}
+
+} // namespace Toolpath
@@ -0,0 +1,100 @@
+/*++
+
+Copyright (C) 2026 3MF Consortium
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+--*/
+
+
+#ifndef __TOOLPATH_TRACE
+#define __TOOLPATH_TRACE
+
+#include <cstdint>
+#include <string>
+#include <atomic>
+
+namespace Toolpath {
+
+	/**
+	 * Opt-in timeline tracing in Chrome trace-event format.
+	 * Every thread records into its own buffer, so recording takes no locks. Buffers are
+	 * registered once per thread and outlive it, so the trace may only be written after all
+	 * traced threads have finished or are idle.
+	 * Event names must be string literals or otherwise outlive the trace.
+	 */
+	class CToolpathTrace {
+	private:
+		static std::atomic<bool> s_bIsEnabled;
+
+	public:
+		static inline bool isEnabled()
+		{
+			return s_bIsEnabled.load(std::memory_order_relaxed);
+		}
+
+		// Must be called before any traced thread is started
+		static void enable();
+
+		static void beginSpan(const char* pszName, const char* pszArgumentName, int64_t nArgumentValue);
+		static void endSpan(const char* pszName);
+
+		static void writeToFile(const std::string& sFileName);
+	};
+
+	/**
+	 * Records a begin and end event for its lifetime if tracing is enabled.
+	 */
+	class CToolpathTraceSpan {
+	private:
+		const char* m_pszName;
+		bool m_bIsActive;
+
+	public:
+		CToolpathTraceSpan(const char* pszName)
+			: m_pszName(pszName), m_bIsActive(CToolpathTrace::isEnabled())
+		{
+			if (m_bIsActive)
+				CToolpathTrace::beginSpan(pszName, nullptr, 0);
+		}
+
+		CToolpathTraceSpan(const char* pszName, const char* pszArgumentName, int64_t nArgumentValue)
+			: m_pszName(pszName), m_bIsActive(CToolpathTrace::isEnabled())
+		{
+			if (m_bIsActive)
+				CToolpathTrace::beginSpan(pszName, pszArgumentName, nArgumentValue);
+		}
+
+		~CToolpathTraceSpan()
+		{
+			if (m_bIsActive)
+				CToolpathTrace::endSpan(m_pszName);
+		}
+
+		CToolpathTraceSpan(const CToolpathTraceSpan&) = delete;
+		CToolpathTraceSpan& operator=(const CToolpathTraceSpan&) = delete;
+	};
+
+} // namespace Toolpath
+
+#endif // __TOOLPATH_TRACE